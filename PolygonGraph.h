@@ -5,8 +5,36 @@
 // INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <future>
 #include <list>
+#include <memory>
 #include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MACROS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Read prefetch hint used by the circulators. Define PG_PREFETCH before
+// including this header to change or disable it.
+
+#ifndef PG_PREFETCH
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        #define PG_PREFETCH( address ) __builtin_prefetch( ( address ), 0, 3 )
+    #else
+        #define PG_PREFETCH( address ) ( ( void ) 0 )
+    #endif
+#endif
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -41,6 +69,366 @@ namespace graph
         // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     };
     
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // STORAGE POLICY DETECTION +++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Besides the base primitives, a Traits class may declare any of these
+    // member templates to choose how the graph stores its elements:
+    //
+    //   template< class T > using Allocator = ...;
+    //   template< class T, class A > using VertexContainer = ...;
+    //   template< class T, class A > using PolygonContainer = ...;
+    //   template< class T, class C, class A > using AdjacencyContainer = ...;
+    //
+    // The allocator serves the containers and the half-edges. Vertex and
+    // polygon containers must keep iterators stable and splice like
+    // std::list, and the adjacency container must behave like
+    // std::multiset. Anything not declared falls back to the standard
+    // library, so the default configuration compiles to exactly the types
+    // used before.
+
+    namespace detail
+    {
+        // Selects the constructors that build an element's payload in place
+
+        class EmplaceTag {};
+
+        template< class... >
+        class MakeVoid
+        {
+            public:
+
+            typedef void type;
+        };
+
+        // ALLOCATOR ----------------------------------------------------------
+
+        template< class Traits, class T, class = void >
+        class TraitsAllocator
+        {
+            public:
+
+            typedef std::allocator< T > type;
+        };
+
+        template< class Traits, class T >
+        class TraitsAllocator
+        <
+            Traits, T,
+            typename MakeVoid
+            <
+                typename Traits::template Allocator< T >
+            >::type
+        >
+        {
+            public:
+
+            typedef typename Traits::template Allocator< T > type;
+        };
+
+        // VERTEX CONTAINER ---------------------------------------------------
+
+        template< class Traits, class T, class A, class = void >
+        class TraitsVertexContainer
+        {
+            public:
+
+            typedef std::list< T, A > type;
+        };
+
+        template< class Traits, class T, class A >
+        class TraitsVertexContainer
+        <
+            Traits, T, A,
+            typename MakeVoid
+            <
+                typename Traits::template VertexContainer< T, A >
+            >::type
+        >
+        {
+            public:
+
+            typedef typename Traits::template VertexContainer< T, A > type;
+        };
+
+        // POLYGON CONTAINER --------------------------------------------------
+
+        template< class Traits, class T, class A, class = void >
+        class TraitsPolygonContainer
+        {
+            public:
+
+            typedef std::list< T, A > type;
+        };
+
+        template< class Traits, class T, class A >
+        class TraitsPolygonContainer
+        <
+            Traits, T, A,
+            typename MakeVoid
+            <
+                typename Traits::template PolygonContainer< T, A >
+            >::type
+        >
+        {
+            public:
+
+            typedef typename Traits::template PolygonContainer< T, A > type;
+        };
+
+        // ADJACENCY CONTAINER ------------------------------------------------
+
+        template< class Traits, class T, class C, class A, class = void >
+        class TraitsAdjacencyContainer
+        {
+            public:
+
+            typedef std::multiset< T, C, A > type;
+        };
+
+        template< class Traits, class T, class C, class A >
+        class TraitsAdjacencyContainer
+        <
+            Traits, T, C, A,
+            typename MakeVoid
+            <
+                typename Traits::template AdjacencyContainer< T, C, A >
+            >::type
+        >
+        {
+            public:
+
+            typedef typename Traits::template AdjacencyContainer< T, C, A >
+                type;
+        };
+
+        // HASH VERTEX PAIR ---------------------------------------------------
+
+        inline std::size_t const hashVertexPair
+        (
+            void const * source,
+            void const * target
+        )
+        {
+            std::uint64_t a = reinterpret_cast< std::uintptr_t >( source );
+            std::uint64_t b = reinterpret_cast< std::uintptr_t >( target );
+            std::uint64_t h = a * 0x9e3779b97f4a7c15ull ^
+                              ( b + 0x7f4a7c159e3779b9ull + ( a << 6 ) );
+
+            h ^= h >> 29;
+            h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 32;
+
+            return static_cast< std::size_t >( h );
+        }
+
+        // EDGE HASH INDEX ----------------------------------------------------
+
+        // Linear-probing table from ( source, target ) vertex pairs to
+        // half-edges. Keys are stored in the slots so probes do not touch
+        // the edges. A pair shared by several half-edges has one slot per
+        // edge. Erasure shifts later entries of the run back, so there are
+        // no tombstones and lookups stop at the first empty slot.
+
+        template< class Vertex, class Edge >
+        class EdgeHashIndex
+        {
+            public:
+
+            EdgeHashIndex( void )
+            {
+                count = 0;
+                mask = 0;
+            }
+
+            std::size_t const getHash
+            (
+                Vertex const * source,
+                Vertex const * target
+            ) const
+            {
+                return hashVertexPair( source, target );
+            }
+
+            void prefetch( std::size_t hash ) const
+            {
+                if( !slots.empty() )
+                {
+                    PG_PREFETCH( &slots[ hash & mask ] );
+                }
+            }
+
+            void insert
+            (
+                Vertex const * source,
+                Vertex const * target,
+                Edge * edge
+            )
+            {
+                if( ( count + 1 ) * 2 > slots.size() )
+                {
+                    rehash( slots.size() < 16 ? 32 : slots.size() * 2 );
+                }
+
+                place( source, target, edge );
+                ++count;
+            }
+
+            void erase
+            (
+                Vertex const * source,
+                Vertex const * target,
+                Edge const * edge
+            )
+            {
+                if( slots.empty() )
+                {
+                    return;
+                }
+
+                std::size_t slot = getHash( source, target ) & mask;
+
+                while( slots[ slot ].edge != edge )
+                {
+                    if( slots[ slot ].edge == nullptr )
+                    {
+                        return;
+                    }
+
+                    slot = ( slot + 1 ) & mask;
+                }
+
+                // Shift back entries that the hole separates from their
+                // home slot
+
+                std::size_t hole = slot;
+                slot = ( slot + 1 ) & mask;
+
+                while( slots[ slot ].edge != nullptr )
+                {
+                    std::size_t home = getHash( slots[ slot ].source,
+                                                slots[ slot ].target ) & mask;
+                    std::size_t homeDistance = ( slot - home ) & mask;
+                    std::size_t holeDistance = ( slot - hole ) & mask;
+
+                    if( homeDistance >= holeDistance )
+                    {
+                        slots[ hole ] = slots[ slot ];
+                        hole = slot;
+                    }
+
+                    slot = ( slot + 1 ) & mask;
+                }
+
+                slots[ hole ] = Slot();
+                --count;
+            }
+
+            Edge * find
+            (
+                Vertex const * source,
+                Vertex const * target,
+                std::size_t hash
+            ) const
+            {
+                if( slots.empty() )
+                {
+                    return nullptr;
+                }
+
+                std::size_t slot = hash & mask;
+
+                while( slots[ slot ].edge != nullptr )
+                {
+                    if( slots[ slot ].source == source &&
+                        slots[ slot ].target == target )
+                    {
+                        return slots[ slot ].edge;
+                    }
+
+                    slot = ( slot + 1 ) & mask;
+                }
+
+                return nullptr;
+            }
+
+            void clear( void )
+            {
+                std::vector< Slot >().swap( slots );
+                count = 0;
+                mask = 0;
+            }
+
+            std::size_t const size( void ) const
+            {
+                return count;
+            }
+
+            std::size_t const getBytes( void ) const
+            {
+                return slots.capacity() * sizeof( Slot );
+            }
+
+            private:
+
+            class Slot
+            {
+                public:
+
+                Slot( void )
+                {
+                    source = nullptr;
+                    target = nullptr;
+                    edge = nullptr;
+                }
+
+                Vertex const * source;
+                Vertex const * target;
+                Edge * edge;
+            };
+
+            void place
+            (
+                Vertex const * source,
+                Vertex const * target,
+                Edge * edge
+            )
+            {
+                std::size_t slot = getHash( source, target ) & mask;
+
+                while( slots[ slot ].edge != nullptr )
+                {
+                    slot = ( slot + 1 ) & mask;
+                }
+
+                slots[ slot ].source = source;
+                slots[ slot ].target = target;
+                slots[ slot ].edge = edge;
+            }
+
+            void rehash( std::size_t capacity )
+            {
+                std::vector< Slot > old( capacity );
+                old.swap( slots );
+                mask = capacity - 1;
+
+                for( std::size_t s = 0; s < old.size(); ++s )
+                {
+                    if( old[ s ].edge != nullptr )
+                    {
+                        place( old[ s ].source, old[ s ].target,
+                               old[ s ].edge );
+                    }
+                }
+            }
+
+            std::vector< Slot > slots;
+            std::size_t count;
+            std::size_t mask;
+        };
+    }
+
     // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     // POLYGON GRAPH CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++
     // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -70,6 +458,27 @@ namespace graph
         class Edge;
         class Polygon;
 
+        // STORAGE POLICIES ---------------------------------------------------
+
+        typedef typename detail::TraitsAllocator< Traits, Vertex >::type
+            VertexAllocator;
+        typedef typename detail::TraitsAllocator< Traits, Edge >::type
+            EdgeAllocator;
+        typedef typename detail::TraitsAllocator< Traits, Polygon >::type
+            PolygonAllocator;
+        typedef typename detail::TraitsAllocator< Traits, Edge * >::type
+            AdjacencyAllocator;
+
+        typedef typename detail::TraitsVertexContainer
+        <
+            Traits, Vertex, VertexAllocator
+        >::type VertexList;
+
+        typedef typename detail::TraitsPolygonContainer
+        <
+            Traits, Polygon, PolygonAllocator
+        >::type PolygonList;
+
         // VERTEX ITERATOR CLASS ----------------------------------------------
 
         class ConstVertexIterator; // forward declaration
@@ -90,7 +499,7 @@ namespace graph
             // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-            typedef typename std::list< Vertex >::iterator VertexListIterator;
+            typedef typename VertexList::iterator VertexListIterator;
 
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
@@ -248,7 +657,7 @@ namespace graph
             // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-            typedef typename std::list< Vertex >::iterator VertexListIterator;
+            typedef typename VertexList::iterator VertexListIterator;
 
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
@@ -432,8 +841,7 @@ namespace graph
             // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-            typedef typename std::list< Polygon >::iterator
-                PolygonListIterator;
+            typedef typename PolygonList::iterator PolygonListIterator;
 
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
@@ -590,8 +998,7 @@ namespace graph
             // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-            typedef typename std::list< Polygon >::iterator
-                PolygonListIterator;
+            typedef typename PolygonList::iterator PolygonListIterator;
 
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
@@ -757,6 +1164,62 @@ namespace graph
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         };
 
+        // CIRCULATORS --------------------------------------------------------
+
+        // Each circulator takes the half-edge type, Edge or Edge const, so
+        // const vertices and polygons yield const elements.
+
+        template< class Circulator > class CirculatorRange;
+
+        template< class EdgeType > class BasicPolygonEdgeCirculator;
+        template< class EdgeType > class BasicPolygonVertexCirculator;
+        template< class EdgeType > class BasicOutgoingEdgeCirculator;
+        template< class EdgeType > class BasicIncomingEdgeCirculator;
+        template< class EdgeType > class BasicVertexPolygonCirculator;
+
+        typedef BasicPolygonEdgeCirculator< Edge > PolygonEdgeCirculator;
+        typedef BasicPolygonVertexCirculator< Edge > PolygonVertexCirculator;
+        typedef BasicOutgoingEdgeCirculator< Edge > OutgoingEdgeCirculator;
+        typedef BasicIncomingEdgeCirculator< Edge > IncomingEdgeCirculator;
+        typedef BasicVertexPolygonCirculator< Edge > VertexPolygonCirculator;
+
+        typedef BasicPolygonEdgeCirculator< Edge const >
+            ConstPolygonEdgeCirculator;
+        typedef BasicPolygonVertexCirculator< Edge const >
+            ConstPolygonVertexCirculator;
+        typedef BasicOutgoingEdgeCirculator< Edge const >
+            ConstOutgoingEdgeCirculator;
+        typedef BasicIncomingEdgeCirculator< Edge const >
+            ConstIncomingEdgeCirculator;
+        typedef BasicVertexPolygonCirculator< Edge const >
+            ConstVertexPolygonCirculator;
+
+        typedef CirculatorRange< PolygonEdgeCirculator > PolygonEdgeRange;
+        typedef CirculatorRange< PolygonVertexCirculator > PolygonVertexRange;
+        typedef CirculatorRange< OutgoingEdgeCirculator > OutgoingEdgeRange;
+        typedef CirculatorRange< IncomingEdgeCirculator > IncomingEdgeRange;
+        typedef CirculatorRange< VertexPolygonCirculator > VertexPolygonRange;
+
+        typedef CirculatorRange< ConstPolygonEdgeCirculator >
+            ConstPolygonEdgeRange;
+        typedef CirculatorRange< ConstPolygonVertexCirculator >
+            ConstPolygonVertexRange;
+        typedef CirculatorRange< ConstOutgoingEdgeCirculator >
+            ConstOutgoingEdgeRange;
+        typedef CirculatorRange< ConstIncomingEdgeCirculator >
+            ConstIncomingEdgeRange;
+        typedef CirculatorRange< ConstVertexPolygonCirculator >
+            ConstVertexPolygonRange;
+
+        // ISOLATED VERTEX LIST -----------------------------------------------
+
+        // Vertices without edges. Each vertex keeps its position in the
+        // list while it is isolated, so joining and leaving are O(1).
+
+        typedef typename detail::TraitsAllocator< Traits, VertexIterator >::
+            type IsolatedAllocator;
+        typedef std::list< VertexIterator, IsolatedAllocator > IsolatedList;
+
         // VERTEX CLASS -------------------------------------------------------
 
         class Vertex : public BaseVertex
@@ -783,7 +1246,10 @@ namespace graph
 
             // EDGE SET -------------------------------------------------------
 
-            typedef std::multiset< Edge *, EdgeSetLess > EdgeSet;
+            typedef typename detail::TraitsAdjacencyContainer
+            <
+                Traits, Edge *, EdgeSetLess, AdjacencyAllocator
+            >::type EdgeSet;
 
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -1131,18 +1597,28 @@ namespace graph
                 // empty
             }
 
+            template< class... Args >
+            Vertex( detail::EmplaceTag, Args &&... args ) :
+                BaseVertex( std::forward< Args >( args )... )
+            {
+                // empty
+            }
+
             // COPY CONSTRUCTOR -----------------------------------------------
 
             Vertex( Vertex const & other ) : BaseVertex( other )
             {
                 this->edges = other.edges;
+                copyIsolatedPosition( other );
             }
 
             // MOVE CONSTRUCTOR -----------------------------------------------
 
-            Vertex( Vertex && other ) : BaseVertex( other )
+            Vertex( Vertex && other ) :
+                BaseVertex( std::move( other ) ),
+                edges( std::move( other.edges ) )
             {
-                this->edges = other.edges;
+                copyIsolatedPosition( other );
             }
 
             // DESTRUCTOR -----------------------------------------------------
@@ -1231,6 +1707,68 @@ namespace graph
                 return edges.size();
             }
 
+            // CIRCULATE ------------------------------------------------------
+
+            // Ranges over the half-edges leaving and entering the vertex and
+            // the polygons around it, for use in range-based for loops.
+            // Incoming edges and polygons follow the outgoing edge order.
+            // On a const vertex they yield const edges and polygon handles.
+
+            OutgoingEdgeRange getOutgoingEdges( void )
+            {
+                return OutgoingEdgeRange
+                (
+                    OutgoingEdgeCirculator( beginEdges(), endEdges() ),
+                    OutgoingEdgeCirculator( endEdges(), endEdges() )
+                );
+            }
+
+            IncomingEdgeRange getIncomingEdges( void )
+            {
+                return IncomingEdgeRange
+                (
+                    IncomingEdgeCirculator( beginEdges(), endEdges() ),
+                    IncomingEdgeCirculator( endEdges(), endEdges() )
+                );
+            }
+
+            VertexPolygonRange getPolygons( void )
+            {
+                return VertexPolygonRange
+                (
+                    VertexPolygonCirculator( beginEdges(), endEdges() ),
+                    VertexPolygonCirculator( endEdges(), endEdges() )
+                );
+            }
+
+            ConstOutgoingEdgeRange getOutgoingEdges( void ) const
+            {
+                return ConstOutgoingEdgeRange
+                (
+                    ConstOutgoingEdgeCirculator( cbeginEdges(), cendEdges() ),
+                    ConstOutgoingEdgeCirculator( cendEdges(), cendEdges() )
+                );
+            }
+
+            ConstIncomingEdgeRange getIncomingEdges( void ) const
+            {
+                return ConstIncomingEdgeRange
+                (
+                    ConstIncomingEdgeCirculator( cbeginEdges(), cendEdges() ),
+                    ConstIncomingEdgeCirculator( cendEdges(), cendEdges() )
+                );
+            }
+
+            ConstVertexPolygonRange getPolygons( void ) const
+            {
+                return ConstVertexPolygonRange
+                (
+                    ConstVertexPolygonCirculator( cbeginEdges(),
+                                                  cendEdges() ),
+                    ConstVertexPolygonCirculator( cendEdges(), cendEdges() )
+                );
+            }
+
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -1242,6 +1780,7 @@ namespace graph
                 BaseVertex::operator=( other );
 
                 this->edges = other.edges;
+                copyIsolatedPosition( other );
 
                 return *this;
             }
@@ -1250,9 +1789,10 @@ namespace graph
 
             Vertex const & operator = ( Vertex && other )
             {
-                BaseVertex::operator=( other );
+                BaseVertex::operator=( std::move( other ) );
 
-                this->edges = other.edges;
+                this->edges = std::move( other.edges );
+                copyIsolatedPosition( other );
 
                 return *this;
             }
@@ -1279,12 +1819,41 @@ namespace graph
                 return EdgeIterator( edges.erase( position.iter ) );
             }
 
+            // REPLACE EDGE ---------------------------------------------------
+
+            // Stores another edge with the same target in an entry. The key
+            // is unchanged, so the entry keeps its place and the links
+            // through it stay valid.
+
+            void replaceEdge( EdgeIterator position, Edge * edge )
+            {
+                const_cast< Edge *& >( *position.iter ) = edge;
+            }
+
+            // COPY ISOLATED POSITION -----------------------------------------
+
+            // The position is only meaningful, and only safe to copy, while
+            // the vertex has no edges.
+
+            void copyIsolatedPosition( Vertex const & other )
+            {
+                if( this->edges.empty() )
+                {
+                    this->isolatedPosition = other.isolatedPosition;
+                }
+            }
+
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
             EdgeSet edges;
 
+            // Position in the graph's isolated list, valid while edges is
+            // empty
+
+            typename IsolatedList::iterator isolatedPosition;
+
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         };
 
@@ -1333,7 +1902,7 @@ namespace graph
 
             // MOVE CONSTRUCTOR -----------------------------------------------
 
-            Edge( Edge && other ) : BaseEdge( other )
+            Edge( Edge && other ) : BaseEdge( std::move( other ) )
             {
                 this->targetVertex    = other.targetVertex;
                 this->nextEdge        = other.nextEdge;
@@ -1418,7 +1987,7 @@ namespace graph
 
             Edge const & operator = ( Edge && other )
             {
-                BaseEdge::operator=( other );
+                BaseEdge::operator=( std::move( other ) );
                 
                 this->targetVertex    = other.targetVertex;
                 this->nextEdge        = other.nextEdge;
@@ -1525,6 +2094,13 @@ namespace graph
                 // empty
             }
 
+            template< class... Args >
+            Polygon( detail::EmplaceTag, Args &&... args ) :
+                BasePolygon( std::forward< Args >( args )... )
+            {
+                // empty
+            }
+
             // COPY CONSTRUCTOR -----------------------------------------------
 
             Polygon( Polygon const & other ) : BasePolygon( other )
@@ -1534,7 +2110,7 @@ namespace graph
 
             // MOVE CONSTRUCTOR -----------------------------------------------
 
-            Polygon( Polygon && other ) : BasePolygon( other )
+            Polygon( Polygon && other ) : BasePolygon( std::move( other ) )
             {
                 this->startEdge = other.startEdge;
             }
@@ -1562,8 +2138,8 @@ namespace graph
 
             size_type const getEdgeCount( void ) const
             {
-                Edge * startEdge = &( *startEdge );
-                Edge * currentEdge = startEdge;
+                Edge const * firstEdge = &( *startEdge );
+                Edge const * currentEdge = firstEdge;
                 size_type edgeCount = 0;
 
                 do
@@ -1571,11 +2147,54 @@ namespace graph
                     ++edgeCount;
                     currentEdge = currentEdge->getNextEdge();
                 }
-                while( currentEdge != startEdge );
+                while( currentEdge != firstEdge );
 
                 return edgeCount;
             }
 
+            // CIRCULATE ------------------------------------------------------
+
+            // Ranges over the polygon's half-edges from the start edge, and
+            // over its vertices from the start edge's source, for use in
+            // range-based for loops. On a const polygon they yield const
+            // edges and vertex handles.
+
+            PolygonEdgeRange getEdges( void )
+            {
+                return PolygonEdgeRange
+                (
+                    PolygonEdgeCirculator( getStartEdge() ),
+                    PolygonEdgeCirculator()
+                );
+            }
+
+            PolygonVertexRange getVertices( void )
+            {
+                return PolygonVertexRange
+                (
+                    PolygonVertexCirculator( getStartEdge() ),
+                    PolygonVertexCirculator()
+                );
+            }
+
+            ConstPolygonEdgeRange getEdges( void ) const
+            {
+                return ConstPolygonEdgeRange
+                (
+                    ConstPolygonEdgeCirculator( getStartEdge() ),
+                    ConstPolygonEdgeCirculator()
+                );
+            }
+
+            ConstPolygonVertexRange getVertices( void ) const
+            {
+                return ConstPolygonVertexRange
+                (
+                    ConstPolygonVertexCirculator( getStartEdge() ),
+                    ConstPolygonVertexCirculator()
+                );
+            }
+
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++
             // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -1595,7 +2214,7 @@ namespace graph
 
             Polygon const & operator = ( Polygon && other )
             {
-                BasePolygon::operator=( other );
+                BasePolygon::operator=( std::move( other ) );
                 
                 this->startEdge = other.startEdge;
 
@@ -1631,532 +2250,2425 @@ namespace graph
         typedef typename Vertex::EdgeIterator EdgeIterator;
         typedef typename Vertex::ConstEdgeIterator ConstEdgeIterator;
 
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
-        private:
-        
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // CIRCULATOR RANGE CLASS ---------------------------------------------
 
-        // CONTAINERS ---------------------------------------------------------
+        template< class Circulator >
+        class CirculatorRange
+        {
+            public:
 
-        typedef std::list< Vertex > VertexList;
-        typedef std::list< Polygon > PolygonList;
+            CirculatorRange( Circulator first, Circulator last )
+            {
+                this->first = first;
+                this->last = last;
+            }
+
+            Circulator begin( void ) const
+            {
+                return first;
+            }
+
+            Circulator end( void ) const
+            {
+                return last;
+            }
+
+            private:
+
+            Circulator first;
+            Circulator last;
+        };
+
+        // POLYGON EDGE CIRCULATOR CLASS --------------------------------------
+
+        // Walks a polygon's ring once from its start edge. The edge after
+        // the current one is prefetched on each step.
+
+        template< class EdgeType >
+        class BasicPolygonEdgeCirculator
+        {
+            public:
+
+            typedef std::forward_iterator_tag   iterator_category;
+            typedef EdgeType                    value_type;
+            typedef std::ptrdiff_t              difference_type;
+            typedef EdgeType *                  pointer;
+            typedef EdgeType &                  reference;
+
+            BasicPolygonEdgeCirculator( void )
+            {
+                this->current = nullptr;
+                this->start = nullptr;
+            }
+
+            BasicPolygonEdgeCirculator( EdgeType * start )
+            {
+                this->current = start;
+                this->start = start;
+                PG_PREFETCH( start->getNextEdge() );
+            }
+
+            bool const operator ==
+                ( BasicPolygonEdgeCirculator const & other ) const
+            {
+                return this->current == other.current;
+            }
+
+            bool const operator !=
+                ( BasicPolygonEdgeCirculator const & other ) const
+            {
+                return this->current != other.current;
+            }
+
+            EdgeType & operator * ( void ) const
+            {
+                return *current;
+            }
+
+            EdgeType * operator -> ( void ) const
+            {
+                return current;
+            }
+
+            BasicPolygonEdgeCirculator & operator ++ ( void ) // prefix
+            {
+                current = current->getNextEdge();
+
+                if( current == start )
+                {
+                    current = nullptr;
+                }
+                else
+                {
+                    PG_PREFETCH( current->getNextEdge() );
+                }
+
+                return *this;
+            }
+
+            BasicPolygonEdgeCirculator const operator ++ ( int ) // postfix
+            {
+                BasicPolygonEdgeCirculator copy( *this );
+                ++( *this );
+                return copy;
+            }
+
+            protected:
+
+            EdgeType * current;
+            EdgeType * start;
+        };
+
+        // POLYGON VERTEX CIRCULATOR CLASS ------------------------------------
+
+        // Yields the source vertex of each edge of the ring, so vertices
+        // come out in the order they were given to addPolygon. The vertex
+        // to be yielded is prefetched as the circulator reaches its edge.
+
+        template< class EdgeType >
+        class BasicPolygonVertexCirculator :
+            public BasicPolygonEdgeCirculator< EdgeType >
+        {
+            public:
+
+            typedef BasicPolygonEdgeCirculator< EdgeType > EdgeCirculator;
+            typedef typename std::conditional
+            <
+                std::is_const< EdgeType >::value,
+                ConstVertexIterator, VertexIterator
+            >::type Handle;
+
+            typedef Handle      value_type;
+            typedef Handle *    pointer;
+            typedef Handle      reference;
+
+            BasicPolygonVertexCirculator( void ) : EdgeCirculator()
+            {
+                // empty
+            }
+
+            BasicPolygonVertexCirculator( EdgeType * start ) :
+                EdgeCirculator( start->getPreviousEdge() )
+            {
+                PG_PREFETCH( &( *this->current->getTargetVertex() ) );
+            }
+
+            Handle operator * ( void ) const
+            {
+                return this->current->getTargetVertex();
+            }
+
+            BasicPolygonVertexCirculator & operator ++ ( void ) // prefix
+            {
+                EdgeCirculator::operator++();
+
+                if( this->current != nullptr )
+                {
+                    PG_PREFETCH( &( *this->current->getTargetVertex() ) );
+                }
+
+                return *this;
+            }
+
+            BasicPolygonVertexCirculator const operator ++ ( int ) // postfix
+            {
+                BasicPolygonVertexCirculator copy( *this );
+                ++( *this );
+                return copy;
+            }
+        };
+
+        // VERTEX FAN CIRCULATOR CLASSES --------------------------------------
+
+        // Walk a vertex's outgoing edge set, yielding each outgoing edge,
+        // the incoming edge preceding it in its polygon, or its polygon.
+        // The element for the following edge is prefetched on each step.
+
+        template< class EdgeType >
+        class BasicOutgoingEdgeCirculator
+        {
+            public:
+
+            typedef typename std::conditional
+            <
+                std::is_const< EdgeType >::value,
+                ConstEdgeIterator, EdgeIterator
+            >::type SetIterator;
+
+            typedef std::forward_iterator_tag   iterator_category;
+            typedef EdgeType                    value_type;
+            typedef std::ptrdiff_t              difference_type;
+            typedef EdgeType *                  pointer;
+            typedef EdgeType &                  reference;
+
+            BasicOutgoingEdgeCirculator( void )
+            {
+                // empty
+            }
+
+            BasicOutgoingEdgeCirculator
+            (
+                SetIterator current,
+                SetIterator end
+            )
+            {
+                this->current = current;
+                this->end = end;
+                prefetch();
+            }
+
+            bool const operator ==
+                ( BasicOutgoingEdgeCirculator const & other ) const
+            {
+                return this->current == other.current;
+            }
+
+            bool const operator !=
+                ( BasicOutgoingEdgeCirculator const & other ) const
+            {
+                return this->current != other.current;
+            }
+
+            EdgeType & operator * ( void ) const
+            {
+                return *current;
+            }
+
+            EdgeType * operator -> ( void ) const
+            {
+                return &( *current );
+            }
+
+            BasicOutgoingEdgeCirculator & operator ++ ( void ) // prefix
+            {
+                ++current;
+                prefetch();
+                return *this;
+            }
+
+            BasicOutgoingEdgeCirculator const operator ++ ( int ) // postfix
+            {
+                BasicOutgoingEdgeCirculator copy( *this );
+                ++( *this );
+                return copy;
+            }
+
+            protected:
+
+            // Returns the following edge, or nullptr at the end
+
+            EdgeType * getFollowingEdge( void ) const
+            {
+                if( current == end )
+                {
+                    return nullptr;
+                }
+
+                SetIterator following = current;
+                ++following;
+
+                return following == end ? nullptr : &( *following );
+            }
+
+            void prefetch( void ) const
+            {
+                EdgeType * following = getFollowingEdge();
+
+                if( following != nullptr )
+                {
+                    PG_PREFETCH( following );
+                }
+            }
+
+            SetIterator current;
+            SetIterator end;
+        };
+
+        template< class EdgeType >
+        class BasicIncomingEdgeCirculator :
+            public BasicOutgoingEdgeCirculator< EdgeType >
+        {
+            public:
+
+            typedef BasicOutgoingEdgeCirculator< EdgeType > EdgeCirculator;
+            typedef typename EdgeCirculator::SetIterator SetIterator;
+
+            BasicIncomingEdgeCirculator( void ) : EdgeCirculator()
+            {
+                // empty
+            }
+
+            BasicIncomingEdgeCirculator
+            (
+                SetIterator current,
+                SetIterator end
+            ) :
+                EdgeCirculator( current, end )
+            {
+                // empty
+            }
+
+            EdgeType & operator * ( void ) const
+            {
+                return *( this->current->getPreviousEdge() );
+            }
+
+            EdgeType * operator -> ( void ) const
+            {
+                return this->current->getPreviousEdge();
+            }
+
+            BasicIncomingEdgeCirculator & operator ++ ( void ) // prefix
+            {
+                EdgeCirculator::operator++();
+                return *this;
+            }
+
+            BasicIncomingEdgeCirculator const operator ++ ( int ) // postfix
+            {
+                BasicIncomingEdgeCirculator copy( *this );
+                ++( *this );
+                return copy;
+            }
+        };
+
+        template< class EdgeType >
+        class BasicVertexPolygonCirculator :
+            public BasicOutgoingEdgeCirculator< EdgeType >
+        {
+            public:
+
+            typedef BasicOutgoingEdgeCirculator< EdgeType > EdgeCirculator;
+            typedef typename EdgeCirculator::SetIterator SetIterator;
+            typedef typename std::conditional
+            <
+                std::is_const< EdgeType >::value,
+                ConstPolygonIterator, PolygonIterator
+            >::type Handle;
+
+            typedef Handle      value_type;
+            typedef Handle *    pointer;
+            typedef Handle      reference;
+
+            BasicVertexPolygonCirculator( void ) : EdgeCirculator()
+            {
+                // empty
+            }
+
+            BasicVertexPolygonCirculator
+            (
+                SetIterator current,
+                SetIterator end
+            ) :
+                EdgeCirculator( current, end )
+            {
+                prefetchPolygon();
+            }
+
+            Handle operator * ( void ) const
+            {
+                return this->current->getPolygon();
+            }
+
+            BasicVertexPolygonCirculator & operator ++ ( void ) // prefix
+            {
+                EdgeCirculator::operator++();
+                prefetchPolygon();
+                return *this;
+            }
+
+            BasicVertexPolygonCirculator const operator ++ ( int ) // postfix
+            {
+                BasicVertexPolygonCirculator copy( *this );
+                ++( *this );
+                return copy;
+            }
+
+            private:
+
+            void prefetchPolygon( void ) const
+            {
+                if( this->current != this->end )
+                {
+                    PG_PREFETCH( &( *this->current->getPolygon() ) );
+                }
+            }
+        };
+
+        // ITERATOR HASH FUNCTORS ---------------------------------------------
+
+        class VertexHash
+        {
+            public:
+
+            std::size_t const
+            operator () ( ConstVertexIterator const & it ) const
+            {
+                return std::hash< Vertex const * >()( &( *it ) );
+            }
+        };
+
+        class PolygonHash
+        {
+            public:
+
+            std::size_t const
+            operator () ( ConstPolygonIterator const & it ) const
+            {
+                return std::hash< Polygon const * >()( &( *it ) );
+            }
+        };
+
+        // CHANGE TRACKER CLASS -----------------------------------------------
+
+        // Records the vertices, half-edges and polygons created, modified
+        // or destroyed since the last call to clear(). Live elements are
+        // reported as handles; destroyed elements are reported by address
+        // only, as their handles are no longer valid. An element created
+        // and destroyed between checkpoints is not reported at all.
+
+        class ChangeTracker
+        {
+            public:
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // FRIENDS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            friend class PolygonGraph< Traits >;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            typedef std::unordered_set< VertexIterator, VertexHash >
+                VertexSet;
+            typedef std::unordered_set< Edge * > EdgeSet;
+            typedef std::unordered_set< PolygonIterator, PolygonHash >
+                PolygonSet;
+
+            typedef std::unordered_set< Vertex const * > DestroyedVertexSet;
+            typedef std::unordered_set< Edge const * > DestroyedEdgeSet;
+            typedef std::unordered_set< Polygon const * >
+                DestroyedPolygonSet;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            // CONSTRUCTORS ---------------------------------------------------
+
+            ChangeTracker( void )
+            {
+                graph = nullptr;
+            }
+
+            // DESTRUCTOR -----------------------------------------------------
+
+            ~ChangeTracker( void )
+            {
+                if( graph != nullptr )
+                {
+                    graph->detachChangeTracker( *this );
+                }
+            }
+
+            // HAS CHANGES ----------------------------------------------------
+
+            bool const hasChanges( void ) const
+            {
+                return !( createdVertices.empty()   &&
+                          modifiedVertices.empty()  &&
+                          destroyedVertices.empty() &&
+                          createdEdges.empty()      &&
+                          modifiedEdges.empty()     &&
+                          destroyedEdges.empty()    &&
+                          createdPolygons.empty()   &&
+                          modifiedPolygons.empty()  &&
+                          destroyedPolygons.empty() );
+            }
+
+            // CLEAR ----------------------------------------------------------
+
+            void clear( void )
+            {
+                createdVertices.clear();
+                modifiedVertices.clear();
+                destroyedVertices.clear();
+                createdEdges.clear();
+                modifiedEdges.clear();
+                destroyedEdges.clear();
+                createdPolygons.clear();
+                modifiedPolygons.clear();
+                destroyedPolygons.clear();
+            }
+
+            // GET VERTEX CHANGES ---------------------------------------------
+
+            VertexSet const & getCreatedVertices( void ) const
+            {
+                return createdVertices;
+            }
+
+            VertexSet const & getModifiedVertices( void ) const
+            {
+                return modifiedVertices;
+            }
+
+            DestroyedVertexSet const & getDestroyedVertices( void ) const
+            {
+                return destroyedVertices;
+            }
+
+            // GET EDGE CHANGES -----------------------------------------------
+
+            EdgeSet const & getCreatedEdges( void ) const
+            {
+                return createdEdges;
+            }
+
+            EdgeSet const & getModifiedEdges( void ) const
+            {
+                return modifiedEdges;
+            }
+
+            DestroyedEdgeSet const & getDestroyedEdges( void ) const
+            {
+                return destroyedEdges;
+            }
+
+            // GET POLYGON CHANGES --------------------------------------------
+
+            PolygonSet const & getCreatedPolygons( void ) const
+            {
+                return createdPolygons;
+            }
+
+            PolygonSet const & getModifiedPolygons( void ) const
+            {
+                return modifiedPolygons;
+            }
+
+            DestroyedPolygonSet const & getDestroyedPolygons( void ) const
+            {
+                return destroyedPolygons;
+            }
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            private:
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            // NON-COPYABLE ---------------------------------------------------
+
+            ChangeTracker( ChangeTracker const & other );
+            ChangeTracker const & operator = ( ChangeTracker const & other );
+
+            // RECORD VERTEX CHANGES ------------------------------------------
+
+            void vertexCreated( VertexIterator vertex )
+            {
+                createdVertices.insert( vertex );
+            }
+
+            void vertexModified( VertexIterator vertex )
+            {
+                if( createdVertices.count( vertex ) == 0 )
+                {
+                    modifiedVertices.insert( vertex );
+                }
+            }
+
+            void vertexDestroyed( VertexIterator vertex )
+            {
+                if( createdVertices.erase( vertex ) == 0 )
+                {
+                    modifiedVertices.erase( vertex );
+                    destroyedVertices.insert( &( *vertex ) );
+                }
+            }
+
+            // RECORD EDGE CHANGES --------------------------------------------
+
+            void edgeCreated( Edge * edge )
+            {
+                createdEdges.insert( edge );
+            }
+
+            void edgeModified( Edge * edge )
+            {
+                if( createdEdges.count( edge ) == 0 )
+                {
+                    modifiedEdges.insert( edge );
+                }
+            }
+
+            void edgeDestroyed( Edge * edge )
+            {
+                if( createdEdges.erase( edge ) == 0 )
+                {
+                    modifiedEdges.erase( edge );
+                    destroyedEdges.insert( edge );
+                }
+            }
+
+            // RECORD POLYGON CHANGES -----------------------------------------
+
+            void polygonCreated( PolygonIterator polygon )
+            {
+                createdPolygons.insert( polygon );
+            }
+
+            void polygonModified( PolygonIterator polygon )
+            {
+                if( createdPolygons.count( polygon ) == 0 )
+                {
+                    modifiedPolygons.insert( polygon );
+                }
+            }
+
+            void polygonDestroyed( PolygonIterator polygon )
+            {
+                if( createdPolygons.erase( polygon ) == 0 )
+                {
+                    modifiedPolygons.erase( polygon );
+                    destroyedPolygons.insert( &( *polygon ) );
+                }
+            }
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            PolygonGraph< Traits > * graph;
+
+            VertexSet           createdVertices;
+            VertexSet           modifiedVertices;
+            DestroyedVertexSet  destroyedVertices;
+
+            EdgeSet             createdEdges;
+            EdgeSet             modifiedEdges;
+            DestroyedEdgeSet    destroyedEdges;
+
+            PolygonSet          createdPolygons;
+            PolygonSet          modifiedPolygons;
+            DestroyedPolygonSet destroyedPolygons;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        };
+
+        // MEMORY USAGE CLASS -------------------------------------------------
+
+        // Estimated heap footprint of a graph in bytes. Structural bytes
+        // exclude payloads, which are counted separately by their inline
+        // size only; memory a payload owns elsewhere is not included.
+        // slack is the allocator's per-block header and rounding overhead.
+
+        class MemoryUsage
+        {
+            public:
+
+            size_type const getTotal( void ) const
+            {
+                return vertices + edges + polygons + adjacency + payloads +
+                       slack;
+            }
+
+            size_type vertices;     // vertex list nodes
+            size_type edges;        // heap-allocated half-edges
+            size_type polygons;     // polygon list nodes
+            size_type adjacency;    // per-vertex edge sets
+            size_type payloads;     // BaseVertex, BaseEdge and BasePolygon
+            size_type slack;        // allocator headers and rounding
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // ITERATORS ----------------------------------------------------------
+
+        typedef typename VertexList::iterator VertexListIterator;
+        typedef typename PolygonList::iterator PolygonListIterator;
+
+        // CHANGE TRACKERS ----------------------------------------------------
+
+        typedef std::list< ChangeTracker * > TrackerList;
+        typedef typename TrackerList::iterator TrackerListIterator;
+
+        typedef detail::EdgeHashIndex< Vertex, Edge > EdgeIndex;
+
+        enum CompactPhase
+        {
+            compactIdle,
+            compactVertices,
+            compactPolygons
+        };
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PolygonGraph( void )
+        {
+            vertices = new VertexList();
+            polygons = new PolygonList();
+            edgeIndex = nullptr;
+            edgeCount = 0;
+            compactPhase = compactIdle;
+        }
+
+        // COPY CONSTRUCTOR ---------------------------------------------------
+
+        PolygonGraph( PolygonGraph< Traits > const & other )
+        {
+            typedef std::unordered_map
+            <
+                ConstVertexIterator,
+                VertexIterator,
+                VertexHash
+            >
+            VertexMap;
+
+            typedef typename VertexMap::const_iterator VertexMapIter;
+
+            typedef std::pair
+            <
+                ConstVertexIterator,
+                VertexIterator
+            >
+            VertexMapEntry;
+
+            PG_TRACE_SCOPE( "PolygonGraph::copy" );
+
+            // Create containers
+
+            this->vertices = new VertexList();
+            this->polygons = new PolygonList();
+            this->edgeIndex = nullptr;
+            this->edgeCount = 0;
+            this->compactPhase = compactIdle;
+
+            enableEdgeIndex( other.hasEdgeIndex() );
+
+            // Create vertex map
+
+            VertexMap vertexMap;
+
+            // Add all vertices from other graph
+
+            ConstVertexIterator otherVertIt = other.cbeginVertices();
+            ConstVertexIterator otherVertItEnd = other.cendVertices();
+            VertexMapEntry mapEntry;
+            VertexIterator vertIt;
+
+            while( otherVertIt != otherVertItEnd )
+            {
+                vertIt = addVertex( *otherVertIt );
+                mapEntry.first = otherVertIt;
+                mapEntry.second = vertIt;
+                vertexMap.insert( mapEntry );
+                ++otherVertIt;
+            }
+
+            // Add all polygons from other graph
+
+            ConstPolygonIterator otherPolyIt = other.cbeginPolygons();
+            ConstPolygonIterator otherPolyItEnd = other.cendPolygons();
+            Edge const * otherCurrentEdge = nullptr;
+            Edge const * otherStartEdge = nullptr;
+            std::list< VertexIterator > vertices;
+            Edge * currentEdge = nullptr;
+            VertexMapIter vertexMapIter;
+            PolygonIterator polyIter;
+
+            while( otherPolyIt != otherPolyItEnd )
+            {
+                vertices.clear();
+
+                // Add mapped vertices of current polygon to list
+
+                otherCurrentEdge =
+                    otherPolyIt->getStartEdge()->getPreviousEdge();
+                otherStartEdge = otherCurrentEdge;
+
+                do
+                {
+                    // Find mapped vertex for current edge
+
+                    vertexMapIter = 
+                        vertexMap.find( otherCurrentEdge->getTargetVertex() );
+
+                    // Add mapped vertex to list
+
+                    vertices.push_back( vertexMapIter->second );
+
+                    // Advance to next edge
+
+                    otherCurrentEdge = otherCurrentEdge->getNextEdge();
+                }
+                while( otherCurrentEdge != otherStartEdge );
+
+                // Add polygon to graph
+
+                polyIter = addPolygon( vertices, *otherPolyIt );
+
+                // Copy edge data to new polygon
+
+                otherCurrentEdge = otherCurrentEdge->getNextEdge();
+                otherStartEdge = otherCurrentEdge;
+                currentEdge = polyIter->getStartEdge();
+
+                do
+                {
+                    // Assign data from source edge to new edge
+
+                    static_cast< BaseEdge & >( *currentEdge ) =
+                        static_cast< BaseEdge const & >( *otherCurrentEdge );
+                    
+                    // Advance edge iterators
+
+                    otherCurrentEdge = otherCurrentEdge->getNextEdge();
+                    currentEdge = currentEdge->getNextEdge();
+                }
+                while( otherCurrentEdge != otherStartEdge );
+
+                // Advance to next polygon
+
+                ++otherPolyIt;
+            }
+        }
+
+        // MOVE CONSTRUCTOR ---------------------------------------------------
+
+        PolygonGraph( PolygonGraph && other )
+        {
+            // Take the other graph's elements and leave it empty
+
+            this->vertices = other.vertices;
+            this->polygons = other.polygons;
+            this->edgeCount = other.edgeCount;
+
+            other.vertices = new VertexList();
+            other.polygons = new PolygonList();
+            other.edgeCount = 0;
+
+            this->edgeIndex = other.edgeIndex;
+            other.edgeIndex = nullptr;
+
+            // The lists moved by pointer, so a pass in progress continues
+
+            this->compactPhase = other.compactPhase;
+            this->compactVertex = other.compactVertex;
+            this->compactPolygon = other.compactPolygon;
+            other.compactPhase = compactIdle;
+
+            this->retiredVertices.swap( other.retiredVertices );
+            this->retiredPolygons.swap( other.retiredPolygons );
+            this->retiredEdges.swap( other.retiredEdges );
+
+            this->isolatedVertices.swap( other.isolatedVertices );
+
+            // Take over change trackers of other graph
+
+            this->trackers.swap( other.trackers );
+            setTrackerGraph( this );
+        }
+
+        // DESTRUCTOR ---------------------------------------------------------
+
+        ~PolygonGraph( void )
+        {
+            if( vertices != nullptr )
+            {
+                clear();
+            }
+
+            delete vertices;
+            delete polygons;
+            delete edgeIndex;
+
+            vertices = nullptr;
+            polygons = nullptr;
+            edgeIndex = nullptr;
+
+            setTrackerGraph( nullptr );
+        }
+
+        // ADD VERTEX ---------------------------------------------------------
+
+        VertexIterator addVertex( void )
+        {
+            return addVertex( BaseVertex() );
+        }
+
+        VertexIterator addVertex( BaseVertex const & baseVertex )
+        {
+            return emplaceVertex( baseVertex );
+        }
+
+        VertexIterator addVertex( BaseVertex && baseVertex )
+        {
+            return emplaceVertex( std::move( baseVertex ) );
+        }
+
+        // EMPLACE VERTEX -----------------------------------------------------
+
+        // Adds a vertex whose payload is constructed in place from args.
+
+        template< class... Args >
+        VertexIterator emplaceVertex( Args &&... args )
+        {
+            vertices->emplace_back( detail::EmplaceTag(),
+                                    std::forward< Args >( args )... );
+            VertexListIterator it = vertices->end(); --it;
+
+            it->isolatedPosition =
+                isolatedVertices.insert( isolatedVertices.end(),
+                                         VertexIterator( it ) );
+
+            if( !trackers.empty() )
+            {
+                notifyVertexCreated( VertexIterator( it ) );
+            }
+
+            return VertexIterator( it );
+        }
+
+        // REMOVE VERTEX ------------------------------------------------------
+
+        VertexIterator removeVertex( VertexIterator vertex )
+        {
+            typedef std::list< PolygonIterator > PolyIterList;
+            typedef typename PolyIterList::iterator PolyIterIt;
+            
+            // Get all dependent polygons
+
+            EdgeIterator edgeItEnd = vertex->endEdges();
+            EdgeIterator edgeIt = vertex->beginEdges();
+            PolyIterList dependentPolygons;
+
+            while( edgeIt != edgeItEnd )
+            {
+                dependentPolygons.push_back( edgeIt->getPolygon() );
+                ++edgeIt;
+            }
+
+            // Remove all dependent polygons
+
+            PolyIterIt polyIterItEnd = dependentPolygons.end();
+            PolyIterIt polyIterIt = dependentPolygons.begin();
+
+            while( polyIterIt != polyIterItEnd )
+            {
+                removePolygon( *polyIterIt );
+                ++polyIterIt;
+            }
+
+            // Remove vertex, now isolated, and return next iterator
+
+            if( !trackers.empty() )
+            {
+                notifyVertexDestroyed( vertex );
+            }
+
+            isolatedVertices.erase( vertex->isolatedPosition );
+            skipCompactionCursor( vertex.iter );
+
+            return VertexIterator( vertices->erase( vertex.iter ) );
+        }
+
+        // REMOVE ISOLATED VERTICES -------------------------------------------
+
+        // Runs in O(number of isolated vertices) using the isolated list.
+
+        size_type const removeIsolatedVertices( void )
+        {
+            PG_TRACE_SCOPE( "PolygonGraph::removeIsolatedVertices" );
+
+            typedef typename IsolatedList::iterator IsolatedListIterator;
+
+            IsolatedListIterator isolatedItEnd = isolatedVertices.end();
+            IsolatedListIterator isolatedIt = isolatedVertices.begin();
+            size_type removeCount = isolatedVertices.size();
+
+            while( isolatedIt != isolatedItEnd )
+            {
+                if( !trackers.empty() )
+                {
+                    notifyVertexDestroyed( *isolatedIt );
+                }
+
+                skipCompactionCursor( isolatedIt->iter );
+                vertices->erase( isolatedIt->iter );
+                ++isolatedIt;
+            }
+
+            isolatedVertices.clear();
+
+            return removeCount;
+        }
+
+        // GET ISOLATED VERTEX COUNT ------------------------------------------
+
+        size_type const getIsolatedVertexCount( void ) const
+        {
+            return isolatedVertices.size();
+        }
+
+        // ENABLE EDGE INDEX --------------------------------------------------
+
+        // Maintains a hash table from ( source, target ) vertex pairs to
+        // half-edges, so findEdge runs in O(1) rather than searching the
+        // source's edge set. Enabling indexes the existing edges; disabling
+        // frees the table. Copies and moves keep the setting of the graph
+        // they take their contents from.
+
+        void enableEdgeIndex( bool enable = true )
+        {
+            if( !enable )
+            {
+                delete edgeIndex;
+                edgeIndex = nullptr;
+                return;
+            }
+
+            if( edgeIndex != nullptr )
+            {
+                return;
+            }
+
+            PG_TRACE_SCOPE( "PolygonGraph::enableEdgeIndex" );
+
+            edgeIndex = new EdgeIndex();
+
+            PolygonListIterator polyItEnd = polygons->end();
+            PolygonListIterator polyIt = polygons->begin();
+
+            while( polyIt != polyItEnd )
+            {
+                Edge * startEdge = polyIt->getStartEdge();
+                Edge * edge = startEdge;
+
+                do
+                {
+                    edgeIndex->insert
+                    (
+                        &( *edge->getPreviousEdge()->getTargetVertex() ),
+                        &( *edge->getTargetVertex() ), edge
+                    );
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
+
+                ++polyIt;
+            }
+        }
+
+        bool const hasEdgeIndex( void ) const
+        {
+            return edgeIndex != nullptr;
+        }
+
+        // FIND EDGE ----------------------------------------------------------
+
+        // Returns a half-edge from source to target, or nullptr. Where
+        // several polygons share the directed pair, any one is returned.
+
+        Edge * findEdge( VertexIterator source, VertexIterator target )
+        {
+            if( edgeIndex != nullptr )
+            {
+                Vertex const * sourceVertex = &( *source );
+                Vertex const * targetVertex = &( *target );
+
+                return edgeIndex->find
+                (
+                    sourceVertex, targetVertex,
+                    edgeIndex->getHash( sourceVertex, targetVertex )
+                );
+            }
+
+            std::pair< EdgeIterator, EdgeIterator > range =
+                source->findEdges( target );
+
+            return range.first != range.second ? &( *range.first ) : nullptr;
+        }
+
+        Edge const * findEdge
+        (
+            ConstVertexIterator source,
+            ConstVertexIterator target
+        ) const
+        {
+            return const_cast< PolygonGraph * >( this )->findEdge
+            (
+                VertexIterator( source.iter ), VertexIterator( target.iter )
+            );
+        }
+
+        // FIND EDGES ---------------------------------------------------------
+
+        // Batched findEdge: edges[ i ] receives the half-edge from
+        // sources[ i ] to targets[ i ], or nullptr. With the edge index
+        // enabled, the table slots of upcoming queries are prefetched
+        // while earlier ones are answered.
+
+        void findEdges
+        (
+            VertexIterator const * sources,
+            VertexIterator const * targets,
+            size_type count,
+            Edge ** edges
+        )
+        {
+            static const size_type prefetchDistance = 8;
+
+            PG_TRACE_SCOPE( "PolygonGraph::findEdges" );
+
+            if( edgeIndex == nullptr )
+            {
+                for( size_type i = 0; i < count; ++i )
+                {
+                    edges[ i ] = findEdge( sources[ i ], targets[ i ] );
+                }
+
+                return;
+            }
+
+            size_type hashes[ prefetchDistance ];
+
+            for( size_type i = 0; i < count && i < prefetchDistance; ++i )
+            {
+                hashes[ i ] = edgeIndex->getHash( &( *sources[ i ] ),
+                                                  &( *targets[ i ] ) );
+                edgeIndex->prefetch( hashes[ i ] );
+            }
+
+            for( size_type i = 0; i < count; ++i )
+            {
+                size_type hash = hashes[ i % prefetchDistance ];
+                size_type ahead = i + prefetchDistance;
+
+                if( ahead < count )
+                {
+                    hashes[ i % prefetchDistance ] =
+                        edgeIndex->getHash( &( *sources[ ahead ] ),
+                                            &( *targets[ ahead ] ) );
+                    edgeIndex->prefetch( hashes[ i % prefetchDistance ] );
+                }
+
+                edges[ i ] = edgeIndex->find( &( *sources[ i ] ),
+                                              &( *targets[ i ] ), hash );
+            }
+        }
 
-        // ITERATORS ----------------------------------------------------------
+        // GET VERTEX COUNT ---------------------------------------------------
+
+        size_type const getVertexCount( void ) const
+        {
+            return vertices->size();
+        }
+
+        // ADD POLYGON --------------------------------------------------------
+
+        PolygonIterator addPolygon
+        (
+            std::list< VertexIterator > const & vertices
+        )
+        {
+            return addPolygon( vertices, BasePolygon() );
+        }
+
+        PolygonIterator addPolygon
+        (
+            std::list< VertexIterator > const & vertices,
+            BasePolygon const & basePolygon
+        )
+        {
+            return addPolygon( vertices.cbegin(), vertices.cend(),
+                               basePolygon );
+        }
+
+        // Builds the polygon directly from any forward range of vertex
+        // iterators, so callers need not gather each face into a list.
+
+        template< class VertIterIt >
+        PolygonIterator addPolygon
+        (
+            VertIterIt firstVertex,
+            VertIterIt endVertex
+        )
+        {
+            return addPolygon( firstVertex, endVertex, BasePolygon() );
+        }
+
+        template< class VertIterIt >
+        PolygonIterator addPolygon
+        (
+            VertIterIt firstVertex,
+            VertIterIt endVertex,
+            BasePolygon const & basePolygon
+        )
+        {
+            return emplacePolygon( firstVertex, endVertex, basePolygon );
+        }
+
+        // Overloads for faces already held in contiguous storage. None of
+        // them allocate beyond the polygon and its half-edges.
+
+        PolygonIterator addPolygon
+        (
+            std::initializer_list< VertexIterator > vertices,
+            BasePolygon const & basePolygon = BasePolygon()
+        )
+        {
+            return emplacePolygon( vertices.begin(), vertices.end(),
+                                   basePolygon );
+        }
+
+        PolygonIterator addPolygon
+        (
+            VertexIterator const * vertices,
+            size_type count,
+            BasePolygon const & basePolygon = BasePolygon()
+        )
+        {
+            return emplacePolygon( vertices, vertices + count, basePolygon );
+        }
+
+        // Takes the face as count indices into a table of vertex handles.
+
+        template< class Index >
+        PolygonIterator addPolygon
+        (
+            VertexIterator const * table,
+            Index const * indices,
+            size_type count,
+            BasePolygon const & basePolygon = BasePolygon()
+        )
+        {
+            return emplacePolygon
+            (
+                IndexedIterator< VertexIterator, Index >( table, indices ),
+                IndexedIterator< VertexIterator, Index >( table,
+                                                          indices + count ),
+                basePolygon
+            );
+        }
+
+        // ADD TRIANGLE -------------------------------------------------------
+
+        // Triangles and quads link their half-edges directly, without
+        // walking a range of vertices.
+
+        PolygonIterator addTriangle
+        (
+            VertexIterator v0,
+            VertexIterator v1,
+            VertexIterator v2,
+            BasePolygon const & basePolygon = BasePolygon()
+        )
+        {
+            PolygonIterator polygonIt = createPolygon( basePolygon );
+
+            EdgeIterator e0 = createRingEdge( polygonIt, v0, v1 );
+            EdgeIterator e1 = createRingEdge( polygonIt, v1, v2 );
+            EdgeIterator e2 = createRingEdge( polygonIt, v2, v0 );
+
+            joinEdges( e0, e1 );
+            joinEdges( e1, e2 );
+            joinEdges( e2, e0 );
+
+            return finishPolygon( polygonIt, e0, 3 );
+        }
+
+        // ADD QUAD -----------------------------------------------------------
+
+        PolygonIterator addQuad
+        (
+            VertexIterator v0,
+            VertexIterator v1,
+            VertexIterator v2,
+            VertexIterator v3,
+            BasePolygon const & basePolygon = BasePolygon()
+        )
+        {
+            PolygonIterator polygonIt = createPolygon( basePolygon );
+
+            EdgeIterator e0 = createRingEdge( polygonIt, v0, v1 );
+            EdgeIterator e1 = createRingEdge( polygonIt, v1, v2 );
+            EdgeIterator e2 = createRingEdge( polygonIt, v2, v3 );
+            EdgeIterator e3 = createRingEdge( polygonIt, v3, v0 );
+
+            joinEdges( e0, e1 );
+            joinEdges( e1, e2 );
+            joinEdges( e2, e3 );
+            joinEdges( e3, e0 );
+
+            return finishPolygon( polygonIt, e0, 4 );
+        }
+
+        // EMPLACE POLYGON ----------------------------------------------------
+
+        // Adds a polygon over a range of vertex iterators, or a list of
+        // them, with its payload constructed in place from args.
+
+        template< class... Args >
+        PolygonIterator emplacePolygon
+        (
+            std::list< VertexIterator > const & vertices,
+            Args &&... args
+        )
+        {
+            return emplacePolygon( vertices.cbegin(), vertices.cend(),
+                                   std::forward< Args >( args )... );
+        }
+
+        template< class VertIterIt, class... Args >
+        PolygonIterator emplacePolygon
+        (
+            VertIterIt firstVertex,
+            VertIterIt endVertex,
+            Args &&... args
+        )
+        {
+            // Ensure polygon has at least three vertices
+
+            size_type vertexCount = static_cast< size_type >
+            (
+                std::distance( firstVertex, endVertex )
+            );
+
+            if( vertexCount < 3 )
+            {
+                return endPolygons();
+            }
+
+            // Create new polygon
+
+            PolygonIterator polygonIt =
+                createPolygon( std::forward< Args >( args )... );
+
+            // Create and link edges
+
+            VertIterIt beginVertex = firstVertex;
+            VertIterIt secondVertex = firstVertex; ++secondVertex;
+
+            EdgeIterator startEdge =
+                createRingEdge( polygonIt, *firstVertex, *secondVertex );
+            EdgeIterator previousEdge = startEdge;
+            EdgeIterator currentEdge;
+            
+            ++firstVertex;
+            ++secondVertex;
+
+            while( secondVertex != endVertex )
+            {
+                currentEdge =
+                    createRingEdge( polygonIt, *firstVertex, *secondVertex );
+                joinEdges( previousEdge, currentEdge );
+                previousEdge = currentEdge;
+
+                ++firstVertex;
+                ++secondVertex;
+            }
+
+            currentEdge =
+                createRingEdge( polygonIt, *firstVertex, *beginVertex );
+            joinEdges( previousEdge, currentEdge );
+            joinEdges( currentEdge, startEdge );
+
+            return finishPolygon( polygonIt, startEdge, vertexCount );
+        }
+
+        // REMOVE POLYGON -----------------------------------------------------
+
+        PolygonIterator removePolygon( PolygonIterator polygon )
+        {
+            // Report polygon, its edges and affected vertices
+
+            if( !trackers.empty() )
+            {
+                notifyPolygonDestroyed( polygon );
+            }
+
+            // Remove all polygon edges from vertices and delete edges
+            
+            Edge * startEdge = polygon->getStartEdge();
+            EdgeIterator currentEdge = startEdge->nextEdge;
+            Edge * edge = &( *currentEdge );
+            EdgeIterator nextEdge;
+
+            VertexIterator currentVertex = startEdge->targetVertex;
+            VertexIterator nextVertex;
+
+            while( edge != startEdge )
+            {
+                // Get next edge and vertex
+
+                nextEdge = currentEdge->nextEdge;
+                nextVertex = currentEdge->targetVertex;
+
+                // Remove current edge from vertex and deallocate
+
+                unlinkEdge( currentVertex, currentEdge );
+                destroyEdge( edge );
+                --edgeCount;
+
+                // Advance to next edge
+
+                currentEdge = nextEdge;
+                currentVertex = nextVertex;
+                edge = &( *currentEdge );
+            }
+
+            // Remove final edge from vertex and deallocate
+
+            unlinkEdge( currentVertex, currentEdge );
+            destroyEdge( edge );
+            --edgeCount;
+
+            // Remove polygon from list and return iterator to next
+
+            skipCompactionCursor( polygon.iter );
+
+            return PolygonIterator( polygons->erase( polygon.iter ) );
+        }
+
+        // GET POLYGON COUNT --------------------------------------------------
+
+        size_type const getPolygonCount( void ) const
+        {
+            return polygons->size();
+        }
+
+        // GET EDGE COUNT -----------------------------------------------------
+
+        // Number of half-edges, maintained as polygons are added and removed.
+
+        size_type const getEdgeCount( void ) const
+        {
+            return edgeCount;
+        }
+
+        // COMPACT ------------------------------------------------------------
+
+        // Relocates up to budget vertices and polygons into freshly
+        // allocated storage, continuing a pass over the graph from where
+        // the last call stopped. Vertices are moved in list order, then
+        // each polygon is moved together with its half-edges. Links, edge
+        // sets, the isolated list and the edge index are patched as
+        // elements move; edge set entries keep their storage.
+        //
+        // The old storage is only freed when the pass completes, so the
+        // allocator cannot hand it back to later moves. With an allocator
+        // that serves fresh memory in address order, as malloc does from
+        // the top of its heap, a full pass leaves elements in traversal
+        // order. Until then the moved elements take twice their memory.
+        // Blocks freed by an earlier pass are handed out again first, so
+        // a pass run straight after another orders elements only as well
+        // as the allocator's free lists allow.
+        //
+        // Relocated elements get new handles: iterators and pointers to
+        // them are invalidated, and change trackers see each move as a
+        // destroy followed by a create. The graph may be edited between
+        // calls. Returns true when a pass has completed; the next call
+        // starts a new one.
+
+        bool const compact( size_type budget )
+        {
+            PG_TRACE_SCOPE( "PolygonGraph::compact" );
+
+            std::vector< Edge * > outgoing;
+            std::vector< EdgeIterator > ring;
+
+            if( compactPhase == compactIdle )
+            {
+                compactPhase = compactVertices;
+                compactVertex = vertices->begin();
+                retiredEdges.reserve( edgeCount );
+            }
+
+            while( budget > 0 && compactPhase == compactVertices )
+            {
+                if( compactVertex == vertices->end() )
+                {
+                    compactPhase = compactPolygons;
+                    compactPolygon = polygons->begin();
+                    break;
+                }
+
+                VertexListIterator vertex = compactVertex;
+                ++compactVertex;
+                relocateVertex( vertex, outgoing );
+                --budget;
+            }
+
+            while( budget > 0 && compactPhase == compactPolygons &&
+                   compactPolygon != polygons->end() )
+            {
+                PolygonListIterator polygon = compactPolygon;
+                ++compactPolygon;
+                relocatePolygon( polygon, ring );
+                --budget;
+            }
+
+            if( compactPhase == compactPolygons &&
+                compactPolygon == polygons->end() )
+            {
+                compactPhase = compactIdle;
+                releaseRetired();
+                return true;
+            }
+
+            return false;
+        }
+
+        // Compacts in slices of a few elements until the time is used up or
+        // the pass completes, for calling from an idle loop.
+
+        template< class Rep, class Period >
+        bool const compactFor( std::chrono::duration< Rep, Period > time )
+        {
+            typedef std::chrono::steady_clock Clock;
+
+            Clock::time_point deadline = Clock::now() +
+                std::chrono::duration_cast< Clock::duration >( time );
+
+            do
+            {
+                if( compact( 64 ) )
+                {
+                    return true;
+                }
+            }
+            while( Clock::now() < deadline );
+
+            return false;
+        }
+
+        // GET MEMORY USAGE ---------------------------------------------------
+
+        // Estimates the graph's heap footprint from element counts and node
+        // sizes, in constant time. The result is an estimate, not a
+        // measurement: node layouts follow the common 64-bit standard
+        // libraries (two links per list node, three links and a colour per
+        // tree node) and slack follows a malloc that adds an 8-byte header
+        // and rounds blocks to 16 bytes. Other libraries, pool allocators
+        // and memory the allocator caches are not accounted for. The
+        // benchmark driver's memory group compares it with resident size.
+
+        MemoryUsage const getMemoryUsage( void ) const
+        {
+            size_type vertexCount = vertices->size();
+            size_type polygonCount = polygons->size();
+
+            size_type vertexPayload = getPayloadSize< BaseVertex >();
+            size_type edgePayload = getPayloadSize< BaseEdge >();
+            size_type polygonPayload = getPayloadSize< BasePolygon >();
+            size_type edgeSetSize = sizeof( typename Vertex::EdgeSet );
+
+            size_type vertexNode = 2 * sizeof( void * ) + sizeof( Vertex );
+            size_type polygonNode = 2 * sizeof( void * ) + sizeof( Polygon );
+            size_type treeNode = 4 * sizeof( void * ) + sizeof( Edge * );
+            size_type isolatedNode =
+                2 * sizeof( void * ) + sizeof( VertexIterator );
+            size_type isolatedCount = isolatedVertices.size();
+
+            MemoryUsage usage;
+
+            usage.vertices = vertexCount *
+                ( vertexNode - vertexPayload - edgeSetSize ) +
+                isolatedCount * isolatedNode;
+            usage.edges = edgeCount * ( sizeof( Edge ) - edgePayload );
+            usage.polygons = polygonCount * ( polygonNode - polygonPayload );
+            usage.adjacency = vertexCount * edgeSetSize +
+                              edgeCount * treeNode +
+                              ( edgeIndex != nullptr
+                                ? edgeIndex->getBytes() : 0 );
+            usage.payloads = vertexCount * vertexPayload +
+                             edgeCount * edgePayload +
+                             polygonCount * polygonPayload;
+            usage.slack =
+                vertexCount * getAllocationSlack( vertexNode ) +
+                edgeCount * getAllocationSlack( sizeof( Edge ) ) +
+                edgeCount * getAllocationSlack( treeNode ) +
+                polygonCount * getAllocationSlack( polygonNode ) +
+                isolatedCount * getAllocationSlack( isolatedNode );
+
+            return usage;
+        }
+
+        // BEGIN VERTICES -----------------------------------------------------
+
+        VertexIterator beginVertices( void )
+        {
+            return VertexIterator( vertices->begin() );
+        }
+
+        ConstVertexIterator cbeginVertices( void ) const
+        {
+            return ConstVertexIterator
+            (
+                const_cast< VertexList * >( vertices )->begin()
+            );
+        }
+
+        // END VERTICES -------------------------------------------------------
+
+        VertexIterator endVertices( void )
+        {
+            return VertexIterator( vertices->end() );
+        }
+
+        ConstVertexIterator cendVertices( void ) const
+        {
+            return ConstVertexIterator
+            (
+                const_cast< VertexList * >( vertices )->end()
+            );
+        }
+
+        // BEGIN POLYGONS -----------------------------------------------------
+
+        PolygonIterator beginPolygons( void )
+        {
+            return PolygonIterator( polygons->begin() );
+        }
+
+        ConstPolygonIterator cbeginPolygons( void ) const
+        {
+            return ConstPolygonIterator
+            (
+                const_cast< PolygonList * >( polygons )->begin()
+            );
+        }
 
-        typedef typename VertexList::iterator VertexListIterator;
-        typedef typename PolygonList::iterator PolygonListIterator;
+        // END POLYGONS -------------------------------------------------------
 
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        PolygonIterator endPolygons( void )
+        {
+            return PolygonIterator( polygons->end() );
+        }
 
-        public:
+        ConstPolygonIterator cendPolygons( void ) const
+        {
+            return ConstPolygonIterator
+            (
+                const_cast< PolygonList * >( polygons )->end()
+            );
+        }
 
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // CLEAR --------------------------------------------------------------
 
-        // CONSTRUCTORS -------------------------------------------------------
+        // Removes everything in O(E). Since every vertex goes too, edges are
+        // freed by walking the polygon rings without taking them out of the
+        // vertices' edge sets, which are then dropped whole.
 
-        PolygonGraph( void )
+        void clear( void )
         {
-            vertices = new VertexList();
-            polygons = new PolygonList();
+            PG_TRACE_SCOPE( "PolygonGraph::clear" );
+
+            notifyAllDestroyed();
+
+            destroyAllEdges( *polygons );
+            polygons->clear();
+            vertices->clear();
+            isolatedVertices.clear();
+            edgeCount = 0;
+            compactPhase = compactIdle;
+            releaseRetired();
+
+            if( edgeIndex != nullptr )
+            {
+                edgeIndex->clear();
+            }
         }
 
-        // COPY CONSTRUCTOR ---------------------------------------------------
+        // CLEAR ASYNC --------------------------------------------------------
 
-        PolygonGraph( PolygonGraph< Traits > const & other )
+        // As clear, but the graph's old elements are handed to a background
+        // thread to free and the graph is empty on return. Wait on the
+        // future before relying on the memory having been released. Storage
+        // kept by a compaction pass in progress is freed before returning.
+        // The Traits allocators must be safe to use from another thread.
+
+        std::future< void > clearAsync( void )
         {
-            class MapHash
+            notifyAllDestroyed();
+
+            VertexList * oldVertices = vertices;
+            PolygonList * oldPolygons = polygons;
+
+            vertices = new VertexList();
+            polygons = new PolygonList();
+            isolatedVertices.clear();
+            edgeCount = 0;
+            compactPhase = compactIdle;
+            releaseRetired();
+
+            if( edgeIndex != nullptr )
             {
-                public:
+                edgeIndex->clear();
+            }
 
-                std::size_t const
-                operator () ( ConstVertexIterator const & it ) const
+            return std::async
+            (
+                std::launch::async,
+                [ oldVertices, oldPolygons ]( void )
                 {
-                    return &( *it );
+                    PG_TRACE_SCOPE( "PolygonGraph::clearAsync" );
+
+                    destroyAllEdges( *oldPolygons );
+                    delete oldPolygons;
+                    delete oldVertices;
                 }
-            };
+            );
+        }
 
-            typedef std::unordered_map
-            <
-                ConstVertexIterator,
-                VertexIterator,
-                MapHash
-            >
-            VertexMap;
+        // ATTACH CHANGE TRACKER ----------------------------------------------
 
-            typedef typename VertexMap::const_iterator VertexMapIter;
+        void attachChangeTracker( ChangeTracker & tracker )
+        {
+            if( tracker.graph != nullptr )
+            {
+                tracker.graph->detachChangeTracker( tracker );
+            }
 
-            typedef std::pair
-            <
-                ConstVertexIterator,
-                VertexIterator
-            >
-            VertexMapEntry;
+            tracker.graph = this;
+            trackers.push_back( &tracker );
+        }
 
-            // Create containers
+        // DETACH CHANGE TRACKER ----------------------------------------------
 
-            this->vertices = new VertexList();
-            this->polygons = new PolygonList();
+        void detachChangeTracker( ChangeTracker & tracker )
+        {
+            if( tracker.graph == this )
+            {
+                trackers.remove( &tracker );
+                tracker.graph = nullptr;
+            }
+        }
 
-            // Create vertex map
+        // MARK MODIFIED ------------------------------------------------------
 
-            VertexMap vertexMap;
+        void markModified( VertexIterator vertex )
+        {
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
 
-            // Add all vertices from other graph
+            while( trackerIt != trackerItEnd )
+            {
+                ( *trackerIt )->vertexModified( vertex );
+                ++trackerIt;
+            }
+        }
 
-            ConstVertexIterator otherVertIt = other.cbeginVertices();
-            ConstVertexIterator otherVertItEnd = other.cendVertices();
-            VertexMapEntry mapEntry;
-            VertexIterator vertIt;
+        void markModified( Edge * edge )
+        {
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
 
-            while( otherVertIt != otherVertItEnd )
+            while( trackerIt != trackerItEnd )
             {
-                vertIt = addVertex( *otherVertIt );
-                mapEntry.first = otherVertIt;
-                mapEntry.second = vertIt;
-                vertexMap.insert( mapEntry );
-                ++otherVertIt;
+                ( *trackerIt )->edgeModified( edge );
+                ++trackerIt;
+            }
+        }
+
+        void markModified( PolygonIterator polygon )
+        {
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
+
+            while( trackerIt != trackerItEnd )
+            {
+                ( *trackerIt )->polygonModified( polygon );
+                ++trackerIt;
             }
+        }
 
-            // Add all polygons from other graph
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-            ConstPolygonIterator otherPolyIt = other.cbeginPolygons();
-            ConstPolygonIterator otherPolyItEnd = other.cendPolygons();
-            Edge const * otherCurrentEdge = nullptr;
-            Edge const * otherStartEdge = nullptr;
-            std::list< VertexIterator > vertices;
-            Edge * currentEdge = nullptr;
-            VertexMapIter vertexMapIter;
-            PolygonIterator polyIter;
+        // COPY ASSIGNMENT ----------------------------------------------------
 
-            while( otherPolyIt != otherPolyItEnd )
+        PolygonGraph< Traits > const & operator =
+            ( PolygonGraph< Traits > const & other )
+        {
+            PolygonGraph< Traits > copy( other );
+
+            clear();
+
+            delete this->vertices;
+            delete this->polygons;
+
+            this->vertices = copy.vertices;
+            this->polygons = copy.polygons;
+            this->edgeCount = copy.edgeCount;
+
+            copy.vertices = nullptr;
+            copy.polygons = nullptr;
+            copy.edgeCount = 0;
+
+            this->isolatedVertices.swap( copy.isolatedVertices );
+            std::swap( this->edgeIndex, copy.edgeIndex );
+            this->compactPhase = compactIdle;
+
+            // Report the vertices and polygons of the new content
+
+            if( !trackers.empty() )
             {
-                vertices.clear();
+                VertexIterator vertexItEnd = endVertices();
+                VertexIterator vertexIt = beginVertices();
 
-                // Add mapped vertices of current polygon to list
+                while( vertexIt != vertexItEnd )
+                {
+                    notifyVertexCreated( vertexIt );
+                    ++vertexIt;
+                }
 
-                otherCurrentEdge =
-                    otherPolyIt->getStartEdge()->getPreviousEdge();
-                otherStartEdge = otherCurrentEdge;
+                PolygonIterator polyItEnd = endPolygons();
+                PolygonIterator polyIt = beginPolygons();
 
-                do
+                while( polyIt != polyItEnd )
                 {
-                    // Find mapped vertex for current edge
+                    notifyPolygonCreated( polyIt );
+                    ++polyIt;
+                }
+            }
 
-                    vertexMapIter = 
-                        vertexMap.find( otherCurrentEdge->getTargetVertex() );
+            return *this;
+        }
 
-                    // Add mapped vertex to list
+        // MOVE ASSIGNMENT ----------------------------------------------------
 
-                    vertices.push_back( vertexMapIter->second );
+        PolygonGraph< Traits > const & operator =
+            ( PolygonGraph< Traits > && other )
+        {
+            if( this == &other )
+            {
+                return *this;
+            }
 
-                    // Advance to next edge
+            // Swap in the other graph's elements, leaving it empty
 
-                    otherCurrentEdge = otherCurrentEdge->getNextEdge();
-                }
-                while( otherCurrentEdge != otherStartEdge );
+            clear();
 
-                // Add polygon to graph
+            std::swap( this->vertices, other.vertices );
+            std::swap( this->polygons, other.polygons );
+            std::swap( this->edgeCount, other.edgeCount );
+            this->isolatedVertices.swap( other.isolatedVertices );
+            std::swap( this->edgeIndex, other.edgeIndex );
+            std::swap( this->compactPhase, other.compactPhase );
+            std::swap( this->compactVertex, other.compactVertex );
+            std::swap( this->compactPolygon, other.compactPolygon );
+            this->retiredVertices.swap( other.retiredVertices );
+            this->retiredPolygons.swap( other.retiredPolygons );
+            this->retiredEdges.swap( other.retiredEdges );
+
+            // Take over change trackers of other graph
+
+            setTrackerGraph( nullptr );
+            this->trackers.clear();
+            this->trackers.swap( other.trackers );
+            setTrackerGraph( this );
 
-                polyIter = addPolygon( vertices, *otherPolyIt );
+            return *this;
+        }
 
-                // Copy edge data to new polygon
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-                otherCurrentEdge = otherCurrentEdge->getNextEdge();
-                otherStartEdge = otherCurrentEdge;
-                currentEdge = polyIter->getStartEdge();
+        private:
 
-                do
-                {
-                    // Assign data from source edge to new edge
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-                    static_cast< BaseEdge & >( *currentEdge ) =
-                        static_cast< BaseEdge & >( otherCurrentEdge );
-                    
-                    // Advance edge iterators
+        // CREATE EDGE --------------------------------------------------------
 
-                    otherCurrentEdge = otherCurrentEdge->getNextEdge();
-                    currentEdge = currentEdge->getNextEdge();
-                }
-                while( otherCurrentEdge != otherStartEdge );
+        // Half-edges come from the Traits allocator. Allocators are default
+        // constructed on use, so stateful ones must share their state.
 
-                // Advance to next polygon
+        Edge * createEdge( void )
+        {
+            typedef std::allocator_traits< EdgeAllocator > Alloc;
 
-                ++otherPolyIt;
-            }
+            EdgeAllocator allocator;
+            Edge * result = Alloc::allocate( allocator, 1 );
+            Alloc::construct( allocator, result );
+
+            return result;
         }
 
-        // MOVE CONSTRUCTOR ---------------------------------------------------
+        // DESTROY EDGE -------------------------------------------------------
 
-        PolygonGraph( PolygonGraph && other )
+        static void destroyEdge( Edge * edge )
         {
-            this->vertices = other.vertices;
-            this->polygons = other.polygons;
+            typedef std::allocator_traits< EdgeAllocator > Alloc;
 
-            other.polygons = nullptr;
-            other.vertices = nullptr;
+            EdgeAllocator allocator;
+            Alloc::destroy( allocator, edge );
+            Alloc::deallocate( allocator, edge, 1 );
         }
 
-        // DESTRUCTOR ---------------------------------------------------------
+        // CREATE EDGE FROM ---------------------------------------------------
 
-        ~PolygonGraph( void )
+        Edge * createEdge( Edge && other )
         {
-            clear();
-            
-            delete vertices;
-            delete polygons;
+            typedef std::allocator_traits< EdgeAllocator > Alloc;
 
-            vertices = nullptr;
-            polygons = nullptr;
+            EdgeAllocator allocator;
+            Edge * result = Alloc::allocate( allocator, 1 );
+            Alloc::construct( allocator, result, std::move( other ) );
+
+            return result;
+        }
+
+        // SKIP COMPACTION CURSOR ---------------------------------------------
+
+        // Keeps the compaction cursor valid when the element under it is
+        // about to be erased.
+
+        void skipCompactionCursor( VertexListIterator vertex )
+        {
+            if( compactPhase == compactVertices && compactVertex == vertex )
+            {
+                ++compactVertex;
+            }
+        }
+
+        void skipCompactionCursor( PolygonListIterator polygon )
+        {
+            if( compactPhase == compactPolygons && compactPolygon == polygon )
+            {
+                ++compactPolygon;
+            }
         }
 
-        // ADD VERTEX ---------------------------------------------------------
+        // RELOCATE VERTEX ----------------------------------------------------
+
+        // Moves a vertex into a new list node in the same position and
+        // retires the old node. Its edge set moves with it. Edges entering
+        // it are re-keyed in their source's edge set, whose order depends
+        // on the target address.
+
+        void relocateVertex
+        (
+            VertexListIterator vertex,
+            std::vector< Edge * > & outgoing
+        )
+        {
+            outgoing.clear();
+
+            typename Vertex::EdgeSet::const_iterator edgeItEnd =
+                vertex->edges.end();
+            typename Vertex::EdgeSet::const_iterator edgeIt =
+                vertex->edges.begin();
+
+            while( edgeIt != edgeItEnd )
+            {
+                outgoing.push_back( *edgeIt );
+                ++edgeIt;
+            }
+
+            if( !trackers.empty() )
+            {
+                notifyVertexDestroyed( VertexIterator( vertex ) );
+            }
+
+            VertexListIterator moved =
+                vertices->emplace( vertex, std::move( *vertex ) );
+            VertexIterator oldVertex( vertex );
+            VertexIterator newVertex( moved );
+
+            if( moved->edges.empty() )
+            {
+                *moved->isolatedPosition = newVertex;
+            }
+
+            for( size_type e = 0; e < outgoing.size(); ++e )
+            {
+                Edge * edge = outgoing[ e ];
+                Edge * incoming = edge->getPreviousEdge();
+                EdgeIterator oldNode = edge->previousEdge;
+                VertexIterator source = incoming->previousEdge->targetVertex;
+
+                if( source == oldVertex )
+                {
+                    source = newVertex;
+                }
+
+                if( edgeIndex != nullptr )
+                {
+                    edgeIndex->erase( &( *oldVertex ),
+                                      &( *edge->targetVertex ), edge );
+                    edgeIndex->erase( &( *source ), &( *oldVertex ),
+                                      incoming );
+                }
+
+                // Re-insert the entering edge under its new key and point
+                // the links to its entry at the new one
+
+                bool const isStartEdge =
+                    incoming->polygon->getStartEdge() == incoming;
+
+                source->removeEdge( oldNode );
+                incoming->targetVertex = newVertex;
+                EdgeIterator newNode = source->addEdge( incoming );
+
+                incoming->previousEdge->nextEdge = newNode;
+                edge->previousEdge = newNode;
+
+                if( isStartEdge )
+                {
+                    incoming->polygon->startEdge = newNode;
+                }
+
+                if( edgeIndex != nullptr )
+                {
+                    edgeIndex->insert( &( *newVertex ),
+                                       &( *edge->targetVertex ), edge );
+                    edgeIndex->insert( &( *source ), &( *newVertex ),
+                                       incoming );
+                }
+
+                if( !trackers.empty() )
+                {
+                    markModified( incoming );
+                }
+            }
+
+            retiredVertices.splice( retiredVertices.end(), *vertices,
+                                    vertex );
 
-        VertexIterator addVertex( void )
-        {
-            return addVertex( BaseVertex() );
+            if( !trackers.empty() )
+            {
+                notifyVertexCreated( newVertex );
+            }
         }
 
-        VertexIterator addVertex( BaseVertex const & baseVertex )
-        {
-            vertices->push_back( Vertex() );
-            VertexListIterator it = vertices->end(); --it;
-            static_cast< BaseVertex & >( *it ) = baseVertex;
-            return VertexIterator( it );
-        }
+        // RELOCATE POLYGON ---------------------------------------------------
 
-        // REMOVE VERTEX ------------------------------------------------------
+        // Moves a polygon into a new list node in the same position, and
+        // its half-edges into new allocations made one after another. The
+        // edge set entries stay and are pointed at the new edges, so the
+        // links through them need no patching. The old storage is retired.
 
-        VertexIterator removeVertex( VertexIterator vertex )
+        void relocatePolygon
+        (
+            PolygonListIterator polygon,
+            std::vector< EdgeIterator > & ring
+        )
         {
-            typedef std::list< PolygonIterator > PolyIterList;
-            typedef typename PolyIterList::iterator PolyIterIt;
-            
-            // Get all dependent polygons
+            if( !trackers.empty() )
+            {
+                notifyPolygonDestroyed( PolygonIterator( polygon ) );
+            }
 
-            EdgeIterator edgeItEnd = vertex->endEdges();
-            EdgeIterator edgeIt = vertex->beginEdges();
-            PolyIterList dependentPolygons;
+            PolygonListIterator moved =
+                polygons->emplace( polygon, std::move( *polygon ) );
+            PolygonIterator newPolygon( moved );
 
-            while( edgeIt != edgeItEnd )
+            // Collect the ring before any entry changes, starting from the
+            // start edge
+
+            ring.clear();
+            Edge * startEdge = moved->getStartEdge();
+            EdgeIterator node = moved->startEdge;
+
+            do
             {
-                dependentPolygons.push_back( edgeIt->getPolygon() );
-                ++edgeIt;
+                ring.push_back( node );
+                node = node->nextEdge;
             }
+            while( &( *node ) != startEdge );
 
-            // Remove all dependent polygons
+            for( size_type e = 0; e < ring.size(); ++e )
+            {
+                Edge * oldEdge = &( *ring[ e ] );
+                VertexIterator source = oldEdge->previousEdge->targetVertex;
+                Edge * newEdge = createEdge( std::move( *oldEdge ) );
+                newEdge->polygon = newPolygon;
 
-            PolyIterIt polyIterItEnd = dependentPolygons.end();
-            PolyIterIt polyIterIt = dependentPolygons.begin();
+                if( edgeIndex != nullptr )
+                {
+                    edgeIndex->erase( &( *source ),
+                                      &( *newEdge->targetVertex ), oldEdge );
+                    edgeIndex->insert( &( *source ),
+                                       &( *newEdge->targetVertex ), newEdge );
+                }
 
-            while( polyIterIt != polyIterItEnd )
-            {
-                removePolygon( *polyIterIt );
-                ++polyIterIt;
+                source->replaceEdge( ring[ e ], newEdge );
+                retiredEdges.push_back( oldEdge );
             }
 
-            // Remove vertex and return next iterator
+            retiredPolygons.splice( retiredPolygons.end(), *polygons,
+                                    polygon );
 
-            return VertexIterator( vertices->erase( vertex.iter ) );
+            if( !trackers.empty() )
+            {
+                notifyPolygonCreated( newPolygon );
+            }
         }
 
-        // REMOVE ISOLATED VERTICES -------------------------------------------
-
-        size_type const removeIsolatedVertices( void )
-        {
-            // Iterate over vertex list and remove any without edges
+        // RELEASE RETIRED ----------------------------------------------------
 
-            VertexListIterator vertexItEnd = vertices->end();
-            VertexListIterator vertexIt = vertices->begin();
-            size_type removeCount = 0;
+        // Frees the storage that compaction moved elements out of.
 
-            while( vertexIt != vertexItEnd )
+        void releaseRetired( void )
+        {
+            for( size_type e = 0; e < retiredEdges.size(); ++e )
             {
-                if( vertexIt->getEdgeCount() == 0 )
-                {
-                    vertexIt = vertices->erase( vertexIt );
-                    ++removeCount;
-                }
-                else
-                {
-                    ++vertexIt;
-                }
+                destroyEdge( retiredEdges[ e ] );
             }
 
-            return removeCount;
+            retiredEdges.clear();
+            retiredPolygons.clear();
+            retiredVertices.clear();
         }
 
-        // GET VERTEX COUNT ---------------------------------------------------
+        // CREATE POLYGON -----------------------------------------------------
 
-        size_type const getVertexCount( void ) const
+        // Appends a polygon with no edges yet, its payload constructed in
+        // place from args.
+
+        template< class... Args >
+        PolygonIterator createPolygon( Args &&... args )
         {
-            return vertices->size();
+            polygons->emplace_back( detail::EmplaceTag(),
+                                    std::forward< Args >( args )... );
+            PolygonListIterator polyListIt = polygons->end();
+            --polyListIt;
+
+            return PolygonIterator( polyListIt );
         }
 
-        // ADD POLYGON --------------------------------------------------------
+        // CREATE RING EDGE ---------------------------------------------------
 
-        PolygonIterator addPolygon
+        // Creates a polygon's half-edge from source to target and links it
+        // to the source. The caller joins it into the ring.
+
+        EdgeIterator createRingEdge
         (
-            std::list< VertexIterator > const & vertices
+            PolygonIterator polygon,
+            VertexIterator source,
+            VertexIterator target
         )
         {
-            return addPolygon( vertices, BasePolygon() );
+            Edge * edge = createEdge();
+            edge->setPolygon( polygon );
+            edge->setTargetVertex( target );
+
+            return linkEdge( source, edge );
         }
 
-        PolygonIterator addPolygon
+        // JOIN EDGES ---------------------------------------------------------
+
+        static void joinEdges( EdgeIterator previous, EdgeIterator next )
+        {
+            previous->setNextEdge( next );
+            next->setPreviousEdge( previous );
+        }
+
+        // FINISH POLYGON -----------------------------------------------------
+
+        // Sets the start edge of a polygon whose ring is joined, counts
+        // its half-edges and reports it.
+
+        PolygonIterator finishPolygon
         (
-            std::list< VertexIterator > const & vertices,
-            BasePolygon const & basePolygon
+            PolygonIterator polygon,
+            EdgeIterator startEdge,
+            size_type ringEdgeCount
         )
         {
-            typedef typename std::list< VertexIterator >::const_iterator
-                VertIterIt;
-            
-            // Ensure polygon has at least three vertices
+            polygon->setStartEdge( startEdge );
+            edgeCount += ringEdgeCount;
+
+            // Report new polygon, its edges and the vertices they leave
 
-            if( vertices.size() < 3 )
+            if( !trackers.empty() )
             {
-                return endPolygons();
+                notifyPolygonCreated( polygon );
             }
-            
-            // Create new polygon
-
-            Polygon polygon;
-            static_cast< BasePolygon & >( polygon ) = basePolygon;
-            polygons->push_back( polygon );
-            PolygonListIterator polyListIt = polygons->end();
-            --polyListIt;
-            PolygonIterator polygonIt( polyListIt );
-
-            // Create and link edges
 
-            VertIterIt firstVertex = vertices.cbegin();
-            VertIterIt secondVertex = firstVertex; ++secondVertex;
-            VertIterIt endVertex = vertices.cend();
+            return polygon;
+        }
 
-            Edge * edge = new Edge();
-            edge->setPolygon( polygonIt );
-            edge->setTargetVertex( *secondVertex );
+        // LINK EDGE ----------------------------------------------------------
 
-            EdgeIterator startEdge = ( *firstVertex )->addEdge( edge );
-            EdgeIterator previousEdge = startEdge;
-            EdgeIterator currentEdge;
-            
-            ++firstVertex;
-            ++secondVertex;
+        // Adds an outgoing edge to a vertex, which is no longer isolated.
 
-            while( secondVertex != endVertex )
+        EdgeIterator linkEdge( VertexIterator vertex, Edge * edge )
+        {
+            if( vertex->edges.empty() )
             {
-                edge = new Edge( *edge );
-                edge->setTargetVertex( *secondVertex );
-                currentEdge = ( *firstVertex )->addEdge( edge );
-
-                previousEdge->setNextEdge( currentEdge );
-                currentEdge->setPreviousEdge( previousEdge );
-                previousEdge = currentEdge;
+                isolatedVertices.erase( vertex->isolatedPosition );
+            }
 
-                ++firstVertex;
-                ++secondVertex;
+            if( edgeIndex != nullptr )
+            {
+                edgeIndex->insert( &( *vertex ),
+                                   &( *edge->getTargetVertex() ), edge );
             }
 
-            secondVertex = vertices.cbegin();
-            edge = new Edge( *edge );
-            edge->setTargetVertex( *secondVertex );
+            return vertex->addEdge( edge );
+        }
 
-            currentEdge = ( *firstVertex )->addEdge( edge );
+        // UNLINK EDGE --------------------------------------------------------
 
-            previousEdge->setNextEdge( currentEdge );
-            currentEdge->setPreviousEdge( previousEdge );
-            currentEdge->setNextEdge( startEdge );
-            startEdge->setPreviousEdge( currentEdge );
+        // Removes an outgoing edge from a vertex, isolating it if it was
+        // the last.
 
-            // Set start edge of polygon
+        void unlinkEdge( VertexIterator vertex, EdgeIterator position )
+        {
+            if( edgeIndex != nullptr )
+            {
+                edgeIndex->erase( &( *vertex ),
+                                  &( *position->getTargetVertex() ),
+                                  &( *position ) );
+            }
 
-            polygonIt->setStartEdge( startEdge );
+            vertex->removeEdge( position );
 
-            return polygonIt;
+            if( vertex->edges.empty() )
+            {
+                vertex->isolatedPosition =
+                    isolatedVertices.insert( isolatedVertices.end(), vertex );
+            }
         }
 
-        // REMOVE POLYGON -----------------------------------------------------
+        // DESTROY ALL EDGES --------------------------------------------------
 
-        PolygonIterator removePolygon( PolygonIterator polygon )
-        {
-            // Remove all polygon edges from vertices and delete edges
-            
-            Edge * startEdge = polygon->getStartEdge();
-            EdgeIterator currentEdge = startEdge->nextEdge;
-            Edge * edge = &( *currentEdge );
-            EdgeIterator nextEdge;
+        // Frees every polygon's half-edges, leaving vertices' edge sets and
+        // polygons' start edges dangling. Only for use when both are about
+        // to be destroyed.
 
-            VertexIterator currentVertex = startEdge->targetVertex;
-            VertexIterator nextVertex;
+        static void destroyAllEdges( PolygonList & polygonList )
+        {
+            typename PolygonList::iterator polyItEnd = polygonList.end();
+            typename PolygonList::iterator polyIt = polygonList.begin();
 
-            while( edge != startEdge )
+            while( polyIt != polyItEnd )
             {
-                // Get next edge and vertex
+                Edge * startEdge = polyIt->getStartEdge();
+                Edge * edge = startEdge->getNextEdge();
 
-                nextEdge = currentEdge->nextEdge;
-                nextVertex = currentEdge->targetVertex;
+                while( edge != startEdge )
+                {
+                    Edge * nextEdge = edge->getNextEdge();
+                    destroyEdge( edge );
+                    edge = nextEdge;
+                }
 
-                // Remove current edge from vertex and deallocate
+                destroyEdge( startEdge );
+                ++polyIt;
+            }
+        }
 
-                currentVertex->removeEdge( currentEdge );
-                delete edge;
+        // NOTIFY ALL DESTROYED -----------------------------------------------
 
-                // Advance to next edge
+        // Reports every polygon, with its edges, and every vertex destroyed.
 
-                currentEdge = nextEdge;
-                currentVertex = nextVertex;
-                edge = &( *currentEdge );
+        void notifyAllDestroyed( void )
+        {
+            if( trackers.empty() )
+            {
+                return;
             }
 
-            // Remove final edge from vertex and deallocate
-
-            currentVertex->removeEdge( currentEdge );
-            delete edge;
-
-            // Remove polygon from list and return iterator to next
+            PolygonIterator polyItEnd = endPolygons();
+            PolygonIterator polyIt = beginPolygons();
 
-            return PolygonIterator( polygons->erase( polygon.iter ) );
-        }
+            while( polyIt != polyItEnd )
+            {
+                notifyPolygonDestroyed( polyIt );
+                ++polyIt;
+            }
 
-        // GET POLYGON COUNT --------------------------------------------------
+            VertexIterator vertexItEnd = endVertices();
+            VertexIterator vertexIt = beginVertices();
 
-        size_type const getPolygonCount( void ) const
-        {
-            return polygons->size();
+            while( vertexIt != vertexItEnd )
+            {
+                notifyVertexDestroyed( vertexIt );
+                ++vertexIt;
+            }
         }
 
-        // BEGIN VERTICES -----------------------------------------------------
+        // MEMORY ESTIMATES ---------------------------------------------------
 
-        VertexIterator beginVertices( void )
-        {
-            return VertexIterator( vertices->begin() );
-        }
+        // Empty payload classes take no space as base classes.
 
-        ConstVertexIterator cbeginVertices( void ) const
+        template< class Payload >
+        static size_type const getPayloadSize( void )
         {
-            return ConstVertexIterator
-            (
-                const_cast< VertexList * >( vertices )->begin()
-            );
+            return std::is_empty< Payload >::value ? 0 : sizeof( Payload );
         }
 
-        // END VERTICES -------------------------------------------------------
-
-        VertexIterator endVertices( void )
+        static size_type const getAllocationSlack( size_type request )
         {
-            return VertexIterator( vertices->end() );
-        }
+            size_type block = ( request + 8 + 15 ) & ~size_type( 15 );
 
-        ConstVertexIterator cendVertices( void ) const
-        {
-            return ConstVertexIterator
-            (
-                const_cast< VertexList * >( vertices )->end()
-            );
+            return ( block < 32 ? 32 : block ) - request;
         }
 
-        // BEGIN POLYGONS -----------------------------------------------------
+        // SET TRACKER GRAPH --------------------------------------------------
 
-        PolygonIterator beginPolygons( void )
+        void setTrackerGraph( PolygonGraph< Traits > * graph )
         {
-            return PolygonIterator( polygons->begin() );
-        }
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
 
-        ConstPolygonIterator cbeginPolygons( void ) const
-        {
-            return ConstPolygonIterator
-            (
-                const_cast< PolygonList * >( polygons )->begin()
-            );
+            while( trackerIt != trackerItEnd )
+            {
+                ( *trackerIt )->graph = graph;
+                ++trackerIt;
+            }
         }
 
-        // END POLYGONS -------------------------------------------------------
+        // NOTIFY VERTEX CHANGES ----------------------------------------------
 
-        PolygonIterator endPolygons( void )
+        void notifyVertexCreated( VertexIterator vertex )
         {
-            return PolygonIterator( polygons->end() );
-        }
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
 
-        ConstPolygonIterator cendPolygons( void ) const
-        {
-            return ConstPolygonIterator
-            (
-                const_cast< PolygonList * >( polygons )->end()
-            );
+            while( trackerIt != trackerItEnd )
+            {
+                ( *trackerIt )->vertexCreated( vertex );
+                ++trackerIt;
+            }
         }
 
-        // CLEAR --------------------------------------------------------------
-
-        void clear( void )
+        void notifyVertexDestroyed( VertexIterator vertex )
         {
-            // Remove all polygons
-
-            PolygonIterator polyItEnd = endPolygons();
-            PolygonIterator polyIt = beginPolygons();
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
 
-            while( polyIt != polyItEnd )
+            while( trackerIt != trackerItEnd )
             {
-                polyIt = removePolygon( polyIt );
+                ( *trackerIt )->vertexDestroyed( vertex );
+                ++trackerIt;
             }
-
-            // Clear vertices
-
-            vertices->clear();
         }
 
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++++++
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
-        // COPY ASSIGNMENT ----------------------------------------------------
+        // NOTIFY POLYGON CHANGES ---------------------------------------------
 
-        PolygonGraph< Traits > const & operator =
-            ( PolygonGraph< Traits > const & other )
+        void notifyPolygonCreated( PolygonIterator polygon )
         {
-            PolygonGraph< Traits > copy( *other );
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
+            Edge * startEdge = polygon->getStartEdge();
+            Edge * edge = nullptr;
 
-            clear();
+            while( trackerIt != trackerItEnd )
+            {
+                ( *trackerIt )->polygonCreated( polygon );
 
-            delete this->vertices;
-            delete this->polygons;
+                // Record edges and the source vertices that gained them
 
-            this->vertices = copy.vertices;
-            this->polygons = copy.polygons;
+                edge = startEdge;
 
-            copy.vertices = nullptr;
-            copy.polygons = nullptr;
+                do
+                {
+                    ( *trackerIt )->edgeCreated( edge );
+                    ( *trackerIt )->vertexModified
+                    (
+                        edge->getPreviousEdge()->targetVertex
+                    );
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
 
-            return *this;
+                ++trackerIt;
+            }
         }
 
-        // MOVE ASSIGNMENT ----------------------------------------------------
-
-        PolygonGraph< Traits > const & operator =
-            ( PolygonGraph< Traits > && other )
+        void notifyPolygonDestroyed( PolygonIterator polygon )
         {
-            clear();
-            
-            delete this->vertices;
-            delete this->polygons;
+            TrackerListIterator trackerItEnd = trackers.end();
+            TrackerListIterator trackerIt = trackers.begin();
+            Edge * startEdge = polygon->getStartEdge();
+            Edge * edge = nullptr;
 
-            this->vertices = other.vertices;
-            this->polygons = other.polygons;
+            while( trackerIt != trackerItEnd )
+            {
+                // Record edges and the source vertices that lose them
 
-            other.vertices = nullptr;
-            other.polygons = nullptr;
+                edge = startEdge;
 
-            return *this;
-        }
+                do
+                {
+                    ( *trackerIt )->edgeDestroyed( edge );
+                    ( *trackerIt )->vertexModified
+                    (
+                        edge->getPreviousEdge()->targetVertex
+                    );
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
 
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+                ( *trackerIt )->polygonDestroyed( polygon );
 
-        private:
+                ++trackerIt;
+            }
+        }
 
         // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -2164,6 +4676,21 @@ namespace graph
 
         VertexList * vertices;
         PolygonList * polygons;
+        IsolatedList isolatedVertices;
+        EdgeIndex * edgeIndex;
+        size_type edgeCount;
+
+        CompactPhase compactPhase;
+        VertexListIterator compactVertex;
+        PolygonListIterator compactPolygon;
+
+        // Storage moved out of by the compaction pass in progress
+
+        VertexList retiredVertices;
+        PolygonList retiredPolygons;
+        std::vector< Edge * > retiredEdges;
+
+        TrackerList trackers;
 
         // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     };
@@ -0,0 +1,299 @@
+#ifndef POLYGON_GRAPH_ADJACENCY_H
+#define POLYGON_GRAPH_ADJACENCY_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // VERTEX ADJACENCY CLASS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Vertex adjacency in compressed sparse row form, treating half-edges
+    // as undirected. Vertex i's neighbours are neighbours[ offsets[ i ] ] up
+    // to offsets[ i + 1 ], sorted and listed once each, whether they are
+    // reached by an outgoing or an incoming half-edge. edges holds the
+    // half-edge joining each pair, preferring the one leaving vertex i.
+    // vertices maps indices back to graph handles.
+
+    template< class Traits = DefaultPGTraits >
+    class VertexAdjacency
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::VertexIterator VertexIterator;
+
+        static std::uint32_t const noVertex = 0xffffffffu;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // GET VERTEX COUNT ---------------------------------------------------
+
+        size_type const getVertexCount( void ) const
+        {
+            return vertices.size();
+        }
+
+        // GET INDEX ----------------------------------------------------------
+
+        // Returns noVertex for vertices not in the adjacency.
+
+        std::uint32_t const getIndex( VertexIterator vertex ) const
+        {
+            typename std::unordered_map< Vertex const *, std::uint32_t >::
+                const_iterator it = indices.find( &( *vertex ) );
+
+            return it == indices.end() ? noVertex : it->second;
+        }
+
+        // GET DEGREE ---------------------------------------------------------
+
+        std::uint32_t const getDegree( std::uint32_t vertex ) const
+        {
+            return offsets[ vertex + 1 ] - offsets[ vertex ];
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC DATA ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        std::vector< std::uint32_t > offsets;
+        std::vector< std::uint32_t > neighbours;
+        std::vector< Edge * > edges;
+        std::vector< VertexIterator > vertices;
+        std::unordered_map< Vertex const *, std::uint32_t > indices;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    template< class Traits >
+    std::uint32_t const VertexAdjacency< Traits >::noVertex;
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ADJACENCY CONSTRUCTION FUNCTIONS +++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // BUILD VERTEX ADJACENCY -------------------------------------------------
+
+    // Builds the vertex adjacency of a graph. Vertices are indexed in graph
+    // order and each half-edge is entered in the rows of both its ends,
+    // then the rows are sorted and duplicates dropped in parallel. Runs in
+    // O(E log d) for half-edge count E and largest degree d.
+
+    template< class Traits >
+    void buildVertexAdjacency
+    (
+        PolygonGraph< Traits > & graph,
+        VertexAdjacency< Traits > & adjacency,
+        std::size_t threadCount = 0
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::EdgeIterator EdgeIterator;
+        typedef typename Graph::VertexIterator VertexIterator;
+
+        PG_TRACE_SCOPE( "buildVertexAdjacency" );
+
+        // Index vertices
+
+        adjacency.vertices.clear();
+        adjacency.indices.clear();
+        adjacency.vertices.reserve( graph.getVertexCount() );
+        adjacency.indices.reserve( graph.getVertexCount() );
+
+        VertexIterator vertexItEnd = graph.endVertices();
+        VertexIterator vertexIt = graph.beginVertices();
+
+        while( vertexIt != vertexItEnd )
+        {
+            adjacency.indices[ &( *vertexIt ) ] =
+                static_cast< std::uint32_t >( adjacency.vertices.size() );
+            adjacency.vertices.push_back( vertexIt );
+            ++vertexIt;
+        }
+
+        std::size_t vertexCount = adjacency.vertices.size();
+
+        // Count each half-edge at both ends
+
+        std::vector< std::uint32_t > targets;
+        std::vector< std::uint32_t > rowEnds( vertexCount + 1, 0 );
+
+        for( std::size_t v = 0; v < vertexCount; ++v )
+        {
+            VertexIterator vertex = adjacency.vertices[ v ];
+            EdgeIterator edgeItEnd = vertex->endEdges();
+            EdgeIterator edgeIt = vertex->beginEdges();
+
+            while( edgeIt != edgeItEnd )
+            {
+                std::uint32_t target = adjacency.indices.find
+                (
+                    &( *( *edgeIt ).getTargetVertex() )
+                )->second;
+
+                targets.push_back( target );
+                ++rowEnds[ v + 1 ];
+                ++rowEnds[ target + 1 ];
+                ++edgeIt;
+            }
+        }
+
+        for( std::size_t v = 0; v < vertexCount; ++v )
+        {
+            rowEnds[ v + 1 ] += rowEnds[ v ];
+        }
+
+        std::vector< std::uint64_t > entries( rowEnds.back() );
+        std::vector< Edge * > entryEdges( rowEnds.back() );
+        std::vector< std::uint32_t > cursors( rowEnds.begin(),
+                                              rowEnds.end() - 1 );
+        std::size_t t = 0;
+
+        // Fill rows. Incoming entries are tagged in the low bit so they sort
+        // after an outgoing edge to the same neighbour.
+
+        for( std::size_t v = 0; v < vertexCount; ++v )
+        {
+            VertexIterator vertex = adjacency.vertices[ v ];
+            EdgeIterator edgeItEnd = vertex->endEdges();
+            EdgeIterator edgeIt = vertex->beginEdges();
+
+            while( edgeIt != edgeItEnd )
+            {
+                std::uint32_t target = targets[ t++ ];
+                std::uint32_t out = cursors[ v ]++;
+                std::uint32_t in = cursors[ target ]++;
+
+                entries[ out ] = std::uint64_t( target ) << 1;
+                entries[ in ] = ( std::uint64_t( v ) << 1 ) | 1;
+                entryEdges[ out ] = &( *edgeIt );
+                entryEdges[ in ] = &( *edgeIt );
+                ++edgeIt;
+            }
+        }
+
+        // Sort rows, keeping one entry per neighbour and its edge
+
+        std::vector< std::uint32_t > & offsets = adjacency.offsets;
+        offsets.assign( vertexCount + 1, 0 );
+
+        parallelFor
+        (
+            vertexCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                std::vector< std::pair< std::uint64_t, std::uint32_t > > keys;
+                std::vector< Edge * > rowEdges;
+
+                for( std::size_t v = begin; v < end; ++v )
+                {
+                    std::uint32_t first = rowEnds[ v ];
+                    std::uint32_t last = rowEnds[ v + 1 ];
+
+                    // Pair each key with its place in the row so edges can
+                    // follow
+
+                    keys.clear();
+                    rowEdges.assign( entryEdges.begin() + first,
+                                     entryEdges.begin() + last );
+
+                    for( std::uint32_t e = first; e < last; ++e )
+                    {
+                        keys.push_back( std::make_pair( entries[ e ],
+                                                        e - first ) );
+                    }
+
+                    std::sort( keys.begin(), keys.end() );
+
+                    std::uint32_t count = 0;
+                    std::uint64_t previous = ~std::uint64_t( 0 );
+
+                    for( std::size_t k = 0; k < keys.size(); ++k )
+                    {
+                        std::uint64_t neighbour = keys[ k ].first >> 1;
+
+                        if( neighbour == previous )
+                        {
+                            continue;
+                        }
+
+                        std::uint32_t slot = keys[ k ].second;
+                        entries[ first + count ] = neighbour;
+                        entryEdges[ first + count ] = rowEdges[ slot ];
+                        previous = neighbour;
+                        ++count;
+                    }
+
+                    offsets[ v + 1 ] = count;
+                }
+            }
+        );
+
+        for( std::size_t v = 0; v < vertexCount; ++v )
+        {
+            offsets[ v + 1 ] += offsets[ v ];
+        }
+
+        // Pack the rows
+
+        adjacency.neighbours.resize( offsets.back() );
+        adjacency.edges.resize( offsets.back() );
+
+        parallelFor
+        (
+            vertexCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                for( std::size_t v = begin; v < end; ++v )
+                {
+                    std::uint32_t first = rowEnds[ v ];
+                    std::uint32_t count = offsets[ v + 1 ] - offsets[ v ];
+
+                    for( std::uint32_t n = 0; n < count; ++n )
+                    {
+                        adjacency.neighbours[ offsets[ v ] + n ] =
+                            static_cast< std::uint32_t >
+                            (
+                                entries[ first + n ]
+                            );
+                        adjacency.edges[ offsets[ v ] + n ] =
+                            entryEdges[ first + n ];
+                    }
+                }
+            }
+        );
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_ADJACENCY_H
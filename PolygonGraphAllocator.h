@@ -0,0 +1,703 @@
+#ifndef POLYGON_GRAPH_ALLOCATOR_H
+#define POLYGON_GRAPH_ALLOCATOR_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined( __linux__ )
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    // libnuma's <numaif.h> defines the policies as macros, which the
+    // kernel header's enum would clash with
+
+    #if !defined( MPOL_INTERLEAVE )
+        #include <linux/mempolicy.h>
+    #endif
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // MALLOC CHUNK SOURCE CLASS ++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Supplies the large chunks that pools carve into blocks. A chunk
+    // source provides static getChunkBytes, allocateChunk and
+    // deallocateChunk functions. getChunkBytes rounds a wanted size up to
+    // the size the source will hand out; allocateChunk returns nullptr on
+    // failure. Block pools keep their chunks for the life of the process,
+    // so only other users call deallocateChunk.
+
+    class MallocChunkSource
+    {
+        public:
+
+        static std::size_t const getChunkBytes( std::size_t bytes )
+        {
+            return bytes;
+        }
+
+        static void * allocateChunk( std::size_t bytes )
+        {
+            return std::malloc( bytes );
+        }
+
+        static void deallocateChunk( void * chunk, std::size_t )
+        {
+            std::free( chunk );
+        }
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // NUMA PLACEMENT POLICIES ++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Decide which NUMA nodes back a chunk's pages. Pools hand out blocks
+    // without writing to them, so a page is first touched by the thread
+    // that constructs an element in it.
+    //
+    // NumaFirstTouch leaves placement to the kernel, which puts each page
+    // on the node of the thread that first touches it. Build each
+    // partition from a thread on the node that will traverse it.
+    //
+    // NumaInterleave spreads pages round-robin over all online nodes, so
+    // threads on every socket see the same average latency.
+    //
+    // apply returns whether the policy is in effect for the chunk.
+    // Placement is only a hint: a chunk it fails for keeps the default
+    // policy and is still usable.
+
+    class NumaFirstTouch
+    {
+        public:
+
+        static bool const apply( void *, std::size_t )
+        {
+            return true;
+        }
+    };
+
+    class NumaInterleave
+    {
+        public:
+
+        // Does nothing on a single node. Once mbind fails, as it does
+        // without kernel NUMA support or when seccomp forbids it, later
+        // chunks are not tried again.
+
+        static bool const apply( void * chunk, std::size_t bytes )
+        {
+            #if defined( __linux__ ) && defined( SYS_mbind )
+
+            unsigned long mask = getOnlineNodes();
+
+            if( ( mask & ( mask - 1 ) ) == 0 ||
+                getFailed().load( std::memory_order_relaxed ) )
+            {
+                return false;
+            }
+
+            if( syscall( SYS_mbind, chunk, bytes, MPOL_INTERLEAVE, &mask,
+                         sizeof( mask ) * 8, 0 ) != 0 )
+            {
+                getFailed().store( true, std::memory_order_relaxed );
+                return false;
+            }
+
+            return true;
+
+            #else
+
+            ( void ) chunk;
+            ( void ) bytes;
+
+            return false;
+
+            #endif
+        }
+
+        private:
+
+        static std::atomic< bool > & getFailed( void )
+        {
+            static std::atomic< bool > failed( false );
+            return failed;
+        }
+
+        // Reads the online node list, such as "0-1", into a bit mask
+
+        static unsigned long const getOnlineNodes( void )
+        {
+            static unsigned long const nodes = readOnlineNodes();
+            return nodes;
+        }
+
+        static unsigned long const readOnlineNodes( void )
+        {
+            unsigned long mask = 0;
+            std::FILE * file =
+                std::fopen( "/sys/devices/system/node/online", "r" );
+
+            if( file == nullptr )
+            {
+                return 1;
+            }
+
+            unsigned first = 0;
+            unsigned last = 0;
+            int matched = 0;
+
+            while( ( matched = std::fscanf( file, "%u-%u", &first,
+                                            &last ) ) >= 1 )
+            {
+                if( matched == 1 )
+                {
+                    last = first;
+                }
+
+                for( unsigned n = first; n <= last && n < 64; ++n )
+                {
+                    mask |= 1ul << n;
+                }
+
+                if( std::fgetc( file ) != ',' )
+                {
+                    break;
+                }
+            }
+
+            std::fclose( file );
+
+            return mask != 0 ? mask : 1;
+        }
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // HUGE PAGE CHUNK SOURCE CLASS +++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Maps chunks in whole, aligned 2 MB units and asks for transparent
+    // huge pages, so a pool of graph elements needs few TLB entries. The
+    // NUMA policy is applied before any page is touched. Elsewhere than
+    // Linux it falls back to malloc.
+
+    template< class NumaPolicy = NumaFirstTouch >
+    class HugePageChunkSource
+    {
+        public:
+
+        static const std::size_t hugePageBytes = std::size_t( 1 ) << 21;
+
+        static std::size_t const getChunkBytes( std::size_t bytes )
+        {
+            return ( bytes + hugePageBytes - 1 ) & ~( hugePageBytes - 1 );
+        }
+
+        static void * allocateChunk( std::size_t bytes )
+        {
+            #if defined( __linux__ )
+
+            // Over-map by a huge page and trim to an aligned range
+
+            std::size_t mappedBytes = bytes + hugePageBytes;
+            void * mapped = mmap( nullptr, mappedBytes,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+            if( mapped == MAP_FAILED )
+            {
+                return nullptr;
+            }
+
+            char * start = static_cast< char * >( mapped );
+            char * aligned = reinterpret_cast< char * >
+            (
+                ( reinterpret_cast< std::size_t >( start ) +
+                  hugePageBytes - 1 ) & ~( hugePageBytes - 1 )
+            );
+
+            if( aligned != start )
+            {
+                munmap( start, aligned - start );
+            }
+
+            munmap( aligned + bytes, start + mappedBytes - aligned - bytes );
+
+            #if defined( MADV_HUGEPAGE )
+            madvise( aligned, bytes, MADV_HUGEPAGE );
+            #endif
+
+            // A chunk the policy fails for keeps the default placement
+
+            NumaPolicy::apply( aligned, bytes );
+
+            return aligned;
+
+            #else
+
+            return std::malloc( bytes );
+
+            #endif
+        }
+
+        static void deallocateChunk( void * chunk, std::size_t bytes )
+        {
+            #if defined( __linux__ )
+            munmap( chunk, bytes );
+            #else
+            ( void ) bytes;
+            std::free( chunk );
+            #endif
+        }
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // BLOCK POOL ---------------------------------------------------------
+
+        // Process-wide free list of fixed-size blocks, one instance per
+        // block size and chunk source. Each thread keeps a cache of up to
+        // twice cacheBlocks free blocks in front of the mutex-guarded
+        // shared list, refilling and spilling cacheBlocks at a time, and
+        // hands its cache back when it exits. Blocks may be freed by any
+        // thread. New chunks are carved on demand, a batch at a time, into
+        // the cache of the thread that asked, so their pages are first
+        // touched by the thread using them. Chunks grow geometrically.
+        //
+        // The pool is never destroyed: static and thread-local objects
+        // destroyed at exit may still free blocks into it, whatever order
+        // they were created in. Its chunks are reclaimed with the process.
+
+        template< std::size_t BlockSize, class ChunkSource >
+        class BlockPool
+        {
+            public:
+
+            static BlockPool & getInstance( void )
+            {
+                static BlockPool & pool = *new BlockPool;
+                return pool;
+            }
+
+            void * allocate( void )
+            {
+                ThreadCache * cache = openCache();
+
+                if( cache == nullptr )
+                {
+                    std::lock_guard< std::mutex > lock( mutex );
+                    return takeBlock();
+                }
+
+                if( cache->blocks == nullptr && !refill( *cache ) )
+                {
+                    return nullptr;
+                }
+
+                FreeBlock * block = cache->blocks;
+                cache->blocks = block->next;
+                --cache->count;
+
+                return block;
+            }
+
+            void deallocate( void * pointer )
+            {
+                FreeBlock * block = static_cast< FreeBlock * >( pointer );
+                ThreadCache * cache = openCache();
+
+                if( cache == nullptr )
+                {
+                    release( block, block );
+                    return;
+                }
+
+                block->next = cache->blocks;
+                cache->blocks = block;
+
+                if( ++cache->count < 2 * cacheBlocks )
+                {
+                    return;
+                }
+
+                // Spill the most recently freed cacheBlocks blocks
+
+                FreeBlock * last = cache->blocks;
+
+                for( std::size_t b = 1; b < cacheBlocks; ++b )
+                {
+                    last = last->next;
+                }
+
+                FreeBlock * first = cache->blocks;
+                cache->blocks = last->next;
+                cache->count -= cacheBlocks;
+                release( first, last );
+            }
+
+            private:
+
+            class FreeBlock
+            {
+                public:
+
+                FreeBlock * next;
+            };
+
+            // Trivially destructible, so it stays usable while the thread
+            // exits; closed once the flusher has handed its blocks back
+
+            class ThreadCache
+            {
+                public:
+
+                FreeBlock * blocks;
+                std::size_t count;
+                bool closed;
+            };
+
+            class CacheFlusher
+            {
+                public:
+
+                ~CacheFlusher( void )
+                {
+                    ThreadCache & cache = getCache();
+                    cache.closed = true;
+
+                    if( cache.blocks != nullptr )
+                    {
+                        FreeBlock * last = cache.blocks;
+
+                        while( last->next != nullptr )
+                        {
+                            last = last->next;
+                        }
+
+                        getInstance().release( cache.blocks, last );
+                        cache.blocks = nullptr;
+                        cache.count = 0;
+                    }
+                }
+            };
+
+            static const std::size_t cacheBlocks = 64;
+            static const std::size_t firstChunkBlocks = 256;
+            static const std::size_t maxChunkBlocks = 65536;
+
+            BlockPool( void )
+            {
+                freeList = nullptr;
+                chunkCursor = nullptr;
+                chunkEnd = nullptr;
+                chunkBlocks = firstChunkBlocks;
+            }
+
+            BlockPool( BlockPool const & ) = delete;
+            BlockPool & operator = ( BlockPool const & ) = delete;
+
+            // GET CACHE ------------------------------------------------------
+
+            static ThreadCache & getCache( void )
+            {
+                thread_local ThreadCache cache = { nullptr, 0, false };
+                return cache;
+            }
+
+            // Returns the calling thread's cache, or nullptr once the
+            // thread is exiting and has flushed it
+
+            static ThreadCache * openCache( void )
+            {
+                ThreadCache & cache = getCache();
+
+                if( cache.closed )
+                {
+                    return nullptr;
+                }
+
+                thread_local CacheFlusher flusher;
+                ( void ) flusher;
+
+                return &cache;
+            }
+
+            // REFILL ---------------------------------------------------------
+
+            bool const refill( ThreadCache & cache )
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+
+                while( cache.count < cacheBlocks )
+                {
+                    FreeBlock * block = takeBlock();
+
+                    if( block == nullptr )
+                    {
+                        break;
+                    }
+
+                    block->next = cache.blocks;
+                    cache.blocks = block;
+                    ++cache.count;
+                }
+
+                return cache.blocks != nullptr;
+            }
+
+            // RELEASE --------------------------------------------------------
+
+            // Returns the linked blocks first to last to the shared list
+
+            void release( FreeBlock * first, FreeBlock * last )
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+
+                last->next = freeList;
+                freeList = first;
+            }
+
+            // TAKE BLOCK -----------------------------------------------------
+
+            // Pops the shared list or carves a new block; the caller holds
+            // the mutex
+
+            FreeBlock * takeBlock( void )
+            {
+                if( freeList != nullptr )
+                {
+                    FreeBlock * block = freeList;
+                    freeList = block->next;
+
+                    return block;
+                }
+
+                if( chunkCursor == chunkEnd && !grow() )
+                {
+                    return nullptr;
+                }
+
+                FreeBlock * block =
+                    reinterpret_cast< FreeBlock * >( chunkCursor );
+                chunkCursor += BlockSize;
+
+                return block;
+            }
+
+            // GROW -----------------------------------------------------------
+
+            bool const grow( void )
+            {
+                std::size_t bytes =
+                    ChunkSource::getChunkBytes( chunkBlocks * BlockSize );
+                char * chunk = static_cast< char * >
+                (
+                    ChunkSource::allocateChunk( bytes )
+                );
+
+                if( chunk == nullptr )
+                {
+                    return false;
+                }
+
+                chunkCursor = chunk;
+                chunkEnd = chunk + bytes / BlockSize * BlockSize;
+
+                if( chunkBlocks < maxChunkBlocks )
+                {
+                    chunkBlocks *= 2;
+                }
+
+                return true;
+            }
+
+            std::mutex mutex;
+            FreeBlock * freeList;
+            char * chunkCursor;
+            char * chunkEnd;
+            std::size_t chunkBlocks;
+        };
+
+        // GET BLOCK SIZE -----------------------------------------------------
+
+        // Rounds an object up to a multiple of its alignment, and to at
+        // least a free-list link.
+
+        constexpr std::size_t getBlockSize
+        (
+            std::size_t size,
+            std::size_t alignment
+        )
+        {
+            return ( ( size < sizeof( void * ) ? sizeof( void * ) : size ) +
+                     alignment - 1 ) / alignment * alignment;
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // POOL ALLOCATOR CLASS +++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Standard allocator handing out single objects from a shared pool of
+    // same-sized blocks, which removes per-node malloc headers and keeps
+    // nodes of one kind together. Array requests go to operator new.
+    // Select it for a graph with
+    //
+    //   template< class T > using Allocator = graph::PoolAllocator< T >;
+    //
+    // in the Traits class. Objects must not need more than the chunk
+    // source's alignment (malloc's by default). For large graphs on
+    // multi-socket hosts, back the pool with huge pages and a NUMA policy:
+    //
+    //   template< class T > using Allocator = graph::PoolAllocator
+    //       < T, graph::HugePageChunkSource< graph::NumaInterleave > >;
+
+    template< class T, class ChunkSource = MallocChunkSource >
+    class PoolAllocator
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef T value_type;
+
+        template< class U >
+        class rebind
+        {
+            public:
+
+            typedef PoolAllocator< U, ChunkSource > other;
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PoolAllocator( void )
+        {
+            // empty
+        }
+
+        template< class U >
+        PoolAllocator( PoolAllocator< U, ChunkSource > const & )
+        {
+            // empty
+        }
+
+        // ALLOCATE -----------------------------------------------------------
+
+        T * allocate( std::size_t count )
+        {
+            void * pointer = count == 1
+                ? allocateBlock()
+                : ::operator new( count * sizeof( T ), std::nothrow );
+
+            if( pointer == nullptr )
+            {
+                throw std::bad_alloc();
+            }
+
+            return static_cast< T * >( pointer );
+        }
+
+        // DEALLOCATE ---------------------------------------------------------
+
+        void deallocate( T * pointer, std::size_t count )
+        {
+            if( count == 1 )
+            {
+                deallocateBlock( pointer );
+            }
+            else
+            {
+                ::operator delete( pointer );
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // All instances share the pool, so any can free another's blocks
+
+        template< class U >
+        bool const operator ==
+            ( PoolAllocator< U, ChunkSource > const & ) const
+        {
+            return true;
+        }
+
+        template< class U >
+        bool const operator !=
+            ( PoolAllocator< U, ChunkSource > const & ) const
+        {
+            return false;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // The pool is named only inside these bodies so that the allocator
+        // can be instantiated while T is still incomplete, as containers
+        // of graph elements require.
+
+        static void * allocateBlock( void )
+        {
+            typedef detail::BlockPool
+            <
+                detail::getBlockSize( sizeof( T ), alignof( T ) ),
+                ChunkSource
+            >
+            Pool;
+
+            return Pool::getInstance().allocate();
+        }
+
+        static void deallocateBlock( void * pointer )
+        {
+            typedef detail::BlockPool
+            <
+                detail::getBlockSize( sizeof( T ), alignof( T ) ),
+                ChunkSource
+            >
+            Pool;
+
+            Pool::getInstance().deallocate( pointer );
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_ALLOCATOR_H
@@ -0,0 +1,1571 @@
+#ifndef POLYGON_GRAPH_BVH_H
+#define POLYGON_GRAPH_BVH_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+#if defined( POLYGON_GRAPH_X86_SIMD )
+#include <immintrin.h>
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // POLYGON BVH CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Bounding volume hierarchy over the polygons of a graph. Built in
+    // parallel with binned SAH splits; leaves reference PolygonIterators.
+    // Each leaf's polygons are fanned into triangles stored in batches of
+    // four, structure-of-arrays, which SSE kernels test a whole batch at a
+    // time; setSimdLevel( simdScalar ) selects the scalar ones instead.
+    // refit() re-reads vertex positions and tightens the boxes without
+    // changing the tree; update() rebuilds or refits as a change tracker
+    // requires.
+
+    template< class Traits = DefaultPGTraits,
+              class PositionAccessor = MemberPosition >
+    class PolygonBVH
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+        typedef typename Graph::ChangeTracker ChangeTracker;
+
+        static const size_type batchWidth = 4;
+
+        // RAY HIT ------------------------------------------------------------
+
+        class RayHit
+        {
+            public:
+
+            PolygonIterator polygon;
+            double distance;
+        };
+
+        // CLOSEST HIT --------------------------------------------------------
+
+        class ClosestHit
+        {
+            public:
+
+            PolygonIterator polygon;
+            double distance;
+            double point[ 3 ];
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PolygonBVH( PositionAccessor accessor = PositionAccessor() )
+        {
+            this->accessor = accessor;
+            this->graph = nullptr;
+            this->maxLeafSize = 4;
+            this->simdLevel = getSupportedSimdLevel();
+        }
+
+        // BUILD --------------------------------------------------------------
+
+        // Rebuilds the hierarchy over every polygon of the graph.
+
+        void build( Graph & graph, size_type threadCount = 0 )
+        {
+            PG_TRACE_SCOPE( "PolygonBVH::build" );
+
+            this->graph = &graph;
+            threadCount = getThreadCount( threadCount );
+
+            nodes.clear();
+            batches.clear();
+            batchCorners.clear();
+            polygons.clear();
+            polygons.reserve( graph.getPolygonCount() );
+
+            PolygonIterator polyItEnd = graph.endPolygons();
+            PolygonIterator polyIt = graph.beginPolygons();
+
+            while( polyIt != polyItEnd )
+            {
+                polygons.push_back( polyIt );
+                ++polyIt;
+            }
+
+            if( polygons.empty() )
+            {
+                return;
+            }
+
+            // Polygon bounds and centroids
+
+            std::vector< Bounds > bounds( polygons.size() );
+            std::vector< float > centroids( polygons.size() * 3 );
+
+            parallelFor
+            (
+                polygons.size(), threadCount,
+                [ & ]( size_type begin, size_type end, size_type )
+                {
+                    for( size_type p = begin; p < end; ++p )
+                    {
+                        bounds[ p ] = getPolygonBounds( polygons[ p ] );
+
+                        for( int axis = 0; axis < 3; ++axis )
+                        {
+                            centroids[ p * 3 + axis ] = 0.5f *
+                            (
+                                bounds[ p ].minimum[ axis ] +
+                                bounds[ p ].maximum[ axis ]
+                            );
+                        }
+                    }
+                }
+            );
+
+            // Build the tree, splitting large subtrees across threads
+
+            std::vector< std::uint32_t > order( polygons.size() );
+
+            for( size_type p = 0; p < order.size(); ++p )
+            {
+                order[ p ] = static_cast< std::uint32_t >( p );
+            }
+
+            nodes.resize( polygons.size() * 2 );
+            nodeCount.store( 1 );
+
+            BuildContext context;
+            context.bounds = &bounds;
+            context.centroids = &centroids;
+            context.order = &order;
+
+            size_type depth = 0;
+
+            while( ( size_type( 1 ) << depth ) < threadCount )
+            {
+                ++depth;
+            }
+
+            buildNode( context, 0, 0,
+                       static_cast< std::uint32_t >( order.size() ), 0,
+                       depth );
+
+            nodes.resize( nodeCount.load() );
+
+            // Pack leaf polygons into triangle batches
+
+            for( size_type n = 0; n < nodes.size(); ++n )
+            {
+                Node & node = nodes[ n ];
+
+                if( node.count == 0 )
+                {
+                    continue;
+                }
+
+                std::uint32_t first = node.first;
+                std::uint32_t last = node.first + node.count;
+                node.first = static_cast< std::uint32_t >( batches.size() );
+                size_type lane = batchWidth;
+
+                for( std::uint32_t o = first; o < last; ++o )
+                {
+                    Edge * startEdge = polygons[ order[ o ] ]->getStartEdge();
+                    Edge * edge = startEdge->getNextEdge();
+
+                    while( edge->getNextEdge() != startEdge )
+                    {
+                        if( lane == batchWidth )
+                        {
+                            batches.push_back( Batch() );
+                            batchCorners.push_back( BatchCorners() );
+                            std::fill( batchCorners.back().corners[ 0 ],
+                                       batchCorners.back().corners[ 0 ] +
+                                       3 * batchWidth, nullptr );
+                            std::fill( batches.back().polygons,
+                                       batches.back().polygons + batchWidth,
+                                       noPolygon );
+                            lane = 0;
+                        }
+
+                        BatchCorners & corners = batchCorners.back();
+                        corners.corners[ 0 ][ lane ] =
+                            &( *startEdge->getTargetVertex() );
+                        corners.corners[ 1 ][ lane ] =
+                            &( *edge->getTargetVertex() );
+                        corners.corners[ 2 ][ lane ] =
+                            &( *edge->getNextEdge()->getTargetVertex() );
+                        batches.back().polygons[ lane ] = order[ o ];
+
+                        edge = edge->getNextEdge();
+                        ++lane;
+                    }
+                }
+
+                node.count = static_cast< std::uint32_t >
+                (
+                    batches.size() - node.first
+                );
+            }
+
+            refit( threadCount );
+        }
+
+        // REFIT --------------------------------------------------------------
+
+        // Re-reads vertex positions into the triangle batches and recomputes
+        // every box bottom-up. Use after moving vertices; the tree shape is
+        // kept, so queries degrade gracefully under large deformations.
+
+        void refit( size_type threadCount = 0 )
+        {
+            parallelFor
+            (
+                batches.size(), threadCount,
+                [ & ]( size_type begin, size_type end, size_type )
+                {
+                    for( size_type b = begin; b < end; ++b )
+                    {
+                        loadBatch( b );
+                    }
+                }
+            );
+
+            parallelFor
+            (
+                nodes.size(), threadCount,
+                [ & ]( size_type begin, size_type end, size_type )
+                {
+                    for( size_type n = begin; n < end; ++n )
+                    {
+                        if( nodes[ n ].count != 0 )
+                        {
+                            fitLeaf( nodes[ n ] );
+                        }
+                    }
+                }
+            );
+
+            // Children are always stored after their parent
+
+            for( size_type n = nodes.size(); n-- > 0; )
+            {
+                Node & node = nodes[ n ];
+
+                if( node.count == 0 )
+                {
+                    node.bounds = nodes[ node.first ].bounds;
+                    node.bounds.add( nodes[ node.first + 1 ].bounds );
+                }
+            }
+        }
+
+        // UPDATE -------------------------------------------------------------
+
+        // Brings the hierarchy up to date with the changes recorded by a
+        // tracker attached to the indexed graph: any created or destroyed
+        // polygon or vertex forces a rebuild, while modified vertices only
+        // need a refit. The tracker is left for the caller to clear.
+
+        void update( ChangeTracker const & tracker, size_type threadCount = 0 )
+        {
+            if( graph == nullptr )
+            {
+                return;
+            }
+
+            if( !tracker.getCreatedPolygons().empty() ||
+                !tracker.getDestroyedPolygons().empty() ||
+                !tracker.getDestroyedVertices().empty() )
+            {
+                build( *graph, threadCount );
+            }
+            else if( !tracker.getModifiedVertices().empty() ||
+                     !tracker.getModifiedPolygons().empty() )
+            {
+                refit( threadCount );
+            }
+        }
+
+        // INTERSECT RAY ------------------------------------------------------
+
+        // Finds the nearest polygon hit by the ray origin + t * direction
+        // with 0 <= t <= maxDistance. Returns false on a miss.
+
+        bool const intersectRay
+        (
+            double const * origin,
+            double const * direction,
+            RayHit & hit,
+            double maxDistance = std::numeric_limits< double >::infinity()
+        ) const
+        {
+            if( nodes.empty() )
+            {
+                return false;
+            }
+
+            float o[ 3 ];
+            float d[ 3 ];
+            float inverse[ 3 ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                o[ axis ] = static_cast< float >( origin[ axis ] );
+                d[ axis ] = static_cast< float >( direction[ axis ] );
+                inverse[ axis ] = 1.0f / d[ axis ];
+            }
+
+            float const miss = std::numeric_limits< float >::infinity();
+            float nearest = maxDistance > std::numeric_limits< float >::max()
+                          ? miss : static_cast< float >( maxDistance );
+            std::uint32_t nearestPolygon = noPolygon;
+
+            // Nodes are stacked with their entry distance, so those behind
+            // a hit found since they were pushed are skipped
+
+            float rootEntry = intersectBox( nodes[ 0 ].bounds, o, inverse,
+                                            nearest );
+
+            if( rootEntry == miss )
+            {
+                return false;
+            }
+
+            std::uint32_t stack[ maxDepth + 1 ];
+            float entries[ maxDepth + 1 ];
+            size_type stackSize = 0;
+            stack[ stackSize ] = 0;
+            entries[ stackSize++ ] = rootEntry;
+
+            while( stackSize != 0 )
+            {
+                --stackSize;
+
+                if( entries[ stackSize ] > nearest )
+                {
+                    continue;
+                }
+
+                Node const & node = nodes[ stack[ stackSize ] ];
+
+                if( node.count != 0 )
+                {
+                    for( std::uint32_t b = node.first;
+                         b < node.first + node.count; ++b )
+                    {
+                        intersectBatch( batches[ b ], o, d, nearest,
+                                        nearestPolygon );
+                    }
+
+                    continue;
+                }
+
+                // Visit the nearer child first
+
+                float entry[ 2 ];
+                entry[ 0 ] = intersectBox( nodes[ node.first ].bounds,
+                                           o, inverse, nearest );
+                entry[ 1 ] = intersectBox( nodes[ node.first + 1 ].bounds,
+                                           o, inverse, nearest );
+                int nearer = entry[ 1 ] < entry[ 0 ] ? 1 : 0;
+
+                // A missed box reports infinity, which must not pass for
+                // a hit when nearest is still infinite
+
+                if( entry[ 1 - nearer ] != miss &&
+                    entry[ 1 - nearer ] <= nearest )
+                {
+                    stack[ stackSize ] = node.first + 1 - nearer;
+                    entries[ stackSize++ ] = entry[ 1 - nearer ];
+                }
+
+                if( entry[ nearer ] != miss && entry[ nearer ] <= nearest )
+                {
+                    stack[ stackSize ] = node.first + nearer;
+                    entries[ stackSize++ ] = entry[ nearer ];
+                }
+            }
+
+            if( nearestPolygon == noPolygon )
+            {
+                return false;
+            }
+
+            hit.polygon = polygons[ nearestPolygon ];
+            hit.distance = nearest;
+
+            return true;
+        }
+
+        // FIND CLOSEST POINT -------------------------------------------------
+
+        // Finds the point on the surface nearest to point, within
+        // maxDistance. Returns false if nothing lies that close.
+
+        bool const findClosestPoint
+        (
+            double const * point,
+            ClosestHit & hit,
+            double maxDistance = std::numeric_limits< double >::infinity()
+        ) const
+        {
+            if( nodes.empty() )
+            {
+                return false;
+            }
+
+            float p[ 3 ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                p[ axis ] = static_cast< float >( point[ axis ] );
+            }
+
+            float nearest = maxDistance > std::numeric_limits< float >::max()
+                          ? std::numeric_limits< float >::infinity()
+                          : static_cast< float >( maxDistance * maxDistance );
+            std::uint32_t nearestPolygon = noPolygon;
+            float nearestPoint[ 3 ] = { 0.0f, 0.0f, 0.0f };
+
+            std::uint32_t stack[ maxDepth + 1 ];
+            size_type stackSize = 0;
+            stack[ stackSize++ ] = 0;
+
+            while( stackSize != 0 )
+            {
+                Node const & node = nodes[ stack[ --stackSize ] ];
+
+                if( getBoxDistance( node.bounds, p ) > nearest )
+                {
+                    continue;
+                }
+
+                if( node.count != 0 )
+                {
+                    for( std::uint32_t b = node.first;
+                         b < node.first + node.count; ++b )
+                    {
+                        closestInBatch( batches[ b ], p, nearest,
+                                        nearestPolygon, nearestPoint );
+                    }
+
+                    continue;
+                }
+
+                float distance[ 2 ];
+                distance[ 0 ] =
+                    getBoxDistance( nodes[ node.first ].bounds, p );
+                distance[ 1 ] =
+                    getBoxDistance( nodes[ node.first + 1 ].bounds, p );
+                int nearer = distance[ 1 ] < distance[ 0 ] ? 1 : 0;
+
+                if( distance[ 1 - nearer ] <= nearest )
+                {
+                    stack[ stackSize++ ] = node.first + 1 - nearer;
+                }
+
+                if( distance[ nearer ] <= nearest )
+                {
+                    stack[ stackSize++ ] = node.first + nearer;
+                }
+            }
+
+            if( nearestPolygon == noPolygon )
+            {
+                return false;
+            }
+
+            hit.polygon = polygons[ nearestPolygon ];
+            hit.distance = std::sqrt( static_cast< double >( nearest ) );
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                hit.point[ axis ] = nearestPoint[ axis ];
+            }
+
+            return true;
+        }
+
+        // SIMD LEVEL ---------------------------------------------------------
+
+        // Limits the instruction set used, e.g. to compare kernels. Levels
+        // above what the CPU supports are lowered to the supported one.
+
+        void setSimdLevel( SimdLevel level )
+        {
+            SimdLevel supported = getSupportedSimdLevel();
+            simdLevel = level > supported ? supported : level;
+        }
+
+        SimdLevel const getSimdLevel( void ) const
+        {
+            return simdLevel;
+        }
+
+        // GET COUNTS ---------------------------------------------------------
+
+        size_type const getNodeCount( void ) const
+        {
+            return nodes.size();
+        }
+
+        size_type const getPolygonCount( void ) const
+        {
+            return polygons.size();
+        }
+
+        size_type const getBatchCount( void ) const
+        {
+            return batches.size();
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        static const std::uint32_t noPolygon = 0xffffffffu;
+        static const size_type binCount = 12;
+        static const size_type parallelThreshold = 4096;
+        static const size_type maxDepth = 128;
+        static const size_type sahDepth = 64;
+
+        // BOUNDS -------------------------------------------------------------
+
+        class Bounds
+        {
+            public:
+
+            Bounds( void )
+            {
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    minimum[ axis ] = std::numeric_limits< float >::max();
+                    maximum[ axis ] = -std::numeric_limits< float >::max();
+                }
+            }
+
+            void add( float const * point )
+            {
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    minimum[ axis ] = std::min( minimum[ axis ],
+                                                point[ axis ] );
+                    maximum[ axis ] = std::max( maximum[ axis ],
+                                                point[ axis ] );
+                }
+            }
+
+            void add( Bounds const & other )
+            {
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    minimum[ axis ] = std::min( minimum[ axis ],
+                                                other.minimum[ axis ] );
+                    maximum[ axis ] = std::max( maximum[ axis ],
+                                                other.maximum[ axis ] );
+                }
+            }
+
+            float const getArea( void ) const
+            {
+                float x = maximum[ 0 ] - minimum[ 0 ];
+                float y = maximum[ 1 ] - minimum[ 1 ];
+                float z = maximum[ 2 ] - minimum[ 2 ];
+
+                return x < 0.0f ? 0.0f : 2.0f * ( x * y + y * z + z * x );
+            }
+
+            float minimum[ 3 ];
+            float maximum[ 3 ];
+        };
+
+        // NODE ---------------------------------------------------------------
+
+        // Interior nodes have count 0 and children at first and first + 1.
+        // Leaves hold count triangle batches starting at batch first.
+
+        class Node
+        {
+            public:
+
+            Bounds bounds;
+            std::uint32_t first;
+            std::uint32_t count;
+        };
+
+        // BATCH --------------------------------------------------------------
+
+        // Fan triangles as first corner plus two edge vectors, one lane per
+        // triangle. Unused lanes have polygon noPolygon and zero extent.
+
+        class Batch
+        {
+            public:
+
+            float origin[ 3 ][ batchWidth ];
+            float edge1[ 3 ][ batchWidth ];
+            float edge2[ 3 ][ batchWidth ];
+            std::uint32_t polygons[ batchWidth ];
+        };
+
+        class BatchCorners
+        {
+            public:
+
+            Vertex const * corners[ 3 ][ batchWidth ];
+        };
+
+        // BUILD CONTEXT ------------------------------------------------------
+
+        class BuildContext
+        {
+            public:
+
+            std::vector< Bounds > const * bounds;
+            std::vector< float > const * centroids;
+            std::vector< std::uint32_t > * order;
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // GET POSITION -------------------------------------------------------
+
+        void getPosition( Vertex const & vertex, float * position ) const
+        {
+            Vertex & mutableVertex = const_cast< Vertex & >( vertex );
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                position[ axis ] =
+                    static_cast< float >( accessor( mutableVertex )[ axis ] );
+            }
+        }
+
+        // GET POLYGON BOUNDS -------------------------------------------------
+
+        Bounds const getPolygonBounds( PolygonIterator polygon ) const
+        {
+            Bounds bounds;
+            Edge * startEdge = polygon->getStartEdge();
+            Edge * edge = startEdge;
+
+            do
+            {
+                float position[ 3 ];
+                getPosition( *edge->getTargetVertex(), position );
+                bounds.add( position );
+                edge = edge->getNextEdge();
+            }
+            while( edge != startEdge );
+
+            return bounds;
+        }
+
+        // BUILD NODE ---------------------------------------------------------
+
+        // Builds the subtree over order[ begin, end ) into node index.
+        // While parallelDepth is non-zero the left child is built on a new
+        // thread. Below sahDepth splits fall back to the median, which
+        // bounds the tree depth and so the traversal stacks.
+
+        void buildNode
+        (
+            BuildContext & context,
+            std::uint32_t index,
+            std::uint32_t begin,
+            std::uint32_t end,
+            size_type depth,
+            size_type parallelDepth
+        )
+        {
+            std::vector< Bounds > const & bounds = *context.bounds;
+            std::vector< float > const & centroids = *context.centroids;
+            std::vector< std::uint32_t > & order = *context.order;
+
+            Node & node = nodes[ index ];
+            node.bounds = Bounds();
+            Bounds centroidBounds;
+
+            for( std::uint32_t o = begin; o < end; ++o )
+            {
+                node.bounds.add( bounds[ order[ o ] ] );
+                centroidBounds.add( &( centroids[ order[ o ] * 3 ] ) );
+            }
+
+            std::uint32_t count = end - begin;
+
+            if( count <= maxLeafSize )
+            {
+                makeLeaf( node, begin, count );
+                return;
+            }
+
+            // Evaluate binned SAH on every axis
+
+            float bestCost = std::numeric_limits< float >::max();
+            int bestAxis = -1;
+            size_type bestSplit = 0;
+
+            for( int axis = 0; axis < 3 && depth < sahDepth; ++axis )
+            {
+                float low = centroidBounds.minimum[ axis ];
+                float extent = centroidBounds.maximum[ axis ] - low;
+
+                if( !( extent > 0.0f ) )
+                {
+                    continue;
+                }
+
+                Bounds binBounds[ binCount ];
+                std::uint32_t binSizes[ binCount ] = { 0 };
+                float scale = binCount / extent;
+
+                for( std::uint32_t o = begin; o < end; ++o )
+                {
+                    size_type bin = getBin( centroids[ order[ o ] * 3 + axis ],
+                                            low, scale );
+                    binBounds[ bin ].add( bounds[ order[ o ] ] );
+                    ++binSizes[ bin ];
+                }
+
+                // Sweep from the right, then from the left
+
+                float rightCost[ binCount ];
+                Bounds right;
+                std::uint32_t rightSize = 0;
+
+                for( size_type bin = binCount - 1; bin > 0; --bin )
+                {
+                    right.add( binBounds[ bin ] );
+                    rightSize += binSizes[ bin ];
+                    rightCost[ bin ] = right.getArea() * rightSize;
+                }
+
+                Bounds left;
+                std::uint32_t leftSize = 0;
+
+                for( size_type bin = 0; bin + 1 < binCount; ++bin )
+                {
+                    left.add( binBounds[ bin ] );
+                    leftSize += binSizes[ bin ];
+
+                    float cost = left.getArea() * leftSize +
+                                 rightCost[ bin + 1 ];
+
+                    if( leftSize != 0 && leftSize != count &&
+                        cost < bestCost )
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = bin + 1;
+                    }
+                }
+            }
+
+            std::uint32_t middle = begin + count / 2;
+
+            if( bestAxis >= 0 )
+            {
+                // Stop splitting when intersecting everything is cheaper
+
+                if( count <= 16 &&
+                    bestCost >= node.bounds.getArea() * count )
+                {
+                    makeLeaf( node, begin, count );
+                    return;
+                }
+
+                float low = centroidBounds.minimum[ bestAxis ];
+                float scale = binCount /
+                    ( centroidBounds.maximum[ bestAxis ] - low );
+
+                middle = static_cast< std::uint32_t >
+                (
+                    std::partition
+                    (
+                        order.begin() + begin, order.begin() + end,
+                        [ & ]( std::uint32_t polygon )
+                        {
+                            return getBin( centroids[ polygon * 3 +
+                                                      bestAxis ],
+                                           low, scale ) < bestSplit;
+                        }
+                    ) - order.begin()
+                );
+            }
+
+            // Coincident centroids: fall back to an even split
+
+            if( middle == begin || middle == end )
+            {
+                middle = begin + count / 2;
+            }
+
+            std::uint32_t child = nodeCount.fetch_add( 2 );
+            node.first = child;
+            node.count = 0;
+
+            if( parallelDepth > 0 && count >= parallelThreshold )
+            {
+                std::thread worker
+                (
+                    [ &, child, begin, middle, depth, parallelDepth ]( void )
+                    {
+                        PG_TRACE_SCOPE( "PolygonBVH::buildSubtree" );
+                        buildNode( context, child, begin, middle, depth + 1,
+                                   parallelDepth - 1 );
+                    }
+                );
+
+                buildNode( context, child + 1, middle, end, depth + 1,
+                           parallelDepth - 1 );
+                worker.join();
+            }
+            else
+            {
+                buildNode( context, child, begin, middle, depth + 1, 0 );
+                buildNode( context, child + 1, middle, end, depth + 1, 0 );
+            }
+        }
+
+        // MAKE LEAF ----------------------------------------------------------
+
+        void makeLeaf( Node & node, std::uint32_t begin, std::uint32_t count )
+        {
+            node.first = begin;
+            node.count = count;
+        }
+
+        // GET BIN ------------------------------------------------------------
+
+        static size_type const getBin( float value, float low, float scale )
+        {
+            float bin = ( value - low ) * scale;
+
+            return bin <= 0.0f ? 0 :
+                   bin >= binCount - 1 ? binCount - 1 :
+                   static_cast< size_type >( bin );
+        }
+
+        // LOAD BATCH ---------------------------------------------------------
+
+        void loadBatch( size_type index )
+        {
+            Batch & batch = batches[ index ];
+            BatchCorners const & corners = batchCorners[ index ];
+
+            for( size_type lane = 0; lane < batchWidth; ++lane )
+            {
+                float p[ 3 ][ 3 ] = { { 0.0f } };
+
+                if( batch.polygons[ lane ] != noPolygon )
+                {
+                    for( int corner = 0; corner < 3; ++corner )
+                    {
+                        getPosition( *corners.corners[ corner ][ lane ],
+                                     p[ corner ] );
+                    }
+                }
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    batch.origin[ axis ][ lane ] = p[ 0 ][ axis ];
+                    batch.edge1[ axis ][ lane ] =
+                        p[ 1 ][ axis ] - p[ 0 ][ axis ];
+                    batch.edge2[ axis ][ lane ] =
+                        p[ 2 ][ axis ] - p[ 0 ][ axis ];
+                }
+            }
+        }
+
+        // FIT LEAF -----------------------------------------------------------
+
+        void fitLeaf( Node & node ) const
+        {
+            node.bounds = Bounds();
+
+            for( std::uint32_t b = node.first; b < node.first + node.count;
+                 ++b )
+            {
+                Batch const & batch = batches[ b ];
+
+                for( size_type lane = 0; lane < batchWidth; ++lane )
+                {
+                    if( batch.polygons[ lane ] == noPolygon )
+                    {
+                        continue;
+                    }
+
+                    float p[ 3 ];
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        p[ axis ] = batch.origin[ axis ][ lane ];
+                    }
+
+                    node.bounds.add( p );
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        p[ axis ] = batch.origin[ axis ][ lane ] +
+                                    batch.edge1[ axis ][ lane ];
+                    }
+
+                    node.bounds.add( p );
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        p[ axis ] = batch.origin[ axis ][ lane ] +
+                                    batch.edge2[ axis ][ lane ];
+                    }
+
+                    node.bounds.add( p );
+                }
+            }
+        }
+
+        // INTERSECT BOX ------------------------------------------------------
+
+        // Returns the entry distance of the ray into the box, or infinity
+        // if it misses within limit. Callers must treat infinity as a miss
+        // even when limit is infinite.
+
+        static float const intersectBox
+        (
+            Bounds const & bounds,
+            float const * origin,
+            float const * inverse,
+            float limit
+        )
+        {
+            float near = 0.0f;
+            float far = limit;
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                float t0 = ( bounds.minimum[ axis ] - origin[ axis ] ) *
+                           inverse[ axis ];
+                float t1 = ( bounds.maximum[ axis ] - origin[ axis ] ) *
+                           inverse[ axis ];
+
+                // NaN from 0 * infinity leaves near and far unchanged
+
+                near = std::max( near, std::min( t0, t1 ) );
+                far = std::min( far, std::max( t0, t1 ) );
+            }
+
+            return near <= far ? near
+                               : std::numeric_limits< float >::infinity();
+        }
+
+        // INTERSECT BATCH ----------------------------------------------------
+
+        // Moller-Trumbore across all lanes of a batch, keeping the nearest
+        // hit within nearest. Ties go to the later lane.
+
+        void intersectBatch
+        (
+            Batch const & batch,
+            float const * o,
+            float const * d,
+            float & nearest,
+            std::uint32_t & nearestPolygon
+        ) const
+        {
+            #if defined( POLYGON_GRAPH_X86_SIMD )
+
+            if( simdLevel != simdScalar )
+            {
+                intersectBatchSse( batch, o, d, nearest, nearestPolygon );
+                return;
+            }
+
+            #endif
+
+            intersectBatchScalar( batch, o, d, nearest, nearestPolygon );
+        }
+
+        void intersectBatchScalar
+        (
+            Batch const & batch,
+            float const * o,
+            float const * d,
+            float & nearest,
+            std::uint32_t & nearestPolygon
+        ) const
+        {
+            float distances[ batchWidth ];
+
+            for( size_type lane = 0; lane < batchWidth; ++lane )
+            {
+                float e1x = batch.edge1[ 0 ][ lane ];
+                float e1y = batch.edge1[ 1 ][ lane ];
+                float e1z = batch.edge1[ 2 ][ lane ];
+                float e2x = batch.edge2[ 0 ][ lane ];
+                float e2y = batch.edge2[ 1 ][ lane ];
+                float e2z = batch.edge2[ 2 ][ lane ];
+
+                float px = d[ 1 ] * e2z - d[ 2 ] * e2y;
+                float py = d[ 2 ] * e2x - d[ 0 ] * e2z;
+                float pz = d[ 0 ] * e2y - d[ 1 ] * e2x;
+                float determinant = e1x * px + e1y * py + e1z * pz;
+                float inverse = 1.0f / determinant;
+
+                float tx = o[ 0 ] - batch.origin[ 0 ][ lane ];
+                float ty = o[ 1 ] - batch.origin[ 1 ][ lane ];
+                float tz = o[ 2 ] - batch.origin[ 2 ][ lane ];
+                float u = ( tx * px + ty * py + tz * pz ) * inverse;
+
+                float qx = ty * e1z - tz * e1y;
+                float qy = tz * e1x - tx * e1z;
+                float qz = tx * e1y - ty * e1x;
+                float v = ( d[ 0 ] * qx + d[ 1 ] * qy + d[ 2 ] * qz ) *
+                          inverse;
+                float t = ( e2x * qx + e2y * qy + e2z * qz ) * inverse;
+
+                bool inside = determinant != 0.0f && u >= 0.0f &&
+                              v >= 0.0f && u + v <= 1.0f && t >= 0.0f;
+
+                distances[ lane ] = inside ? t :
+                    std::numeric_limits< float >::infinity();
+            }
+
+            for( size_type lane = 0; lane < batchWidth; ++lane )
+            {
+                if( distances[ lane ] <= nearest &&
+                    distances[ lane ] !=
+                        std::numeric_limits< float >::infinity() &&
+                    batch.polygons[ lane ] != noPolygon )
+                {
+                    nearest = distances[ lane ];
+                    nearestPolygon = batch.polygons[ lane ];
+                }
+            }
+        }
+
+        #if defined( POLYGON_GRAPH_X86_SIMD )
+
+        // Follows the scalar kernel operation for operation, so both find
+        // the same hit at the same distance.
+
+        __attribute__(( target( "sse2" ) ))
+        static void intersectBatchSse
+        (
+            Batch const & batch,
+            float const * o,
+            float const * d,
+            float & nearest,
+            std::uint32_t & nearestPolygon
+        )
+        {
+            __m128 const zero = _mm_setzero_ps();
+            __m128 const one = _mm_set1_ps( 1.0f );
+            __m128 const miss =
+                _mm_set1_ps( std::numeric_limits< float >::infinity() );
+
+            __m128 dx = _mm_set1_ps( d[ 0 ] );
+            __m128 dy = _mm_set1_ps( d[ 1 ] );
+            __m128 dz = _mm_set1_ps( d[ 2 ] );
+
+            __m128 e1x = _mm_loadu_ps( batch.edge1[ 0 ] );
+            __m128 e1y = _mm_loadu_ps( batch.edge1[ 1 ] );
+            __m128 e1z = _mm_loadu_ps( batch.edge1[ 2 ] );
+            __m128 e2x = _mm_loadu_ps( batch.edge2[ 0 ] );
+            __m128 e2y = _mm_loadu_ps( batch.edge2[ 1 ] );
+            __m128 e2z = _mm_loadu_ps( batch.edge2[ 2 ] );
+
+            __m128 px = _mm_sub_ps( _mm_mul_ps( dy, e2z ),
+                                    _mm_mul_ps( dz, e2y ) );
+            __m128 py = _mm_sub_ps( _mm_mul_ps( dz, e2x ),
+                                    _mm_mul_ps( dx, e2z ) );
+            __m128 pz = _mm_sub_ps( _mm_mul_ps( dx, e2y ),
+                                    _mm_mul_ps( dy, e2x ) );
+            __m128 determinant = dot( e1x, e1y, e1z, px, py, pz );
+            __m128 inverse = _mm_div_ps( one, determinant );
+
+            __m128 tx = _mm_sub_ps( _mm_set1_ps( o[ 0 ] ),
+                                    _mm_loadu_ps( batch.origin[ 0 ] ) );
+            __m128 ty = _mm_sub_ps( _mm_set1_ps( o[ 1 ] ),
+                                    _mm_loadu_ps( batch.origin[ 1 ] ) );
+            __m128 tz = _mm_sub_ps( _mm_set1_ps( o[ 2 ] ),
+                                    _mm_loadu_ps( batch.origin[ 2 ] ) );
+            __m128 u = _mm_mul_ps( dot( tx, ty, tz, px, py, pz ), inverse );
+
+            __m128 qx = _mm_sub_ps( _mm_mul_ps( ty, e1z ),
+                                    _mm_mul_ps( tz, e1y ) );
+            __m128 qy = _mm_sub_ps( _mm_mul_ps( tz, e1x ),
+                                    _mm_mul_ps( tx, e1z ) );
+            __m128 qz = _mm_sub_ps( _mm_mul_ps( tx, e1y ),
+                                    _mm_mul_ps( ty, e1x ) );
+            __m128 v = _mm_mul_ps( dot( dx, dy, dz, qx, qy, qz ), inverse );
+            __m128 t = _mm_mul_ps( dot( e2x, e2y, e2z, qx, qy, qz ),
+                                   inverse );
+
+            // Unused lanes have zero extent, so their determinant is zero
+
+            __m128 inside = _mm_and_ps
+            (
+                _mm_and_ps( _mm_cmpneq_ps( determinant, zero ),
+                            _mm_cmpge_ps( u, zero ) ),
+                _mm_and_ps( _mm_cmpge_ps( v, zero ),
+                            _mm_cmple_ps( _mm_add_ps( u, v ), one ) )
+            );
+            inside = _mm_and_ps
+            (
+                inside,
+                _mm_and_ps( _mm_cmpge_ps( t, zero ),
+                            _mm_cmpneq_ps( t, miss ) )
+            );
+            inside = _mm_and_ps
+            (
+                inside, _mm_cmple_ps( t, _mm_set1_ps( nearest ) )
+            );
+
+            int hits = _mm_movemask_ps( inside );
+
+            if( hits == 0 )
+            {
+                return;
+            }
+
+            float distances[ batchWidth ];
+            _mm_storeu_ps( distances, t );
+
+            for( size_type lane = 0; lane < batchWidth; ++lane )
+            {
+                if( ( hits >> lane & 1 ) != 0 &&
+                    batch.polygons[ lane ] != noPolygon &&
+                    distances[ lane ] <= nearest )
+                {
+                    nearest = distances[ lane ];
+                    nearestPolygon = batch.polygons[ lane ];
+                }
+            }
+        }
+
+        #endif
+
+        // CLOSEST IN BATCH ---------------------------------------------------
+
+        // Closest point on each lane's triangle by region classification,
+        // keeping the nearest in squared distance. Ties go to the later
+        // lane.
+
+        void closestInBatch
+        (
+            Batch const & batch,
+            float const * p,
+            float & nearest,
+            std::uint32_t & nearestPolygon,
+            float * nearestPoint
+        ) const
+        {
+            #if defined( POLYGON_GRAPH_X86_SIMD )
+
+            if( simdLevel != simdScalar )
+            {
+                closestInBatchSse( batch, p, nearest, nearestPolygon,
+                                   nearestPoint );
+                return;
+            }
+
+            #endif
+
+            closestInBatchScalar( batch, p, nearest, nearestPolygon,
+                                  nearestPoint );
+        }
+
+        void closestInBatchScalar
+        (
+            Batch const & batch,
+            float const * p,
+            float & nearest,
+            std::uint32_t & nearestPolygon,
+            float * nearestPoint
+        ) const
+        {
+            for( size_type lane = 0; lane < batchWidth; ++lane )
+            {
+                if( batch.polygons[ lane ] == noPolygon )
+                {
+                    continue;
+                }
+
+                float a[ 3 ];
+                float ab[ 3 ];
+                float ac[ 3 ];
+                float ap[ 3 ];
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    a[ axis ] = batch.origin[ axis ][ lane ];
+                    ab[ axis ] = batch.edge1[ axis ][ lane ];
+                    ac[ axis ] = batch.edge2[ axis ][ lane ];
+                    ap[ axis ] = p[ axis ] - a[ axis ];
+                }
+
+                // Corner regions are tested against bp = ap - ab and
+                // cp = ap - ac without forming those vectors
+
+                float d1 = dot( ab, ap );
+                float d2 = dot( ac, ap );
+                float d3 = d1 - dot( ab, ab );
+                float d4 = d2 - dot( ac, ab );
+                float d5 = d1 - dot( ab, ac );
+                float d6 = d2 - dot( ac, ac );
+                float va = d3 * d6 - d5 * d4;
+                float vb = d5 * d2 - d1 * d6;
+                float vc = d1 * d4 - d3 * d2;
+                float v = 0.0f;
+                float w = 0.0f;
+
+                if( d1 <= 0.0f && d2 <= 0.0f )
+                {
+                    // Corner a
+                }
+                else if( d3 >= 0.0f && d4 <= d3 )
+                {
+                    v = 1.0f;
+                }
+                else if( d6 >= 0.0f && d5 <= d6 )
+                {
+                    w = 1.0f;
+                }
+                else if( vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f )
+                {
+                    v = d1 / ( d1 - d3 );
+                }
+                else if( vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f )
+                {
+                    w = d2 / ( d2 - d6 );
+                }
+                else if( va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f )
+                {
+                    w = ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) );
+                    v = 1.0f - w;
+                }
+                else
+                {
+                    float denominator = 1.0f / ( va + vb + vc );
+                    v = vb * denominator;
+                    w = vc * denominator;
+                }
+
+                float closest[ 3 ];
+                float distance = 0.0f;
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    closest[ axis ] = a[ axis ] + ab[ axis ] * v +
+                                      ac[ axis ] * w;
+                    float offset = p[ axis ] - closest[ axis ];
+                    distance += offset * offset;
+                }
+
+                if( distance <= nearest )
+                {
+                    nearest = distance;
+                    nearestPolygon = batch.polygons[ lane ];
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        nearestPoint[ axis ] = closest[ axis ];
+                    }
+                }
+            }
+        }
+
+        #if defined( POLYGON_GRAPH_X86_SIMD )
+
+        // Evaluates every region for all lanes and keeps, per lane, the
+        // first whose test passes, in the scalar kernel's order. The
+        // arithmetic matches the scalar kernel's.
+
+        __attribute__(( target( "sse2" ) ))
+        static void closestInBatchSse
+        (
+            Batch const & batch,
+            float const * p,
+            float & nearest,
+            std::uint32_t & nearestPolygon,
+            float * nearestPoint
+        )
+        {
+            __m128 const zero = _mm_setzero_ps();
+            __m128 const one = _mm_set1_ps( 1.0f );
+
+            __m128 a[ 3 ];
+            __m128 ab[ 3 ];
+            __m128 ac[ 3 ];
+            __m128 ap[ 3 ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                a[ axis ] = _mm_loadu_ps( batch.origin[ axis ] );
+                ab[ axis ] = _mm_loadu_ps( batch.edge1[ axis ] );
+                ac[ axis ] = _mm_loadu_ps( batch.edge2[ axis ] );
+                ap[ axis ] = _mm_sub_ps( _mm_set1_ps( p[ axis ] ),
+                                         a[ axis ] );
+            }
+
+            __m128 d1 = dot( ab, ap );
+            __m128 d2 = dot( ac, ap );
+            __m128 d3 = _mm_sub_ps( d1, dot( ab, ab ) );
+            __m128 d4 = _mm_sub_ps( d2, dot( ac, ab ) );
+            __m128 d5 = _mm_sub_ps( d1, dot( ab, ac ) );
+            __m128 d6 = _mm_sub_ps( d2, dot( ac, ac ) );
+            __m128 va = _mm_sub_ps( _mm_mul_ps( d3, d6 ),
+                                    _mm_mul_ps( d5, d4 ) );
+            __m128 vb = _mm_sub_ps( _mm_mul_ps( d5, d2 ),
+                                    _mm_mul_ps( d1, d6 ) );
+            __m128 vc = _mm_sub_ps( _mm_mul_ps( d1, d4 ),
+                                    _mm_mul_ps( d3, d2 ) );
+
+            // Interior first, then each region overriding those tested
+            // after it in the scalar kernel
+
+            __m128 denominator =
+                _mm_div_ps( one, _mm_add_ps( _mm_add_ps( va, vb ), vc ) );
+            __m128 v = _mm_mul_ps( vb, denominator );
+            __m128 w = _mm_mul_ps( vc, denominator );
+
+            __m128 d43 = _mm_sub_ps( d4, d3 );
+            __m128 d56 = _mm_sub_ps( d5, d6 );
+            __m128 region = _mm_and_ps
+            (
+                _mm_cmple_ps( va, zero ),
+                _mm_and_ps( _mm_cmpge_ps( d43, zero ),
+                            _mm_cmpge_ps( d56, zero ) )
+            );
+            __m128 edgeW = _mm_div_ps( d43, _mm_add_ps( d43, d56 ) );
+            w = select( region, edgeW, w );
+            v = select( region, _mm_sub_ps( one, edgeW ), v );
+
+            region = _mm_and_ps
+            (
+                _mm_cmple_ps( vb, zero ),
+                _mm_and_ps( _mm_cmpge_ps( d2, zero ),
+                            _mm_cmple_ps( d6, zero ) )
+            );
+            w = select( region,
+                        _mm_div_ps( d2, _mm_sub_ps( d2, d6 ) ), w );
+            v = select( region, zero, v );
+
+            region = _mm_and_ps
+            (
+                _mm_cmple_ps( vc, zero ),
+                _mm_and_ps( _mm_cmpge_ps( d1, zero ),
+                            _mm_cmple_ps( d3, zero ) )
+            );
+            v = select( region,
+                        _mm_div_ps( d1, _mm_sub_ps( d1, d3 ) ), v );
+            w = select( region, zero, w );
+
+            region = _mm_and_ps( _mm_cmpge_ps( d6, zero ),
+                                 _mm_cmple_ps( d5, d6 ) );
+            v = select( region, zero, v );
+            w = select( region, one, w );
+
+            region = _mm_and_ps( _mm_cmpge_ps( d3, zero ),
+                                 _mm_cmple_ps( d4, d3 ) );
+            v = select( region, one, v );
+            w = select( region, zero, w );
+
+            region = _mm_and_ps( _mm_cmple_ps( d1, zero ),
+                                 _mm_cmple_ps( d2, zero ) );
+            v = select( region, zero, v );
+            w = select( region, zero, w );
+
+            __m128 closest[ 3 ];
+            __m128 distance = zero;
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                closest[ axis ] = _mm_add_ps
+                (
+                    _mm_add_ps( a[ axis ], _mm_mul_ps( ab[ axis ], v ) ),
+                    _mm_mul_ps( ac[ axis ], w )
+                );
+                __m128 offset = _mm_sub_ps( _mm_set1_ps( p[ axis ] ),
+                                            closest[ axis ] );
+                distance = _mm_add_ps( distance,
+                                       _mm_mul_ps( offset, offset ) );
+            }
+
+            int near = _mm_movemask_ps
+            (
+                _mm_cmple_ps( distance, _mm_set1_ps( nearest ) )
+            );
+
+            if( near == 0 )
+            {
+                return;
+            }
+
+            float distances[ batchWidth ];
+            float points[ 3 ][ batchWidth ];
+            _mm_storeu_ps( distances, distance );
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                _mm_storeu_ps( points[ axis ], closest[ axis ] );
+            }
+
+            for( size_type lane = 0; lane < batchWidth; ++lane )
+            {
+                if( ( near >> lane & 1 ) != 0 &&
+                    batch.polygons[ lane ] != noPolygon &&
+                    distances[ lane ] <= nearest )
+                {
+                    nearest = distances[ lane ];
+                    nearestPolygon = batch.polygons[ lane ];
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        nearestPoint[ axis ] = points[ axis ][ lane ];
+                    }
+                }
+            }
+        }
+
+        // Lane-wise mask ? a : b, and dot products of lane vectors
+
+        __attribute__(( target( "sse2" ) ))
+        static __m128 select( __m128 mask, __m128 a, __m128 b )
+        {
+            return _mm_or_ps( _mm_and_ps( mask, a ),
+                              _mm_andnot_ps( mask, b ) );
+        }
+
+        __attribute__(( target( "sse2" ) ))
+        static __m128 dot
+        (
+            __m128 ax, __m128 ay, __m128 az,
+            __m128 bx, __m128 by, __m128 bz
+        )
+        {
+            return _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ),
+                                           _mm_mul_ps( ay, by ) ),
+                               _mm_mul_ps( az, bz ) );
+        }
+
+        __attribute__(( target( "sse2" ) ))
+        static __m128 dot( __m128 const * a, __m128 const * b )
+        {
+            return dot( a[ 0 ], a[ 1 ], a[ 2 ], b[ 0 ], b[ 1 ], b[ 2 ] );
+        }
+
+        #endif
+
+        // DOT ----------------------------------------------------------------
+
+        static float const dot( float const * a, float const * b )
+        {
+            return a[ 0 ] * b[ 0 ] + a[ 1 ] * b[ 1 ] + a[ 2 ] * b[ 2 ];
+        }
+
+        // GET BOX DISTANCE ---------------------------------------------------
+
+        // Squared distance from a point to a box, zero inside.
+
+        static float const getBoxDistance
+        (
+            Bounds const & bounds,
+            float const * p
+        )
+        {
+            float distance = 0.0f;
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                float below = bounds.minimum[ axis ] - p[ axis ];
+                float above = p[ axis ] - bounds.maximum[ axis ];
+                float offset = std::max( 0.0f, std::max( below, above ) );
+                distance += offset * offset;
+            }
+
+            return distance;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        PositionAccessor accessor;
+        Graph * graph;
+        std::uint32_t maxLeafSize;
+        SimdLevel simdLevel;
+
+        std::vector< Node > nodes;
+        std::atomic< std::uint32_t > nodeCount;
+        std::vector< Batch > batches;
+        std::vector< BatchCorners > batchCorners;
+        std::vector< PolygonIterator > polygons;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    template< class Traits, class PositionAccessor >
+    typename PolygonBVH< Traits, PositionAccessor >::size_type const
+        PolygonBVH< Traits, PositionAccessor >::batchWidth;
+
+    template< class Traits, class PositionAccessor >
+    std::uint32_t const PolygonBVH< Traits, PositionAccessor >::noPolygon;
+
+    template< class Traits, class PositionAccessor >
+    typename PolygonBVH< Traits, PositionAccessor >::size_type const
+        PolygonBVH< Traits, PositionAccessor >::binCount;
+
+    template< class Traits, class PositionAccessor >
+    typename PolygonBVH< Traits, PositionAccessor >::size_type const
+        PolygonBVH< Traits, PositionAccessor >::parallelThreshold;
+
+    template< class Traits, class PositionAccessor >
+    typename PolygonBVH< Traits, PositionAccessor >::size_type const
+        PolygonBVH< Traits, PositionAccessor >::maxDepth;
+
+    template< class Traits, class PositionAccessor >
+    typename PolygonBVH< Traits, PositionAccessor >::size_type const
+        PolygonBVH< Traits, PositionAccessor >::sahDepth;
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_BVH_H
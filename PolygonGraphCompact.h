@@ -0,0 +1,837 @@
+#ifndef POLYGON_GRAPH_COMPACT_H
+#define POLYGON_GRAPH_COMPACT_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "PolygonGraph.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // COW ARRAY ----------------------------------------------------------
+
+        // Array stored as fixed-size chunks that copies share. Copying an
+        // array only shares its chunk table; the first write through a
+        // copy duplicates the table of chunk pointers, and each write
+        // duplicates just the chunk it lands in if another copy still
+        // holds it. Reads never copy, so element writes go through
+        // getMutable rather than a non-const subscript.
+        //
+        // Sharing is detected with use_count(), which does not order a
+        // write here after another copy's last use of a chunk on another
+        // thread. Copies that share storage may be read from several
+        // threads, but only written while they are all confined to the
+        // writing thread.
+
+        template< class T, std::size_t ChunkBits = 12 >
+        class CowArray
+        {
+            public:
+
+            static const std::size_t chunkSize =
+                std::size_t( 1 ) << ChunkBits;
+
+            CowArray( void )
+            {
+                table = std::make_shared< Table >();
+            }
+
+            // Moves copy too, so a moved-from array stays usable
+
+            CowArray( CowArray const & ) = default;
+            CowArray & operator = ( CowArray const & ) = default;
+
+            void push_back( T const & value )
+            {
+                std::size_t count = table->count;
+
+                if( ( count & ( chunkSize - 1 ) ) == 0 )
+                {
+                    getTable().chunks.push_back( createChunk() );
+                }
+
+                getMutable( count ) = value;
+                ++table->count;
+            }
+
+            void reserve( std::size_t count )
+            {
+                getTable().chunks.reserve( ( count + chunkSize - 1 ) >>
+                                           ChunkBits );
+            }
+
+            void clear( void )
+            {
+                table = std::make_shared< Table >();
+            }
+
+            std::size_t const size( void ) const
+            {
+                return table->count;
+            }
+
+            T const & operator [] ( std::size_t index ) const
+            {
+                return table->chunks[ index >> ChunkBits ].get()
+                    [ index & ( chunkSize - 1 ) ];
+            }
+
+            T & getMutable( std::size_t index )
+            {
+                Chunk & chunk = getTable().chunks[ index >> ChunkBits ];
+
+                if( chunk.use_count() > 1 )
+                {
+                    Chunk copy = createChunk();
+                    std::copy( chunk.get(), chunk.get() + chunkSize,
+                               copy.get() );
+                    chunk.swap( copy );
+                }
+
+                return chunk.get()[ index & ( chunkSize - 1 ) ];
+            }
+
+            // Bytes held by all chunks, and by those no copy shares
+
+            std::size_t const getBytes( void ) const
+            {
+                return table->chunks.size() * chunkSize * sizeof( T );
+            }
+
+            std::size_t const getUniqueBytes( void ) const
+            {
+                std::size_t chunkCount = 0;
+
+                for( std::size_t c = 0; c < table->chunks.size(); ++c )
+                {
+                    if( table.use_count() == 1 &&
+                        table->chunks[ c ].use_count() == 1 )
+                    {
+                        ++chunkCount;
+                    }
+                }
+
+                return chunkCount * chunkSize * sizeof( T );
+            }
+
+            private:
+
+            typedef std::shared_ptr< T > Chunk;
+
+            class Table
+            {
+                public:
+
+                Table( void )
+                {
+                    count = 0;
+                }
+
+                std::vector< Chunk > chunks;
+                std::size_t count;
+            };
+
+            static Chunk createChunk( void )
+            {
+                return Chunk( new T[ chunkSize ](),
+                              std::default_delete< T[] >() );
+            }
+
+            Table & getTable( void )
+            {
+                if( table.use_count() > 1 )
+                {
+                    table = std::make_shared< Table >( *table );
+                }
+
+                return *table;
+            }
+
+            std::shared_ptr< Table > table;
+        };
+
+        // PAYLOAD ARRAY ------------------------------------------------------
+
+        // Copy-on-write payload storage that takes no space for empty
+        // payload classes, which all share a single instance.
+
+        template< class T, bool Empty = std::is_empty< T >::value >
+        class PayloadArray
+        {
+            public:
+
+            void push_back( T const & value ) { values.push_back( value ); }
+            void reserve( std::size_t count ) { values.reserve( count ); }
+            void clear( void ) { values.clear(); }
+
+            std::size_t const size( void ) const { return values.size(); }
+
+            T const & operator [] ( std::size_t index ) const
+            {
+                return values[ index ];
+            }
+
+            T & getMutable( std::size_t index )
+            {
+                return values.getMutable( index );
+            }
+
+            std::size_t const getBytes( void ) const
+            {
+                return values.getBytes();
+            }
+
+            std::size_t const getUniqueBytes( void ) const
+            {
+                return values.getUniqueBytes();
+            }
+
+            private:
+
+            CowArray< T > values;
+        };
+
+        template< class T >
+        class PayloadArray< T, true >
+        {
+            public:
+
+            PayloadArray( void ) { count = 0; }
+
+            void push_back( T const & ) { ++count; }
+            void reserve( std::size_t ) {}
+            void clear( void ) { count = 0; }
+
+            std::size_t const size( void ) const { return count; }
+
+            T const & operator [] ( std::size_t ) const { return value; }
+            T & getMutable( std::size_t ) { return value; }
+
+            std::size_t const getBytes( void ) const { return 0; }
+            std::size_t const getUniqueBytes( void ) const { return 0; }
+
+            private:
+
+            std::size_t count;
+            T value;
+        };
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // COMPACT POLYGON GRAPH CLASS ++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Append-only polygon graph storing its topology as 32-bit indices into
+    // contiguous arrays. Each half-edge is 16 bytes: target vertex, next
+    // and previous half-edge, and polygon. A polygon's half-edges are
+    // stored consecutively starting with the edge from its first to its
+    // second vertex, as in PolygonGraph. Payloads live in parallel arrays.
+    //
+    // Half-edges are not indexed by vertex as they are added. Call
+    // buildAdjacency() before findEdge, getTwin or the outgoing edge
+    // queries; it builds an array of outgoing half-edges per vertex sorted
+    // by target, and adding polygons invalidates it.
+    //
+    // Copies share storage. Topology and payloads are held in chunked
+    // copy-on-write arrays and the adjacency index is immutable once
+    // built, so copying a graph is O(1) and a copy allocates only the
+    // chunks it later writes to. Only payloads and appends write, so
+    // forks of one base graph grow with their edits alone.
+    //
+    // Copies are single-thread-mutable. A graph and its copies may be
+    // read from any number of threads at once, but to write one, every
+    // copy still sharing storage with it must be used on the writing
+    // thread alone, or handed over with a synchronising operation such
+    // as joining a thread or locking a mutex.
+
+    template< class Traits = DefaultPGTraits >
+    class CompactPolygonGraph
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef std::size_t size_type;
+        typedef std::uint32_t index_type;
+
+        typedef typename Traits::BaseVertex BaseVertex;
+        typedef typename Traits::BaseEdge BaseEdge;
+        typedef typename Traits::BasePolygon BasePolygon;
+
+        typedef PolygonGraph< Traits > Graph;
+
+        static const index_type invalidIndex = 0xffffffffu;
+
+        // HALF EDGE ----------------------------------------------------------
+
+        class HalfEdge
+        {
+            public:
+
+            index_type target;
+            index_type next;
+            index_type previous;
+            index_type polygon;
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        CompactPolygonGraph( void )
+        {
+            adjacency = std::make_shared< Adjacency >();
+            adjacencyValid = true;
+        }
+
+        explicit CompactPolygonGraph( Graph const & graph )
+        {
+            adjacency = std::make_shared< Adjacency >();
+            adjacencyValid = true;
+            assign( graph );
+        }
+
+        // Copies share storage with the original. Moves copy too, so a
+        // moved-from graph stays usable.
+
+        CompactPolygonGraph( CompactPolygonGraph const & ) = default;
+
+        CompactPolygonGraph & operator =
+            ( CompactPolygonGraph const & ) = default;
+
+        // ADD VERTEX ---------------------------------------------------------
+
+        index_type addVertex( void )
+        {
+            return addVertex( BaseVertex() );
+        }
+
+        index_type addVertex( BaseVertex const & baseVertex )
+        {
+            vertexData.push_back( baseVertex );
+            adjacencyValid = false;
+
+            return static_cast< index_type >( vertexData.size() - 1 );
+        }
+
+        // ADD POLYGON --------------------------------------------------------
+
+        // Adds a polygon over a forward range of vertex indices. Returns
+        // invalidIndex if the range has fewer than three vertices or names
+        // a vertex that does not exist.
+
+        template< class IndexIt >
+        index_type addPolygon
+        (
+            IndexIt firstVertex,
+            IndexIt endVertex,
+            BasePolygon const & basePolygon = BasePolygon()
+        )
+        {
+            size_type vertexCount = static_cast< size_type >
+            (
+                std::distance( firstVertex, endVertex )
+            );
+
+            if( vertexCount < 3 )
+            {
+                return invalidIndex;
+            }
+
+            for( IndexIt vertex = firstVertex; vertex != endVertex; ++vertex )
+            {
+                if( static_cast< size_type >( *vertex ) >= vertexData.size() )
+                {
+                    return invalidIndex;
+                }
+            }
+
+            index_type polygon =
+                static_cast< index_type >( polygonEdges.size() );
+            index_type first = static_cast< index_type >( edges.size() );
+            index_type last = first + static_cast< index_type >
+            (
+                vertexCount - 1
+            );
+
+            // Edge i runs from vertex i to vertex i + 1
+
+            IndexIt target = firstVertex;
+            ++target;
+
+            for( index_type e = first; e <= last; ++e )
+            {
+                HalfEdge edge;
+                edge.target = static_cast< index_type >
+                (
+                    target == endVertex ? *firstVertex : *target
+                );
+                edge.next = e == last ? first : e + 1;
+                edge.previous = e == first ? last : e - 1;
+                edge.polygon = polygon;
+
+                edges.push_back( edge );
+                edgeData.push_back( BaseEdge() );
+
+                if( target != endVertex )
+                {
+                    ++target;
+                }
+            }
+
+            polygonEdges.push_back( first );
+            polygonData.push_back( basePolygon );
+            adjacencyValid = false;
+
+            return polygon;
+        }
+
+        // GET COUNTS ---------------------------------------------------------
+
+        size_type const getVertexCount( void ) const
+        {
+            return vertexData.size();
+        }
+
+        size_type const getEdgeCount( void ) const
+        {
+            return edges.size();
+        }
+
+        size_type const getPolygonCount( void ) const
+        {
+            return polygonEdges.size();
+        }
+
+        // HALF-EDGE TOPOLOGY -------------------------------------------------
+
+        HalfEdge const & getEdge( index_type edge ) const
+        {
+            return edges[ edge ];
+        }
+
+        index_type const getTargetVertex( index_type edge ) const
+        {
+            return edges[ edge ].target;
+        }
+
+        index_type const getSourceVertex( index_type edge ) const
+        {
+            return edges[ edges[ edge ].previous ].target;
+        }
+
+        index_type const getNextEdge( index_type edge ) const
+        {
+            return edges[ edge ].next;
+        }
+
+        index_type const getPreviousEdge( index_type edge ) const
+        {
+            return edges[ edge ].previous;
+        }
+
+        index_type const getPolygon( index_type edge ) const
+        {
+            return edges[ edge ].polygon;
+        }
+
+        // POLYGON TOPOLOGY ---------------------------------------------------
+
+        index_type const getStartEdge( index_type polygon ) const
+        {
+            return polygonEdges[ polygon ];
+        }
+
+        size_type const getPolygonEdgeCount( index_type polygon ) const
+        {
+            index_type first = polygonEdges[ polygon ];
+            return edges[ first ].previous - first + 1;
+        }
+
+        // BUILD ADJACENCY ----------------------------------------------------
+
+        // Indexes outgoing half-edges by source vertex, sorted by target.
+
+        // The index is built aside and then published, so copies sharing
+        // the previous index keep it.
+
+        void buildAdjacency( void )
+        {
+            PG_TRACE_SCOPE( "CompactPolygonGraph::buildAdjacency" );
+
+            std::shared_ptr< Adjacency > built =
+                std::make_shared< Adjacency >();
+            std::vector< index_type > & vertexOffsets = built->offsets;
+            std::vector< index_type > & vertexEdges = built->edges;
+            CompactPolygonGraph const & self = *this;
+
+            vertexOffsets.assign( vertexData.size() + 1, 0 );
+
+            for( index_type e = 0; e < edges.size(); ++e )
+            {
+                ++vertexOffsets[ getSourceVertex( e ) + 1 ];
+            }
+
+            for( size_type v = 0; v < vertexData.size(); ++v )
+            {
+                vertexOffsets[ v + 1 ] += vertexOffsets[ v ];
+            }
+
+            std::vector< index_type > fill( vertexOffsets.begin(),
+                                            vertexOffsets.end() - 1 );
+            vertexEdges.resize( edges.size() );
+
+            for( index_type e = 0; e < edges.size(); ++e )
+            {
+                vertexEdges[ fill[ getSourceVertex( e ) ]++ ] = e;
+            }
+
+            for( size_type v = 0; v < vertexData.size(); ++v )
+            {
+                std::sort
+                (
+                    vertexEdges.begin() + vertexOffsets[ v ],
+                    vertexEdges.begin() + vertexOffsets[ v + 1 ],
+                    [ &self ]( index_type lhs, index_type rhs )
+                    {
+                        return self.edges[ lhs ].target <
+                               self.edges[ rhs ].target;
+                    }
+                );
+            }
+
+            adjacency = built;
+            adjacencyValid = true;
+        }
+
+        bool const hasAdjacency( void ) const
+        {
+            return adjacencyValid;
+        }
+
+        // VERTEX TOPOLOGY ----------------------------------------------------
+
+        // Outgoing half-edges of a vertex are [ begin, end ). These
+        // require a valid adjacency.
+
+        index_type const * beginOutgoingEdges( index_type vertex ) const
+        {
+            return adjacency->edges.data() + adjacency->offsets[ vertex ];
+        }
+
+        index_type const * endOutgoingEdges( index_type vertex ) const
+        {
+            return adjacency->edges.data() +
+                   adjacency->offsets[ vertex + 1 ];
+        }
+
+        size_type const getVertexEdgeCount( index_type vertex ) const
+        {
+            return adjacency->offsets[ vertex + 1 ] -
+                   adjacency->offsets[ vertex ];
+        }
+
+        // FIND EDGE ----------------------------------------------------------
+
+        // Returns a half-edge from source to target, or invalidIndex.
+
+        index_type const findEdge( index_type source, index_type target ) const
+        {
+            index_type const * end = endOutgoingEdges( source );
+            index_type const * edge = std::lower_bound
+            (
+                beginOutgoingEdges( source ), end, target,
+                [ this ]( index_type lhs, index_type value )
+                {
+                    return edges[ lhs ].target < value;
+                }
+            );
+
+            return edge != end && edges[ *edge ].target == target
+                   ? *edge : invalidIndex;
+        }
+
+        // GET TWIN -----------------------------------------------------------
+
+        index_type const getTwin( index_type edge ) const
+        {
+            return findEdge( edges[ edge ].target, getSourceVertex( edge ) );
+        }
+
+        // PAYLOADS -----------------------------------------------------------
+
+        BaseVertex & getVertex( index_type vertex )
+        {
+            return vertexData.getMutable( vertex );
+        }
+
+        BaseVertex const & getVertex( index_type vertex ) const
+        {
+            return vertexData[ vertex ];
+        }
+
+        BaseEdge & getEdgeData( index_type edge )
+        {
+            return edgeData.getMutable( edge );
+        }
+
+        BaseEdge const & getEdgeData( index_type edge ) const
+        {
+            return edgeData[ edge ];
+        }
+
+        BasePolygon & getPolygonData( index_type polygon )
+        {
+            return polygonData.getMutable( polygon );
+        }
+
+        BasePolygon const & getPolygonData( index_type polygon ) const
+        {
+            return polygonData[ polygon ];
+        }
+
+        // CLEAR --------------------------------------------------------------
+
+        void clear( void )
+        {
+            edges.clear();
+            polygonEdges.clear();
+            adjacency = std::make_shared< Adjacency >();
+            vertexData.clear();
+            edgeData.clear();
+            polygonData.clear();
+            adjacencyValid = true;
+        }
+
+        // GET MEMORY BYTES ---------------------------------------------------
+
+        // Bytes held by all arrays, payloads included, whether or not
+        // they are shared with copies.
+
+        size_type const getMemoryBytes( void ) const
+        {
+            return edges.getBytes() + polygonEdges.getBytes() +
+                   getAdjacencyBytes() +
+                   vertexData.getBytes() + edgeData.getBytes() +
+                   polygonData.getBytes();
+        }
+
+        // Bytes held by this graph alone, which copying it would not share.
+        // A fork of a graph reports only the chunks it has written to.
+
+        size_type const getUniqueMemoryBytes( void ) const
+        {
+            return edges.getUniqueBytes() + polygonEdges.getUniqueBytes() +
+                   ( adjacency.use_count() == 1 ? getAdjacencyBytes() : 0 ) +
+                   vertexData.getUniqueBytes() +
+                   edgeData.getUniqueBytes() +
+                   polygonData.getUniqueBytes();
+        }
+
+        // ASSIGN -------------------------------------------------------------
+
+        // Replaces the contents with a copy of a polygon graph. Vertices and
+        // polygons are numbered in the graph's iteration order.
+
+        void assign( Graph const & graph )
+        {
+            typedef typename Graph::ConstVertexIterator ConstVertexIterator;
+            typedef typename Graph::ConstPolygonIterator ConstPolygonIterator;
+            typedef typename Graph::Vertex Vertex;
+            typedef typename Graph::Edge Edge;
+
+            PG_TRACE_SCOPE( "CompactPolygonGraph::assign" );
+
+            clear();
+
+            std::unordered_map< Vertex const *, index_type > indices;
+            indices.reserve( graph.getVertexCount() );
+            vertexData.reserve( graph.getVertexCount() );
+
+            ConstVertexIterator vertexItEnd = graph.cendVertices();
+            ConstVertexIterator vertexIt = graph.cbeginVertices();
+
+            while( vertexIt != vertexItEnd )
+            {
+                indices[ &( *vertexIt ) ] = addVertex( *vertexIt );
+                ++vertexIt;
+            }
+
+            edges.reserve( graph.getEdgeCount() );
+            edgeData.reserve( graph.getEdgeCount() );
+            polygonEdges.reserve( graph.getPolygonCount() );
+            polygonData.reserve( graph.getPolygonCount() );
+
+            std::vector< index_type > ring;
+            ConstPolygonIterator polyItEnd = graph.cendPolygons();
+            ConstPolygonIterator polyIt = graph.cbeginPolygons();
+
+            while( polyIt != polyItEnd )
+            {
+                // Start from the start edge's source vertex
+
+                Edge const * startEdge = polyIt->getStartEdge();
+                Edge const * edge = startEdge;
+                ring.clear();
+
+                do
+                {
+                    ring.push_back
+                    (
+                        indices[ &( *edge->getPreviousEdge()->
+                                        getTargetVertex() ) ]
+                    );
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
+
+                index_type polygon =
+                    addPolygon( ring.begin(), ring.end(), *polyIt );
+                index_type compactEdge = polygonEdges[ polygon ];
+
+                do
+                {
+                    edgeData.getMutable( compactEdge++ ) = *edge;
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
+
+                ++polyIt;
+            }
+
+            buildAdjacency();
+        }
+
+        // EXPORT -------------------------------------------------------------
+
+        // Appends the contents to a polygon graph. When vertexHandles is
+        // given it receives the graph vertex for each compact vertex.
+
+        void exportTo
+        (
+            Graph & graph,
+            std::vector< typename Graph::VertexIterator > * vertexHandles =
+                nullptr
+        ) const
+        {
+            typedef typename Graph::VertexIterator VertexIterator;
+            typedef typename Graph::PolygonIterator PolygonIterator;
+            typedef typename Graph::Edge Edge;
+
+            std::vector< VertexIterator > handles;
+            handles.reserve( vertexData.size() );
+
+            for( size_type v = 0; v < vertexData.size(); ++v )
+            {
+                handles.push_back( graph.addVertex( vertexData[ v ] ) );
+            }
+
+            std::vector< VertexIterator > ring;
+
+            for( size_type p = 0; p < polygonEdges.size(); ++p )
+            {
+                index_type first = polygonEdges[ p ];
+                index_type last = edges[ first ].previous;
+                ring.clear();
+
+                for( index_type e = first; e <= last; ++e )
+                {
+                    ring.push_back( handles[ getSourceVertex( e ) ] );
+                }
+
+                PolygonIterator polygon = graph.addPolygon
+                (
+                    ring.begin(), ring.end(), polygonData[ p ]
+                );
+                Edge * edge = polygon->getStartEdge();
+
+                for( index_type e = first; e <= last; ++e )
+                {
+                    static_cast< BaseEdge & >( *edge ) = edgeData[ e ];
+                    edge = edge->getNextEdge();
+                }
+            }
+
+            if( vertexHandles != nullptr )
+            {
+                vertexHandles->swap( handles );
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // Outgoing half-edges per vertex, as offsets into an edge array
+
+        class Adjacency
+        {
+            public:
+
+            std::vector< index_type > offsets;
+            std::vector< index_type > edges;
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        size_type const getAdjacencyBytes( void ) const
+        {
+            return ( adjacency->offsets.capacity() +
+                     adjacency->edges.capacity() ) * sizeof( index_type );
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        static_assert( sizeof( HalfEdge ) == 16,
+                       "compact half-edges must be 16 bytes" );
+
+        detail::CowArray< HalfEdge > edges;
+        detail::CowArray< index_type > polygonEdges;
+
+        std::shared_ptr< Adjacency const > adjacency;
+        bool adjacencyValid;
+
+        detail::PayloadArray< BaseVertex > vertexData;
+        detail::PayloadArray< BaseEdge > edgeData;
+        detail::PayloadArray< BasePolygon > polygonData;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_COMPACT_H
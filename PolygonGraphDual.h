@@ -0,0 +1,479 @@
+#ifndef POLYGON_GRAPH_DUAL_H
+#define POLYGON_GRAPH_DUAL_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // TWIN TABLE ---------------------------------------------------------
+
+        // Open-addressing table of half-edges keyed on their source and
+        // target vertices, filled concurrently by lock-free inserts. Each
+        // slot stores only the edge; its key is recovered from the edge.
+
+        template< class Edge >
+        class TwinTable
+        {
+            public:
+
+            TwinTable( std::size_t edgeCount )
+            {
+                std::size_t capacity = 16;
+
+                while( capacity < edgeCount * 2 )
+                {
+                    capacity *= 2;
+                }
+
+                mask = capacity - 1;
+                slots.reset( new std::atomic< Edge * >[ capacity ] );
+
+                for( std::size_t s = 0; s < capacity; ++s )
+                {
+                    slots[ s ].store( nullptr, std::memory_order_relaxed );
+                }
+            }
+
+            void insert( Edge * edge )
+            {
+                std::size_t slot = hashVertexPair
+                (
+                    getSource( edge ), &( *edge->getTargetVertex() )
+                ) & mask;
+
+                for( ;; )
+                {
+                    Edge * expected = nullptr;
+
+                    if( slots[ slot ].compare_exchange_strong
+                        (
+                            expected, edge, std::memory_order_relaxed
+                        ) )
+                    {
+                        return;
+                    }
+
+                    slot = ( slot + 1 ) & mask;
+                }
+            }
+
+            // Calls function( Edge * ) for every edge from target to
+            // source, i.e. every twin of a source to target edge.
+
+            template< class Function >
+            void forEachTwin
+            (
+                void const * source,
+                void const * target,
+                Function function
+            ) const
+            {
+                std::size_t slot = hashVertexPair( target, source ) & mask;
+                Edge * edge = nullptr;
+
+                while( ( edge = slots[ slot ].load
+                         (
+                             std::memory_order_relaxed
+                         ) ) != nullptr )
+                {
+                    if( getSource( edge ) == target &&
+                        &( *edge->getTargetVertex() ) == source )
+                    {
+                        function( edge );
+                    }
+
+                    slot = ( slot + 1 ) & mask;
+                }
+            }
+
+            static void const * getSource( Edge * edge )
+            {
+                return &( *edge->getPreviousEdge()->getTargetVertex() );
+            }
+
+            private:
+
+            std::unique_ptr< std::atomic< Edge * >[] > slots;
+            std::size_t mask;
+        };
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // FACE ADJACENCY CLASS +++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Polygon adjacency in compressed sparse row form. Polygon i's
+    // neighbours are neighbours[ offsets[ i ] ] up to offsets[ i + 1 ], with
+    // one entry per shared edge; sharedEdges holds the matching half-edge
+    // of polygon i and twinEdges the neighbour's half-edge running the
+    // other way. polygons maps indices back to graph handles.
+
+    template< class Traits = DefaultPGTraits >
+    class FaceAdjacency
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::Polygon Polygon;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+
+        static std::uint32_t const noPolygon = 0xffffffffu;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // GET POLYGON COUNT --------------------------------------------------
+
+        size_type const getPolygonCount( void ) const
+        {
+            return polygons.size();
+        }
+
+        // GET INDEX ----------------------------------------------------------
+
+        // Returns noPolygon for polygons not in the adjacency.
+
+        std::uint32_t const getIndex( PolygonIterator polygon ) const
+        {
+            typename std::unordered_map< Polygon const *, std::uint32_t >::
+                const_iterator it = indices.find( &( *polygon ) );
+
+            return it == indices.end() ? noPolygon : it->second;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC DATA ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        std::vector< std::uint32_t > offsets;
+        std::vector< std::uint32_t > neighbours;
+        std::vector< Edge * > sharedEdges;
+        std::vector< Edge * > twinEdges;
+        std::vector< PolygonIterator > polygons;
+        std::unordered_map< Polygon const *, std::uint32_t > indices;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    template< class Traits >
+    std::uint32_t const FaceAdjacency< Traits >::noPolygon;
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // DUAL CONSTRUCTION FUNCTIONS ++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // BUILD DUAL -------------------------------------------------------------
+
+    // Builds the face adjacency of a graph. Polygons are indexed in graph
+    // order, then all half-edges are hashed on (source, target) and each
+    // polygon's twins are looked up, both in parallel. Runs in time linear
+    // in the number of half-edges.
+
+    template< class Traits >
+    void buildDual
+    (
+        PolygonGraph< Traits > & graph,
+        FaceAdjacency< Traits > & adjacency,
+        std::size_t threadCount = 0
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+
+        PG_TRACE_SCOPE( "buildDual" );
+
+        // Index polygons
+
+        adjacency.polygons.clear();
+        adjacency.indices.clear();
+        adjacency.polygons.reserve( graph.getPolygonCount() );
+        adjacency.indices.reserve( graph.getPolygonCount() );
+
+        PolygonIterator polyItEnd = graph.endPolygons();
+        PolygonIterator polyIt = graph.beginPolygons();
+
+        while( polyIt != polyItEnd )
+        {
+            adjacency.indices[ &( *polyIt ) ] =
+                static_cast< std::uint32_t >( adjacency.polygons.size() );
+            adjacency.polygons.push_back( polyIt );
+            ++polyIt;
+        }
+
+        std::size_t polygonCount = adjacency.polygons.size();
+
+        // Hash every half-edge, sizing the table from the vertex valences
+
+        std::size_t edgeCount = 0;
+
+        typename Graph::VertexIterator vertexItEnd = graph.endVertices();
+        typename Graph::VertexIterator vertexIt = graph.beginVertices();
+
+        while( vertexIt != vertexItEnd )
+        {
+            edgeCount += vertexIt->getEdgeCount();
+            ++vertexIt;
+        }
+
+        detail::TwinTable< Edge > twins( edgeCount );
+
+        parallelFor
+        (
+            polygonCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                for( std::size_t p = begin; p < end; ++p )
+                {
+                    Edge * startEdge = adjacency.polygons[ p ]->getStartEdge();
+                    Edge * edge = startEdge;
+
+                    do
+                    {
+                        twins.insert( edge );
+                        edge = edge->getNextEdge();
+                    }
+                    while( edge != startEdge );
+                }
+            }
+        );
+
+        // Count neighbours, then fill them in at their CSR offsets
+
+        std::vector< std::uint32_t > & offsets = adjacency.offsets;
+        offsets.assign( polygonCount + 1, 0 );
+
+        for( int pass = 0; pass < 2; ++pass )
+        {
+            parallelFor
+            (
+                polygonCount, threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    for( std::size_t p = begin; p < end; ++p )
+                    {
+                        Edge * startEdge =
+                            adjacency.polygons[ p ]->getStartEdge();
+                        Edge * edge = startEdge;
+                        std::uint32_t count = 0;
+                        std::uint32_t base = pass == 0 ? 0 : offsets[ p ];
+
+                        do
+                        {
+                            twins.forEachTwin
+                            (
+                                detail::TwinTable< Edge >::getSource( edge ),
+                                &( *edge->getTargetVertex() ),
+                                [ & ]( Edge * twin )
+                                {
+                                    if( pass == 1 )
+                                    {
+                                        adjacency.neighbours[ base + count ] =
+                                            adjacency.indices.find
+                                            (
+                                                &( *twin->getPolygon() )
+                                            )->second;
+                                        adjacency.sharedEdges
+                                            [ base + count ] = edge;
+                                        adjacency.twinEdges
+                                            [ base + count ] = twin;
+                                    }
+
+                                    ++count;
+                                }
+                            );
+
+                            edge = edge->getNextEdge();
+                        }
+                        while( edge != startEdge );
+
+                        if( pass == 0 )
+                        {
+                            offsets[ p + 1 ] = count;
+                        }
+                    }
+                }
+            );
+
+            if( pass == 0 )
+            {
+                for( std::size_t p = 0; p < polygonCount; ++p )
+                {
+                    offsets[ p + 1 ] += offsets[ p ];
+                }
+
+                adjacency.neighbours.resize( offsets.back() );
+                adjacency.sharedEdges.resize( offsets.back() );
+                adjacency.twinEdges.resize( offsets.back() );
+            }
+        }
+    }
+
+    // Builds the dual mesh as a polygon graph: one dual vertex per polygon
+    // and one dual polygon per vertex whose one-ring is closed, ordered
+    // the same way round as the primal polygons. dualVertices maps each
+    // adjacency index to its dual vertex; vertices on a boundary or with
+    // non-manifold one-rings produce no dual polygon.
+
+    template< class Traits, class DualTraits >
+    void buildDual
+    (
+        PolygonGraph< Traits > & graph,
+        FaceAdjacency< Traits > & adjacency,
+        PolygonGraph< DualTraits > & dual,
+        std::vector< typename PolygonGraph< DualTraits >::VertexIterator > &
+            dualVertices,
+        std::size_t threadCount = 0
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef PolygonGraph< DualTraits > Dual;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::EdgeIterator EdgeIterator;
+        typedef typename Graph::VertexIterator VertexIterator;
+        typedef typename Dual::VertexIterator DualVertexIterator;
+        typedef IndexedIterator< DualVertexIterator, std::uint32_t >
+            IndexIter;
+
+        PG_TRACE_SCOPE( "buildDualGraph" );
+
+        buildDual( graph, adjacency, threadCount );
+
+        // Index vertices
+
+        std::vector< VertexIterator > vertices;
+        vertices.reserve( graph.getVertexCount() );
+
+        VertexIterator vertexItEnd = graph.endVertices();
+        VertexIterator vertexIt = graph.beginVertices();
+
+        while( vertexIt != vertexItEnd )
+        {
+            vertices.push_back( vertexIt );
+            ++vertexIt;
+        }
+
+        // Walk each one-ring from polygon to polygon across shared edges
+
+        std::vector< std::vector< std::uint32_t > > rings( vertices.size() );
+
+        parallelFor
+        (
+            vertices.size(), threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                for( std::size_t v = begin; v < end; ++v )
+                {
+                    VertexIterator vertex = vertices[ v ];
+                    std::size_t valence = vertex->getEdgeCount();
+
+                    if( valence < 3 )
+                    {
+                        continue;
+                    }
+
+                    std::vector< std::uint32_t > & ring = rings[ v ];
+                    EdgeIterator first = vertex->beginEdges();
+                    Edge * startEdge = &( *first );
+                    Edge * edge = startEdge;
+
+                    do
+                    {
+                        std::uint32_t polygon =
+                            adjacency.getIndex( edge->getPolygon() );
+                        ring.push_back( polygon );
+
+                        // Next outgoing edge is the twin of the incoming one
+
+                        Edge * incoming = edge->getPreviousEdge();
+                        Edge * next = nullptr;
+                        std::uint32_t twinCount = 0;
+
+                        for( std::uint32_t n = adjacency.offsets[ polygon ];
+                             n < adjacency.offsets[ polygon + 1 ]; ++n )
+                        {
+                            if( adjacency.sharedEdges[ n ] == incoming )
+                            {
+                                next = adjacency.twinEdges[ n ];
+                                ++twinCount;
+                            }
+                        }
+
+                        if( twinCount != 1 || ring.size() > valence )
+                        {
+                            ring.clear();
+                            break;
+                        }
+
+                        edge = next;
+                    }
+                    while( edge != startEdge );
+
+                    if( ring.size() != valence )
+                    {
+                        ring.clear();
+                    }
+                }
+            }
+        );
+
+        // Add dual vertices and polygons
+
+        dualVertices.clear();
+        dualVertices.reserve( adjacency.getPolygonCount() );
+
+        for( std::size_t p = 0; p < adjacency.getPolygonCount(); ++p )
+        {
+            dualVertices.push_back( dual.addVertex() );
+        }
+
+        DualVertexIterator const * table =
+            dualVertices.empty() ? nullptr : &( dualVertices[ 0 ] );
+
+        for( std::size_t v = 0; v < rings.size(); ++v )
+        {
+            if( !rings[ v ].empty() )
+            {
+                std::uint32_t const * ring = &( rings[ v ][ 0 ] );
+
+                dual.addPolygon( IndexIter( table, ring ),
+                                 IndexIter( table,
+                                            ring + rings[ v ].size() ) );
+            }
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_DUAL_H
@@ -0,0 +1,625 @@
+#ifndef POLYGON_GRAPH_GENERATORS_H
+#define POLYGON_GRAPH_GENERATORS_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Lazy traversals need C++20 coroutines; the header is empty without them.
+
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "PolygonGraph.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // GENERATOR CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Move-only range over the values a coroutine yields. Each value is
+    // produced on demand, and destroying the generator part way through
+    // ends the traversal and frees its state. An exception escaping the
+    // coroutine is rethrown from the begin or increment that resumed it,
+    // after which the range is at its end.
+
+    template< class T >
+    class Generator
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // PROMISE TYPE -------------------------------------------------------
+
+        class promise_type
+        {
+            public:
+
+            Generator get_return_object( void )
+            {
+                return Generator( Handle::from_promise( *this ) );
+            }
+
+            std::suspend_always initial_suspend( void ) noexcept
+            {
+                return std::suspend_always();
+            }
+
+            std::suspend_always final_suspend( void ) noexcept
+            {
+                return std::suspend_always();
+            }
+
+            std::suspend_always yield_value( T value )
+            {
+                this->value = std::move( value );
+                return std::suspend_always();
+            }
+
+            void return_void( void )
+            {
+                // empty
+            }
+
+            void unhandled_exception( void )
+            {
+                this->exception = std::current_exception();
+            }
+
+            // Rethrows, once, an exception the coroutine let escape
+
+            void rethrowException( void )
+            {
+                if( exception )
+                {
+                    std::exception_ptr escaped = std::move( exception );
+                    exception = nullptr;
+                    std::rethrow_exception( escaped );
+                }
+            }
+
+            T value;
+            std::exception_ptr exception;
+        };
+
+        typedef std::coroutine_handle< promise_type > Handle;
+
+        // ITERATOR -----------------------------------------------------------
+
+        class Iterator
+        {
+            public:
+
+            typedef std::input_iterator_tag     iterator_category;
+            typedef T                           value_type;
+            typedef std::ptrdiff_t              difference_type;
+            typedef T const *                   pointer;
+            typedef T const &                   reference;
+
+            Iterator( void )
+            {
+                // empty
+            }
+
+            explicit Iterator( Handle handle )
+            {
+                this->handle = handle;
+            }
+
+            bool const operator == ( Iterator const & other ) const
+            {
+                return isDone() == other.isDone();
+            }
+
+            bool const operator != ( Iterator const & other ) const
+            {
+                return isDone() != other.isDone();
+            }
+
+            T const & operator * ( void ) const
+            {
+                return handle.promise().value;
+            }
+
+            T const * operator -> ( void ) const
+            {
+                return &( handle.promise().value );
+            }
+
+            Iterator & operator ++ ( void ) // prefix
+            {
+                handle.resume();
+                handle.promise().rethrowException();
+                return *this;
+            }
+
+            void operator ++ ( int ) // postfix
+            {
+                handle.resume();
+                handle.promise().rethrowException();
+            }
+
+            private:
+
+            bool const isDone( void ) const
+            {
+                return !handle || handle.done();
+            }
+
+            Handle handle;
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        explicit Generator( Handle handle )
+        {
+            this->handle = handle;
+        }
+
+        Generator( Generator && other )
+        {
+            this->handle = other.handle;
+            other.handle = Handle();
+        }
+
+        Generator( Generator const & ) = delete;
+
+        // DESTRUCTOR ---------------------------------------------------------
+
+        ~Generator( void )
+        {
+            if( handle )
+            {
+                handle.destroy();
+            }
+        }
+
+        // BEGIN / END --------------------------------------------------------
+
+        // Begin runs the coroutine to its first value
+
+        Iterator begin( void )
+        {
+            if( handle )
+            {
+                handle.resume();
+                handle.promise().rethrowException();
+            }
+
+            return Iterator( handle );
+        }
+
+        Iterator end( void )
+        {
+            return Iterator();
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        Generator & operator = ( Generator && other )
+        {
+            if( this != &other )
+            {
+                if( handle )
+                {
+                    handle.destroy();
+                }
+
+                this->handle = other.handle;
+                other.handle = Handle();
+            }
+
+            return *this;
+        }
+
+        Generator & operator = ( Generator const & ) = delete;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        Handle handle;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // VISITED SET --------------------------------------------------------
+
+        // Set of element addresses marked during one traversal. Graph
+        // elements have no dense indices, so instead of a bitset this is a
+        // linear-probing table whose slots are stamped with a generation.
+        // Slots from earlier generations count as empty, so reset is O(1)
+        // and the table keeps its capacity between traversals.
+
+        class VisitedSet
+        {
+            public:
+
+            VisitedSet( void )
+            {
+                generation = 1;
+                count = 0;
+                mask = 0;
+            }
+
+            void reset( void )
+            {
+                count = 0;
+
+                if( ++generation == 0 )
+                {
+                    for( std::size_t s = 0; s < slots.size(); ++s )
+                    {
+                        slots[ s ].stamp = 0;
+                    }
+
+                    generation = 1;
+                }
+            }
+
+            // Marks an element, returning false if it was already marked
+
+            bool const insert( void const * key )
+            {
+                if( ( count + 1 ) * 2 > slots.size() )
+                {
+                    grow();
+                }
+
+                std::size_t slot = getSlot( key );
+
+                if( slots[ slot ].stamp == generation )
+                {
+                    return false;
+                }
+
+                slots[ slot ].key = key;
+                slots[ slot ].stamp = generation;
+                ++count;
+
+                return true;
+            }
+
+            bool const contains( void const * key ) const
+            {
+                return !slots.empty() &&
+                       slots[ getSlot( key ) ].stamp == generation;
+            }
+
+            private:
+
+            class Slot
+            {
+                public:
+
+                void const * key;
+                std::uint32_t stamp;
+            };
+
+            // Returns the key's slot, or the empty slot ending its run
+
+            std::size_t const getSlot( void const * key ) const
+            {
+                std::uint64_t h = reinterpret_cast< std::uintptr_t >( key );
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+
+                std::size_t slot = static_cast< std::size_t >( h ) & mask;
+
+                while( slots[ slot ].stamp == generation &&
+                       slots[ slot ].key != key )
+                {
+                    slot = ( slot + 1 ) & mask;
+                }
+
+                return slot;
+            }
+
+            void grow( void )
+            {
+                std::vector< Slot > old( slots.size() < 32
+                                         ? 64 : slots.size() * 2,
+                                         Slot{ nullptr, 0 } );
+                old.swap( slots );
+                mask = slots.size() - 1;
+
+                for( std::size_t s = 0; s < old.size(); ++s )
+                {
+                    if( old[ s ].stamp == generation )
+                    {
+                        slots[ getSlot( old[ s ].key ) ] = old[ s ];
+                    }
+                }
+            }
+
+            std::vector< Slot > slots;
+            std::uint32_t generation;
+            std::size_t count;
+            std::size_t mask;
+        };
+
+        // VISITED LEASE ------------------------------------------------------
+
+        // Borrows a cleared visited set from the calling thread's pool and
+        // returns it when the traversal ends, so repeated traversals reuse
+        // grown tables instead of allocating.
+
+        class VisitedLease
+        {
+            public:
+
+            VisitedLease( void )
+            {
+                std::vector< std::unique_ptr< VisitedSet > > & pool =
+                    getPool();
+
+                if( pool.empty() )
+                {
+                    set.reset( new VisitedSet() );
+                }
+                else
+                {
+                    set = std::move( pool.back() );
+                    pool.pop_back();
+                }
+
+                set->reset();
+            }
+
+            ~VisitedLease( void )
+            {
+                getPool().push_back( std::move( set ) );
+            }
+
+            VisitedLease( VisitedLease const & ) = delete;
+            VisitedLease & operator = ( VisitedLease const & ) = delete;
+
+            VisitedSet & operator * ( void ) const
+            {
+                return *set;
+            }
+
+            VisitedSet * operator -> ( void ) const
+            {
+                return set.get();
+            }
+
+            private:
+
+            static std::vector< std::unique_ptr< VisitedSet > > &
+                getPool( void )
+            {
+                thread_local std::vector< std::unique_ptr< VisitedSet > >
+                    pool;
+                return pool;
+            }
+
+            std::unique_ptr< VisitedSet > set;
+        };
+
+        // GET TWIN EDGE ------------------------------------------------------
+
+        // Returns a half-edge running opposite to edge, or nullptr.
+
+        template< class Traits >
+        typename PolygonGraph< Traits >::Edge * getTwinEdge
+        (
+            PolygonGraph< Traits > & graph,
+            typename PolygonGraph< Traits >::Edge * edge
+        )
+        {
+            return graph.findEdge
+            (
+                edge->getTargetVertex(),
+                edge->getPreviousEdge()->getTargetVertex()
+            );
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // TRAVERSAL GENERATORS +++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // The graph must not be modified while a traversal is suspended.
+
+    // FACE BREADTH FIRST -----------------------------------------------------
+
+    // Yields polygons in breadth-first order from seed, stepping across
+    // shared edges, including every polygon sharing a non-manifold edge.
+
+    template< class Traits >
+    Generator< typename PolygonGraph< Traits >::PolygonIterator >
+    faceBreadthFirst
+    (
+        PolygonGraph< Traits > &,
+        typename PolygonGraph< Traits >::PolygonIterator seed
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+        typedef typename Graph::EdgeIterator EdgeIterator;
+        typedef typename Graph::Edge Edge;
+
+        detail::VisitedLease visited;
+        std::vector< PolygonIterator > queue;
+        std::size_t head = 0;
+
+        visited->insert( &( *seed ) );
+        queue.push_back( seed );
+
+        while( head < queue.size() )
+        {
+            PolygonIterator polygon = queue[ head++ ];
+            co_yield polygon;
+
+            for( Edge & edge : polygon->getEdges() )
+            {
+                // Opposite edges run from this edge's target to its source
+
+                std::pair< EdgeIterator, EdgeIterator > twins =
+                    edge.getTargetVertex()->findEdges
+                    (
+                        edge.getPreviousEdge()->getTargetVertex()
+                    );
+
+                for( EdgeIterator twin = twins.first; twin != twins.second;
+                     ++twin )
+                {
+                    PolygonIterator neighbour = twin->getPolygon();
+
+                    if( visited->insert( &( *neighbour ) ) )
+                    {
+                        queue.push_back( neighbour );
+                    }
+                }
+            }
+        }
+    }
+
+    // VERTEX RING ------------------------------------------------------------
+
+    // Yields the vertices within ringCount edges of centre, ring by ring
+    // and starting with centre itself. Edges are followed in either
+    // direction, so boundary vertices reach all their neighbours.
+
+    template< class Traits >
+    Generator< typename PolygonGraph< Traits >::VertexIterator > vertexRing
+    (
+        PolygonGraph< Traits > &,
+        typename PolygonGraph< Traits >::VertexIterator centre,
+        std::size_t ringCount
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::VertexIterator VertexIterator;
+        typedef typename Graph::Edge Edge;
+
+        detail::VisitedLease visited;
+        std::vector< VertexIterator > ring;
+        std::vector< VertexIterator > nextRing;
+
+        visited->insert( &( *centre ) );
+        ring.push_back( centre );
+        co_yield centre;
+
+        for( std::size_t r = 0; r < ringCount && !ring.empty(); ++r )
+        {
+            nextRing.clear();
+
+            for( std::size_t v = 0; v < ring.size(); ++v )
+            {
+                for( Edge & edge : ring[ v ]->getOutgoingEdges() )
+                {
+                    // Outgoing edge's target, and source of the edge
+                    // entering the vertex before it
+
+                    VertexIterator neighbours[ 2 ] =
+                    {
+                        edge.getTargetVertex(),
+                        edge.getPreviousEdge()->getPreviousEdge()->
+                            getTargetVertex()
+                    };
+
+                    for( VertexIterator neighbour : neighbours )
+                    {
+                        if( visited->insert( &( *neighbour ) ) )
+                        {
+                            nextRing.push_back( neighbour );
+                            co_yield neighbour;
+                        }
+                    }
+                }
+            }
+
+            ring.swap( nextRing );
+        }
+    }
+
+    // BOUNDARY WALK ----------------------------------------------------------
+
+    // Yields the boundary half-edges of the loop containing start, a
+    // half-edge with no opposite, in order around the loop. From each
+    // edge's target the walk turns through the polygons around the
+    // target until it reaches the next edge without an opposite. It
+    // stops early if the loop cannot be followed, as at some
+    // non-manifold vertices.
+
+    template< class Traits >
+    Generator< typename PolygonGraph< Traits >::Edge * > boundaryWalk
+    (
+        PolygonGraph< Traits > & graph,
+        typename PolygonGraph< Traits >::Edge * start
+    )
+    {
+        typedef typename PolygonGraph< Traits >::Edge Edge;
+
+        detail::VisitedLease visited;
+        Edge * edge = start;
+
+        while( visited->insert( edge ) )
+        {
+            co_yield edge;
+
+            // Turn around the target vertex until a boundary edge leaves it
+
+            Edge * candidate = edge->getNextEdge();
+            std::size_t turns = candidate->getPreviousEdge()->
+                getTargetVertex()->getEdgeCount();
+            Edge * twin = detail::getTwinEdge( graph, candidate );
+
+            while( twin != nullptr && turns-- > 0 )
+            {
+                candidate = twin->getNextEdge();
+                twin = detail::getTwinEdge( graph, candidate );
+            }
+
+            if( twin != nullptr )
+            {
+                co_return;
+            }
+
+            edge = candidate;
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // coroutine support
+
+#endif // POLYGON_GRAPH_GENERATORS_H
@@ -0,0 +1,737 @@
+#ifndef POLYGON_GRAPH_GEOMETRY_H
+#define POLYGON_GRAPH_GEOMETRY_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+#if defined( POLYGON_GRAPH_X86_SIMD )
+#include <immintrin.h>
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // FACE KERNEL DATA ---------------------------------------------------
+
+        // Arrays read and written by the face kernels, all structure-of-
+        // arrays. Polygon p's vertex indices are indices[ offsets[ p ] ] up
+        // to offsets[ p + 1 ]; for triangle meshes they are at 3p.
+
+        class FaceKernelData
+        {
+            public:
+
+            float const * positions[ 3 ];
+            std::uint32_t const * offsets;
+            std::uint32_t const * indices;
+            float * normals[ 3 ];
+            float * areas;
+            float * centroids[ 3 ];
+        };
+
+        // TRIANGLE KERNELS ---------------------------------------------------
+
+        // Unit normal, area and centroid of triangles [ begin, end ). The
+        // normal of a degenerate triangle is zero. The vector kernels
+        // follow the scalar one operation for operation, so results agree
+        // up to rounding, and use it for their remainders.
+
+        inline void computeTrianglesScalar
+        (
+            FaceKernelData const & data,
+            std::size_t begin,
+            std::size_t end
+        )
+        {
+            float const * x = data.positions[ 0 ];
+            float const * y = data.positions[ 1 ];
+            float const * z = data.positions[ 2 ];
+
+            for( std::size_t t = begin; t < end; ++t )
+            {
+                std::uint32_t a = data.indices[ t * 3 ];
+                std::uint32_t b = data.indices[ t * 3 + 1 ];
+                std::uint32_t c = data.indices[ t * 3 + 2 ];
+
+                float e1x = x[ b ] - x[ a ];
+                float e1y = y[ b ] - y[ a ];
+                float e1z = z[ b ] - z[ a ];
+                float e2x = x[ c ] - x[ a ];
+                float e2y = y[ c ] - y[ a ];
+                float e2z = z[ c ] - z[ a ];
+
+                float nx = e1y * e2z - e1z * e2y;
+                float ny = e1z * e2x - e1x * e2z;
+                float nz = e1x * e2y - e1y * e2x;
+
+                float length = std::sqrt( nx * nx + ny * ny + nz * nz );
+                float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+                float third = 1.0f / 3.0f;
+
+                data.normals[ 0 ][ t ] = nx * inverse;
+                data.normals[ 1 ][ t ] = ny * inverse;
+                data.normals[ 2 ][ t ] = nz * inverse;
+                data.areas[ t ] = 0.5f * length;
+                data.centroids[ 0 ][ t ] =
+                    ( x[ a ] + x[ b ] + x[ c ] ) * third;
+                data.centroids[ 1 ][ t ] =
+                    ( y[ a ] + y[ b ] + y[ c ] ) * third;
+                data.centroids[ 2 ][ t ] =
+                    ( z[ a ] + z[ b ] + z[ c ] ) * third;
+            }
+        }
+
+        #if defined( POLYGON_GRAPH_X86_SIMD )
+
+        __attribute__(( target( "avx2" ) ))
+        inline void computeTrianglesAvx2
+        (
+            FaceKernelData const & data,
+            std::size_t begin,
+            std::size_t end
+        )
+        {
+            __m256i const stride =
+                _mm256_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21 );
+            __m256 const zero = _mm256_setzero_ps();
+            __m256 const one = _mm256_set1_ps( 1.0f );
+            __m256 const half = _mm256_set1_ps( 0.5f );
+            __m256 const third = _mm256_set1_ps( 1.0f / 3.0f );
+
+            std::size_t t = begin;
+
+            for( ; t + 8 <= end; t += 8 )
+            {
+                int const * corners =
+                    reinterpret_cast< int const * >( data.indices + t * 3 );
+                __m256i corner[ 3 ];
+                __m256 p[ 3 ][ 3 ];
+
+                for( int k = 0; k < 3; ++k )
+                {
+                    corner[ k ] =
+                        _mm256_i32gather_epi32( corners + k, stride, 4 );
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        p[ k ][ axis ] = _mm256_i32gather_ps
+                        (
+                            data.positions[ axis ], corner[ k ], 4
+                        );
+                    }
+                }
+
+                __m256 e1x = _mm256_sub_ps( p[ 1 ][ 0 ], p[ 0 ][ 0 ] );
+                __m256 e1y = _mm256_sub_ps( p[ 1 ][ 1 ], p[ 0 ][ 1 ] );
+                __m256 e1z = _mm256_sub_ps( p[ 1 ][ 2 ], p[ 0 ][ 2 ] );
+                __m256 e2x = _mm256_sub_ps( p[ 2 ][ 0 ], p[ 0 ][ 0 ] );
+                __m256 e2y = _mm256_sub_ps( p[ 2 ][ 1 ], p[ 0 ][ 1 ] );
+                __m256 e2z = _mm256_sub_ps( p[ 2 ][ 2 ], p[ 0 ][ 2 ] );
+
+                __m256 nx = _mm256_sub_ps( _mm256_mul_ps( e1y, e2z ),
+                                           _mm256_mul_ps( e1z, e2y ) );
+                __m256 ny = _mm256_sub_ps( _mm256_mul_ps( e1z, e2x ),
+                                           _mm256_mul_ps( e1x, e2z ) );
+                __m256 nz = _mm256_sub_ps( _mm256_mul_ps( e1x, e2y ),
+                                           _mm256_mul_ps( e1y, e2x ) );
+
+                __m256 length = _mm256_sqrt_ps
+                (
+                    _mm256_add_ps
+                    (
+                        _mm256_add_ps( _mm256_mul_ps( nx, nx ),
+                                       _mm256_mul_ps( ny, ny ) ),
+                        _mm256_mul_ps( nz, nz )
+                    )
+                );
+                __m256 inverse = _mm256_and_ps
+                (
+                    _mm256_div_ps( one, length ),
+                    _mm256_cmp_ps( length, zero, _CMP_GT_OQ )
+                );
+
+                _mm256_storeu_ps( data.normals[ 0 ] + t,
+                                  _mm256_mul_ps( nx, inverse ) );
+                _mm256_storeu_ps( data.normals[ 1 ] + t,
+                                  _mm256_mul_ps( ny, inverse ) );
+                _mm256_storeu_ps( data.normals[ 2 ] + t,
+                                  _mm256_mul_ps( nz, inverse ) );
+                _mm256_storeu_ps( data.areas + t,
+                                  _mm256_mul_ps( half, length ) );
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    __m256 sum = _mm256_add_ps
+                    (
+                        _mm256_add_ps( p[ 0 ][ axis ], p[ 1 ][ axis ] ),
+                        p[ 2 ][ axis ]
+                    );
+
+                    _mm256_storeu_ps( data.centroids[ axis ] + t,
+                                      _mm256_mul_ps( sum, third ) );
+                }
+            }
+
+            computeTrianglesScalar( data, t, end );
+        }
+
+        __attribute__(( target( "avx512f" ) ))
+        inline void computeTrianglesAvx512
+        (
+            FaceKernelData const & data,
+            std::size_t begin,
+            std::size_t end
+        )
+        {
+            __m512i const stride = _mm512_setr_epi32
+            (
+                0, 3, 6, 9, 12, 15, 18, 21,
+                24, 27, 30, 33, 36, 39, 42, 45
+            );
+            __m512 const zero = _mm512_setzero_ps();
+            __m512 const one = _mm512_set1_ps( 1.0f );
+            __m512 const half = _mm512_set1_ps( 0.5f );
+            __m512 const third = _mm512_set1_ps( 1.0f / 3.0f );
+            __mmask16 const all = 0xffff;
+
+            // Masked forms throughout: the unmasked gathers and square root
+            // start from an undefined register, which GCC 12 warns about
+
+            std::size_t t = begin;
+
+            for( ; t + 16 <= end; t += 16 )
+            {
+                int const * corners =
+                    reinterpret_cast< int const * >( data.indices + t * 3 );
+                __m512i corner[ 3 ];
+                __m512 p[ 3 ][ 3 ];
+
+                for( int k = 0; k < 3; ++k )
+                {
+                    corner[ k ] = _mm512_mask_i32gather_epi32
+                    (
+                        _mm512_setzero_si512(), all, stride, corners + k, 4
+                    );
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        p[ k ][ axis ] = _mm512_mask_i32gather_ps
+                        (
+                            zero, all, corner[ k ], data.positions[ axis ], 4
+                        );
+                    }
+                }
+
+                __m512 e1x = _mm512_sub_ps( p[ 1 ][ 0 ], p[ 0 ][ 0 ] );
+                __m512 e1y = _mm512_sub_ps( p[ 1 ][ 1 ], p[ 0 ][ 1 ] );
+                __m512 e1z = _mm512_sub_ps( p[ 1 ][ 2 ], p[ 0 ][ 2 ] );
+                __m512 e2x = _mm512_sub_ps( p[ 2 ][ 0 ], p[ 0 ][ 0 ] );
+                __m512 e2y = _mm512_sub_ps( p[ 2 ][ 1 ], p[ 0 ][ 1 ] );
+                __m512 e2z = _mm512_sub_ps( p[ 2 ][ 2 ], p[ 0 ][ 2 ] );
+
+                __m512 nx = _mm512_sub_ps( _mm512_mul_ps( e1y, e2z ),
+                                           _mm512_mul_ps( e1z, e2y ) );
+                __m512 ny = _mm512_sub_ps( _mm512_mul_ps( e1z, e2x ),
+                                           _mm512_mul_ps( e1x, e2z ) );
+                __m512 nz = _mm512_sub_ps( _mm512_mul_ps( e1x, e2y ),
+                                           _mm512_mul_ps( e1y, e2x ) );
+
+                __m512 length = _mm512_maskz_sqrt_ps
+                (
+                    all,
+                    _mm512_add_ps
+                    (
+                        _mm512_add_ps( _mm512_mul_ps( nx, nx ),
+                                       _mm512_mul_ps( ny, ny ) ),
+                        _mm512_mul_ps( nz, nz )
+                    )
+                );
+                __m512 inverse = _mm512_maskz_div_ps
+                (
+                    _mm512_cmp_ps_mask( length, zero, _CMP_GT_OQ ),
+                    one, length
+                );
+
+                _mm512_storeu_ps( data.normals[ 0 ] + t,
+                                  _mm512_mul_ps( nx, inverse ) );
+                _mm512_storeu_ps( data.normals[ 1 ] + t,
+                                  _mm512_mul_ps( ny, inverse ) );
+                _mm512_storeu_ps( data.normals[ 2 ] + t,
+                                  _mm512_mul_ps( nz, inverse ) );
+                _mm512_storeu_ps( data.areas + t,
+                                  _mm512_mul_ps( half, length ) );
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    __m512 sum = _mm512_add_ps
+                    (
+                        _mm512_add_ps( p[ 0 ][ axis ], p[ 1 ][ axis ] ),
+                        p[ 2 ][ axis ]
+                    );
+
+                    _mm512_storeu_ps( data.centroids[ axis ] + t,
+                                      _mm512_mul_ps( sum, third ) );
+                }
+            }
+
+            computeTrianglesScalar( data, t, end );
+        }
+
+        #endif
+
+        // POLYGON KERNEL -----------------------------------------------------
+
+        // Unit normal, area and centroid of polygons [ begin, end ) of any
+        // size. The normal and area come from the fan of triangles about
+        // the first vertex, which is exact for planar polygons and gives
+        // the vector area otherwise; the centroid is the vertex average.
+
+        inline void computePolygonsScalar
+        (
+            FaceKernelData const & data,
+            std::size_t begin,
+            std::size_t end
+        )
+        {
+            float const * x = data.positions[ 0 ];
+            float const * y = data.positions[ 1 ];
+            float const * z = data.positions[ 2 ];
+
+            for( std::size_t p = begin; p < end; ++p )
+            {
+                std::uint32_t first = data.offsets[ p ];
+                std::uint32_t last = data.offsets[ p + 1 ];
+                std::uint32_t a = data.indices[ first ];
+
+                float nx = 0.0f;
+                float ny = 0.0f;
+                float nz = 0.0f;
+                float cx = x[ a ];
+                float cy = y[ a ];
+                float cz = z[ a ];
+
+                for( std::uint32_t i = first + 1; i < last; ++i )
+                {
+                    std::uint32_t b = data.indices[ i ];
+
+                    cx += x[ b ];
+                    cy += y[ b ];
+                    cz += z[ b ];
+
+                    if( i + 1 == last )
+                    {
+                        break;
+                    }
+
+                    std::uint32_t c = data.indices[ i + 1 ];
+
+                    float e1x = x[ b ] - x[ a ];
+                    float e1y = y[ b ] - y[ a ];
+                    float e1z = z[ b ] - z[ a ];
+                    float e2x = x[ c ] - x[ a ];
+                    float e2y = y[ c ] - y[ a ];
+                    float e2z = z[ c ] - z[ a ];
+
+                    nx += e1y * e2z - e1z * e2y;
+                    ny += e1z * e2x - e1x * e2z;
+                    nz += e1x * e2y - e1y * e2x;
+                }
+
+                float length = std::sqrt( nx * nx + ny * ny + nz * nz );
+                float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+                float count = static_cast< float >( last - first );
+
+                data.normals[ 0 ][ p ] = nx * inverse;
+                data.normals[ 1 ][ p ] = ny * inverse;
+                data.normals[ 2 ][ p ] = nz * inverse;
+                data.areas[ p ] = 0.5f * length;
+                data.centroids[ 0 ][ p ] = cx / count;
+                data.centroids[ 1 ][ p ] = cy / count;
+                data.centroids[ 2 ][ p ] = cz / count;
+            }
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // POLYGON GEOMETRY CLASS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Per-polygon normals, areas and centroids and area-weighted vertex
+    // normals for a whole graph. build() flattens the topology into index
+    // arrays once; update() then gathers positions into structure-of-arrays
+    // and recomputes everything in parallel, so it can run every frame
+    // while only positions change. Triangle meshes use vector kernels
+    // chosen at run time from the CPU's instruction sets.
+    //
+    // Results are indexed like polygons and vertices; faceNormals[ axis ]
+    // [ p ] is a component of polygon p's unit normal.
+
+    template< class Traits = DefaultPGTraits,
+              class PositionAccessor = MemberPosition >
+    class PolygonGeometry
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::Polygon Polygon;
+        typedef typename Graph::VertexIterator VertexIterator;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PolygonGeometry( PositionAccessor accessor = PositionAccessor() )
+        {
+            this->accessor = accessor;
+            this->triangleMesh = true;
+            this->simdLevel = getSupportedSimdLevel();
+        }
+
+        // BUILD --------------------------------------------------------------
+
+        // Indexes the graph's vertices and polygons and computes all
+        // quantities. Call again after the topology changes.
+
+        void build( Graph & graph, size_type threadCount = 0 )
+        {
+            PG_TRACE_SCOPE( "PolygonGeometry::build" );
+
+            vertices.clear();
+            polygons.clear();
+            vertexIndices.clear();
+            polygonIndices.clear();
+            vertices.reserve( graph.getVertexCount() );
+            polygons.reserve( graph.getPolygonCount() );
+            vertexIndices.reserve( graph.getVertexCount() );
+            polygonIndices.reserve( graph.getPolygonCount() );
+
+            VertexIterator vertexItEnd = graph.endVertices();
+            VertexIterator vertexIt = graph.beginVertices();
+
+            while( vertexIt != vertexItEnd )
+            {
+                vertexIndices[ &( *vertexIt ) ] =
+                    static_cast< std::uint32_t >( vertices.size() );
+                vertices.push_back( vertexIt );
+                ++vertexIt;
+            }
+
+            // Polygon rings as vertex index lists, in addPolygon order
+
+            offsets.assign( 1, 0 );
+            indices.clear();
+            triangleMesh = true;
+
+            PolygonIterator polyItEnd = graph.endPolygons();
+            PolygonIterator polyIt = graph.beginPolygons();
+
+            while( polyIt != polyItEnd )
+            {
+                polygonIndices[ &( *polyIt ) ] =
+                    static_cast< std::uint32_t >( polygons.size() );
+                polygons.push_back( polyIt );
+
+                for( VertexIterator vertex : polyIt->getVertices() )
+                {
+                    indices.push_back
+                    (
+                        vertexIndices.find( &( *vertex ) )->second
+                    );
+                }
+
+                offsets.push_back
+                (
+                    static_cast< std::uint32_t >( indices.size() )
+                );
+                triangleMesh = triangleMesh &&
+                    offsets.back() - offsets[ offsets.size() - 2 ] == 3;
+                ++polyIt;
+            }
+
+            // Polygons around each vertex, for the vertex normals
+
+            vertexFaceOffsets.assign( vertices.size() + 1, 0 );
+
+            for( size_type i = 0; i < indices.size(); ++i )
+            {
+                ++vertexFaceOffsets[ indices[ i ] + 1 ];
+            }
+
+            for( size_type v = 0; v < vertices.size(); ++v )
+            {
+                vertexFaceOffsets[ v + 1 ] += vertexFaceOffsets[ v ];
+            }
+
+            std::vector< std::uint32_t > cursors
+            (
+                vertexFaceOffsets.begin(), vertexFaceOffsets.end() - 1
+            );
+            vertexFaces.resize( indices.size() );
+
+            for( size_type p = 0; p < polygons.size(); ++p )
+            {
+                for( std::uint32_t i = offsets[ p ];
+                     i < offsets[ p + 1 ]; ++i )
+                {
+                    vertexFaces[ cursors[ indices[ i ] ]++ ] =
+                        static_cast< std::uint32_t >( p );
+                }
+            }
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                positions[ axis ].resize( vertices.size() );
+                vertexNormals[ axis ].resize( vertices.size() );
+                faceNormals[ axis ].resize( polygons.size() );
+                faceCentroids[ axis ].resize( polygons.size() );
+            }
+
+            faceAreas.resize( polygons.size() );
+
+            update( threadCount );
+        }
+
+        // UPDATE -------------------------------------------------------------
+
+        // Re-reads vertex positions and recomputes all quantities for the
+        // topology seen by the last build.
+
+        void update( size_type threadCount = 0 )
+        {
+            PG_TRACE_SCOPE( "PolygonGeometry::update" );
+
+            // Gather positions
+
+            parallelFor
+            (
+                vertices.size(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    for( std::size_t v = begin; v < end; ++v )
+                    {
+                        for( int axis = 0; axis < 3; ++axis )
+                        {
+                            positions[ axis ][ v ] = static_cast< float >
+                            (
+                                accessor( *vertices[ v ] )[ axis ]
+                            );
+                        }
+                    }
+                }
+            );
+
+            // Polygon quantities
+
+            detail::FaceKernelData data;
+            data.offsets = offsets.data();
+            data.indices = indices.data();
+            data.areas = faceAreas.data();
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                data.positions[ axis ] = positions[ axis ].data();
+                data.normals[ axis ] = faceNormals[ axis ].data();
+                data.centroids[ axis ] = faceCentroids[ axis ].data();
+            }
+
+            parallelFor
+            (
+                polygons.size(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    computeFaces( data, begin, end );
+                }
+            );
+
+            // Vertex normals, summing area-weighted face normals
+
+            parallelFor
+            (
+                vertices.size(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    computeVertexNormals( begin, end );
+                }
+            );
+        }
+
+        // GET COUNTS ---------------------------------------------------------
+
+        size_type const getVertexCount( void ) const
+        {
+            return vertices.size();
+        }
+
+        size_type const getPolygonCount( void ) const
+        {
+            return polygons.size();
+        }
+
+        bool const isTriangleMesh( void ) const
+        {
+            return triangleMesh;
+        }
+
+        // GET INDEX ----------------------------------------------------------
+
+        std::uint32_t const getIndex( VertexIterator vertex ) const
+        {
+            return vertexIndices.find( &( *vertex ) )->second;
+        }
+
+        std::uint32_t const getIndex( PolygonIterator polygon ) const
+        {
+            return polygonIndices.find( &( *polygon ) )->second;
+        }
+
+        // SIMD LEVEL ---------------------------------------------------------
+
+        // Limits the instruction set used, e.g. to compare kernels. Levels
+        // above what the CPU supports are lowered to the supported one.
+
+        void setSimdLevel( SimdLevel level )
+        {
+            SimdLevel supported = getSupportedSimdLevel();
+            simdLevel = level > supported ? supported : level;
+        }
+
+        SimdLevel const getSimdLevel( void ) const
+        {
+            return simdLevel;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC DATA ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        std::vector< VertexIterator > vertices;
+        std::vector< PolygonIterator > polygons;
+        std::vector< float > positions[ 3 ];
+        std::vector< float > faceNormals[ 3 ];
+        std::vector< float > faceAreas;
+        std::vector< float > faceCentroids[ 3 ];
+        std::vector< float > vertexNormals[ 3 ];
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // COMPUTE FACES ------------------------------------------------------
+
+        void computeFaces
+        (
+            detail::FaceKernelData const & data,
+            std::size_t begin,
+            std::size_t end
+        ) const
+        {
+            if( !triangleMesh )
+            {
+                detail::computePolygonsScalar( data, begin, end );
+                return;
+            }
+
+            #if defined( POLYGON_GRAPH_X86_SIMD )
+
+            if( simdLevel == simdAvx512 )
+            {
+                detail::computeTrianglesAvx512( data, begin, end );
+                return;
+            }
+
+            if( simdLevel == simdAvx2 )
+            {
+                detail::computeTrianglesAvx2( data, begin, end );
+                return;
+            }
+
+            #endif
+
+            detail::computeTrianglesScalar( data, begin, end );
+        }
+
+        // COMPUTE VERTEX NORMALS ---------------------------------------------
+
+        void computeVertexNormals( std::size_t begin, std::size_t end )
+        {
+            for( std::size_t v = begin; v < end; ++v )
+            {
+                float nx = 0.0f;
+                float ny = 0.0f;
+                float nz = 0.0f;
+
+                for( std::uint32_t f = vertexFaceOffsets[ v ];
+                     f < vertexFaceOffsets[ v + 1 ]; ++f )
+                {
+                    std::uint32_t face = vertexFaces[ f ];
+                    float area = faceAreas[ face ];
+
+                    nx += faceNormals[ 0 ][ face ] * area;
+                    ny += faceNormals[ 1 ][ face ] * area;
+                    nz += faceNormals[ 2 ][ face ] * area;
+                }
+
+                float length = std::sqrt( nx * nx + ny * ny + nz * nz );
+                float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+
+                vertexNormals[ 0 ][ v ] = nx * inverse;
+                vertexNormals[ 1 ][ v ] = ny * inverse;
+                vertexNormals[ 2 ][ v ] = nz * inverse;
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        PositionAccessor accessor;
+        bool triangleMesh;
+        SimdLevel simdLevel;
+
+        std::vector< std::uint32_t > offsets;
+        std::vector< std::uint32_t > indices;
+        std::vector< std::uint32_t > vertexFaceOffsets;
+        std::vector< std::uint32_t > vertexFaces;
+        std::unordered_map< Vertex const *, std::uint32_t > vertexIndices;
+        std::unordered_map< Polygon const *, std::uint32_t > polygonIndices;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_GEOMETRY_H
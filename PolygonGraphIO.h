@@ -0,0 +1,1755 @@
+#ifndef POLYGON_GRAPH_IO_H
+#define POLYGON_GRAPH_IO_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POLYGON_GRAPH_IO_MMAP
+#endif
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // MAPPED FILE CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Read-only view of a whole file. Uses mmap where available and falls
+    // back to reading the file into memory elsewhere.
+
+    class MappedFile
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        MappedFile( void )
+        {
+            mapping = nullptr;
+            length = 0;
+        }
+
+        // DESTRUCTOR ---------------------------------------------------------
+
+        ~MappedFile( void )
+        {
+            close();
+        }
+
+        // OPEN ---------------------------------------------------------------
+
+        bool const open( char const * path )
+        {
+            close();
+
+#ifdef POLYGON_GRAPH_IO_MMAP
+            int descriptor = ::open( path, O_RDONLY );
+
+            if( descriptor < 0 )
+            {
+                return false;
+            }
+
+            struct stat status;
+
+            if( fstat( descriptor, &status ) != 0 )
+            {
+                ::close( descriptor );
+                return false;
+            }
+
+            length = static_cast< std::size_t >( status.st_size );
+
+            if( length != 0 )
+            {
+                void * address = mmap( nullptr, length, PROT_READ,
+                                       MAP_PRIVATE, descriptor, 0 );
+
+                if( address == MAP_FAILED )
+                {
+                    ::close( descriptor );
+                    length = 0;
+                    return false;
+                }
+
+                madvise( address, length, MADV_SEQUENTIAL );
+                mapping = static_cast< char const * >( address );
+            }
+
+            ::close( descriptor );
+
+            return true;
+#else
+            std::FILE * file = std::fopen( path, "rb" );
+
+            if( file == nullptr )
+            {
+                return false;
+            }
+
+            char block[ 65536 ];
+            std::size_t count = 0;
+
+            while( ( count = std::fread( block, 1, sizeof( block ),
+                                         file ) ) != 0 )
+            {
+                buffer.insert( buffer.end(), block, block + count );
+            }
+
+            std::fclose( file );
+
+            mapping = buffer.empty() ? nullptr : &( buffer[ 0 ] );
+            length = buffer.size();
+
+            return true;
+#endif
+        }
+
+        // CLOSE --------------------------------------------------------------
+
+        void close( void )
+        {
+#ifdef POLYGON_GRAPH_IO_MMAP
+            if( mapping != nullptr )
+            {
+                munmap( const_cast< char * >( mapping ), length );
+            }
+#else
+            buffer.clear();
+#endif
+            mapping = nullptr;
+            length = 0;
+        }
+
+        // GET DATA -----------------------------------------------------------
+
+        char const * getData( void ) const
+        {
+            return mapping;
+        }
+
+        // GET SIZE -----------------------------------------------------------
+
+        std::size_t const getSize( void ) const
+        {
+            return length;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // NON-COPYABLE -------------------------------------------------------
+
+        MappedFile( MappedFile const & other );
+        MappedFile const & operator = ( MappedFile const & other );
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        char const * mapping;
+        std::size_t length;
+
+#ifndef POLYGON_GRAPH_IO_MMAP
+        std::vector< char > buffer;
+#endif
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // MESH CHUNK ---------------------------------------------------------
+
+        // Vertex positions and face indices parsed from one part of a file.
+        // Indices are zero based; entries listed in relativeSlots are
+        // relative to the first vertex of the chunk until resolved.
+
+        class MeshChunk
+        {
+            public:
+
+            std::vector< double > positions;
+            std::vector< long long > indices;
+            std::vector< std::size_t > faceSizes;
+            std::vector< std::size_t > relativeSlots;
+        };
+
+        // INDEX RANGE --------------------------------------------------------
+
+        // Largest vertex count or index accepted from a file. Graphs built
+        // from files are indexed with 32 bits, and the bound keeps every
+        // size computed from a header well clear of overflow.
+
+        long long const maxIndex = 0xffffffffLL;
+
+        // Converts a face index read as a double, failing on NaN, negative
+        // and out of range values instead of an undefined conversion.
+
+        inline bool const toIndex( double value, long long & index )
+        {
+            if( !( value >= 0.0 && value <= double( maxIndex ) ) )
+            {
+                return false;
+            }
+
+            index = static_cast< long long >( value );
+
+            return true;
+        }
+
+        // SKIP HELPERS -------------------------------------------------------
+
+        inline bool const isSpace( char c )
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline char const * skipSpace( char const * it, char const * end )
+        {
+            while( it != end && isSpace( *it ) )
+            {
+                ++it;
+            }
+
+            return it;
+        }
+
+        inline char const * skipBlank( char const * it, char const * end )
+        {
+            while( it != end && ( isSpace( *it ) || *it == '\n' ) )
+            {
+                ++it;
+            }
+
+            return it;
+        }
+
+        inline char const * skipLine( char const * it, char const * end )
+        {
+            while( it != end && *it != '\n' )
+            {
+                ++it;
+            }
+
+            return it == end ? end : it + 1;
+        }
+
+        inline char const * skipToken( char const * it, char const * end )
+        {
+            while( it != end && !isSpace( *it ) && *it != '\n' )
+            {
+                ++it;
+            }
+
+            return it;
+        }
+
+        // PARSE DOUBLE -------------------------------------------------------
+
+        // Copies the token into a terminated buffer so strtod never reads
+        // past the end of a mapped file.
+
+        inline bool const parseDouble
+        (
+            char const * & it,
+            char const * end,
+            double & value
+        )
+        {
+            it = skipSpace( it, end );
+            char const * tokenEnd = skipToken( it, end );
+            std::size_t length = static_cast< std::size_t >( tokenEnd - it );
+            char token[ 64 ];
+
+            if( length == 0 || length >= sizeof( token ) )
+            {
+                return false;
+            }
+
+            std::memcpy( token, it, length );
+            token[ length ] = '\0';
+
+            char * parsedEnd = nullptr;
+            value = std::strtod( token, &parsedEnd );
+            it = tokenEnd;
+
+            return parsedEnd == token + length;
+        }
+
+        // PARSE INTEGER ------------------------------------------------------
+
+        // Fails on magnitudes beyond the 32-bit index range rather than
+        // overflowing.
+
+        inline bool const parseInteger
+        (
+            char const * & it,
+            char const * end,
+            long long & value
+        )
+        {
+            bool negative = false;
+
+            if( it != end && ( *it == '-' || *it == '+' ) )
+            {
+                negative = *it == '-';
+                ++it;
+            }
+
+            if( it == end || *it < '0' || *it > '9' )
+            {
+                return false;
+            }
+
+            value = 0;
+
+            while( it != end && *it >= '0' && *it <= '9' )
+            {
+                value = value * 10 + ( *it - '0' );
+                ++it;
+
+                if( value > maxIndex )
+                {
+                    return false;
+                }
+            }
+
+            if( negative )
+            {
+                value = -value;
+            }
+
+            return true;
+        }
+
+        // PARSE OBJ CHUNK ----------------------------------------------------
+
+        inline bool const parseObjChunk
+        (
+            char const * it,
+            char const * end,
+            MeshChunk & chunk
+        )
+        {
+            long long localVertexCount = 0;
+            long long index = 0;
+            double value = 0.0;
+
+            while( it != end )
+            {
+                it = skipSpace( it, end );
+
+                if( it == end )
+                {
+                    break;
+                }
+
+                // Vertex position
+
+                if( *it == 'v' && it + 1 != end && isSpace( it[ 1 ] ) )
+                {
+                    ++it;
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        if( !parseDouble( it, end, value ) )
+                        {
+                            return false;
+                        }
+
+                        chunk.positions.push_back( value );
+                    }
+
+                    ++localVertexCount;
+                }
+
+                // Face, keeping only the position index of each corner
+
+                else if( *it == 'f' && it + 1 != end && isSpace( it[ 1 ] ) )
+                {
+                    ++it;
+                    std::size_t faceSize = 0;
+
+                    for( ;; )
+                    {
+                        it = skipSpace( it, end );
+
+                        if( it == end || *it == '\n' || *it == '#' )
+                        {
+                            break;
+                        }
+
+                        if( !parseInteger( it, end, index ) || index == 0 )
+                        {
+                            return false;
+                        }
+
+                        if( index > 0 )
+                        {
+                            chunk.indices.push_back( index - 1 );
+                        }
+                        else
+                        {
+                            chunk.relativeSlots.push_back
+                            (
+                                chunk.indices.size()
+                            );
+                            chunk.indices.push_back
+                            (
+                                localVertexCount + index
+                            );
+                        }
+
+                        it = skipToken( it, end );
+                        ++faceSize;
+                    }
+
+                    chunk.faceSizes.push_back( faceSize );
+                }
+
+                it = skipLine( it, end );
+            }
+
+            return true;
+        }
+
+        // PLY TYPES ----------------------------------------------------------
+
+        enum PlyType
+        {
+            PLY_NONE,
+            PLY_INT8,
+            PLY_UINT8,
+            PLY_INT16,
+            PLY_UINT16,
+            PLY_INT32,
+            PLY_UINT32,
+            PLY_FLOAT32,
+            PLY_FLOAT64
+        };
+
+        inline PlyType const getPlyType( std::string const & name )
+        {
+            if( name == "char" || name == "int8" )      return PLY_INT8;
+            if( name == "uchar" || name == "uint8" )    return PLY_UINT8;
+            if( name == "short" || name == "int16" )    return PLY_INT16;
+            if( name == "ushort" || name == "uint16" )  return PLY_UINT16;
+            if( name == "int" || name == "int32" )      return PLY_INT32;
+            if( name == "uint" || name == "uint32" )    return PLY_UINT32;
+            if( name == "float" || name == "float32" )  return PLY_FLOAT32;
+            if( name == "double" || name == "float64" ) return PLY_FLOAT64;
+
+            return PLY_NONE;
+        }
+
+        inline std::size_t const getPlyTypeSize( PlyType type )
+        {
+            switch( type )
+            {
+                case PLY_INT8:
+                case PLY_UINT8:     return 1;
+                case PLY_INT16:
+                case PLY_UINT16:    return 2;
+                case PLY_INT32:
+                case PLY_UINT32:
+                case PLY_FLOAT32:   return 4;
+                case PLY_FLOAT64:   return 8;
+                default:            return 0;
+            }
+        }
+
+        // IS LITTLE ENDIAN ---------------------------------------------------
+
+        inline bool const isLittleEndian( void )
+        {
+            unsigned short const probe = 1;
+            unsigned char bytes[ sizeof( probe ) ];
+            std::memcpy( bytes, &probe, sizeof( probe ) );
+
+            return bytes[ 0 ] == 1;
+        }
+
+        // READ PLY BINARY VALUE ----------------------------------------------
+
+        template< class T >
+        inline T const readRaw( char const * data, bool swap )
+        {
+            char bytes[ sizeof( T ) ];
+            std::memcpy( bytes, data, sizeof( T ) );
+
+            if( swap )
+            {
+                for( std::size_t i = 0; i < sizeof( T ) / 2; ++i )
+                {
+                    char byte = bytes[ i ];
+                    bytes[ i ] = bytes[ sizeof( T ) - 1 - i ];
+                    bytes[ sizeof( T ) - 1 - i ] = byte;
+                }
+            }
+
+            T value;
+            std::memcpy( &value, bytes, sizeof( T ) );
+
+            return value;
+        }
+
+        inline double const readPlyValue
+        (
+            char const * data,
+            PlyType type,
+            bool swap
+        )
+        {
+            switch( type )
+            {
+                case PLY_INT8:
+                    return readRaw< signed char >( data, swap );
+                case PLY_UINT8:
+                    return readRaw< unsigned char >( data, swap );
+                case PLY_INT16:
+                    return readRaw< short >( data, swap );
+                case PLY_UINT16:
+                    return readRaw< unsigned short >( data, swap );
+                case PLY_INT32:
+                    return readRaw< int >( data, swap );
+                case PLY_UINT32:
+                    return readRaw< unsigned int >( data, swap );
+                case PLY_FLOAT32:
+                    return readRaw< float >( data, swap );
+                case PLY_FLOAT64:
+                    return readRaw< double >( data, swap );
+                default:
+                    return 0.0;
+            }
+        }
+
+        // PLY PROPERTY -------------------------------------------------------
+
+        class PlyProperty
+        {
+            public:
+
+            std::string name;
+            PlyType type;
+            PlyType countType; // PLY_NONE unless property is a list
+        };
+
+        // PLY ELEMENT --------------------------------------------------------
+
+        class PlyElement
+        {
+            public:
+
+            // Size of one record, or zero if it contains lists
+
+            std::size_t const getStride( void ) const
+            {
+                std::size_t stride = 0;
+
+                for( std::size_t i = 0; i < properties.size(); ++i )
+                {
+                    if( properties[ i ].countType != PLY_NONE )
+                    {
+                        return 0;
+                    }
+
+                    stride += getPlyTypeSize( properties[ i ].type );
+                }
+
+                return stride;
+            }
+
+            std::string name;
+            std::size_t count;
+            std::vector< PlyProperty > properties;
+        };
+
+        // PLY FORMATS --------------------------------------------------------
+
+        enum PlyFormat
+        {
+            PLY_ASCII,
+            PLY_BINARY_LITTLE_ENDIAN,
+            PLY_BINARY_BIG_ENDIAN
+        };
+
+        // PARSE PLY HEADER ---------------------------------------------------
+
+        inline bool const parsePlyHeader
+        (
+            char const * & it,
+            char const * end,
+            PlyFormat & format,
+            std::vector< PlyElement > & elements
+        )
+        {
+            std::vector< std::string > words;
+            bool hasFormat = false;
+
+            if( end - it < 4 || std::strncmp( it, "ply", 3 ) != 0 )
+            {
+                return false;
+            }
+
+            it = skipLine( it, end );
+
+            while( it != end )
+            {
+                // Split line into words
+
+                words.clear();
+                char const * lineEnd = it;
+
+                while( lineEnd != end && *lineEnd != '\n' )
+                {
+                    ++lineEnd;
+                }
+
+                while( ( it = skipSpace( it, lineEnd ) ) != lineEnd )
+                {
+                    char const * wordEnd = skipToken( it, lineEnd );
+                    words.push_back( std::string( it, wordEnd ) );
+                    it = wordEnd;
+                }
+
+                it = lineEnd == end ? end : lineEnd + 1;
+
+                if( words.empty() )
+                {
+                    continue;
+                }
+
+                // Interpret header line
+
+                if( words[ 0 ] == "end_header" )
+                {
+                    return hasFormat;
+                }
+                else if( words[ 0 ] == "format" && words.size() >= 2 )
+                {
+                    if( words[ 1 ] == "ascii" )
+                    {
+                        format = PLY_ASCII;
+                    }
+                    else if( words[ 1 ] == "binary_little_endian" )
+                    {
+                        format = PLY_BINARY_LITTLE_ENDIAN;
+                    }
+                    else if( words[ 1 ] == "binary_big_endian" )
+                    {
+                        format = PLY_BINARY_BIG_ENDIAN;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+
+                    hasFormat = true;
+                }
+                else if( words[ 0 ] == "element" && words.size() >= 3 )
+                {
+                    PlyElement element;
+                    char const * countIt = words[ 2 ].c_str();
+                    char const * countEnd = countIt + words[ 2 ].size();
+                    long long count = 0;
+
+                    if( *countIt == '-' || *countIt == '+' ||
+                        !parseInteger( countIt, countEnd, count ) ||
+                        countIt != countEnd )
+                    {
+                        return false;
+                    }
+
+                    element.name = words[ 1 ];
+                    element.count = static_cast< std::size_t >( count );
+                    elements.push_back( element );
+                }
+                else if( words[ 0 ] == "property" && !elements.empty() )
+                {
+                    PlyProperty property;
+
+                    if( words.size() >= 5 && words[ 1 ] == "list" )
+                    {
+                        property.countType = getPlyType( words[ 2 ] );
+                        property.type = getPlyType( words[ 3 ] );
+                        property.name = words[ 4 ];
+
+                        if( property.countType == PLY_NONE )
+                        {
+                            return false;
+                        }
+                    }
+                    else if( words.size() >= 3 )
+                    {
+                        property.countType = PLY_NONE;
+                        property.type = getPlyType( words[ 1 ] );
+                        property.name = words[ 2 ];
+                    }
+                    else
+                    {
+                        return false;
+                    }
+
+                    if( property.type == PLY_NONE )
+                    {
+                        return false;
+                    }
+
+                    elements.back().properties.push_back( property );
+                }
+            }
+
+            return false;
+        }
+
+        // READ PLY BINARY ELEMENT --------------------------------------------
+
+        // Reads every record of an element, storing x/y/z of vertices and
+        // the index list of faces. Fixed-size vertex records are decoded in
+        // parallel since their offsets are known up front.
+
+        inline bool const readPlyBinaryElement
+        (
+            char const * & it,
+            char const * end,
+            PlyElement const & element,
+            bool swap,
+            std::size_t threadCount,
+            MeshChunk & chunk
+        )
+        {
+            std::size_t stride = element.getStride();
+            bool isVertex = element.name == "vertex";
+            bool isFace = element.name == "face";
+
+            // Locate properties of interest
+
+            int position[ 3 ] = { -1, -1, -1 };
+            std::size_t offset[ 3 ] = { 0, 0, 0 };
+            int faceList = -1;
+            std::size_t recordOffset = 0;
+
+            for( std::size_t i = 0; i < element.properties.size(); ++i )
+            {
+                PlyProperty const & property = element.properties[ i ];
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    if( isVertex && property.countType == PLY_NONE &&
+                        property.name.size() == 1 &&
+                        property.name[ 0 ] == "xyz"[ axis ] )
+                    {
+                        position[ axis ] = static_cast< int >( i );
+                        offset[ axis ] = recordOffset;
+                    }
+                }
+
+                if( isFace && property.countType != PLY_NONE &&
+                    ( property.name == "vertex_indices" ||
+                      property.name == "vertex_index" ) )
+                {
+                    faceList = static_cast< int >( i );
+                }
+
+                recordOffset += getPlyTypeSize( property.type );
+            }
+
+            if( isVertex && ( position[ 0 ] < 0 || position[ 1 ] < 0 ||
+                              position[ 2 ] < 0 ) )
+            {
+                return false;
+            }
+
+            if( isFace && faceList < 0 )
+            {
+                return false;
+            }
+
+            // Fixed-size records can be decoded or skipped directly
+
+            if( stride != 0 )
+            {
+                if( element.count >
+                    static_cast< std::size_t >( end - it ) / stride )
+                {
+                    return false;
+                }
+
+                if( isVertex )
+                {
+                    char const * base = it;
+                    PlyType types[ 3 ] =
+                    {
+                        element.properties[ position[ 0 ] ].type,
+                        element.properties[ position[ 1 ] ].type,
+                        element.properties[ position[ 2 ] ].type
+                    };
+
+                    chunk.positions.resize( element.count * 3 );
+
+                    parallelFor
+                    (
+                        element.count, threadCount,
+                        [ & ]( std::size_t begin, std::size_t last,
+                               std::size_t )
+                        {
+                            for( std::size_t v = begin; v < last; ++v )
+                            {
+                                char const * record = base + v * stride;
+
+                                for( int axis = 0; axis < 3; ++axis )
+                                {
+                                    chunk.positions[ v * 3 + axis ] =
+                                        readPlyValue
+                                        (
+                                            record + offset[ axis ],
+                                            types[ axis ], swap
+                                        );
+                                }
+                            }
+                        },
+                        16384
+                    );
+                }
+
+                it += stride * element.count;
+
+                return true;
+            }
+
+            // Variable-size records are walked one property at a time
+
+            double record[ 3 ] = { 0.0, 0.0, 0.0 };
+
+            for( std::size_t r = 0; r < element.count; ++r )
+            {
+                for( std::size_t i = 0; i < element.properties.size(); ++i )
+                {
+                    PlyProperty const & property = element.properties[ i ];
+                    std::size_t typeSize = getPlyTypeSize( property.type );
+
+                    if( property.countType == PLY_NONE )
+                    {
+                        if( static_cast< std::size_t >( end - it ) <
+                            typeSize )
+                        {
+                            return false;
+                        }
+
+                        if( isVertex )
+                        {
+                            for( int axis = 0; axis < 3; ++axis )
+                            {
+                                if( position[ axis ] ==
+                                    static_cast< int >( i ) )
+                                {
+                                    record[ axis ] = readPlyValue
+                                    (
+                                        it, property.type, swap
+                                    );
+                                }
+                            }
+                        }
+
+                        it += typeSize;
+                        continue;
+                    }
+
+                    // List property
+
+                    std::size_t countSize =
+                        getPlyTypeSize( property.countType );
+
+                    if( static_cast< std::size_t >( end - it ) < countSize )
+                    {
+                        return false;
+                    }
+
+                    long long listSize = 0;
+
+                    if( !toIndex( readPlyValue( it, property.countType,
+                                                swap ),
+                                  listSize ) )
+                    {
+                        return false;
+                    }
+
+                    std::size_t count = static_cast< std::size_t >( listSize );
+                    it += countSize;
+
+                    if( count >
+                        static_cast< std::size_t >( end - it ) / typeSize )
+                    {
+                        return false;
+                    }
+
+                    if( faceList == static_cast< int >( i ) )
+                    {
+                        long long index = 0;
+
+                        for( std::size_t c = 0; c < count; ++c )
+                        {
+                            if( !toIndex( readPlyValue( it + c * typeSize,
+                                                        property.type,
+                                                        swap ),
+                                          index ) )
+                            {
+                                return false;
+                            }
+
+                            chunk.indices.push_back( index );
+                        }
+
+                        chunk.faceSizes.push_back( count );
+                    }
+
+                    it += count * typeSize;
+                }
+
+                if( isVertex )
+                {
+                    chunk.positions.insert( chunk.positions.end(),
+                                            record, record + 3 );
+                }
+            }
+
+            return true;
+        }
+
+        // READ PLY ASCII ELEMENT ---------------------------------------------
+
+        inline bool const readPlyAsciiElement
+        (
+            char const * & it,
+            char const * end,
+            PlyElement const & element,
+            MeshChunk & chunk
+        )
+        {
+            bool isVertex = element.name == "vertex";
+            bool isFace = element.name == "face";
+            double value = 0.0;
+            long long index = 0;
+            double record[ 3 ] = { 0.0, 0.0, 0.0 };
+            bool hasPosition[ 3 ] = { false, false, false };
+            bool hasFaceList = false;
+
+            for( std::size_t r = 0; r < element.count; ++r )
+            {
+                for( std::size_t i = 0; i < element.properties.size(); ++i )
+                {
+                    PlyProperty const & property = element.properties[ i ];
+                    std::size_t count = 1;
+
+                    if( property.countType != PLY_NONE )
+                    {
+                        it = skipBlank( it, end );
+
+                        if( !parseDouble( it, end, value ) ||
+                            !toIndex( value, index ) )
+                        {
+                            return false;
+                        }
+
+                        count = static_cast< std::size_t >( index );
+                    }
+
+                    bool isFaceList = isFace &&
+                        property.countType != PLY_NONE &&
+                        ( property.name == "vertex_indices" ||
+                          property.name == "vertex_index" );
+
+                    for( std::size_t c = 0; c < count; ++c )
+                    {
+                        it = skipBlank( it, end );
+
+                        if( !parseDouble( it, end, value ) )
+                        {
+                            return false;
+                        }
+
+                        if( isFaceList )
+                        {
+                            if( !toIndex( value, index ) )
+                            {
+                                return false;
+                            }
+
+                            chunk.indices.push_back( index );
+                        }
+                        else if( isVertex && property.name.size() == 1 &&
+                                 property.countType == PLY_NONE )
+                        {
+                            for( int axis = 0; axis < 3; ++axis )
+                            {
+                                if( property.name[ 0 ] == "xyz"[ axis ] )
+                                {
+                                    record[ axis ] = value;
+                                    hasPosition[ axis ] = true;
+                                }
+                            }
+                        }
+                    }
+
+                    if( isFaceList )
+                    {
+                        chunk.faceSizes.push_back( count );
+                        hasFaceList = true;
+                    }
+                }
+
+                if( isVertex )
+                {
+                    chunk.positions.insert( chunk.positions.end(),
+                                            record, record + 3 );
+                }
+            }
+
+            if( isVertex && element.count != 0 &&
+                !( hasPosition[ 0 ] && hasPosition[ 1 ] && hasPosition[ 2 ] ) )
+            {
+                return false;
+            }
+
+            return !isFace || element.count == 0 || hasFaceList;
+        }
+
+        // BUILD GRAPH FROM CHUNKS --------------------------------------------
+
+        // Resolves and validates all indices, then adds the vertices and
+        // polygons of every chunk in file order. The graph is left
+        // untouched if any face references a missing vertex.
+
+        template< class Traits, class PositionAccessor >
+        bool const buildFromChunks
+        (
+            PolygonGraph< Traits > & graph,
+            std::vector< MeshChunk > & chunks,
+            PositionAccessor accessor,
+            std::size_t threadCount
+        )
+        {
+            typedef PolygonGraph< Traits > Graph;
+            typedef typename Graph::BaseVertex BaseVertex;
+            typedef typename Graph::VertexIterator VertexIterator;
+            typedef IndexedIterator< VertexIterator, long long > IndexIter;
+
+            PG_TRACE_SCOPE( "buildFromChunks" );
+
+            // Find first vertex of each chunk
+
+            std::vector< long long > chunkOffsets( chunks.size() + 1, 0 );
+
+            for( std::size_t c = 0; c < chunks.size(); ++c )
+            {
+                chunkOffsets[ c + 1 ] = chunkOffsets[ c ] +
+                    static_cast< long long >
+                    (
+                        chunks[ c ].positions.size() / 3
+                    );
+            }
+
+            long long vertexCount = chunkOffsets.back();
+
+            // Resolve relative indices and validate in parallel
+
+            std::vector< char > valid( chunks.size(), 1 );
+
+            parallelFor
+            (
+                chunks.size(), threadCount,
+                [ & ]( std::size_t begin, std::size_t last, std::size_t )
+                {
+                    for( std::size_t c = begin; c < last; ++c )
+                    {
+                        MeshChunk & chunk = chunks[ c ];
+
+                        for( std::size_t s = 0;
+                             s < chunk.relativeSlots.size(); ++s )
+                        {
+                            chunk.indices[ chunk.relativeSlots[ s ] ] +=
+                                chunkOffsets[ c ];
+                        }
+
+                        for( std::size_t i = 0; i < chunk.indices.size();
+                             ++i )
+                        {
+                            if( chunk.indices[ i ] < 0 ||
+                                chunk.indices[ i ] >= vertexCount )
+                            {
+                                valid[ c ] = 0;
+                            }
+                        }
+                    }
+                },
+                1
+            );
+
+            for( std::size_t c = 0; c < chunks.size(); ++c )
+            {
+                if( !valid[ c ] )
+                {
+                    return false;
+                }
+            }
+
+            // Add vertices
+
+            typedef typename std::decay
+            <
+                decltype( accessor( std::declval< BaseVertex & >() )[ 0 ] )
+            >::type Scalar;
+
+            std::vector< VertexIterator > handles;
+            handles.reserve( static_cast< std::size_t >( vertexCount ) );
+            BaseVertex baseVertex;
+
+            for( std::size_t c = 0; c < chunks.size(); ++c )
+            {
+                std::vector< double > const & positions =
+                    chunks[ c ].positions;
+
+                for( std::size_t p = 0; p < positions.size(); p += 3 )
+                {
+                    accessor( baseVertex )[ 0 ] =
+                        static_cast< Scalar >( positions[ p ] );
+                    accessor( baseVertex )[ 1 ] =
+                        static_cast< Scalar >( positions[ p + 1 ] );
+                    accessor( baseVertex )[ 2 ] =
+                        static_cast< Scalar >( positions[ p + 2 ] );
+
+                    handles.push_back( graph.addVertex( baseVertex ) );
+                }
+            }
+
+            // Add polygons straight from the index arrays
+
+            VertexIterator const * table =
+                handles.empty() ? nullptr : &( handles[ 0 ] );
+
+            for( std::size_t c = 0; c < chunks.size(); ++c )
+            {
+                MeshChunk const & chunk = chunks[ c ];
+                long long const * index =
+                    chunk.indices.empty() ? nullptr : &( chunk.indices[ 0 ] );
+
+                for( std::size_t f = 0; f < chunk.faceSizes.size(); ++f )
+                {
+                    long long const * faceEnd = index + chunk.faceSizes[ f ];
+
+                    graph.addPolygon( IndexIter( table, index ),
+                                      IndexIter( table, faceEnd ) );
+
+                    index = faceEnd;
+                }
+            }
+
+            return true;
+        }
+
+        // OUTPUT BUFFER ------------------------------------------------------
+
+        // Accumulates output and writes it to a file in large blocks.
+
+        class OutputBuffer
+        {
+            public:
+
+            OutputBuffer( std::FILE * file )
+            {
+                this->file = file;
+                this->failed = false;
+                buffer.reserve( 1 << 20 );
+            }
+
+            void write( void const * data, std::size_t size )
+            {
+                if( buffer.size() + size > buffer.capacity() )
+                {
+                    flush();
+                }
+
+                char const * bytes = static_cast< char const * >( data );
+                buffer.insert( buffer.end(), bytes, bytes + size );
+            }
+
+            void write( char const * text )
+            {
+                write( text, std::strlen( text ) );
+            }
+
+            bool const flush( void )
+            {
+                if( !buffer.empty() &&
+                    std::fwrite( &( buffer[ 0 ] ), 1, buffer.size(), file ) !=
+                        buffer.size() )
+                {
+                    failed = true;
+                }
+
+                buffer.clear();
+
+                return !failed;
+            }
+
+            private:
+
+            std::FILE * file;
+            std::vector< char > buffer;
+            bool failed;
+        };
+
+        // VERTEX INDEX TABLE -------------------------------------------------
+
+        // File index of each vertex, for writers whose faces refer to
+        // vertices by position. Vertices are added while the writer walks
+        // them in graph order, so the running count is each one's index;
+        // the table is then sorted by address once and looked up by binary
+        // search, one flat array instead of a node per vertex.
+
+        template< class Vertex >
+        class VertexIndexTable
+        {
+            public:
+
+            void reserve( std::size_t count )
+            {
+                entries.reserve( count );
+            }
+
+            void add( Vertex const * vertex )
+            {
+                Entry entry;
+                entry.vertex = vertex;
+                entry.index = static_cast< std::uint32_t >( entries.size() );
+                entries.push_back( entry );
+            }
+
+            void sort( void )
+            {
+                if( !std::is_sorted( entries.begin(), entries.end() ) )
+                {
+                    std::sort( entries.begin(), entries.end() );
+                }
+            }
+
+            std::uint32_t const getIndex( Vertex const * vertex ) const
+            {
+                Entry key;
+                key.vertex = vertex;
+                key.index = 0;
+
+                return std::lower_bound( entries.begin(), entries.end(),
+                                         key )->index;
+            }
+
+            private:
+
+            class Entry
+            {
+                public:
+
+                bool const operator < ( Entry const & other ) const
+                {
+                    return std::less< Vertex const * >()( vertex,
+                                                          other.vertex );
+                }
+
+                Vertex const * vertex;
+                std::uint32_t index;
+            };
+
+            std::vector< Entry > entries;
+        };
+
+        // WRITE LITTLE ENDIAN ------------------------------------------------
+
+        template< class T >
+        inline void writeLittleEndian( OutputBuffer & output, T value )
+        {
+            char bytes[ sizeof( T ) ];
+            std::memcpy( bytes, &value, sizeof( T ) );
+
+            if( !isLittleEndian() )
+            {
+                for( std::size_t i = 0; i < sizeof( T ) / 2; ++i )
+                {
+                    char byte = bytes[ i ];
+                    bytes[ i ] = bytes[ sizeof( T ) - 1 - i ];
+                    bytes[ sizeof( T ) - 1 - i ] = byte;
+                }
+            }
+
+            output.write( bytes, sizeof( T ) );
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPORT FUNCTIONS +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // READ OBJ ---------------------------------------------------------------
+
+    // Appends the vertices and faces of a Wavefront OBJ file to the graph.
+    // The file is mapped and split at line boundaries into one chunk per
+    // thread, which are tokenized in parallel. Texture and normal indices
+    // are ignored. Returns false, leaving the graph unchanged, if the file
+    // cannot be read or parsed.
+
+    template< class Traits, class PositionAccessor >
+    bool const readObj
+    (
+        PolygonGraph< Traits > & graph,
+        char const * path,
+        PositionAccessor accessor,
+        std::size_t threadCount = 0
+    )
+    {
+        PG_TRACE_SCOPE( "readObj" );
+
+        MappedFile file;
+
+        if( !file.open( path ) )
+        {
+            return false;
+        }
+
+        char const * data = file.getData();
+        char const * end = data + file.getSize();
+
+        // Split file into chunks at line boundaries
+
+        threadCount = getThreadCount( threadCount );
+        std::size_t chunkCount = file.getSize() / ( 1 << 20 ) + 1;
+
+        if( chunkCount > threadCount )
+        {
+            chunkCount = threadCount;
+        }
+
+        std::vector< char const * > bounds( chunkCount + 1, end );
+        bounds[ 0 ] = data;
+
+        for( std::size_t c = 1; c < chunkCount; ++c )
+        {
+            char const * split = data + file.getSize() * c / chunkCount;
+
+            if( split < bounds[ c - 1 ] )
+            {
+                split = bounds[ c - 1 ];
+            }
+
+            bounds[ c ] = split == data ? data :
+                detail::skipLine( split - 1, end );
+        }
+
+        // Tokenize chunks in parallel
+
+        std::vector< detail::MeshChunk > chunks( chunkCount );
+        std::vector< char > parsed( chunkCount, 0 );
+
+        parallelFor
+        (
+            chunkCount, chunkCount,
+            [ & ]( std::size_t begin, std::size_t last, std::size_t )
+            {
+                for( std::size_t c = begin; c < last; ++c )
+                {
+                    parsed[ c ] = detail::parseObjChunk
+                    (
+                        bounds[ c ], bounds[ c + 1 ], chunks[ c ]
+                    );
+                }
+            },
+            1
+        );
+
+        for( std::size_t c = 0; c < chunkCount; ++c )
+        {
+            if( !parsed[ c ] )
+            {
+                return false;
+            }
+        }
+
+        return detail::buildFromChunks( graph, chunks, accessor,
+                                        threadCount );
+    }
+
+    template< class Traits >
+    bool const readObj
+    (
+        PolygonGraph< Traits > & graph,
+        char const * path
+    )
+    {
+        return readObj( graph, path, MemberPosition() );
+    }
+
+    // READ PLY ---------------------------------------------------------------
+
+    // Appends the vertices and faces of an ASCII or binary PLY file to the
+    // graph. Binary vertex records are decoded in parallel straight from
+    // the mapped file. Elements other than "vertex" and "face" are
+    // skipped. Returns false, leaving the graph unchanged, on failure.
+
+    template< class Traits, class PositionAccessor >
+    bool const readPly
+    (
+        PolygonGraph< Traits > & graph,
+        char const * path,
+        PositionAccessor accessor,
+        std::size_t threadCount = 0
+    )
+    {
+        PG_TRACE_SCOPE( "readPly" );
+
+        MappedFile file;
+
+        if( !file.open( path ) )
+        {
+            return false;
+        }
+
+        char const * it = file.getData();
+        char const * end = it + file.getSize();
+
+        // Parse header
+
+        detail::PlyFormat format = detail::PLY_ASCII;
+        std::vector< detail::PlyElement > elements;
+
+        if( !detail::parsePlyHeader( it, end, format, elements ) )
+        {
+            return false;
+        }
+
+        bool swap = format != detail::PLY_ASCII &&
+            ( format == detail::PLY_BINARY_LITTLE_ENDIAN ) !=
+                detail::isLittleEndian();
+
+        // Read elements in file order
+
+        std::vector< detail::MeshChunk > chunks( 1 );
+
+        for( std::size_t e = 0; e < elements.size(); ++e )
+        {
+            bool read = format == detail::PLY_ASCII ?
+                detail::readPlyAsciiElement( it, end, elements[ e ],
+                                             chunks[ 0 ] ) :
+                detail::readPlyBinaryElement( it, end, elements[ e ], swap,
+                                              threadCount, chunks[ 0 ] );
+
+            if( !read )
+            {
+                return false;
+            }
+        }
+
+        return detail::buildFromChunks( graph, chunks, accessor,
+                                        threadCount );
+    }
+
+    template< class Traits >
+    bool const readPly
+    (
+        PolygonGraph< Traits > & graph,
+        char const * path
+    )
+    {
+        return readPly( graph, path, MemberPosition() );
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // EXPORT FUNCTIONS +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // WRITE OBJ --------------------------------------------------------------
+
+    // Writes the graph as a Wavefront OBJ file, streaming vertices and
+    // polygon rings directly from the graph. Fails on graphs with more
+    // vertices than 32-bit indices can address.
+
+    template< class Traits, class PositionAccessor >
+    bool const writeObj
+    (
+        PolygonGraph< Traits > const & graph,
+        char const * path,
+        PositionAccessor accessor
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::ConstVertexIterator ConstVertexIterator;
+        typedef typename Graph::ConstPolygonIterator ConstPolygonIterator;
+
+        if( graph.getVertexCount() >
+            static_cast< std::size_t >( detail::maxIndex ) )
+        {
+            return false;
+        }
+
+        std::FILE * file = std::fopen( path, "wb" );
+
+        if( file == nullptr )
+        {
+            return false;
+        }
+
+        detail::OutputBuffer output( file );
+        detail::VertexIndexTable< Vertex > indices;
+        indices.reserve( graph.getVertexCount() );
+        char text[ 128 ];
+
+        // Write vertices
+
+        ConstVertexIterator vertexItEnd = graph.cendVertices();
+        ConstVertexIterator vertexIt = graph.cbeginVertices();
+
+        while( vertexIt != vertexItEnd )
+        {
+            indices.add( &( *vertexIt ) );
+
+            std::snprintf( text, sizeof( text ), "v %.9g %.9g %.9g\n",
+                           static_cast< double >( accessor( *vertexIt )[ 0 ] ),
+                           static_cast< double >( accessor( *vertexIt )[ 1 ] ),
+                           static_cast< double >( accessor( *vertexIt )[ 2 ] ) );
+            output.write( text );
+            ++vertexIt;
+        }
+
+        // Write polygons
+
+        indices.sort();
+
+        ConstPolygonIterator polyItEnd = graph.cendPolygons();
+        ConstPolygonIterator polyIt = graph.cbeginPolygons();
+
+        while( polyIt != polyItEnd )
+        {
+            Edge const * startEdge = polyIt->getStartEdge()->getPreviousEdge();
+            Edge const * edge = startEdge;
+
+            output.write( "f", 1 );
+
+            do
+            {
+                std::snprintf( text, sizeof( text ), " %lu",
+                               static_cast< unsigned long >
+                               (
+                                   indices.getIndex
+                                   (
+                                       &( *edge->getTargetVertex() )
+                                   ) + 1
+                               ) );
+                output.write( text );
+                edge = edge->getNextEdge();
+            }
+            while( edge != startEdge );
+
+            output.write( "\n", 1 );
+            ++polyIt;
+        }
+
+        bool written = output.flush();
+
+        return std::fclose( file ) == 0 && written;
+    }
+
+    template< class Traits >
+    bool const writeObj
+    (
+        PolygonGraph< Traits > const & graph,
+        char const * path
+    )
+    {
+        return writeObj( graph, path, MemberPosition() );
+    }
+
+    // WRITE PLY --------------------------------------------------------------
+
+    // Writes the graph as a binary little-endian PLY file. Positions are
+    // stored as float, or double if the accessor yields doubles, and
+    // indices as uint32. Fails on graphs with more vertices than that.
+
+    template< class Traits, class PositionAccessor >
+    bool const writePly
+    (
+        PolygonGraph< Traits > const & graph,
+        char const * path,
+        PositionAccessor accessor
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::ConstVertexIterator ConstVertexIterator;
+        typedef typename Graph::ConstPolygonIterator ConstPolygonIterator;
+
+        typedef typename std::decay
+        <
+            decltype( accessor( std::declval< Vertex const & >() )[ 0 ] )
+        >::type Scalar;
+
+        bool const isDouble = sizeof( Scalar ) > sizeof( float );
+
+        if( graph.getVertexCount() >
+            static_cast< std::size_t >( detail::maxIndex ) )
+        {
+            return false;
+        }
+
+        std::FILE * file = std::fopen( path, "wb" );
+
+        if( file == nullptr )
+        {
+            return false;
+        }
+
+        detail::OutputBuffer output( file );
+        char text[ 256 ];
+
+        // Write header
+
+        std::snprintf( text, sizeof( text ),
+                       "ply\nformat binary_little_endian 1.0\n"
+                       "element vertex %zu\n"
+                       "property %s x\nproperty %s y\nproperty %s z\n"
+                       "element face %zu\n"
+                       "property list uint uint vertex_indices\n"
+                       "end_header\n",
+                       static_cast< std::size_t >( graph.getVertexCount() ),
+                       isDouble ? "double" : "float",
+                       isDouble ? "double" : "float",
+                       isDouble ? "double" : "float",
+                       static_cast< std::size_t >( graph.getPolygonCount() ) );
+        output.write( text );
+
+        // Write vertices
+
+        detail::VertexIndexTable< Vertex > indices;
+        indices.reserve( graph.getVertexCount() );
+
+        ConstVertexIterator vertexItEnd = graph.cendVertices();
+        ConstVertexIterator vertexIt = graph.cbeginVertices();
+
+        while( vertexIt != vertexItEnd )
+        {
+            indices.add( &( *vertexIt ) );
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                if( isDouble )
+                {
+                    detail::writeLittleEndian
+                    (
+                        output,
+                        static_cast< double >( accessor( *vertexIt )[ axis ] )
+                    );
+                }
+                else
+                {
+                    detail::writeLittleEndian
+                    (
+                        output,
+                        static_cast< float >( accessor( *vertexIt )[ axis ] )
+                    );
+                }
+            }
+
+            ++vertexIt;
+        }
+
+        // Write polygons
+
+        indices.sort();
+
+        ConstPolygonIterator polyItEnd = graph.cendPolygons();
+        ConstPolygonIterator polyIt = graph.cbeginPolygons();
+
+        while( polyIt != polyItEnd )
+        {
+            Edge const * startEdge = polyIt->getStartEdge()->getPreviousEdge();
+            Edge const * edge = startEdge;
+            std::uint32_t count = 0;
+
+            do
+            {
+                ++count;
+                edge = edge->getNextEdge();
+            }
+            while( edge != startEdge );
+
+            detail::writeLittleEndian( output, count );
+
+            do
+            {
+                detail::writeLittleEndian
+                (
+                    output, indices.getIndex( &( *edge->getTargetVertex() ) )
+                );
+                edge = edge->getNextEdge();
+            }
+            while( edge != startEdge );
+
+            ++polyIt;
+        }
+
+        bool written = output.flush();
+
+        return std::fclose( file ) == 0 && written;
+    }
+
+    template< class Traits >
+    bool const writePly
+    (
+        PolygonGraph< Traits > const & graph,
+        char const * path
+    )
+    {
+        return writePly( graph, path, MemberPosition() );
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_IO_H
@@ -0,0 +1,1786 @@
+#ifndef POLYGON_GRAPH_PAGED_H
+#define POLYGON_GRAPH_PAGED_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <unistd.h>
+#define POLYGON_GRAPH_PAGED_PREAD
+#endif
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // MORTON CODE --------------------------------------------------------
+
+        // Interleaves the low 21 bits of three coordinates, so sorting by
+        // the code walks a Z-order curve and nearby points end up close in
+        // the order.
+
+        inline std::uint64_t const spreadMortonBits( std::uint32_t value )
+        {
+            std::uint64_t bits = value & 0x1fffffu;
+
+            bits = ( bits | bits << 32 ) & 0x001f00000000ffffull;
+            bits = ( bits | bits << 16 ) & 0x001f0000ff0000ffull;
+            bits = ( bits | bits << 8 ) & 0x100f00f00f00f00full;
+            bits = ( bits | bits << 4 ) & 0x10c30c30c30c30c3ull;
+            bits = ( bits | bits << 2 ) & 0x1249249249249249ull;
+
+            return bits;
+        }
+
+        inline std::uint64_t const getMortonCode
+        (
+            std::uint32_t x,
+            std::uint32_t y,
+            std::uint32_t z
+        )
+        {
+            return spreadMortonBits( x ) |
+                   spreadMortonBits( y ) << 1 |
+                   spreadMortonBits( z ) << 2;
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // PAGE FILE CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Random access binary file with 64-bit offsets.
+
+    class PageFile
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PageFile( void )
+        {
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+            descriptor = -1;
+#else
+            file = nullptr;
+#endif
+            length = 0;
+        }
+
+        // DESTRUCTOR ---------------------------------------------------------
+
+        ~PageFile( void )
+        {
+            close();
+        }
+
+        // OPEN ---------------------------------------------------------------
+
+        bool const open( std::string const & path, bool truncate )
+        {
+            close();
+
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+            descriptor = ::open( path.c_str(),
+                                 O_RDWR | O_CREAT | ( truncate ? O_TRUNC : 0 ),
+                                 0644 );
+
+            if( descriptor < 0 )
+            {
+                return false;
+            }
+
+            off_t end = lseek( descriptor, 0, SEEK_END );
+            length = end < 0 ? 0 : static_cast< std::uint64_t >( end );
+#else
+            file = std::fopen( path.c_str(), truncate ? "w+b" : "r+b" );
+
+            if( file == nullptr )
+            {
+                return false;
+            }
+
+            std::fseek( file, 0, SEEK_END );
+            length = static_cast< std::uint64_t >( std::ftell( file ) );
+#endif
+            return true;
+        }
+
+        // CLOSE --------------------------------------------------------------
+
+        void close( void )
+        {
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+            if( descriptor >= 0 )
+            {
+                ::close( descriptor );
+                descriptor = -1;
+            }
+#else
+            if( file != nullptr )
+            {
+                std::fclose( file );
+                file = nullptr;
+            }
+#endif
+            length = 0;
+        }
+
+        // READ ---------------------------------------------------------------
+
+        bool const read( std::uint64_t offset, void * data,
+                         std::size_t size ) const
+        {
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+            char * bytes = static_cast< char * >( data );
+
+            while( size != 0 )
+            {
+                ssize_t count = pread( descriptor, bytes, size,
+                                       static_cast< off_t >( offset ) );
+
+                if( count <= 0 )
+                {
+                    return false;
+                }
+
+                bytes += count;
+                offset += static_cast< std::uint64_t >( count );
+                size -= static_cast< std::size_t >( count );
+            }
+
+            return true;
+#else
+            return std::fseek( file, static_cast< long >( offset ),
+                               SEEK_SET ) == 0 &&
+                   std::fread( data, 1, size, file ) == size;
+#endif
+        }
+
+        // WRITE --------------------------------------------------------------
+
+        bool const write( std::uint64_t offset, void const * data,
+                          std::size_t size )
+        {
+            if( offset + size > length )
+            {
+                length = offset + size;
+            }
+
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+            char const * bytes = static_cast< char const * >( data );
+
+            while( size != 0 )
+            {
+                ssize_t count = pwrite( descriptor, bytes, size,
+                                        static_cast< off_t >( offset ) );
+
+                if( count <= 0 )
+                {
+                    return false;
+                }
+
+                bytes += count;
+                offset += static_cast< std::uint64_t >( count );
+                size -= static_cast< std::size_t >( count );
+            }
+
+            return true;
+#else
+            return std::fseek( file, static_cast< long >( offset ),
+                               SEEK_SET ) == 0 &&
+                   std::fwrite( data, 1, size, file ) == size;
+#endif
+        }
+
+        // APPEND -------------------------------------------------------------
+
+        bool const append( void const * data, std::size_t size )
+        {
+            return write( length, data, size );
+        }
+
+        // GET SIZE -----------------------------------------------------------
+
+        std::uint64_t const getSize( void ) const
+        {
+            return length;
+        }
+
+        // IS OPEN ------------------------------------------------------------
+
+        bool const isOpen( void ) const
+        {
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+            return descriptor >= 0;
+#else
+            return file != nullptr;
+#endif
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // NON-COPYABLE -------------------------------------------------------
+
+        PageFile( PageFile const & other );
+        PageFile const & operator = ( PageFile const & other );
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifdef POLYGON_GRAPH_PAGED_PREAD
+        int descriptor;
+#else
+        mutable std::FILE * file;
+#endif
+        std::uint64_t length;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // PAGED POLYGON GRAPH CLASS ++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Polygon graph kept in files and brought into memory one chunk at a
+    // time. Vertices are stored once, in a file of fixed-size records
+    // addressed by global id. A loaded chunk is an ordinary PolygonGraph
+    // holding its polygons and a copy of every vertex they reference.
+    //
+    // By default polygons are grouped into chunks in the order they are
+    // added, which only gives compact chunks if the input is already in a
+    // coherent order; with shuffled input nearly every vertex is shared by
+    // several chunks. Creating the graph with a position accessor instead
+    // sorts the polygons along a Morton curve of their centroids before
+    // cutting chunks, so each chunk covers a compact region and only the
+    // vertices on region borders are shared.
+    //
+    // Traversal is not transparent across chunks. Since each polygon lives
+    // in exactly one chunk, face-ring traversal (getNextEdge,
+    // getTargetVertex) never leaves the loaded chunk, but a vertex's
+    // one-ring can span chunks. For a vertex on a chunk border, which
+    // Chunk::isShared reports, the edges and polygons around it in one
+    // chunk's graph (beginEdges, getPolygons) are only the part of its
+    // one-ring in that chunk, with nothing else marking them partial.
+    // getVertexChunks lists every chunk referencing a vertex and
+    // forEachOutgoingEdge walks the whole one-ring, loading each chunk in
+    // turn.
+    //
+    // Chunks are cached in LRU order under a byte budget. A chunk still
+    // referenced by the caller is never evicted. Payloads (not topology)
+    // of chunks flagged with markDirty are written back on eviction or
+    // flush. A vertex shared by several chunks is only written back by a
+    // chunk whose copy changed since it was loaded, and the new value is
+    // then copied into the other resident chunks, so an edit made through
+    // one chunk is neither overwritten by another chunk's stale copy nor
+    // hidden from it after the write-back. If one vertex is edited
+    // through two chunks between write-backs, the last written wins.
+    // setVertex updates the file and every resident copy at once.
+
+    template< class Traits = DefaultPGTraits >
+    class PagedPolygonGraph
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // GRAPH TYPES --------------------------------------------------------
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::BaseVertex BaseVertex;
+        typedef typename Graph::BaseEdge BaseEdge;
+        typedef typename Graph::BasePolygon BasePolygon;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::VertexIterator VertexIterator;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+
+        // GLOBAL VERTEX ID ---------------------------------------------------
+
+        typedef std::uint64_t VertexId;
+
+        static VertexId const noVertex = ~VertexId( 0 );
+
+        // CHUNK CLASS --------------------------------------------------------
+
+        class Chunk
+        {
+            public:
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // FRIENDS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            friend class PagedPolygonGraph< Traits >;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            // CONSTRUCTORS ---------------------------------------------------
+
+            Chunk( void )
+            {
+                index = 0;
+                dirty = false;
+            }
+
+            // GET GRAPH ------------------------------------------------------
+
+            Graph & getGraph( void )
+            {
+                return graph;
+            }
+
+            Graph const & getGraph( void ) const
+            {
+                return graph;
+            }
+
+            // GET INDEX ------------------------------------------------------
+
+            size_type const getIndex( void ) const
+            {
+                return index;
+            }
+
+            // FIND VERTEX ----------------------------------------------------
+
+            // Returns the local handle of a global vertex, or endVertices()
+            // if the chunk does not reference it.
+
+            VertexIterator findVertex( VertexId id )
+            {
+                typename IdMap::const_iterator it = localVertices.find( id );
+
+                return it == localVertices.end() ?
+                    graph.endVertices() : vertices[ it->second ];
+            }
+
+            // GET VERTEX ID --------------------------------------------------
+
+            // Returns the global id of a local vertex, or noVertex if the
+            // vertex does not belong to this chunk.
+
+            VertexId const getVertexId( VertexIterator vertex ) const
+            {
+                typename IndexMap::const_iterator it =
+                    vertexIndices.find( &( *vertex ) );
+
+                return it == vertexIndices.end() ?
+                    noVertex : globalIds[ it->second ];
+            }
+
+            // IS SHARED ------------------------------------------------------
+
+            // True if polygons in other chunks also use the local vertex.
+            // Its edges and polygons in this chunk's graph are then only
+            // part of its one-ring; forEachOutgoingEdge gives all of it.
+
+            bool const isShared( VertexIterator vertex ) const
+            {
+                typename IndexMap::const_iterator it =
+                    vertexIndices.find( &( *vertex ) );
+
+                return it != vertexIndices.end() &&
+                       std::binary_search( sharedVertices.begin(),
+                                           sharedVertices.end(),
+                                           it->second );
+            }
+
+            // MARK DIRTY -----------------------------------------------------
+
+            // Requests that payload changes be written back on eviction.
+
+            void markDirty( void )
+            {
+                dirty = true;
+            }
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            private:
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            typedef std::unordered_map< VertexId, std::uint32_t > IdMap;
+            typedef std::unordered_map< Vertex const *, std::uint32_t >
+                IndexMap;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            Graph graph;
+            size_type index;
+            bool dirty;
+
+            std::vector< VertexId > globalIds;
+            std::vector< VertexIterator > vertices;
+            std::vector< PolygonIterator > polygons;
+            IdMap localVertices;
+            IndexMap vertexIndices;
+
+            // Local indices of the vertices shared with other chunks, in
+            // ascending order, and their payloads as last read or written
+
+            std::vector< std::uint32_t > sharedVertices;
+            std::vector< BaseVertex > sharedPayloads;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        };
+
+        // CHUNK POINTER ------------------------------------------------------
+
+        typedef std::shared_ptr< Chunk > ChunkPointer;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PagedPolygonGraph( void )
+        {
+            static_assert
+            (
+                std::is_trivially_copyable< BaseVertex >::value &&
+                std::is_trivially_copyable< BaseEdge >::value &&
+                std::is_trivially_copyable< BasePolygon >::value,
+                "Paged graphs store payloads as raw bytes"
+            );
+
+            polygonsPerChunk = 65536;
+            memoryBudget = size_type( 1 ) << 30;
+            residentBytes = 0;
+            vertexCount = 0;
+            writing = false;
+        }
+
+        // DESTRUCTOR ---------------------------------------------------------
+
+        ~PagedPolygonGraph( void )
+        {
+            close();
+        }
+
+        // CREATE -------------------------------------------------------------
+
+        // Starts a new paged graph in files named after the given prefix.
+        // Vertices and polygons are then added with addVertex/addPolygon
+        // and the graph becomes readable after finish().
+
+        bool const create( std::string const & prefix,
+                           size_type polygonsPerChunk = 65536 )
+        {
+            close();
+
+            this->prefix = prefix;
+            this->polygonsPerChunk = polygonsPerChunk == 0 ?
+                1 : polygonsPerChunk;
+
+            if( !vertexFile.open( prefix + ".vertices", true ) ||
+                !chunkFile.open( prefix + ".chunks", true ) )
+            {
+                close();
+                return false;
+            }
+
+            writing = true;
+
+            return true;
+        }
+
+        // Starts a new paged graph whose chunks are cut in Morton order of
+        // polygon centroids, with positions read through accessor. Until
+        // finish(), polygons are staged in a temporary file and the writer
+        // keeps three floats per vertex and one small record per polygon
+        // in memory.
+
+        template< class PositionAccessor >
+        bool const create
+        (
+            std::string const & prefix,
+            size_type polygonsPerChunk,
+            PositionAccessor accessor
+        )
+        {
+            if( !create( prefix, polygonsPerChunk ) ||
+                !stagingFile.open( prefix + ".staging", true ) )
+            {
+                close();
+                return false;
+            }
+
+            readPosition =
+                [ accessor ]( BaseVertex const & vertex,
+                              float * position ) mutable
+                {
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        position[ axis ] =
+                            static_cast< float >( accessor( vertex )[ axis ] );
+                    }
+                };
+
+            return true;
+        }
+
+        // OPEN ---------------------------------------------------------------
+
+        // Opens a paged graph previously written with create/finish.
+
+        bool const open( std::string const & prefix )
+        {
+            close();
+
+            this->prefix = prefix;
+
+            if( !vertexFile.open( prefix + ".vertices", false ) ||
+                !chunkFile.open( prefix + ".chunks", false ) ||
+                !vertexChunkFile.open( prefix + ".vchunks", false ) ||
+                !readIndex() )
+            {
+                close();
+                return false;
+            }
+
+            return true;
+        }
+
+        // CLOSE --------------------------------------------------------------
+
+        void close( void )
+        {
+            if( writing )
+            {
+                finish();
+            }
+
+            evict( 0, true );
+
+            cache.clear();
+            lru.clear();
+            directory.clear();
+            boundaryChunks.clear();
+            vertexChunks.clear();
+            pendingSizes.clear();
+            pendingIndices.clear();
+            pendingPolygons.clear();
+            pendingEdges.clear();
+
+            readPosition = nullptr;
+            std::vector< float >().swap( stagedPositions );
+            std::vector< StagedPolygon >().swap( stagedPolygons );
+
+            if( stagingFile.isOpen() )
+            {
+                stagingFile.close();
+                std::remove( ( prefix + ".staging" ).c_str() );
+            }
+
+            vertexFile.close();
+            chunkFile.close();
+            vertexChunkFile.close();
+
+            residentBytes = 0;
+            vertexCount = 0;
+        }
+
+        // ADD VERTEX ---------------------------------------------------------
+
+        VertexId addVertex( BaseVertex const & baseVertex = BaseVertex() )
+        {
+            vertexFile.append( &baseVertex, sizeof( BaseVertex ) );
+            vertexChunks.push_back( noChunk );
+
+            if( readPosition )
+            {
+                float position[ 3 ];
+                readPosition( baseVertex, position );
+                stagedPositions.insert( stagedPositions.end(),
+                                        position, position + 3 );
+            }
+
+            return vertexCount++;
+        }
+
+        // ADD POLYGON --------------------------------------------------------
+
+        // Adds a polygon over global vertex ids. Edge payloads may be given
+        // in ring order, starting with the edge leaving the first vertex.
+
+        bool const addPolygon
+        (
+            VertexId const * ids,
+            size_type count,
+            BasePolygon const & basePolygon = BasePolygon(),
+            BaseEdge const * baseEdges = nullptr
+        )
+        {
+            if( !writing || count < 3 )
+            {
+                return false;
+            }
+
+            for( size_type i = 0; i < count; ++i )
+            {
+                if( ids[ i ] >= vertexCount )
+                {
+                    return false;
+                }
+            }
+
+            if( readPosition )
+            {
+                return stagePolygon( ids, count, basePolygon, baseEdges );
+            }
+
+            pendingSizes.push_back( static_cast< std::uint32_t >( count ) );
+            pendingIndices.insert( pendingIndices.end(), ids, ids + count );
+            pendingPolygons.push_back( basePolygon );
+
+            for( size_type i = 0; i < count; ++i )
+            {
+                pendingEdges.push_back
+                (
+                    baseEdges == nullptr ? BaseEdge() : baseEdges[ i ]
+                );
+            }
+
+            if( pendingSizes.size() >= polygonsPerChunk )
+            {
+                return flushChunk();
+            }
+
+            return true;
+        }
+
+        // FINISH -------------------------------------------------------------
+
+        // Flushes the last chunk and writes the chunk directory.
+
+        bool const finish( void )
+        {
+            if( !writing )
+            {
+                return false;
+            }
+
+            bool flushed = ( !readPosition || flushStaged() ) &&
+                ( pendingSizes.empty() || flushChunk() );
+            writing = false;
+
+            return flushed && writeIndex();
+        }
+
+        // SET MEMORY BUDGET --------------------------------------------------
+
+        void setMemoryBudget( size_type bytes )
+        {
+            memoryBudget = bytes;
+            evict( memoryBudget, false );
+        }
+
+        size_type const getMemoryBudget( void ) const
+        {
+            return memoryBudget;
+        }
+
+        // GET RESIDENT BYTES -------------------------------------------------
+
+        size_type const getResidentBytes( void ) const
+        {
+            return residentBytes;
+        }
+
+        // GET COUNTS ---------------------------------------------------------
+
+        size_type const getChunkCount( void ) const
+        {
+            return directory.size();
+        }
+
+        size_type const getVertexCount( void ) const
+        {
+            return static_cast< size_type >( vertexCount );
+        }
+
+        // SET VERTEX ---------------------------------------------------------
+
+        // Writes a vertex payload to the file and to every resident chunk
+        // holding a copy of the vertex.
+
+        bool const setVertex( VertexId id, BaseVertex const & baseVertex )
+        {
+            if( writing || id >= vertexCount ||
+                !vertexFile.write( id * sizeof( BaseVertex ), &baseVertex,
+                                   sizeof( BaseVertex ) ) )
+            {
+                return false;
+            }
+
+            shareVertex( id, baseVertex, nullptr, true );
+
+            return true;
+        }
+
+        // GET CHUNK ----------------------------------------------------------
+
+        // Returns the chunk, loading it if it is not resident. The chunk
+        // stays resident at least as long as the returned pointer is held.
+        // Returns a null pointer on failure.
+
+        ChunkPointer getChunk( size_type index )
+        {
+            if( index >= directory.size() )
+            {
+                return ChunkPointer();
+            }
+
+            // Move cached chunk to front of LRU order
+
+            typename ChunkCache::iterator cached = cache.find( index );
+
+            if( cached != cache.end() )
+            {
+                lru.splice( lru.begin(), lru, cached->second.position );
+                return cached->second.chunk;
+            }
+
+            // Load chunk and make room for it
+
+            ChunkPointer chunk = loadChunk( index );
+
+            if( !chunk )
+            {
+                return chunk;
+            }
+
+            size_type bytes = estimateBytes( *chunk );
+            evict( memoryBudget > bytes ? memoryBudget - bytes : 0, false );
+
+            lru.push_front( index );
+            CacheEntry entry;
+            entry.chunk = chunk;
+            entry.position = lru.begin();
+            entry.bytes = bytes;
+            cache[ index ] = entry;
+            residentBytes += bytes;
+
+            return chunk;
+        }
+
+        // GET VERTEX CHUNKS --------------------------------------------------
+
+        // Lists every chunk containing a polygon that uses the vertex.
+
+        std::vector< size_type > getVertexChunks( VertexId id ) const
+        {
+            std::vector< size_type > chunks;
+            std::uint32_t first = getFirstChunk( id );
+
+            if( first != noChunk )
+            {
+                chunks.push_back( first );
+            }
+
+            std::pair< BoundaryIterator, BoundaryIterator > range =
+                boundaryChunks.equal_range( id );
+
+            while( range.first != range.second )
+            {
+                chunks.push_back( range.first->second );
+                ++range.first;
+            }
+
+            return chunks;
+        }
+
+        // FOR EACH OUTGOING EDGE ---------------------------------------------
+
+        // Calls function( Chunk &, Edge & ) for every half-edge leaving the
+        // vertex, loading the chunks of its one-ring as needed.
+
+        template< class Function >
+        void forEachOutgoingEdge( VertexId id, Function function )
+        {
+            std::vector< size_type > chunks = getVertexChunks( id );
+
+            for( size_type c = 0; c < chunks.size(); ++c )
+            {
+                ChunkPointer chunk = getChunk( chunks[ c ] );
+
+                if( !chunk )
+                {
+                    continue;
+                }
+
+                VertexIterator vertex = chunk->findVertex( id );
+
+                if( vertex == chunk->graph.endVertices() )
+                {
+                    continue;
+                }
+
+                typename Graph::EdgeIterator edgeItEnd = vertex->endEdges();
+                typename Graph::EdgeIterator edgeIt = vertex->beginEdges();
+
+                while( edgeIt != edgeItEnd )
+                {
+                    function( *chunk, *edgeIt );
+                    ++edgeIt;
+                }
+            }
+        }
+
+        // FLUSH --------------------------------------------------------------
+
+        // Writes back payloads of all dirty resident chunks.
+
+        bool const flush( void )
+        {
+            bool written = true;
+            typename ChunkCache::iterator it = cache.begin();
+
+            while( it != cache.end() )
+            {
+                if( it->second.chunk->dirty )
+                {
+                    written = writeBack( *it->second.chunk ) && written;
+                }
+
+                ++it;
+            }
+
+            return written;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CHUNK DIRECTORY ----------------------------------------------------
+
+        class ChunkRecord
+        {
+            public:
+
+            std::uint64_t offset;
+            std::uint64_t vertexCount;
+            std::uint64_t polygonCount;
+            std::uint64_t edgeCount;
+        };
+
+        // CHUNK CACHE --------------------------------------------------------
+
+        typedef std::list< size_type > LruList;
+
+        class CacheEntry
+        {
+            public:
+
+            ChunkPointer chunk;
+            typename LruList::iterator position;
+            size_type bytes;
+        };
+
+        typedef std::unordered_map< size_type, CacheEntry > ChunkCache;
+
+        // STAGED POLYGON -----------------------------------------------------
+
+        // A polygon waiting in the staging file for spatial ordering.
+
+        class StagedPolygon
+        {
+            public:
+
+            float centroid[ 3 ];
+            std::uint32_t size;
+            std::uint64_t offset;
+        };
+
+        // BOUNDARY TABLE -----------------------------------------------------
+
+        typedef std::unordered_multimap< VertexId, std::uint32_t >
+            BoundaryMap;
+        typedef typename BoundaryMap::const_iterator BoundaryIterator;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // NON-COPYABLE -------------------------------------------------------
+
+        PagedPolygonGraph( PagedPolygonGraph const & other );
+        PagedPolygonGraph const & operator =
+            ( PagedPolygonGraph const & other );
+
+        // CHUNK LAYOUT -------------------------------------------------------
+
+        // A chunk is stored as: global ids of its vertices, polygon sizes,
+        // local vertex indices, polygon payloads and edge payloads.
+
+        static std::uint64_t const getIdsOffset( ChunkRecord const & )
+        {
+            return 0;
+        }
+
+        static std::uint64_t const getSizesOffset( ChunkRecord const & r )
+        {
+            return r.vertexCount * sizeof( VertexId );
+        }
+
+        static std::uint64_t const getIndicesOffset( ChunkRecord const & r )
+        {
+            return getSizesOffset( r ) +
+                r.polygonCount * sizeof( std::uint32_t );
+        }
+
+        static std::uint64_t const getPolygonsOffset( ChunkRecord const & r )
+        {
+            return getIndicesOffset( r ) +
+                r.edgeCount * sizeof( std::uint32_t );
+        }
+
+        static std::uint64_t const getEdgesOffset( ChunkRecord const & r )
+        {
+            return getPolygonsOffset( r ) +
+                r.polygonCount * sizeof( BasePolygon );
+        }
+
+        // FLUSH CHUNK --------------------------------------------------------
+
+        bool const flushChunk( void )
+        {
+            std::uint32_t chunkIndex =
+                static_cast< std::uint32_t >( directory.size() );
+
+            // Assign local indices to referenced vertices
+
+            std::unordered_map< VertexId, std::uint32_t > localIndices;
+            std::vector< VertexId > ids;
+            std::vector< std::uint32_t > indices( pendingIndices.size() );
+
+            for( size_type i = 0; i < pendingIndices.size(); ++i )
+            {
+                VertexId id = pendingIndices[ i ];
+                std::pair< typename std::unordered_map< VertexId,
+                                                        std::uint32_t >::
+                           iterator, bool > inserted =
+                    localIndices.insert
+                    (
+                        std::make_pair
+                        (
+                            id, static_cast< std::uint32_t >( ids.size() )
+                        )
+                    );
+
+                if( inserted.second )
+                {
+                    ids.push_back( id );
+
+                    // Record which chunks reference the vertex
+
+                    if( vertexChunks[ id ] == noChunk )
+                    {
+                        vertexChunks[ id ] = chunkIndex;
+                    }
+                    else
+                    {
+                        boundaryChunks.insert
+                        (
+                            std::make_pair( id, chunkIndex )
+                        );
+                    }
+                }
+
+                indices[ i ] = inserted.first->second;
+            }
+
+            // Append chunk to chunk file
+
+            ChunkRecord record;
+            record.offset = chunkFile.getSize();
+            record.vertexCount = ids.size();
+            record.polygonCount = pendingSizes.size();
+            record.edgeCount = pendingIndices.size();
+
+            bool written =
+                appendArray( ids ) &&
+                appendArray( pendingSizes ) &&
+                appendArray( indices ) &&
+                appendArray( pendingPolygons ) &&
+                appendArray( pendingEdges );
+
+            directory.push_back( record );
+
+            pendingSizes.clear();
+            pendingIndices.clear();
+            pendingPolygons.clear();
+            pendingEdges.clear();
+
+            return written;
+        }
+
+        // STAGE POLYGON ------------------------------------------------------
+
+        // Appends a polygon's ids and payloads to the staging file and
+        // records its centroid.
+
+        bool const stagePolygon
+        (
+            VertexId const * ids,
+            size_type count,
+            BasePolygon const & basePolygon,
+            BaseEdge const * baseEdges
+        )
+        {
+            StagedPolygon staged;
+            staged.size = static_cast< std::uint32_t >( count );
+            staged.offset = stagingFile.getSize();
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                float sum = 0.0f;
+
+                for( size_type i = 0; i < count; ++i )
+                {
+                    sum += stagedPositions[ ids[ i ] * 3 + axis ];
+                }
+
+                staged.centroid[ axis ] = sum / static_cast< float >( count );
+            }
+
+            std::vector< BaseEdge > edges( count );
+
+            for( size_type i = 0; i < count && baseEdges != nullptr; ++i )
+            {
+                edges[ i ] = baseEdges[ i ];
+            }
+
+            if( !stagingFile.append( ids, count * sizeof( VertexId ) ) ||
+                !stagingFile.append( &basePolygon, sizeof( BasePolygon ) ) ||
+                !stagingFile.append( &( edges[ 0 ] ),
+                                     count * sizeof( BaseEdge ) ) )
+            {
+                return false;
+            }
+
+            stagedPolygons.push_back( staged );
+
+            return true;
+        }
+
+        // FLUSH STAGED -------------------------------------------------------
+
+        // Sorts the staged polygons by the Morton code of their centroids,
+        // quantised to 21 bits per axis over the centroids' bounds, and
+        // writes them out as chunks in that order.
+
+        bool const flushStaged( void )
+        {
+            float lower[ 3 ];
+            float scale[ 3 ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                float low = 0.0f;
+                float high = 0.0f;
+
+                for( size_type p = 0; p < stagedPolygons.size(); ++p )
+                {
+                    float value = stagedPolygons[ p ].centroid[ axis ];
+                    low = p == 0 ? value : std::min( low, value );
+                    high = p == 0 ? value : std::max( high, value );
+                }
+
+                lower[ axis ] = low;
+                scale[ axis ] = high > low ?
+                    float( 0x1fffff ) / ( high - low ) : 0.0f;
+            }
+
+            std::vector< std::pair< std::uint64_t, std::uint32_t > > order;
+            order.reserve( stagedPolygons.size() );
+
+            for( size_type p = 0; p < stagedPolygons.size(); ++p )
+            {
+                std::uint32_t cell[ 3 ];
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    float value = ( stagedPolygons[ p ].centroid[ axis ] -
+                                    lower[ axis ] ) * scale[ axis ];
+
+                    // Also sends NaN centroids to cell zero
+
+                    cell[ axis ] = value > 0.0f ?
+                        static_cast< std::uint32_t >
+                        (
+                            std::min( value, float( 0x1fffff ) )
+                        ) : 0;
+                }
+
+                order.push_back
+                (
+                    std::make_pair
+                    (
+                        detail::getMortonCode( cell[ 0 ], cell[ 1 ],
+                                               cell[ 2 ] ),
+                        static_cast< std::uint32_t >( p )
+                    )
+                );
+            }
+
+            std::sort( order.begin(), order.end() );
+
+            std::vector< VertexId > ids;
+            std::vector< BaseEdge > edges;
+            BasePolygon basePolygon;
+
+            for( size_type o = 0; o < order.size(); ++o )
+            {
+                StagedPolygon const & staged =
+                    stagedPolygons[ order[ o ].second ];
+                std::uint64_t offset = staged.offset;
+
+                ids.resize( staged.size );
+                edges.resize( staged.size );
+
+                if( !stagingFile.read( offset, &( ids[ 0 ] ),
+                                       ids.size() * sizeof( VertexId ) ) ||
+                    !stagingFile.read( offset += ids.size() *
+                                           sizeof( VertexId ),
+                                       &basePolygon,
+                                       sizeof( BasePolygon ) ) ||
+                    !stagingFile.read( offset + sizeof( BasePolygon ),
+                                       &( edges[ 0 ] ),
+                                       edges.size() * sizeof( BaseEdge ) ) )
+                {
+                    return false;
+                }
+
+                pendingSizes.push_back( staged.size );
+                pendingIndices.insert( pendingIndices.end(),
+                                       ids.begin(), ids.end() );
+                pendingPolygons.push_back( basePolygon );
+                pendingEdges.insert( pendingEdges.end(),
+                                     edges.begin(), edges.end() );
+
+                if( pendingSizes.size() >= polygonsPerChunk &&
+                    !flushChunk() )
+                {
+                    return false;
+                }
+            }
+
+            std::vector< StagedPolygon >().swap( stagedPolygons );
+
+            return true;
+        }
+
+        // APPEND ARRAY -------------------------------------------------------
+
+        template< class T >
+        bool const appendArray( std::vector< T > const & array )
+        {
+            return array.empty() ||
+                chunkFile.append( &( array[ 0 ] ),
+                                  array.size() * sizeof( T ) );
+        }
+
+        // READ ARRAY ---------------------------------------------------------
+
+        template< class T >
+        bool const readArray
+        (
+            PageFile const & file,
+            std::uint64_t offset,
+            std::vector< T > & array,
+            std::uint64_t count
+        )
+        {
+            array.resize( static_cast< std::size_t >( count ) );
+
+            return array.empty() ||
+                file.read( offset, &( array[ 0 ] ),
+                           array.size() * sizeof( T ) );
+        }
+
+        // WRITE INDEX --------------------------------------------------------
+
+        // The index file holds the vertex count, chunk directory and the
+        // table of vertices shared between chunks. The first chunk of each
+        // vertex goes to a separate file read on demand.
+
+        bool const writeIndex( void )
+        {
+            PageFile indexFile;
+
+            if( !indexFile.open( prefix + ".index", true ) ||
+                !vertexChunkFile.open( prefix + ".vchunks", true ) )
+            {
+                return false;
+            }
+
+            std::uint64_t header[ 3 ] =
+            {
+                vertexCount,
+                directory.size(),
+                boundaryChunks.size()
+            };
+
+            bool written = indexFile.append( header, sizeof( header ) ) &&
+                ( directory.empty() ||
+                  indexFile.append( &( directory[ 0 ] ),
+                                    directory.size() *
+                                        sizeof( ChunkRecord ) ) );
+
+            BoundaryIterator it = boundaryChunks.begin();
+
+            while( written && it != boundaryChunks.end() )
+            {
+                std::uint64_t entry[ 2 ] = { it->first, it->second };
+                written = indexFile.append( entry, sizeof( entry ) );
+                ++it;
+            }
+
+            written = written &&
+                ( vertexChunks.empty() ||
+                  vertexChunkFile.append( &( vertexChunks[ 0 ] ),
+                                          vertexChunks.size() *
+                                              sizeof( std::uint32_t ) ) );
+
+            // Vertex chunks are looked up from the file from now on
+
+            std::vector< std::uint32_t >().swap( vertexChunks );
+
+            return written;
+        }
+
+        // READ INDEX ---------------------------------------------------------
+
+        bool const readIndex( void )
+        {
+            PageFile indexFile;
+            std::uint64_t header[ 3 ];
+
+            if( !indexFile.open( prefix + ".index", false ) ||
+                !indexFile.read( 0, header, sizeof( header ) ) ||
+                !readArray( indexFile, sizeof( header ), directory,
+                            header[ 1 ] ) )
+            {
+                return false;
+            }
+
+            vertexCount = header[ 0 ];
+
+            std::vector< std::uint64_t > entries;
+
+            if( !readArray( indexFile, sizeof( header ) +
+                                header[ 1 ] * sizeof( ChunkRecord ),
+                            entries, header[ 2 ] * 2 ) )
+            {
+                return false;
+            }
+
+            for( size_type e = 0; e < entries.size(); e += 2 )
+            {
+                boundaryChunks.insert
+                (
+                    std::make_pair
+                    (
+                        entries[ e ],
+                        static_cast< std::uint32_t >( entries[ e + 1 ] )
+                    )
+                );
+            }
+
+            return true;
+        }
+
+        // GET FIRST CHUNK ----------------------------------------------------
+
+        std::uint32_t const getFirstChunk( VertexId id ) const
+        {
+            if( id < vertexChunks.size() )
+            {
+                return vertexChunks[ id ];
+            }
+
+            std::uint32_t chunk = noChunk;
+
+            if( id < vertexCount )
+            {
+                vertexChunkFile.read( id * sizeof( std::uint32_t ), &chunk,
+                                      sizeof( chunk ) );
+            }
+
+            return chunk;
+        }
+
+        // LOAD CHUNK ---------------------------------------------------------
+
+        ChunkPointer loadChunk( size_type index )
+        {
+            ChunkRecord const & record = directory[ index ];
+            ChunkPointer chunk( new Chunk() );
+            chunk->index = index;
+
+            // Read chunk arrays
+
+            std::vector< std::uint32_t > sizes;
+            std::vector< std::uint32_t > indices;
+            std::vector< BasePolygon > basePolygons;
+            std::vector< BaseEdge > baseEdges;
+
+            if( !readArray( chunkFile, record.offset, chunk->globalIds,
+                            record.vertexCount ) ||
+                !readArray( chunkFile,
+                            record.offset + getSizesOffset( record ),
+                            sizes, record.polygonCount ) ||
+                !readArray( chunkFile,
+                            record.offset + getIndicesOffset( record ),
+                            indices, record.edgeCount ) ||
+                !readArray( chunkFile,
+                            record.offset + getPolygonsOffset( record ),
+                            basePolygons, record.polygonCount ) ||
+                !readArray( chunkFile,
+                            record.offset + getEdgesOffset( record ),
+                            baseEdges, record.edgeCount ) )
+            {
+                return ChunkPointer();
+            }
+
+            // Read vertex payloads and add vertices
+
+            std::vector< BaseVertex > baseVertices;
+
+            if( !readVertices( chunk->globalIds, baseVertices ) )
+            {
+                return ChunkPointer();
+            }
+
+            chunk->vertices.reserve( baseVertices.size() );
+
+            for( size_type v = 0; v < baseVertices.size(); ++v )
+            {
+                VertexIterator vertex =
+                    chunk->graph.addVertex( baseVertices[ v ] );
+
+                chunk->vertices.push_back( vertex );
+                chunk->localVertices[ chunk->globalIds[ v ] ] =
+                    static_cast< std::uint32_t >( v );
+                chunk->vertexIndices[ &( *vertex ) ] =
+                    static_cast< std::uint32_t >( v );
+
+                if( boundaryChunks.count( chunk->globalIds[ v ] ) != 0 )
+                {
+                    chunk->sharedVertices.push_back
+                    (
+                        static_cast< std::uint32_t >( v )
+                    );
+                    chunk->sharedPayloads.push_back( baseVertices[ v ] );
+                }
+            }
+
+            // Add polygons and restore edge payloads
+
+            typedef IndexedIterator< VertexIterator, std::uint32_t > IndexIter;
+
+            VertexIterator const * table =
+                chunk->vertices.empty() ? nullptr : &( chunk->vertices[ 0 ] );
+            std::uint32_t const * corner =
+                indices.empty() ? nullptr : &( indices[ 0 ] );
+            BaseEdge const * baseEdge =
+                baseEdges.empty() ? nullptr : &( baseEdges[ 0 ] );
+
+            chunk->polygons.reserve( sizes.size() );
+
+            for( size_type p = 0; p < sizes.size(); ++p )
+            {
+                PolygonIterator polygon = chunk->graph.addPolygon
+                (
+                    IndexIter( table, corner ),
+                    IndexIter( table, corner + sizes[ p ] ),
+                    basePolygons[ p ]
+                );
+
+                chunk->polygons.push_back( polygon );
+
+                Edge * edge = polygon->getStartEdge();
+
+                for( std::uint32_t e = 0; e < sizes[ p ]; ++e )
+                {
+                    static_cast< BaseEdge & >( *edge ) = baseEdge[ e ];
+                    edge = edge->getNextEdge();
+                }
+
+                corner += sizes[ p ];
+                baseEdge += sizes[ p ];
+            }
+
+            return chunk;
+        }
+
+        // READ VERTICES ------------------------------------------------------
+
+        // Reads vertex payloads in ascending id order, coalescing runs of
+        // consecutive ids into single reads.
+
+        bool const readVertices
+        (
+            std::vector< VertexId > const & ids,
+            std::vector< BaseVertex > & baseVertices
+        )
+        {
+            std::vector< std::uint32_t > order( ids.size() );
+
+            for( size_type i = 0; i < order.size(); ++i )
+            {
+                order[ i ] = static_cast< std::uint32_t >( i );
+            }
+
+            std::sort
+            (
+                order.begin(), order.end(),
+                [ & ]( std::uint32_t lhs, std::uint32_t rhs )
+                {
+                    return ids[ lhs ] < ids[ rhs ];
+                }
+            );
+
+            baseVertices.resize( ids.size() );
+            std::vector< BaseVertex > run;
+            size_type begin = 0;
+
+            while( begin < order.size() )
+            {
+                size_type end = begin + 1;
+
+                while( end < order.size() &&
+                       ids[ order[ end ] ] == ids[ order[ end - 1 ] ] + 1 )
+                {
+                    ++end;
+                }
+
+                run.resize( end - begin );
+
+                if( !vertexFile.read( ids[ order[ begin ] ] *
+                                          sizeof( BaseVertex ),
+                                      &( run[ 0 ] ),
+                                      run.size() * sizeof( BaseVertex ) ) )
+                {
+                    return false;
+                }
+
+                for( size_type i = begin; i < end; ++i )
+                {
+                    baseVertices[ order[ i ] ] = run[ i - begin ];
+                }
+
+                begin = end;
+            }
+
+            return true;
+        }
+
+        // WRITE BACK ---------------------------------------------------------
+
+        // Writes vertex, polygon and edge payloads of a chunk back to the
+        // files. Topology is fixed once written. Vertices only this chunk
+        // holds are always written; shared vertices only if this chunk's
+        // copy changed, in which case the other resident copies are
+        // updated too.
+
+        bool const writeBack( Chunk & chunk )
+        {
+            ChunkRecord const & record = directory[ chunk.index ];
+            bool written = true;
+            size_type shared = 0;
+
+            for( size_type v = 0; v < chunk.vertices.size(); ++v )
+            {
+                BaseVertex const & baseVertex = *chunk.vertices[ v ];
+                bool isShared = shared < chunk.sharedVertices.size() &&
+                    chunk.sharedVertices[ shared ] == v;
+
+                if( isShared )
+                {
+                    BaseVertex & loaded = chunk.sharedPayloads[ shared++ ];
+
+                    if( std::memcmp( &loaded, &baseVertex,
+                                     sizeof( BaseVertex ) ) == 0 )
+                    {
+                        continue;
+                    }
+
+                    loaded = baseVertex;
+                    shareVertex( chunk.globalIds[ v ], baseVertex, &chunk,
+                                 false );
+                }
+
+                written = vertexFile.write( chunk.globalIds[ v ] *
+                                                sizeof( BaseVertex ),
+                                            &baseVertex,
+                                            sizeof( BaseVertex ) ) && written;
+            }
+
+            std::vector< BasePolygon > basePolygons;
+            std::vector< BaseEdge > baseEdges;
+            basePolygons.reserve( chunk.polygons.size() );
+            baseEdges.reserve( static_cast< size_type >( record.edgeCount ) );
+
+            for( size_type p = 0; p < chunk.polygons.size(); ++p )
+            {
+                basePolygons.push_back( *chunk.polygons[ p ] );
+
+                Edge * startEdge = chunk.polygons[ p ]->getStartEdge();
+                Edge * edge = startEdge;
+
+                do
+                {
+                    baseEdges.push_back( *edge );
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
+            }
+
+            written = written &&
+                ( basePolygons.empty() ||
+                  chunkFile.write( record.offset +
+                                       getPolygonsOffset( record ),
+                                   &( basePolygons[ 0 ] ),
+                                   basePolygons.size() *
+                                       sizeof( BasePolygon ) ) ) &&
+                ( baseEdges.empty() ||
+                  chunkFile.write( record.offset + getEdgesOffset( record ),
+                                   &( baseEdges[ 0 ] ),
+                                   baseEdges.size() * sizeof( BaseEdge ) ) );
+
+            chunk.dirty = false;
+
+            return written;
+        }
+
+        // SHARE VERTEX -------------------------------------------------------
+
+        // Copies a vertex payload just written to the file into every
+        // other resident chunk holding the vertex, and records it as that
+        // chunk's loaded value. A copy with an edit of its own not yet
+        // written back is left alone unless overwrite is set, so that edit
+        // is written (and wins) when its chunk is.
+
+        void shareVertex
+        (
+            VertexId id,
+            BaseVertex const & baseVertex,
+            Chunk const * source,
+            bool overwrite
+        )
+        {
+            std::vector< size_type > chunks = getVertexChunks( id );
+
+            for( size_type c = 0; c < chunks.size(); ++c )
+            {
+                typename ChunkCache::iterator cached =
+                    cache.find( chunks[ c ] );
+
+                if( cached == cache.end() ||
+                    cached->second.chunk.get() == source )
+                {
+                    continue;
+                }
+
+                Chunk & chunk = *cached->second.chunk;
+                typename Chunk::IdMap::const_iterator local =
+                    chunk.localVertices.find( id );
+
+                if( local == chunk.localVertices.end() )
+                {
+                    continue;
+                }
+
+                BaseVertex & current = *chunk.vertices[ local->second ];
+                std::vector< std::uint32_t >::const_iterator slot =
+                    std::lower_bound( chunk.sharedVertices.begin(),
+                                      chunk.sharedVertices.end(),
+                                      local->second );
+
+                if( slot == chunk.sharedVertices.end() ||
+                    *slot != local->second )
+                {
+                    current = baseVertex;
+                    continue;
+                }
+
+                BaseVertex & loaded = chunk.sharedPayloads
+                [
+                    slot - chunk.sharedVertices.begin()
+                ];
+
+                if( overwrite ||
+                    std::memcmp( &loaded, &current,
+                                 sizeof( BaseVertex ) ) == 0 )
+                {
+                    current = baseVertex;
+                }
+
+                loaded = baseVertex;
+            }
+        }
+
+        // ESTIMATE BYTES -----------------------------------------------------
+
+        // Approximate heap footprint of a loaded chunk: list and tree nodes
+        // carry two and four pointer-sized words of overhead respectively.
+
+        static size_type const estimateBytes( Chunk const & chunk )
+        {
+            size_type vertices = chunk.vertices.size();
+            size_type polygons = chunk.polygons.size();
+            size_type edges = 0;
+
+            for( size_type v = 0; v < vertices; ++v )
+            {
+                edges += chunk.vertices[ v ]->getEdgeCount();
+            }
+
+            return vertices * ( sizeof( Vertex ) + 2 * sizeof( void * ) +
+                                sizeof( VertexId ) +
+                                sizeof( VertexIterator ) +
+                                8 * sizeof( void * ) ) +
+                   polygons * ( sizeof( typename Graph::Polygon ) +
+                                2 * sizeof( void * ) +
+                                sizeof( PolygonIterator ) ) +
+                   edges * ( sizeof( Edge ) + 5 * sizeof( void * ) ) +
+                   chunk.sharedVertices.size() *
+                       ( sizeof( std::uint32_t ) + sizeof( BaseVertex ) );
+        }
+
+        // EVICT --------------------------------------------------------------
+
+        // Evicts least recently used chunks not held elsewhere until the
+        // resident size fits the limit, or every such chunk if forced.
+
+        void evict( size_type limit, bool all )
+        {
+            typename LruList::iterator it = lru.end();
+
+            while( it != lru.begin() && ( all || residentBytes > limit ) )
+            {
+                --it;
+
+                typename ChunkCache::iterator cached = cache.find( *it );
+
+                if( !all && cached->second.chunk.use_count() > 1 )
+                {
+                    continue;
+                }
+
+                if( cached->second.chunk->dirty )
+                {
+                    writeBack( *cached->second.chunk );
+                }
+
+                residentBytes -= cached->second.bytes;
+                cache.erase( cached );
+                it = lru.erase( it );
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        static std::uint32_t const noChunk = 0xffffffffu;
+
+        std::string prefix;
+        PageFile vertexFile;
+        PageFile chunkFile;
+        mutable PageFile vertexChunkFile;
+
+        std::vector< ChunkRecord > directory;
+        std::vector< std::uint32_t > vertexChunks;
+        BoundaryMap boundaryChunks;
+        std::uint64_t vertexCount;
+
+        size_type polygonsPerChunk;
+        bool writing;
+
+        std::function< void ( BaseVertex const &, float * ) > readPosition;
+        PageFile stagingFile;
+        std::vector< float > stagedPositions;
+        std::vector< StagedPolygon > stagedPolygons;
+
+        std::vector< std::uint32_t > pendingSizes;
+        std::vector< VertexId > pendingIndices;
+        std::vector< BasePolygon > pendingPolygons;
+        std::vector< BaseEdge > pendingEdges;
+
+        ChunkCache cache;
+        LruList lru;
+        size_type memoryBudget;
+        size_type residentBytes;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    template< class Traits >
+    std::uint32_t const PagedPolygonGraph< Traits >::noChunk;
+
+    template< class Traits >
+    typename PagedPolygonGraph< Traits >::VertexId const
+        PagedPolygonGraph< Traits >::noVertex;
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_PAGED_H
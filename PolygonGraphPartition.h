@@ -0,0 +1,1467 @@
+#ifndef POLYGON_GRAPH_PARTITION_H
+#define POLYGON_GRAPH_PARTITION_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphDual.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // WEIGHTED GRAPH CLASS +++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Undirected graph in compressed sparse row form with node and edge
+    // weights, as used by the multilevel partitioner.
+
+    class WeightedGraph
+    {
+        public:
+
+        std::size_t const getNodeCount( void ) const
+        {
+            return nodeWeights.size();
+        }
+
+        std::vector< std::uint32_t > offsets;       // node count + 1
+        std::vector< std::uint32_t > neighbours;
+        std::vector< std::uint32_t > edgeWeights;
+        std::vector< std::uint32_t > nodeWeights;
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // MULTILEVEL PARTITIONING FUNCTIONS ++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // COARSEN ------------------------------------------------------------
+
+        // Contracts a heavy-edge matching of the graph. Returns false if
+        // the graph did not shrink enough to be worth another level.
+
+        inline bool const coarsen
+        (
+            WeightedGraph const & fine,
+            WeightedGraph & coarse,
+            std::vector< std::uint32_t > & coarseMap,
+            std::uint32_t seed
+        )
+        {
+            std::uint32_t const unmatched = 0xffffffffu;
+            std::size_t nodeCount = fine.getNodeCount();
+
+            // Visit nodes in a pseudo-random order
+
+            std::vector< std::uint32_t > order( nodeCount );
+
+            for( std::size_t n = 0; n < nodeCount; ++n )
+            {
+                order[ n ] = static_cast< std::uint32_t >( n );
+            }
+
+            for( std::size_t n = nodeCount; n > 1; --n )
+            {
+                seed = seed * 1664525u + 1013904223u;
+                std::swap( order[ n - 1 ], order[ seed % n ] );
+            }
+
+            // Match each node with its heaviest unmatched neighbour
+
+            std::vector< std::uint32_t > match( nodeCount, unmatched );
+            std::vector< std::uint32_t > firsts;
+            coarseMap.assign( nodeCount, unmatched );
+            std::uint32_t coarseCount = 0;
+
+            firsts.reserve( nodeCount );
+
+            for( std::size_t o = 0; o < nodeCount; ++o )
+            {
+                std::uint32_t node = order[ o ];
+
+                if( match[ node ] != unmatched )
+                {
+                    continue;
+                }
+
+                std::uint32_t best = node;
+                std::uint32_t bestWeight = 0;
+
+                for( std::uint32_t e = fine.offsets[ node ];
+                     e < fine.offsets[ node + 1 ]; ++e )
+                {
+                    std::uint32_t other = fine.neighbours[ e ];
+
+                    if( match[ other ] == unmatched && other != node &&
+                        fine.edgeWeights[ e ] > bestWeight )
+                    {
+                        best = other;
+                        bestWeight = fine.edgeWeights[ e ];
+                    }
+                }
+
+                match[ node ] = best;
+                match[ best ] = node;
+                firsts.push_back( node );
+                coarseMap[ node ] = coarseCount;
+                coarseMap[ best ] = coarseCount;
+                ++coarseCount;
+            }
+
+            if( coarseCount > nodeCount * 9 / 10 )
+            {
+                return false;
+            }
+
+            // Build contracted graph, summing weights of merged edges. Each
+            // coarse node is its first node and that node's match, which
+            // may be itself
+
+            std::vector< std::uint32_t > slot( coarseCount, unmatched );
+
+            coarse.offsets.assign( 1, 0 );
+            coarse.neighbours.clear();
+            coarse.edgeWeights.clear();
+            coarse.nodeWeights.assign( coarseCount, 0 );
+
+            for( std::uint32_t c = 0; c < coarseCount; ++c )
+            {
+                std::size_t begin = coarse.neighbours.size();
+
+                std::uint32_t first = firsts[ c ];
+                std::uint32_t pair[ 2 ] = { first, match[ first ] };
+                std::uint32_t memberCount = first == match[ first ] ? 1 : 2;
+
+                for( std::uint32_t m = 0; m < memberCount; ++m )
+                {
+                    std::uint32_t node = pair[ m ];
+                    coarse.nodeWeights[ c ] += fine.nodeWeights[ node ];
+
+                    for( std::uint32_t e = fine.offsets[ node ];
+                         e < fine.offsets[ node + 1 ]; ++e )
+                    {
+                        std::uint32_t target =
+                            coarseMap[ fine.neighbours[ e ] ];
+
+                        if( target == c )
+                        {
+                            continue;
+                        }
+
+                        if( slot[ target ] == unmatched )
+                        {
+                            slot[ target ] = static_cast< std::uint32_t >
+                            (
+                                coarse.neighbours.size()
+                            );
+                            coarse.neighbours.push_back( target );
+                            coarse.edgeWeights.push_back( 0 );
+                        }
+
+                        coarse.edgeWeights[ slot[ target ] ] +=
+                            fine.edgeWeights[ e ];
+                    }
+                }
+
+                for( std::size_t e = begin; e < coarse.neighbours.size();
+                     ++e )
+                {
+                    slot[ coarse.neighbours[ e ] ] = unmatched;
+                }
+
+                coarse.offsets.push_back
+                (
+                    static_cast< std::uint32_t >( coarse.neighbours.size() )
+                );
+            }
+
+            return true;
+        }
+
+        // GROW INITIAL PARTS -------------------------------------------------
+
+        // Grows parts one at a time by breadth-first search until each
+        // reaches its share of the total weight.
+
+        inline void growParts
+        (
+            WeightedGraph const & graph,
+            std::uint32_t partCount,
+            std::vector< std::uint32_t > & parts
+        )
+        {
+            std::uint32_t const unassigned = 0xffffffffu;
+            std::size_t nodeCount = graph.getNodeCount();
+            std::uint64_t remaining = 0;
+
+            for( std::size_t n = 0; n < nodeCount; ++n )
+            {
+                remaining += graph.nodeWeights[ n ];
+            }
+
+            parts.assign( nodeCount, unassigned );
+            std::vector< std::uint32_t > queue;
+            std::size_t nextSeed = 0;
+
+            for( std::uint32_t part = 0; part + 1 < partCount; ++part )
+            {
+                std::uint64_t target = remaining / ( partCount - part );
+                std::uint64_t weight = 0;
+                std::size_t head = 0;
+                queue.clear();
+
+                while( weight < target )
+                {
+                    // Restart from a new seed if the region is enclosed
+
+                    if( head == queue.size() )
+                    {
+                        while( nextSeed < nodeCount &&
+                               parts[ nextSeed ] != unassigned )
+                        {
+                            ++nextSeed;
+                        }
+
+                        if( nextSeed == nodeCount )
+                        {
+                            break;
+                        }
+
+                        parts[ nextSeed ] = part;
+                        weight += graph.nodeWeights[ nextSeed ];
+                        queue.push_back
+                        (
+                            static_cast< std::uint32_t >( nextSeed )
+                        );
+                    }
+
+                    std::uint32_t node = queue[ head++ ];
+
+                    for( std::uint32_t e = graph.offsets[ node ];
+                         e < graph.offsets[ node + 1 ] && weight < target;
+                         ++e )
+                    {
+                        std::uint32_t other = graph.neighbours[ e ];
+
+                        if( parts[ other ] == unassigned )
+                        {
+                            parts[ other ] = part;
+                            weight += graph.nodeWeights[ other ];
+                            queue.push_back( other );
+                        }
+                    }
+                }
+
+                remaining -= weight;
+            }
+
+            for( std::size_t n = 0; n < nodeCount; ++n )
+            {
+                if( parts[ n ] == unassigned )
+                {
+                    parts[ n ] = partCount - 1;
+                }
+            }
+        }
+
+        // REFINE PARTS -------------------------------------------------------
+
+        // Greedy boundary refinement: moves nodes to the neighbouring part
+        // they are most connected to when that lowers the cut without
+        // breaking the balance limit, or when it relieves an overweight
+        // part.
+
+        inline void refineParts
+        (
+            WeightedGraph const & graph,
+            std::uint32_t partCount,
+            std::uint64_t maxWeight,
+            std::vector< std::uint32_t > & parts
+        )
+        {
+            std::size_t nodeCount = graph.getNodeCount();
+            std::vector< std::uint64_t > partWeights( partCount, 0 );
+            std::vector< std::uint64_t > connection( partCount, 0 );
+            std::vector< std::uint32_t > touched;
+
+            for( std::size_t n = 0; n < nodeCount; ++n )
+            {
+                partWeights[ parts[ n ] ] += graph.nodeWeights[ n ];
+            }
+
+            for( int pass = 0; pass < 8; ++pass )
+            {
+                std::size_t moves = 0;
+
+                for( std::size_t n = 0; n < nodeCount; ++n )
+                {
+                    std::uint32_t from = parts[ n ];
+                    std::uint64_t weight = graph.nodeWeights[ n ];
+
+                    // Sum edge weight towards each adjacent part
+
+                    touched.clear();
+
+                    for( std::uint32_t e = graph.offsets[ n ];
+                         e < graph.offsets[ n + 1 ]; ++e )
+                    {
+                        std::uint32_t part = parts[ graph.neighbours[ e ] ];
+
+                        if( connection[ part ] == 0 )
+                        {
+                            touched.push_back( part );
+                        }
+
+                        connection[ part ] += graph.edgeWeights[ e ];
+                    }
+
+                    // Pick the best admissible destination
+
+                    bool overweight = partWeights[ from ] > maxWeight;
+                    std::uint32_t best = from;
+                    long long bestGain = 0;
+
+                    for( std::size_t t = 0; t < touched.size(); ++t )
+                    {
+                        std::uint32_t to = touched[ t ];
+                        long long gain =
+                            static_cast< long long >( connection[ to ] ) -
+                            static_cast< long long >( connection[ from ] );
+
+                        if( to == from ||
+                            partWeights[ to ] + weight > maxWeight )
+                        {
+                            continue;
+                        }
+
+                        if( gain > bestGain ||
+                            ( overweight && best == from ) ||
+                            ( gain == bestGain && best != from &&
+                              partWeights[ to ] < partWeights[ best ] ) )
+                        {
+                            best = to;
+                            bestGain = gain;
+                        }
+                    }
+
+                    for( std::size_t t = 0; t < touched.size(); ++t )
+                    {
+                        connection[ touched[ t ] ] = 0;
+                    }
+
+                    if( best != from && partWeights[ from ] > weight )
+                    {
+                        parts[ n ] = best;
+                        partWeights[ from ] -= weight;
+                        partWeights[ best ] += weight;
+                        ++moves;
+                    }
+                }
+
+                if( moves == 0 )
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    // PARTITION WEIGHTED GRAPH -----------------------------------------------
+
+    // Multilevel k-way partitioning: coarsens by heavy-edge matching,
+    // grows an initial partition on the coarsest graph, then projects it
+    // back level by level with boundary refinement. The imbalance is the
+    // allowed excess of any part over the average part weight.
+
+    inline void partitionWeightedGraph
+    (
+        WeightedGraph const & graph,
+        std::uint32_t partCount,
+        double imbalance,
+        std::vector< std::uint32_t > & parts
+    )
+    {
+        std::size_t nodeCount = graph.getNodeCount();
+
+        if( partCount <= 1 || nodeCount == 0 )
+        {
+            parts.assign( nodeCount, 0 );
+            return;
+        }
+
+        std::uint64_t totalWeight = 0;
+
+        for( std::size_t n = 0; n < nodeCount; ++n )
+        {
+            totalWeight += graph.nodeWeights[ n ];
+        }
+
+        std::uint64_t maxWeight = static_cast< std::uint64_t >
+        (
+            ( 1.0 + imbalance ) * static_cast< double >( totalWeight ) /
+                partCount
+        ) + 1;
+
+        // Coarsen until the graph is small relative to the part count
+
+        std::vector< WeightedGraph > levels;
+        std::vector< std::vector< std::uint32_t > > maps;
+        WeightedGraph const * current = &graph;
+        std::size_t const coarsest = std::max< std::size_t >
+        (
+            64, static_cast< std::size_t >( partCount ) * 16
+        );
+
+        levels.reserve( 64 );
+        maps.reserve( 64 );
+
+        while( current->getNodeCount() > coarsest && levels.size() < 64 )
+        {
+            levels.push_back( WeightedGraph() );
+            maps.push_back( std::vector< std::uint32_t >() );
+
+            if( !detail::coarsen( *current, levels.back(), maps.back(),
+                                  static_cast< std::uint32_t >
+                                  (
+                                      levels.size()
+                                  ) ) )
+            {
+                levels.pop_back();
+                maps.pop_back();
+                break;
+            }
+
+            current = &levels.back();
+        }
+
+        // Partition coarsest graph and project back with refinement
+
+        std::vector< std::uint32_t > coarseParts;
+        detail::growParts( *current, partCount, coarseParts );
+        detail::refineParts( *current, partCount, maxWeight, coarseParts );
+
+        for( std::size_t level = levels.size(); level > 0; --level )
+        {
+            WeightedGraph const & fine =
+                level == 1 ? graph : levels[ level - 2 ];
+            std::vector< std::uint32_t > const & map = maps[ level - 1 ];
+            std::vector< std::uint32_t > fineParts( fine.getNodeCount() );
+
+            for( std::size_t n = 0; n < fineParts.size(); ++n )
+            {
+                fineParts[ n ] = coarseParts[ map[ n ] ];
+            }
+
+            detail::refineParts( fine, partCount, maxWeight, fineParts );
+            coarseParts.swap( fineParts );
+        }
+
+        parts.swap( coarseParts );
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // GRAPH PARTITIONER CLASS ++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Splits a polygon graph into balanced sub-graphs by partitioning its
+    // face-adjacency graph. Each part holds its owned polygons plus a halo
+    // of every other polygon sharing a vertex with them, with payloads
+    // copied from the source graph. Each source vertex is owned by the
+    // lowest-numbered part owning one of its polygons. After processing,
+    // merge() copies payloads of owned vertices, polygons and edges back.
+    //
+    // Parts are independent graphs, so they can be handed to worker
+    // threads, or to worker processes through Part::serialize and
+    // Part::deserialize: a worker deserialises a part into an empty Part,
+    // edits payloads, and serialises it back; deserialising that into the
+    // original part updates its payloads, ready for merge().
+
+    template< class Traits = DefaultPGTraits >
+    class GraphPartitioner
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::BaseEdge BaseEdge;
+        typedef typename Graph::Vertex Vertex;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::Polygon Polygon;
+        typedef typename Graph::VertexIterator VertexIterator;
+        typedef typename Graph::PolygonIterator PolygonIterator;
+        typedef typename Graph::EdgeIterator EdgeIterator;
+
+        // PART CLASS ---------------------------------------------------------
+
+        class Part
+        {
+            public:
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // FRIENDS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            friend class GraphPartitioner< Traits >;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            // CONSTRUCTORS ---------------------------------------------------
+
+            Part( void )
+            {
+                this->source = nullptr;
+                this->ownedPolygonCount = 0;
+            }
+
+            // GET GRAPH ------------------------------------------------------
+
+            Graph & getGraph( void )
+            {
+                return graph;
+            }
+
+            Graph const & getGraph( void ) const
+            {
+                return graph;
+            }
+
+            // GET OWNED COUNTS -----------------------------------------------
+
+            size_type const getOwnedPolygonCount( void ) const
+            {
+                return ownedPolygonCount;
+            }
+
+            // IS HALO --------------------------------------------------------
+
+            // False for polygons not in this part's graph.
+
+            bool const isHalo( PolygonIterator localPolygon ) const
+            {
+                typename IndexMap::const_iterator it =
+                    polygonIndices.find( &( *localPolygon ) );
+
+                return it != polygonIndices.end() &&
+                    it->second >= ownedPolygonCount;
+            }
+
+            // IS OWNED -------------------------------------------------------
+
+            // False for vertices not in this part's graph.
+
+            bool const isOwned( VertexIterator localVertex ) const
+            {
+                typename IndexMap::const_iterator it =
+                    vertexIndices.find( &( *localVertex ) );
+
+                return it != vertexIndices.end() &&
+                    ownedVertices[ it->second ] != 0;
+            }
+
+            // GLOBAL TO LOCAL ------------------------------------------------
+
+            // Returns the local handle, or the end iterator of the part's
+            // graph if the global element is not in this part.
+
+            VertexIterator getLocalVertex( VertexIterator globalVertex )
+            {
+                typename IndexMap::const_iterator it =
+                    globalVertexIndices.find( &( *globalVertex ) );
+
+                return it == globalVertexIndices.end() ?
+                    graph.endVertices() : localVertices[ it->second ];
+            }
+
+            PolygonIterator getLocalPolygon( PolygonIterator globalPolygon )
+            {
+                typename IndexMap::const_iterator it =
+                    globalPolygonIndices.find( &( *globalPolygon ) );
+
+                return it == globalPolygonIndices.end() ?
+                    graph.endPolygons() : localPolygons[ it->second ];
+            }
+
+            // LOCAL TO GLOBAL ------------------------------------------------
+
+            // Returns the source graph's handle, or its end iterator if the
+            // local element is not in this part. A part deserialised in a
+            // worker has no source graph and returns its own end iterator.
+
+            VertexIterator getGlobalVertex( VertexIterator localVertex )
+            {
+                typename IndexMap::const_iterator it =
+                    vertexIndices.find( &( *localVertex ) );
+
+                if( it == vertexIndices.end() ||
+                    it->second >= globalVertices.size() )
+                {
+                    return source != nullptr ?
+                        source->endVertices() : graph.endVertices();
+                }
+
+                return globalVertices[ it->second ];
+            }
+
+            PolygonIterator getGlobalPolygon( PolygonIterator localPolygon )
+            {
+                typename IndexMap::const_iterator it =
+                    polygonIndices.find( &( *localPolygon ) );
+
+                if( it == polygonIndices.end() ||
+                    it->second >= globalPolygons.size() )
+                {
+                    return source != nullptr ?
+                        source->endPolygons() : graph.endPolygons();
+                }
+
+                return globalPolygons[ it->second ];
+            }
+
+            // SERIALIZE ------------------------------------------------------
+
+            // Appends the part to bytes: counts, vertex payloads and owned
+            // flags, then polygon sizes, corners, owned polygon count and
+            // polygon and edge payloads, in local order. Payloads are
+            // copied as raw bytes, so the buffer is only meant for
+            // processes built from the same code on the same machine.
+
+            void serialize( std::vector< char > & bytes ) const
+            {
+                typedef typename Graph::BaseVertex BaseVertex;
+                typedef typename Graph::BasePolygon BasePolygon;
+
+                static_assert
+                (
+                    std::is_trivially_copyable< BaseVertex >::value &&
+                    std::is_trivially_copyable< BaseEdge >::value &&
+                    std::is_trivially_copyable< BasePolygon >::value,
+                    "Serialised parts store payloads as raw bytes"
+                );
+
+                std::uint64_t corners = 0;
+
+                for( size_type p = 0; p < localPolygons.size(); ++p )
+                {
+                    corners += getRingSize( localPolygons[ p ] );
+                }
+
+                std::uint64_t const header[ 5 ] =
+                {
+                    serialMagic,
+                    localVertices.size(),
+                    localPolygons.size(),
+                    ownedPolygonCount,
+                    corners
+                };
+
+                append( bytes, header, sizeof( header ) );
+
+                for( size_type v = 0; v < localVertices.size(); ++v )
+                {
+                    appendPayload
+                    (
+                        bytes,
+                        static_cast< BaseVertex const & >
+                        (
+                            *localVertices[ v ]
+                        )
+                    );
+                }
+
+                if( !ownedVertices.empty() )
+                {
+                    append( bytes, &( ownedVertices[ 0 ] ),
+                            ownedVertices.size() );
+                }
+
+                // Polygon sizes and corners, each ring starting at the
+                // source of the start edge
+
+                for( size_type p = 0; p < localPolygons.size(); ++p )
+                {
+                    std::uint32_t size = static_cast< std::uint32_t >
+                    (
+                        getRingSize( localPolygons[ p ] )
+                    );
+                    append( bytes, &size, sizeof( size ) );
+                }
+
+                for( size_type p = 0; p < localPolygons.size(); ++p )
+                {
+                    Edge * startEdge =
+                        localPolygons[ p ]->getStartEdge()->getPreviousEdge();
+                    Edge * edge = startEdge;
+
+                    do
+                    {
+                        std::uint32_t corner = vertexIndices.find
+                        (
+                            &( *edge->getTargetVertex() )
+                        )->second;
+                        append( bytes, &corner, sizeof( corner ) );
+                        edge = edge->getNextEdge();
+                    }
+                    while( edge != startEdge );
+                }
+
+                // Polygon and edge payloads
+
+                for( size_type p = 0; p < localPolygons.size(); ++p )
+                {
+                    appendPayload
+                    (
+                        bytes,
+                        static_cast< BasePolygon const & >
+                        (
+                            *localPolygons[ p ]
+                        )
+                    );
+                }
+
+                for( size_type p = 0; p < localPolygons.size(); ++p )
+                {
+                    Edge * startEdge = localPolygons[ p ]->getStartEdge();
+                    Edge * edge = startEdge;
+
+                    do
+                    {
+                        appendPayload
+                        (
+                            bytes, static_cast< BaseEdge const & >( *edge )
+                        );
+                        edge = edge->getNextEdge();
+                    }
+                    while( edge != startEdge );
+                }
+            }
+
+            // DESERIALIZE ----------------------------------------------------
+
+            // Reads a serialised part. An empty part is rebuilt from the
+            // buffer, without source graph handles; a part already holding
+            // the same topology, such as the one serialised for a worker,
+            // only takes the payloads, so merge() then copies the worker's
+            // results back. Returns false, leaving the part unchanged, if
+            // the buffer is malformed or the topology differs.
+
+            bool const deserialize( char const * data, std::size_t size )
+            {
+                typedef typename Graph::BaseVertex BaseVertex;
+                typedef typename Graph::BasePolygon BasePolygon;
+                typedef IndexedIterator< VertexIterator, std::uint32_t >
+                    IndexIter;
+
+                std::uint64_t header[ 5 ];
+
+                if( size < sizeof( header ) )
+                {
+                    return false;
+                }
+
+                std::memcpy( header, data, sizeof( header ) );
+
+                std::uint64_t vertexCount = header[ 1 ];
+                std::uint64_t polygonCount = header[ 2 ];
+                std::uint64_t corners = header[ 4 ];
+                std::uint64_t remaining = size - sizeof( header );
+                bool rebuild = localVertices.empty() &&
+                    localPolygons.empty();
+
+                // Check the sections fit before sizing anything from them
+
+                std::size_t const vertexSize = getPayloadSize< BaseVertex >();
+                std::size_t const polygonSize =
+                    getPayloadSize< BasePolygon >();
+                std::size_t const edgeSize = getPayloadSize< BaseEdge >();
+                std::uint64_t const vertexBytes = vertexSize + 1;
+                std::uint64_t const polygonBytes =
+                    sizeof( std::uint32_t ) + polygonSize;
+                std::uint64_t const cornerBytes =
+                    sizeof( std::uint32_t ) + edgeSize;
+
+                if( header[ 0 ] != serialMagic ||
+                    header[ 3 ] > polygonCount ||
+                    vertexCount > remaining / vertexBytes ||
+                    polygonCount > ( remaining - vertexCount * vertexBytes ) /
+                        polygonBytes ||
+                    corners != ( remaining - vertexCount * vertexBytes -
+                                 polygonCount * polygonBytes ) /
+                                     cornerBytes ||
+                    remaining != vertexCount * vertexBytes +
+                        polygonCount * polygonBytes + corners * cornerBytes )
+                {
+                    return false;
+                }
+
+                if( !rebuild && ( vertexCount != localVertices.size() ||
+                                  polygonCount != localPolygons.size() ||
+                                  header[ 3 ] != ownedPolygonCount ) )
+                {
+                    return false;
+                }
+
+                char const * vertexData = data + sizeof( header );
+                char const * ownedData =
+                    vertexData + vertexCount * vertexSize;
+                char const * sizeData = ownedData + vertexCount;
+                char const * cornerData =
+                    sizeData + polygonCount * sizeof( std::uint32_t );
+                char const * polygonData =
+                    cornerData + corners * sizeof( std::uint32_t );
+                char const * edgeData =
+                    polygonData + polygonCount * polygonSize;
+
+                // Validate rings against the vertex count and, when
+                // updating, against the existing polygons
+
+                std::vector< std::uint32_t > sizes( polygonCount );
+                std::vector< std::uint32_t > ring( corners );
+                std::uint64_t total = 0;
+
+                if( polygonCount != 0 )
+                {
+                    std::memcpy( &( sizes[ 0 ] ), sizeData,
+                                 sizes.size() * sizeof( std::uint32_t ) );
+                }
+
+                if( corners != 0 )
+                {
+                    std::memcpy( &( ring[ 0 ] ), cornerData,
+                                 ring.size() * sizeof( std::uint32_t ) );
+                }
+
+                for( size_type p = 0; p < sizes.size(); ++p )
+                {
+                    if( sizes[ p ] < 3 ||
+                        ( !rebuild &&
+                          sizes[ p ] != getRingSize( localPolygons[ p ] ) ) )
+                    {
+                        return false;
+                    }
+
+                    total += sizes[ p ];
+                }
+
+                for( size_type c = 0; c < ring.size(); ++c )
+                {
+                    if( ring[ c ] >= vertexCount )
+                    {
+                        return false;
+                    }
+                }
+
+                if( total != corners )
+                {
+                    return false;
+                }
+
+                // Payloads are read into a local and assigned rather than
+                // copied over the element, which would clobber its links
+                // when the payload is an empty base
+
+                BaseVertex baseVertex;
+                BasePolygon basePolygon;
+                BaseEdge baseEdge;
+
+                // Rebuild the topology of an empty part
+
+                if( rebuild )
+                {
+                    for( size_type v = 0; v < vertexCount; ++v )
+                    {
+                        std::memcpy( &baseVertex,
+                                     vertexData + v * vertexSize,
+                                     vertexSize );
+                        VertexIterator vertex =
+                            graph.addVertex( baseVertex );
+
+                        vertexIndices[ &( *vertex ) ] =
+                            static_cast< std::uint32_t >( v );
+                        localVertices.push_back( vertex );
+                        ownedVertices.push_back( ownedData[ v ] != 0 );
+                    }
+
+                    VertexIterator const * table =
+                        localVertices.empty() ? nullptr :
+                                                &( localVertices[ 0 ] );
+                    std::uint32_t const * corner =
+                        ring.empty() ? nullptr : &( ring[ 0 ] );
+
+                    for( size_type p = 0; p < polygonCount; ++p )
+                    {
+                        PolygonIterator polygon = graph.addPolygon
+                        (
+                            IndexIter( table, corner ),
+                            IndexIter( table, corner + sizes[ p ] )
+                        );
+
+                        polygonIndices[ &( *polygon ) ] =
+                            static_cast< std::uint32_t >( p );
+                        localPolygons.push_back( polygon );
+                        corner += sizes[ p ];
+                    }
+
+                    ownedPolygonCount =
+                        static_cast< size_type >( header[ 3 ] );
+                }
+
+                // Copy payloads in local order
+
+                for( size_type v = 0; v < vertexCount; ++v )
+                {
+                    std::memcpy( &baseVertex,
+                                 vertexData + v * vertexSize,
+                                 vertexSize );
+                    static_cast< BaseVertex & >( *localVertices[ v ] ) =
+                        baseVertex;
+                }
+
+                for( size_type p = 0; p < polygonCount; ++p )
+                {
+                    std::memcpy( &basePolygon,
+                                 polygonData + p * polygonSize,
+                                 polygonSize );
+                    static_cast< BasePolygon & >( *localPolygons[ p ] ) =
+                        basePolygon;
+
+                    Edge * startEdge = localPolygons[ p ]->getStartEdge();
+                    Edge * edge = startEdge;
+
+                    do
+                    {
+                        std::memcpy( &baseEdge, edgeData, edgeSize );
+                        static_cast< BaseEdge & >( *edge ) = baseEdge;
+                        edgeData += edgeSize;
+                        edge = edge->getNextEdge();
+                    }
+                    while( edge != startEdge );
+                }
+
+                return true;
+            }
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            private:
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            typedef std::unordered_map< void const *, std::uint32_t >
+                IndexMap;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            // NON-COPYABLE ---------------------------------------------------
+
+            Part( Part const & other );
+            Part const & operator = ( Part const & other );
+
+            // GET RING SIZE --------------------------------------------------
+
+            static size_type const getRingSize( PolygonIterator polygon )
+            {
+                Edge * startEdge = polygon->getStartEdge();
+                Edge * edge = startEdge;
+                size_type size = 0;
+
+                do
+                {
+                    ++size;
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
+
+                return size;
+            }
+
+            // APPEND ---------------------------------------------------------
+
+            static void append( std::vector< char > & bytes,
+                                void const * data,
+                                std::size_t size )
+            {
+                char const * begin = static_cast< char const * >( data );
+                bytes.insert( bytes.end(), begin, begin + size );
+            }
+
+            // GET PAYLOAD SIZE -----------------------------------------------
+
+            // Empty payloads take no bytes; their single byte may alias
+            // the element's own links.
+
+            template< class Payload >
+            static std::size_t const getPayloadSize( void )
+            {
+                return std::is_empty< Payload >::value ? 0 :
+                                                         sizeof( Payload );
+            }
+
+            // APPEND PAYLOAD -------------------------------------------------
+
+            template< class Payload >
+            static void appendPayload( std::vector< char > & bytes,
+                                       Payload const & payload )
+            {
+                Payload copy( payload );
+                append( bytes, &copy, getPayloadSize< Payload >() );
+            }
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+            static std::uint64_t const serialMagic = 0x5452415047504750ull;
+
+            Graph graph;
+            Graph * source;
+
+            // Owned polygons come first in the polygon arrays
+
+            std::vector< VertexIterator > localVertices;
+            std::vector< VertexIterator > globalVertices;
+            std::vector< char > ownedVertices;
+            std::vector< PolygonIterator > localPolygons;
+            std::vector< PolygonIterator > globalPolygons;
+            size_type ownedPolygonCount;
+
+            IndexMap vertexIndices;
+            IndexMap polygonIndices;
+            IndexMap globalVertexIndices;
+            IndexMap globalPolygonIndices;
+
+            // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // PARTITION ----------------------------------------------------------
+
+        // Replaces any previous parts with a partition of the graph into
+        // partCount parts. Parts are built on up to threadCount threads.
+
+        void partition
+        (
+            Graph & graph,
+            size_type partCount,
+            double imbalance = 0.03,
+            size_type threadCount = 0
+        )
+        {
+            PG_TRACE_SCOPE( "GraphPartitioner::partition" );
+
+            parts.clear();
+            polygons.clear();
+            polygonIndices.clear();
+            polygonParts.clear();
+
+            if( partCount == 0 )
+            {
+                return;
+            }
+
+            // Partition the face-adjacency graph
+
+            WeightedGraph faceGraph;
+            buildFaceGraph( graph, faceGraph, threadCount );
+            partitionWeightedGraph
+            (
+                faceGraph, static_cast< std::uint32_t >( partCount ),
+                imbalance, polygonParts
+            );
+
+            // Extract each part with its halo
+
+            std::vector< std::vector< std::uint32_t > > owned( partCount );
+
+            for( size_type p = 0; p < polygons.size(); ++p )
+            {
+                owned[ polygonParts[ p ] ].push_back
+                (
+                    static_cast< std::uint32_t >( p )
+                );
+            }
+
+            for( size_type p = 0; p < partCount; ++p )
+            {
+                parts.push_back( std::unique_ptr< Part >( new Part() ) );
+                parts.back()->source = &graph;
+            }
+
+            parallelFor
+            (
+                partCount, threadCount,
+                [ & ]( size_type begin, size_type end, size_type )
+                {
+                    for( size_type p = begin; p < end; ++p )
+                    {
+                        buildPart( static_cast< std::uint32_t >( p ),
+                                   owned[ p ], *parts[ p ] );
+                    }
+                },
+                1
+            );
+        }
+
+        // GET PARTS ----------------------------------------------------------
+
+        size_type const getPartCount( void ) const
+        {
+            return parts.size();
+        }
+
+        Part & getPart( size_type index )
+        {
+            return *parts[ index ];
+        }
+
+        Part const & getPart( size_type index ) const
+        {
+            return *parts[ index ];
+        }
+
+        // MERGE --------------------------------------------------------------
+
+        // Copies payloads of owned vertices, owned polygons and their edges
+        // from every part back into the source graph.
+
+        void merge( size_type threadCount = 0 )
+        {
+            parallelFor
+            (
+                parts.size(), threadCount,
+                [ & ]( size_type begin, size_type end, size_type )
+                {
+                    for( size_type p = begin; p < end; ++p )
+                    {
+                        mergePart( *parts[ p ] );
+                    }
+                },
+                1
+            );
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef std::unordered_map< Polygon const *, std::uint32_t >
+            PolygonIndexMap;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // BUILD FACE GRAPH ---------------------------------------------------
+
+        // Indexes the polygons and connects each pair sharing an edge,
+        // weighting connections by the number of shared edges. Each row of
+        // the dual lists a neighbour once per shared edge, so sorting it
+        // and counting runs gives the weights.
+
+        void buildFaceGraph
+        (
+            Graph & graph,
+            WeightedGraph & faceGraph,
+            size_type threadCount
+        )
+        {
+            FaceAdjacency< Traits > adjacency;
+            buildDual( graph, adjacency, threadCount );
+
+            polygons.swap( adjacency.polygons );
+            polygonIndices.swap( adjacency.indices );
+
+            faceGraph.offsets.assign( 1, 0 );
+            faceGraph.neighbours.clear();
+            faceGraph.edgeWeights.clear();
+            faceGraph.nodeWeights.assign( polygons.size(), 1 );
+            faceGraph.neighbours.reserve( adjacency.neighbours.size() );
+            faceGraph.edgeWeights.reserve( adjacency.neighbours.size() );
+
+            std::vector< std::uint32_t > row;
+
+            for( size_type p = 0; p < polygons.size(); ++p )
+            {
+                row.assign
+                (
+                    adjacency.neighbours.begin() + adjacency.offsets[ p ],
+                    adjacency.neighbours.begin() + adjacency.offsets[ p + 1 ]
+                );
+                std::sort( row.begin(), row.end() );
+
+                for( size_type n = 0; n < row.size(); ++n )
+                {
+                    if( row[ n ] == p )
+                    {
+                        continue;
+                    }
+
+                    if( n != 0 && row[ n ] == row[ n - 1 ] )
+                    {
+                        ++faceGraph.edgeWeights.back();
+                        continue;
+                    }
+
+                    faceGraph.neighbours.push_back( row[ n ] );
+                    faceGraph.edgeWeights.push_back( 1 );
+                }
+
+                faceGraph.offsets.push_back
+                (
+                    static_cast< std::uint32_t >
+                    (
+                        faceGraph.neighbours.size()
+                    )
+                );
+            }
+        }
+
+        // GET MINIMUM PART ---------------------------------------------------
+
+        // The owning part of a vertex: lowest part among its polygons.
+
+        std::uint32_t const getMinimumPart( VertexIterator vertex ) const
+        {
+            std::uint32_t minimum = 0xffffffffu;
+            EdgeIterator edgeItEnd = vertex->endEdges();
+            EdgeIterator edgeIt = vertex->beginEdges();
+
+            while( edgeIt != edgeItEnd )
+            {
+                std::uint32_t part = polygonParts
+                [
+                    polygonIndices.find( &( *edgeIt->getPolygon() ) )->second
+                ];
+                minimum = part < minimum ? part : minimum;
+                ++edgeIt;
+            }
+
+            return minimum;
+        }
+
+        // BUILD PART ---------------------------------------------------------
+
+        void buildPart
+        (
+            std::uint32_t partIndex,
+            std::vector< std::uint32_t > const & owned,
+            Part & part
+        )
+        {
+            std::vector< std::uint32_t > selected( owned );
+            part.ownedPolygonCount = selected.size();
+
+            // Add halo polygons around every vertex of owned polygons
+
+            std::vector< char > included( polygons.size(), 0 );
+
+            for( size_type s = 0; s < part.ownedPolygonCount; ++s )
+            {
+                included[ selected[ s ] ] = 1;
+            }
+
+            for( size_type s = 0; s < part.ownedPolygonCount; ++s )
+            {
+                Edge * startEdge = polygons[ selected[ s ] ]->getStartEdge();
+                Edge * edge = startEdge;
+
+                do
+                {
+                    VertexIterator vertex = edge->getTargetVertex();
+                    EdgeIterator edgeItEnd = vertex->endEdges();
+                    EdgeIterator edgeIt = vertex->beginEdges();
+
+                    while( edgeIt != edgeItEnd )
+                    {
+                        std::uint32_t other = polygonIndices.find
+                        (
+                            &( *edgeIt->getPolygon() )
+                        )->second;
+
+                        if( !included[ other ] )
+                        {
+                            included[ other ] = 1;
+                            selected.push_back( other );
+                        }
+
+                        ++edgeIt;
+                    }
+
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge );
+            }
+
+            // Copy vertices and polygons into the part graph
+
+            std::vector< VertexIterator > ring;
+
+            for( size_type s = 0; s < selected.size(); ++s )
+            {
+                PolygonIterator globalPolygon = polygons[ selected[ s ] ];
+                Edge * startEdge = globalPolygon->getStartEdge();
+                Edge * edge = startEdge->getPreviousEdge();
+
+                ring.clear();
+
+                do
+                {
+                    VertexIterator globalVertex = edge->getTargetVertex();
+                    std::pair< typename Part::IndexMap::iterator, bool >
+                        inserted = part.globalVertexIndices.insert
+                        (
+                            std::make_pair
+                            (
+                                static_cast< void const * >
+                                (
+                                    &( *globalVertex )
+                                ),
+                                static_cast< std::uint32_t >
+                                (
+                                    part.localVertices.size()
+                                )
+                            )
+                        );
+
+                    if( inserted.second )
+                    {
+                        VertexIterator localVertex =
+                            part.graph.addVertex( *globalVertex );
+
+                        part.vertexIndices[ &( *localVertex ) ] =
+                            inserted.first->second;
+                        part.localVertices.push_back( localVertex );
+                        part.globalVertices.push_back( globalVertex );
+                        part.ownedVertices.push_back
+                        (
+                            getMinimumPart( globalVertex ) == partIndex
+                        );
+                    }
+
+                    ring.push_back
+                    (
+                        part.localVertices[ inserted.first->second ]
+                    );
+                    edge = edge->getNextEdge();
+                }
+                while( edge != startEdge->getPreviousEdge() );
+
+                PolygonIterator localPolygon = part.graph.addPolygon
+                (
+                    ring.begin(), ring.end(), *globalPolygon
+                );
+
+                copyEdges( globalPolygon, localPolygon );
+
+                part.polygonIndices[ &( *localPolygon ) ] =
+                    static_cast< std::uint32_t >( s );
+                part.globalPolygonIndices[ &( *globalPolygon ) ] =
+                    static_cast< std::uint32_t >( s );
+                part.localPolygons.push_back( localPolygon );
+                part.globalPolygons.push_back( globalPolygon );
+            }
+        }
+
+        // COPY EDGES ---------------------------------------------------------
+
+        // Copies edge payloads between two polygons built over the same
+        // ring with matching start edges.
+
+        static void copyEdges( PolygonIterator from, PolygonIterator to )
+        {
+            Edge * startEdge = from->getStartEdge();
+            Edge * fromEdge = startEdge;
+            Edge * toEdge = to->getStartEdge();
+
+            do
+            {
+                static_cast< BaseEdge & >( *toEdge ) =
+                    static_cast< BaseEdge const & >( *fromEdge );
+                fromEdge = fromEdge->getNextEdge();
+                toEdge = toEdge->getNextEdge();
+            }
+            while( fromEdge != startEdge );
+        }
+
+        // MERGE PART ---------------------------------------------------------
+
+        void mergePart( Part & part )
+        {
+            typedef typename Graph::BaseVertex BaseVertex;
+            typedef typename Graph::BasePolygon BasePolygon;
+
+            for( size_type v = 0; v < part.localVertices.size(); ++v )
+            {
+                if( part.ownedVertices[ v ] )
+                {
+                    static_cast< BaseVertex & >( *part.globalVertices[ v ] ) =
+                        static_cast< BaseVertex const & >
+                        (
+                            *part.localVertices[ v ]
+                        );
+                }
+            }
+
+            for( size_type p = 0; p < part.ownedPolygonCount; ++p )
+            {
+                static_cast< BasePolygon & >( *part.globalPolygons[ p ] ) =
+                    static_cast< BasePolygon const & >
+                    (
+                        *part.localPolygons[ p ]
+                    );
+
+                copyEdges( part.localPolygons[ p ],
+                           part.globalPolygons[ p ] );
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        std::vector< std::unique_ptr< Part > > parts;
+        std::vector< PolygonIterator > polygons;
+        PolygonIndexMap polygonIndices;
+        std::vector< std::uint32_t > polygonParts;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_PARTITION_H
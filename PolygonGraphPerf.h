@@ -0,0 +1,741 @@
+#ifndef POLYGON_GRAPH_PERF_H
+#define POLYGON_GRAPH_PERF_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined( __linux__ )
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define POLYGON_GRAPH_PERF_EVENTS
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // PERF COUNTERS CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Hardware counters read through Linux perf_event_open. They count the
+    // calling thread and, being inherited, every thread it starts once
+    // they are open, so work spread by parallelFor is included; threads
+    // started earlier, such as an existing pool, are not. Inherited
+    // counters cannot be read as a group, so each is opened, scheduled
+    // and scaled on its own. Counters the CPU, kernel or permissions do
+    // not allow are left out; if none open, isAvailable() is false and
+    // only wall-clock time is worth reporting. An open counter can still
+    // go unread in an interval, when it never got onto the PMU or the read
+    // came back short, and hasValue() says whether it was. Kernel-mode
+    // events are excluded so that the default perf_event_paranoid level
+    // suffices.
+
+    class PerfCounters
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        enum Counter
+        {
+            cycles,
+            instructions,
+            branchMisses,
+            l1dMisses,
+            llcMisses,
+            dtlbMisses,
+            counterCount
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PerfCounters( void )
+        {
+            for( int c = 0; c < counterCount; ++c )
+            {
+                descriptors[ c ] = -1;
+                values[ c ] = 0;
+                counted[ c ] = false;
+            }
+
+            open();
+        }
+
+        // DESTRUCTOR ---------------------------------------------------------
+
+        ~PerfCounters( void )
+        {
+            #if defined( POLYGON_GRAPH_PERF_EVENTS )
+
+            for( int c = 0; c < counterCount; ++c )
+            {
+                if( descriptors[ c ] >= 0 )
+                {
+                    close( descriptors[ c ] );
+                }
+            }
+
+            #endif
+        }
+
+        // GET NAME -----------------------------------------------------------
+
+        static char const * getName( Counter counter )
+        {
+            static char const * const names[ counterCount ] =
+            {
+                "cycles",
+                "instructions",
+                "branch_misses",
+                "l1d_misses",
+                "llc_misses",
+                "dtlb_misses"
+            };
+
+            return names[ counter ];
+        }
+
+        // AVAILABILITY -------------------------------------------------------
+
+        bool const isAvailable( void ) const
+        {
+            for( int c = 0; c < counterCount; ++c )
+            {
+                if( descriptors[ c ] >= 0 )
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool const isCounting( Counter counter ) const
+        {
+            return descriptors[ counter ] >= 0;
+        }
+
+        // START --------------------------------------------------------------
+
+        void start( void )
+        {
+            #if defined( POLYGON_GRAPH_PERF_EVENTS )
+
+            for( int c = 0; c < counterCount; ++c )
+            {
+                if( descriptors[ c ] >= 0 )
+                {
+                    ioctl( descriptors[ c ], PERF_EVENT_IOC_RESET, 0 );
+                    ioctl( descriptors[ c ], PERF_EVENT_IOC_ENABLE, 0 );
+                }
+            }
+
+            #endif
+        }
+
+        // STOP ---------------------------------------------------------------
+
+        // Stops counting and reads each counter. Counts are scaled up when
+        // the kernel had to multiplex the counters. Every counter is reset
+        // first, so one whose read fails or that never ran has no value
+        // for this interval.
+
+        void stop( void )
+        {
+            for( int c = 0; c < counterCount; ++c )
+            {
+                values[ c ] = 0;
+                counted[ c ] = false;
+            }
+
+            #if defined( POLYGON_GRAPH_PERF_EVENTS )
+
+            for( int c = 0; c < counterCount; ++c )
+            {
+                if( descriptors[ c ] >= 0 )
+                {
+                    ioctl( descriptors[ c ], PERF_EVENT_IOC_DISABLE, 0 );
+                }
+            }
+
+            for( int c = 0; c < counterCount; ++c )
+            {
+                if( descriptors[ c ] < 0 )
+                {
+                    continue;
+                }
+
+                // value, time enabled, time running
+
+                std::uint64_t buffer[ 3 ];
+                ssize_t bytes = read( descriptors[ c ], buffer,
+                                      sizeof( buffer ) );
+
+                // Nothing can be scaled from zero time on the PMU
+
+                if( bytes != static_cast< ssize_t >( sizeof( buffer ) ) ||
+                    buffer[ 2 ] == 0 )
+                {
+                    continue;
+                }
+
+                double scale =
+                    static_cast< double >( buffer[ 1 ] ) / buffer[ 2 ];
+                values[ c ] =
+                    static_cast< std::uint64_t >( buffer[ 0 ] * scale );
+                counted[ c ] = true;
+            }
+
+            #endif
+        }
+
+        // GET VALUE ----------------------------------------------------------
+
+        // Count from the last start/stop interval, or 0 if the counter was
+        // not read in it.
+
+        std::uint64_t const getValue( Counter counter ) const
+        {
+            return values[ counter ];
+        }
+
+        bool const hasValue( Counter counter ) const
+        {
+            return counted[ counter ];
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // NON-COPYABLE -------------------------------------------------------
+
+        PerfCounters( PerfCounters const & other );
+        PerfCounters const & operator = ( PerfCounters const & other );
+
+        // OPEN ---------------------------------------------------------------
+
+        void open( void )
+        {
+            #if defined( POLYGON_GRAPH_PERF_EVENTS )
+
+            static std::uint32_t const types[ counterCount ] =
+            {
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HW_CACHE,
+                PERF_TYPE_HW_CACHE,
+                PERF_TYPE_HW_CACHE
+            };
+
+            static std::uint64_t const readMiss =
+                ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) |
+                ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+
+            static std::uint64_t const configs[ counterCount ] =
+            {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_BRANCH_MISSES,
+                PERF_COUNT_HW_CACHE_L1D | readMiss,
+                PERF_COUNT_HW_CACHE_LL | readMiss,
+                PERF_COUNT_HW_CACHE_DTLB | readMiss
+            };
+
+            for( int c = 0; c < counterCount; ++c )
+            {
+                perf_event_attr attributes;
+                std::memset( &attributes, 0, sizeof( attributes ) );
+
+                attributes.size = sizeof( attributes );
+                attributes.type = types[ c ];
+                attributes.config = configs[ c ];
+                attributes.disabled = 1;
+                attributes.inherit = 1;
+                attributes.exclude_kernel = 1;
+                attributes.exclude_hv = 1;
+                attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                long descriptor = syscall( SYS_perf_event_open, &attributes,
+                                           0, -1, -1, 0 );
+
+                if( descriptor >= 0 )
+                {
+                    descriptors[ c ] = static_cast< int >( descriptor );
+                }
+            }
+
+            #endif
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        int descriptors[ counterCount ];
+        std::uint64_t values[ counterCount ];
+        bool counted[ counterCount ];
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // PERF SAMPLE CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Totals for one measured operation over its repetitions, with the
+    // number of threads it was run with. Counters that were not counted,
+    // or not read for this interval, have valid set to false and are
+    // written as null.
+
+    class PerfSample
+    {
+        public:
+
+        PerfSample( void )
+        {
+            repetitions = 0;
+            threads = 1;
+            seconds = 0.0;
+
+            for( int c = 0; c < PerfCounters::counterCount; ++c )
+            {
+                values[ c ] = 0;
+                valid[ c ] = false;
+            }
+        }
+
+        std::string name;
+        std::size_t repetitions;
+        std::size_t threads;
+        double seconds;
+        std::uint64_t values[ PerfCounters::counterCount ];
+        bool valid[ PerfCounters::counterCount ];
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // PERF REPORT CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Collects samples of named operations and writes them as JSON. When a
+    // baseline report has been read, each sample whose name appears in it
+    // with the same thread count also gets the ratio of its per-repetition
+    // time and counts to the baseline's, so values below 1 are
+    // improvements. Reports are written
+    // one sample per line, which is the form readBaseline expects.
+
+    class PerfReport
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        PerfReport( void )
+        {
+            threadCount = 1;
+        }
+
+        // MEASURE ------------------------------------------------------------
+
+        // Runs function repetitions times inside one counting interval and
+        // records the totals under name.
+
+        template< class Function >
+        PerfSample const & measure
+        (
+            char const * name,
+            Function function,
+            std::size_t repetitions = 1
+        )
+        {
+            typedef std::chrono::steady_clock Clock;
+
+            PerfSample sample;
+            sample.name = name;
+            sample.repetitions = repetitions;
+            sample.threads = threadCount;
+
+            counters.start();
+            Clock::time_point begin = Clock::now();
+
+            for( std::size_t r = 0; r < repetitions; ++r )
+            {
+                function();
+            }
+
+            Clock::time_point end = Clock::now();
+            counters.stop();
+
+            sample.seconds = std::chrono::duration< double >
+            (
+                end - begin
+            ).count();
+
+            for( int c = 0; c < PerfCounters::counterCount; ++c )
+            {
+                PerfCounters::Counter counter =
+                    static_cast< PerfCounters::Counter >( c );
+                sample.valid[ c ] = counters.hasValue( counter );
+                sample.values[ c ] = counters.getValue( counter );
+            }
+
+            samples.push_back( sample );
+
+            return samples.back();
+        }
+
+        // SET THREAD COUNT ---------------------------------------------------
+
+        // Number of threads the measured operations use, recorded with
+        // each sample from then on. Defaults to 1.
+
+        void setThreadCount( std::size_t threadCount )
+        {
+            this->threadCount = threadCount;
+        }
+
+        // ADD SAMPLE ---------------------------------------------------------
+
+        void addSample( PerfSample const & sample )
+        {
+            samples.push_back( sample );
+        }
+
+        // GET SAMPLES --------------------------------------------------------
+
+        std::size_t const getSampleCount( void ) const
+        {
+            return samples.size();
+        }
+
+        PerfSample const & getSample( std::size_t index ) const
+        {
+            return samples[ index ];
+        }
+
+        bool const isCounting( void ) const
+        {
+            return counters.isAvailable();
+        }
+
+        // READ BASELINE ------------------------------------------------------
+
+        // Reads a report written by writeJson to compare against. Returns
+        // false if the file cannot be read.
+
+        bool const readBaseline( char const * path )
+        {
+            std::FILE * file = std::fopen( path, "rb" );
+
+            if( file == nullptr )
+            {
+                return false;
+            }
+
+            baseline.clear();
+            std::string line;
+            int character = 0;
+
+            while( ( character = std::fgetc( file ) ) != EOF )
+            {
+                if( character != '\n' )
+                {
+                    line.push_back( static_cast< char >( character ) );
+                    continue;
+                }
+
+                parseSample( line );
+                line.clear();
+            }
+
+            parseSample( line );
+            std::fclose( file );
+
+            return true;
+        }
+
+        // WRITE JSON ---------------------------------------------------------
+
+        bool const writeJson( char const * path ) const
+        {
+            std::FILE * file = std::fopen( path, "wb" );
+
+            if( file == nullptr )
+            {
+                return false;
+            }
+
+            std::fprintf( file, "{\n  \"samples\": [\n" );
+
+            for( std::size_t s = 0; s < samples.size(); ++s )
+            {
+                writeSample( file, samples[ s ] );
+                std::fprintf( file, s + 1 < samples.size() ? ",\n" : "\n" );
+            }
+
+            std::fprintf( file, "  ]\n}\n" );
+
+            return std::fclose( file ) == 0;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // WRITE SAMPLE -------------------------------------------------------
+
+        void writeSample( std::FILE * file, PerfSample const & sample ) const
+        {
+            std::fprintf( file, "    { \"name\": \"" );
+
+            for( std::size_t c = 0; c < sample.name.size(); ++c )
+            {
+                char character = sample.name[ c ];
+
+                if( character == '"' || character == '\\' )
+                {
+                    std::fputc( '\\', file );
+                }
+
+                std::fputc( character, file );
+            }
+
+            std::fprintf( file, "\", \"repetitions\": %llu, "
+                                "\"threads\": %llu, \"seconds\": %.9g",
+                          static_cast< unsigned long long >
+                          (
+                              sample.repetitions
+                          ),
+                          static_cast< unsigned long long >
+                          (
+                              sample.threads
+                          ),
+                          sample.seconds );
+
+            for( int c = 0; c < PerfCounters::counterCount; ++c )
+            {
+                char const * name = PerfCounters::getName
+                (
+                    static_cast< PerfCounters::Counter >( c )
+                );
+
+                if( sample.valid[ c ] )
+                {
+                    std::fprintf( file, ", \"%s\": %llu", name,
+                                  static_cast< unsigned long long >
+                                  (
+                                      sample.values[ c ]
+                                  ) );
+                }
+                else
+                {
+                    std::fprintf( file, ", \"%s\": null", name );
+                }
+            }
+
+            PerfSample const * base = findBaseline( sample.name );
+
+            if( base != nullptr && base->repetitions > 0 &&
+                sample.repetitions > 0 && base->threads == sample.threads )
+            {
+                double perRun = static_cast< double >( base->repetitions ) /
+                                sample.repetitions;
+
+                std::fprintf( file, ", \"baseline\": { \"seconds\": " );
+                writeRatio( file, sample.seconds * perRun, base->seconds,
+                            true );
+
+                for( int c = 0; c < PerfCounters::counterCount; ++c )
+                {
+                    std::fprintf( file, ", \"%s\": ", PerfCounters::getName
+                    (
+                        static_cast< PerfCounters::Counter >( c )
+                    ) );
+                    writeRatio( file, sample.values[ c ] * perRun,
+                                static_cast< double >( base->values[ c ] ),
+                                sample.valid[ c ] && base->valid[ c ] );
+                }
+
+                std::fprintf( file, " }" );
+            }
+
+            std::fprintf( file, " }" );
+        }
+
+        static void writeRatio
+        (
+            std::FILE * file,
+            double value,
+            double base,
+            bool valid
+        )
+        {
+            if( valid && base > 0.0 )
+            {
+                std::fprintf( file, "%.4f", value / base );
+            }
+            else
+            {
+                std::fprintf( file, "null" );
+            }
+        }
+
+        // FIND BASELINE ------------------------------------------------------
+
+        PerfSample const * findBaseline( std::string const & name ) const
+        {
+            for( std::size_t s = 0; s < baseline.size(); ++s )
+            {
+                if( baseline[ s ].name == name )
+                {
+                    return &baseline[ s ];
+                }
+            }
+
+            return nullptr;
+        }
+
+        // PARSE SAMPLE -------------------------------------------------------
+
+        // Reads the fields of one sample line, ignoring any baseline
+        // ratios it carries.
+
+        void parseSample( std::string const & line )
+        {
+            std::size_t nameStart = line.find( "\"name\": \"" );
+
+            if( nameStart == std::string::npos )
+            {
+                return;
+            }
+
+            PerfSample sample;
+            std::size_t c = nameStart + 9;
+
+            while( c < line.size() && line[ c ] != '"' )
+            {
+                if( line[ c ] == '\\' && c + 1 < line.size() )
+                {
+                    ++c;
+                }
+
+                sample.name.push_back( line[ c++ ] );
+            }
+
+            std::string fields = line.substr( 0, line.find( "\"baseline\"" ) );
+            double value = 0.0;
+
+            if( parseField( fields, "repetitions", value ) )
+            {
+                sample.repetitions = static_cast< std::size_t >( value );
+            }
+
+            if( parseField( fields, "threads", value ) )
+            {
+                sample.threads = static_cast< std::size_t >( value );
+            }
+
+            parseField( fields, "seconds", sample.seconds );
+
+            for( int k = 0; k < PerfCounters::counterCount; ++k )
+            {
+                char const * name = PerfCounters::getName
+                (
+                    static_cast< PerfCounters::Counter >( k )
+                );
+
+                if( parseField( fields, name, value ) )
+                {
+                    sample.values[ k ] =
+                        static_cast< std::uint64_t >( value );
+                    sample.valid[ k ] = true;
+                }
+            }
+
+            baseline.push_back( sample );
+        }
+
+        // Finds "key": and reads the number after it; false for null or
+        // a missing key
+
+        static bool const parseField
+        (
+            std::string const & fields,
+            char const * key,
+            double & value
+        )
+        {
+            std::string pattern = std::string( "\"" ) + key + "\": ";
+            std::size_t position = fields.find( pattern );
+
+            if( position == std::string::npos )
+            {
+                return false;
+            }
+
+            char const * start = fields.c_str() + position + pattern.size();
+            char * end = nullptr;
+            double parsed = std::strtod( start, &end );
+
+            if( end == start )
+            {
+                return false;
+            }
+
+            value = parsed;
+
+            return true;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        PerfCounters counters;
+        std::size_t threadCount;
+        std::vector< PerfSample > samples;
+        std::vector< PerfSample > baseline;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_PERF_H
@@ -0,0 +1,558 @@
+#ifndef POLYGON_GRAPH_SHORTEST_PATH_H
+#define POLYGON_GRAPH_SHORTEST_PATH_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphAdjacency.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // QUATERNARY HEAP ----------------------------------------------------
+
+        // Min-heap of ( key, vertex ) pairs with four children per node,
+        // which halves the depth of a binary heap and keeps the children
+        // compared on each sift-down within one cache line. There is no
+        // decrease-key: callers push again and skip stale entries.
+
+        class QuaternaryHeap
+        {
+            public:
+
+            class Entry
+            {
+                public:
+
+                double key;
+                std::uint32_t vertex;
+            };
+
+            void clear( void )
+            {
+                entries.clear();
+            }
+
+            bool const isEmpty( void ) const
+            {
+                return entries.empty();
+            }
+
+            void push( double key, std::uint32_t vertex )
+            {
+                std::size_t index = entries.size();
+                entries.push_back( Entry() );
+
+                while( index > 0 )
+                {
+                    std::size_t parent = ( index - 1 ) / 4;
+
+                    if( entries[ parent ].key <= key )
+                    {
+                        break;
+                    }
+
+                    entries[ index ] = entries[ parent ];
+                    index = parent;
+                }
+
+                entries[ index ].key = key;
+                entries[ index ].vertex = vertex;
+            }
+
+            Entry const pop( void )
+            {
+                Entry top = entries[ 0 ];
+                Entry last = entries.back();
+                entries.pop_back();
+
+                std::size_t count = entries.size();
+                std::size_t index = 0;
+
+                if( count == 0 )
+                {
+                    return top;
+                }
+
+                while( true )
+                {
+                    std::size_t first = index * 4 + 1;
+
+                    if( first >= count )
+                    {
+                        break;
+                    }
+
+                    std::size_t end = std::min( first + 4, count );
+                    std::size_t least = first;
+
+                    for( std::size_t c = first + 1; c < end; ++c )
+                    {
+                        if( entries[ c ].key < entries[ least ].key )
+                        {
+                            least = c;
+                        }
+                    }
+
+                    if( last.key <= entries[ least ].key )
+                    {
+                        break;
+                    }
+
+                    entries[ index ] = entries[ least ];
+                    index = least;
+                }
+
+                entries[ index ] = last;
+
+                return top;
+            }
+
+            std::vector< Entry > entries;
+        };
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // SHORTEST PATHS CLASS +++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Dijkstra's algorithm over a VertexAdjacency, so relaxation walks
+    // contiguous neighbour rows instead of edge set nodes. Weights are
+    // stored per CSR entry; until set, every edge has weight one and
+    // distances count edges. Results are dense arrays indexed like the
+    // adjacency, so the adjacency must outlive the engine and be rebuilt
+    // (followed by the weights) when the graph changes.
+
+    template< class Traits = DefaultPGTraits >
+    class ShortestPaths
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef VertexAdjacency< Traits > Adjacency;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::VertexIterator VertexIterator;
+
+        static std::uint32_t const noVertex = 0xffffffff;
+
+        // RESULT CLASS -------------------------------------------------------
+
+        // distances[ i ] is the distance of adjacency vertex i from the
+        // nearest source, or infinity if it was not reached; predecessors
+        // [ i ] is the vertex before it on a shortest path, or noVertex for
+        // sources and unreached vertices.
+
+        class Result
+        {
+            public:
+
+            std::vector< double > distances;
+            std::vector< std::uint32_t > predecessors;
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        ShortestPaths( Adjacency const & adjacency )
+        {
+            this->adjacency = &adjacency;
+        }
+
+        // SET WEIGHTS --------------------------------------------------------
+
+        // Sets each edge's weight to weight( source, target ) for the two
+        // vertex handles. Weights must not be negative.
+
+        template< class WeightFunction >
+        void setWeights
+        (
+            WeightFunction weight,
+            size_type threadCount = 0
+        )
+        {
+            Adjacency const & csr = *adjacency;
+            weights.resize( csr.neighbours.size() );
+
+            parallelFor
+            (
+                csr.getVertexCount(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    for( std::size_t v = begin; v < end; ++v )
+                    {
+                        for( std::uint32_t n = csr.offsets[ v ];
+                             n < csr.offsets[ v + 1 ]; ++n )
+                        {
+                            weights[ n ] = weight
+                            (
+                                csr.vertices[ v ],
+                                csr.vertices[ csr.neighbours[ n ] ]
+                            );
+                        }
+                    }
+                }
+            );
+        }
+
+        // Sets each edge's weight to its length, with positions read
+        // through accessor as in the other geometry modules.
+
+        template< class PositionAccessor = MemberPosition >
+        void setEdgeLengths
+        (
+            PositionAccessor accessor = PositionAccessor(),
+            size_type threadCount = 0
+        )
+        {
+            setWeights
+            (
+                [ & ]( VertexIterator source, VertexIterator target )
+                {
+                    double length = 0.0;
+
+                    for( int axis = 0; axis < 3; ++axis )
+                    {
+                        double delta =
+                            double( accessor( *target )[ axis ] ) -
+                            double( accessor( *source )[ axis ] );
+                        length += delta * delta;
+                    }
+
+                    return std::sqrt( length );
+                },
+                threadCount
+            );
+        }
+
+        // Restores unit weights.
+
+        void clearWeights( void )
+        {
+            weights.clear();
+        }
+
+        // FIND PATHS ---------------------------------------------------------
+
+        // Distances from the nearest of sources to every vertex within
+        // maxDistance; the search stops once the next vertex is further.
+        // Sources and targets missing from the adjacency are ignored.
+
+        void findPaths
+        (
+            std::vector< VertexIterator > const & sources,
+            Result & result,
+            double maxDistance = std::numeric_limits< double >::infinity()
+        ) const
+        {
+            detail::QuaternaryHeap heap;
+            std::vector< std::uint32_t > indices = getIndices( sources );
+
+            search( indices.data(), indices.size(), nullptr, 0, maxDistance,
+                    result, heap );
+        }
+
+        // As above, but also stops as soon as every one of targets has
+        // been reached, leaving further vertices unreached.
+
+        void findPaths
+        (
+            std::vector< VertexIterator > const & sources,
+            std::vector< VertexIterator > const & targets,
+            Result & result,
+            double maxDistance = std::numeric_limits< double >::infinity()
+        ) const
+        {
+            detail::QuaternaryHeap heap;
+            std::vector< std::uint32_t > sourceIndices =
+                getIndices( sources );
+            std::vector< std::uint32_t > targetIndices =
+                getIndices( targets );
+
+            search( sourceIndices.data(), sourceIndices.size(),
+                    targetIndices.data(), targetIndices.size(), maxDistance,
+                    result, heap );
+        }
+
+        // FIND PATHS BATCH ---------------------------------------------------
+
+        // Runs one single-source search per entry of sources, spread over
+        // threads, with results[ i ] holding the search from sources[ i ].
+        // A source missing from the adjacency reaches nothing.
+
+        void findPathsBatch
+        (
+            std::vector< VertexIterator > const & sources,
+            std::vector< Result > & results,
+            double maxDistance = std::numeric_limits< double >::infinity(),
+            size_type threadCount = 0
+        ) const
+        {
+            PG_TRACE_SCOPE( "ShortestPaths::findPathsBatch" );
+
+            std::vector< std::uint32_t > indices = getIndices( sources );
+            results.resize( indices.size() );
+
+            parallelFor
+            (
+                indices.size(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    detail::QuaternaryHeap heap;
+
+                    for( std::size_t s = begin; s < end; ++s )
+                    {
+                        search( &indices[ s ], 1, nullptr, 0, maxDistance,
+                                results[ s ], heap );
+                    }
+                },
+                1
+            );
+        }
+
+        // GET DISTANCE -------------------------------------------------------
+
+        // Returns infinity for vertices missing from the adjacency.
+
+        double const getDistance
+        (
+            Result const & result,
+            VertexIterator vertex
+        ) const
+        {
+            std::uint32_t index = adjacency->getIndex( vertex );
+
+            return index == noVertex
+                   ? std::numeric_limits< double >::infinity()
+                   : result.distances[ index ];
+        }
+
+        // GET PATH -----------------------------------------------------------
+
+        // Fills path with the vertices from the nearest source to target,
+        // inclusive. Returns false, leaving path empty, if target was not
+        // reached.
+
+        bool const getPath
+        (
+            Result const & result,
+            VertexIterator target,
+            std::vector< VertexIterator > & path
+        ) const
+        {
+            path.clear();
+
+            std::uint32_t vertex = adjacency->getIndex( target );
+
+            if( vertex == noVertex || result.distances[ vertex ] ==
+                std::numeric_limits< double >::infinity() )
+            {
+                return false;
+            }
+
+            while( vertex != noVertex )
+            {
+                path.push_back( adjacency->vertices[ vertex ] );
+                vertex = result.predecessors[ vertex ];
+            }
+
+            std::reverse( path.begin(), path.end() );
+
+            return true;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // GET INDICES --------------------------------------------------------
+
+        std::vector< std::uint32_t > getIndices
+        (
+            std::vector< VertexIterator > const & vertices
+        ) const
+        {
+            std::vector< std::uint32_t > indices;
+            indices.reserve( vertices.size() );
+
+            for( std::size_t v = 0; v < vertices.size(); ++v )
+            {
+                indices.push_back( adjacency->getIndex( vertices[ v ] ) );
+            }
+
+            return indices;
+        }
+
+        // SEARCH -------------------------------------------------------------
+
+        void search
+        (
+            std::uint32_t const * sources,
+            std::size_t sourceCount,
+            std::uint32_t const * targets,
+            std::size_t targetCount,
+            double maxDistance,
+            Result & result,
+            detail::QuaternaryHeap & heap
+        ) const
+        {
+            Adjacency const & csr = *adjacency;
+            std::uint32_t const * offsets = csr.offsets.data();
+            std::uint32_t const * neighbours = csr.neighbours.data();
+            double const * edgeWeights =
+                weights.empty() ? nullptr : weights.data();
+
+            result.distances.assign
+            (
+                csr.getVertexCount(),
+                std::numeric_limits< double >::infinity()
+            );
+            result.predecessors.assign( csr.getVertexCount(), noVertex );
+
+            double * distances = result.distances.data();
+            std::uint32_t * predecessors = result.predecessors.data();
+
+            // Mark targets, counting each once. Vertices missing from the
+            // adjacency come through as noVertex and are skipped.
+
+            std::vector< std::uint8_t > isTarget;
+            std::size_t remaining = 0;
+
+            if( targetCount != 0 )
+            {
+                isTarget.assign( csr.getVertexCount(), 0 );
+
+                for( std::size_t t = 0; t < targetCount; ++t )
+                {
+                    if( targets[ t ] == noVertex )
+                    {
+                        continue;
+                    }
+
+                    remaining += isTarget[ targets[ t ] ] == 0 ? 1 : 0;
+                    isTarget[ targets[ t ] ] = 1;
+                }
+            }
+
+            heap.clear();
+
+            for( std::size_t s = 0; s < sourceCount; ++s )
+            {
+                if( sources[ s ] != noVertex &&
+                    distances[ sources[ s ] ] != 0.0 )
+                {
+                    distances[ sources[ s ] ] = 0.0;
+                    heap.push( 0.0, sources[ s ] );
+                }
+            }
+
+            // Settle vertices in order of distance. An entry is current
+            // only if it matches the vertex's distance, since improvements
+            // are pushed rather than decreased in place.
+
+            while( !heap.isEmpty() )
+            {
+                detail::QuaternaryHeap::Entry entry = heap.pop();
+                std::uint32_t vertex = entry.vertex;
+
+                if( entry.key != distances[ vertex ] )
+                {
+                    continue;
+                }
+
+                if( entry.key > maxDistance )
+                {
+                    distances[ vertex ] =
+                        std::numeric_limits< double >::infinity();
+                    predecessors[ vertex ] = noVertex;
+                    break;
+                }
+
+                if( remaining != 0 && isTarget[ vertex ] != 0 &&
+                    --remaining == 0 )
+                {
+                    break;
+                }
+
+                for( std::uint32_t n = offsets[ vertex ];
+                     n < offsets[ vertex + 1 ]; ++n )
+                {
+                    std::uint32_t neighbour = neighbours[ n ];
+                    double distance = entry.key +
+                        ( edgeWeights != nullptr ? edgeWeights[ n ] : 1.0 );
+
+                    if( distance < distances[ neighbour ] )
+                    {
+                        distances[ neighbour ] = distance;
+                        predecessors[ neighbour ] = vertex;
+                        heap.push( distance, neighbour );
+                    }
+                }
+            }
+
+            // Vertices left tentative were not reached within the limits.
+            // Their current entries are still queued; settled vertices only
+            // have stale ones left.
+
+            while( !heap.isEmpty() )
+            {
+                detail::QuaternaryHeap::Entry entry = heap.pop();
+
+                if( entry.key == distances[ entry.vertex ] )
+                {
+                    distances[ entry.vertex ] =
+                        std::numeric_limits< double >::infinity();
+                    predecessors[ entry.vertex ] = noVertex;
+                }
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        Adjacency const * adjacency;
+        std::vector< double > weights;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    template< class Traits >
+    std::uint32_t const ShortestPaths< Traits >::noVertex;
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_SHORTEST_PATH_H
@@ -0,0 +1,490 @@
+#ifndef POLYGON_GRAPH_SMOOTHING_H
+#define POLYGON_GRAPH_SMOOTHING_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphAdjacency.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // LAPLACIAN SMOOTHER CLASS +++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Laplacian and Taubin smoothing over a VertexAdjacency. build() reads
+    // the vertex positions into structure-of-arrays buffers and computes
+    // one normalised weight per CSR entry; each iteration is then a
+    // parallel sweep over the neighbour rows from one buffer into the
+    // other, and apply() writes the result back through the accessor.
+    // The adjacency must outlive the smoother.
+
+    template< class Traits = DefaultPGTraits,
+              class PositionAccessor = MemberPosition >
+    class LaplacianSmoother
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef PolygonGraph< Traits > Graph;
+        typedef VertexAdjacency< Traits > Adjacency;
+        typedef typename Graph::size_type size_type;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::EdgeIterator EdgeIterator;
+        typedef typename Graph::VertexIterator VertexIterator;
+
+        enum Weighting
+        {
+            uniformWeights,
+            cotangentWeights
+        };
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        LaplacianSmoother
+        (
+            Adjacency const & adjacency,
+            PositionAccessor accessor = PositionAccessor()
+        )
+        {
+            this->adjacency = &adjacency;
+            this->accessor = accessor;
+            this->current = 0;
+            this->fixedBoundary = false;
+        }
+
+        // BUILD --------------------------------------------------------------
+
+        // Reads positions and computes weights. Uniform weights average
+        // the neighbours. Cotangent weights use the angles opposite each
+        // edge in the polygons either side of it, which is exact for
+        // triangles; other polygons use the angles of the triangles their
+        // corners span. Negative cotangents are clamped to zero so every
+        // step stays a convex combination. Vertices with no neighbours, or
+        // on the boundary while it is fixed, do not move.
+
+        void build
+        (
+            Weighting weighting = uniformWeights,
+            size_type threadCount = 0
+        )
+        {
+            PG_TRACE_SCOPE( "LaplacianSmoother::build" );
+
+            Adjacency const & csr = *adjacency;
+            size_type vertexCount = csr.getVertexCount();
+
+            current = 0;
+
+            for( int buffer = 0; buffer < 2; ++buffer )
+            {
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    positions[ buffer ][ axis ].resize( vertexCount );
+                }
+            }
+
+            weights.assign( csr.neighbours.size(), 0.0f );
+            boundary.assign( vertexCount, 0 );
+
+            gather( threadCount );
+
+            parallelFor
+            (
+                vertexCount, threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    std::vector< std::uint8_t > sides;
+
+                    for( std::size_t v = begin; v < end; ++v )
+                    {
+                        buildRow( v, weighting, sides );
+                    }
+                }
+            );
+        }
+
+        // FIXED BOUNDARY -----------------------------------------------------
+
+        // Keeps boundary vertices, those with an edge used by only one
+        // polygon, in place. Off by default.
+
+        void setFixedBoundary( bool fixed = true )
+        {
+            fixedBoundary = fixed;
+        }
+
+        bool const isBoundary( std::uint32_t vertex ) const
+        {
+            return boundary[ vertex ] != 0;
+        }
+
+        // GATHER -------------------------------------------------------------
+
+        // Re-reads positions, e.g. after the graph's vertices were moved,
+        // keeping the weights.
+
+        void gather( size_type threadCount = 0 )
+        {
+            Adjacency const & csr = *adjacency;
+
+            parallelFor
+            (
+                csr.getVertexCount(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    for( std::size_t v = begin; v < end; ++v )
+                    {
+                        for( int axis = 0; axis < 3; ++axis )
+                        {
+                            positions[ current ][ axis ][ v ] =
+                                static_cast< float >
+                                (
+                                    accessor( *csr.vertices[ v ] )[ axis ]
+                                );
+                        }
+                    }
+                }
+            );
+        }
+
+        // SMOOTH -------------------------------------------------------------
+
+        // Moves each vertex lambda of the way towards the weighted average
+        // of its neighbours, iterations times. Shrinks the mesh.
+
+        void smooth
+        (
+            size_type iterations,
+            float lambda = 0.5f,
+            size_type threadCount = 0
+        )
+        {
+            PG_TRACE_SCOPE( "LaplacianSmoother::smooth" );
+
+            for( size_type i = 0; i < iterations; ++i )
+            {
+                step( lambda, threadCount );
+            }
+        }
+
+        // SMOOTH TAUBIN ------------------------------------------------------
+
+        // Alternates a shrinking step of lambda with an inflating step of
+        // mu, which must be negative with |mu| slightly above lambda, so
+        // noise is removed without the mesh shrinking. Each iteration is
+        // one pair of steps.
+
+        void smoothTaubin
+        (
+            size_type iterations,
+            float lambda = 0.5f,
+            float mu = -0.53f,
+            size_type threadCount = 0
+        )
+        {
+            PG_TRACE_SCOPE( "LaplacianSmoother::smoothTaubin" );
+
+            for( size_type i = 0; i < iterations; ++i )
+            {
+                step( lambda, threadCount );
+                step( mu, threadCount );
+            }
+        }
+
+        // APPLY --------------------------------------------------------------
+
+        // Writes the smoothed positions back to the graph's vertices.
+        // Smoothing runs in single precision; vertices that do not move
+        // are skipped, so they keep their exact positions.
+
+        void apply( size_type threadCount = 0 )
+        {
+            Adjacency const & csr = *adjacency;
+
+            parallelFor
+            (
+                csr.getVertexCount(), threadCount,
+                [ & ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    for( std::size_t v = begin; v < end; ++v )
+                    {
+                        if( isFixed( v ) )
+                        {
+                            continue;
+                        }
+
+                        auto && position = accessor( *csr.vertices[ v ] );
+
+                        for( int axis = 0; axis < 3; ++axis )
+                        {
+                            position[ axis ] =
+                                positions[ current ][ axis ][ v ];
+                        }
+                    }
+                }
+            );
+        }
+
+        // GET POSITION -------------------------------------------------------
+
+        void getPosition( std::uint32_t vertex, float * position ) const
+        {
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                position[ axis ] = positions[ current ][ axis ][ vertex ];
+            }
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // IS FIXED -----------------------------------------------------------
+
+        bool const isFixed( std::size_t vertex ) const
+        {
+            Adjacency const & csr = *adjacency;
+
+            return csr.offsets[ vertex ] == csr.offsets[ vertex + 1 ] ||
+                   ( fixedBoundary && boundary[ vertex ] != 0 );
+        }
+
+        // FIND ENTRY ---------------------------------------------------------
+
+        std::uint32_t const findEntry
+        (
+            std::uint32_t vertex,
+            std::uint32_t neighbour
+        ) const
+        {
+            Adjacency const & csr = *adjacency;
+            std::uint32_t const * first =
+                csr.neighbours.data() + csr.offsets[ vertex ];
+            std::uint32_t const * last =
+                csr.neighbours.data() + csr.offsets[ vertex + 1 ];
+
+            return static_cast< std::uint32_t >
+            (
+                std::lower_bound( first, last, neighbour ) -
+                csr.neighbours.data()
+            );
+        }
+
+        // GET COTANGENT ------------------------------------------------------
+
+        // Cotangent of the angle at corner between a and b.
+
+        float const getCotangent
+        (
+            std::uint32_t corner,
+            std::uint32_t a,
+            std::uint32_t b
+        ) const
+        {
+            float u[ 3 ];
+            float w[ 3 ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                float origin = positions[ current ][ axis ][ corner ];
+                u[ axis ] = positions[ current ][ axis ][ a ] - origin;
+                w[ axis ] = positions[ current ][ axis ][ b ] - origin;
+            }
+
+            float dot = u[ 0 ] * w[ 0 ] + u[ 1 ] * w[ 1 ] + u[ 2 ] * w[ 2 ];
+            float cx = u[ 1 ] * w[ 2 ] - u[ 2 ] * w[ 1 ];
+            float cy = u[ 2 ] * w[ 0 ] - u[ 0 ] * w[ 2 ];
+            float cz = u[ 0 ] * w[ 1 ] - u[ 1 ] * w[ 0 ];
+            float sine = std::sqrt( cx * cx + cy * cy + cz * cz );
+
+            return sine > 0.0f ? dot / sine : 0.0f;
+        }
+
+        // BUILD ROW ----------------------------------------------------------
+
+        // Weights of vertex v's row. Every polygon around v is reached
+        // through the half-edge leaving v, whose ring neighbours give both
+        // of v's edges in that polygon, so the row is built without
+        // touching other rows. sides records which half-edges of each
+        // pair exist, to find boundary edges.
+
+        void buildRow
+        (
+            std::size_t v,
+            Weighting weighting,
+            std::vector< std::uint8_t > & sides
+        )
+        {
+            Adjacency const & csr = *adjacency;
+            std::uint32_t first = csr.offsets[ v ];
+            std::uint32_t last = csr.offsets[ v + 1 ];
+            std::uint32_t vertex = static_cast< std::uint32_t >( v );
+
+            sides.assign( last - first, 0 );
+
+            VertexIterator source = csr.vertices[ v ];
+            EdgeIterator edgeItEnd = source->endEdges();
+            EdgeIterator edgeIt = source->beginEdges();
+
+            while( edgeIt != edgeItEnd )
+            {
+                Edge & edge = *edgeIt;
+                Edge * previous = edge.getPreviousEdge();
+
+                // This polygon's corner at v runs from h through v to j;
+                // k follows j
+
+                std::uint32_t j = csr.getIndex( edge.getTargetVertex() );
+                std::uint32_t k = csr.getIndex
+                (
+                    edge.getNextEdge()->getTargetVertex()
+                );
+                std::uint32_t h = csr.getIndex
+                (
+                    previous->getPreviousEdge()->getTargetVertex()
+                );
+
+                std::uint32_t toJ = findEntry( vertex, j );
+                std::uint32_t toH = findEntry( vertex, h );
+
+                sides[ toJ - first ] |= 1;
+                sides[ toH - first ] |= 2;
+
+                if( weighting == cotangentWeights )
+                {
+                    weights[ toJ ] += 0.5f * getCotangent( k, vertex, j );
+                    weights[ toH ] += 0.5f * getCotangent( j, h, vertex );
+                }
+
+                ++edgeIt;
+            }
+
+            // Clamp and normalise. Rows left without weight, which is all
+            // of them for uniform weighting, get equal weights.
+
+            float sum = 0.0f;
+
+            for( std::uint32_t n = first; n < last; ++n )
+            {
+                weights[ n ] = std::max( weights[ n ], 0.0f );
+                sum += weights[ n ];
+                boundary[ v ] |= sides[ n - first ] != 3 ? 1 : 0;
+            }
+
+            for( std::uint32_t n = first; n < last; ++n )
+            {
+                weights[ n ] = sum > 0.0f ?
+                    weights[ n ] / sum :
+                    1.0f / static_cast< float >( last - first );
+            }
+        }
+
+        // STEP ---------------------------------------------------------------
+
+        // One sweep: p' = p + factor * ( weighted neighbour average - p ),
+        // read from the current buffer and written to the other.
+
+        void step( float factor, size_type threadCount )
+        {
+            Adjacency const & csr = *adjacency;
+            std::uint32_t const * offsets = csr.offsets.data();
+            std::uint32_t const * neighbours = csr.neighbours.data();
+            float const * rowWeights = weights.data();
+            std::uint8_t const * onBoundary = boundary.data();
+            bool fixed = fixedBoundary;
+
+            float const * inX = positions[ current ][ 0 ].data();
+            float const * inY = positions[ current ][ 1 ].data();
+            float const * inZ = positions[ current ][ 2 ].data();
+            float * outX = positions[ 1 - current ][ 0 ].data();
+            float * outY = positions[ 1 - current ][ 1 ].data();
+            float * outZ = positions[ 1 - current ][ 2 ].data();
+
+            parallelFor
+            (
+                csr.getVertexCount(), threadCount,
+                [ = ]( std::size_t begin, std::size_t end, std::size_t )
+                {
+                    for( std::size_t v = begin; v < end; ++v )
+                    {
+                        std::uint32_t first = offsets[ v ];
+                        std::uint32_t last = offsets[ v + 1 ];
+
+                        if( first == last || ( fixed && onBoundary[ v ] ) )
+                        {
+                            outX[ v ] = inX[ v ];
+                            outY[ v ] = inY[ v ];
+                            outZ[ v ] = inZ[ v ];
+                            continue;
+                        }
+
+                        float x = 0.0f;
+                        float y = 0.0f;
+                        float z = 0.0f;
+
+                        for( std::uint32_t n = first; n < last; ++n )
+                        {
+                            float weight = rowWeights[ n ];
+                            std::uint32_t u = neighbours[ n ];
+
+                            x += weight * inX[ u ];
+                            y += weight * inY[ u ];
+                            z += weight * inZ[ u ];
+                        }
+
+                        outX[ v ] = inX[ v ] + factor * ( x - inX[ v ] );
+                        outY[ v ] = inY[ v ] + factor * ( y - inY[ v ] );
+                        outZ[ v ] = inZ[ v ] + factor * ( z - inZ[ v ] );
+                    }
+                }
+            );
+
+            current = 1 - current;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        Adjacency const * adjacency;
+        PositionAccessor accessor;
+        int current;
+        bool fixedBoundary;
+
+        std::vector< float > positions[ 2 ][ 3 ];
+        std::vector< float > weights;
+        std::vector< std::uint8_t > boundary;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_SMOOTHING_H
@@ -0,0 +1,326 @@
+#ifndef POLYGON_GRAPH_TRACE_H
+#define POLYGON_GRAPH_TRACE_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TRACE MACROS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// PG_TRACE_SCOPE( "name" ) records a span from that point to the end of the
+// enclosing scope. Spans are only recorded when POLYGON_GRAPH_TRACE is
+// defined; otherwise the macro expands to nothing. Names must outlive the
+// trace, so use string literals.
+
+#if !defined( POLYGON_GRAPH_TRACE_CAPACITY )
+#define POLYGON_GRAPH_TRACE_CAPACITY 65536
+#endif
+
+#define PG_TRACE_JOIN_( a, b ) a ## b
+#define PG_TRACE_JOIN( a, b ) PG_TRACE_JOIN_( a, b )
+
+#if defined( POLYGON_GRAPH_TRACE )
+#define PG_TRACE_SCOPE( name ) \
+    graph::TraceScope PG_TRACE_JOIN( pgTraceScope, __LINE__ )( name )
+#else
+#define PG_TRACE_SCOPE( name )
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // DETAIL NAMESPACE +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // TRACE EVENT --------------------------------------------------------
+
+        class TraceEvent
+        {
+            public:
+
+            char const * name;
+            std::uint64_t begin;
+            std::uint64_t end;
+        };
+
+        // TRACE RING ---------------------------------------------------------
+
+        // Fixed-size buffer of the most recent spans of the thread holding
+        // it. Only that thread writes; the count is published with release
+        // order so a reader sees every event below it. Older events are
+        // overwritten once the ring is full.
+
+        class TraceRing
+        {
+            public:
+
+            static std::size_t const capacity = POLYGON_GRAPH_TRACE_CAPACITY;
+
+            static_assert( ( capacity & ( capacity - 1 ) ) == 0,
+                           "Trace capacity must be a power of two" );
+
+            TraceRing( std::uint32_t thread )
+            : events( capacity )
+            {
+                this->thread = thread;
+                this->count.store( 0, std::memory_order_relaxed );
+            }
+
+            void push( char const * name,
+                       std::uint64_t begin,
+                       std::uint64_t end )
+            {
+                std::uint64_t index = count.load( std::memory_order_relaxed );
+                TraceEvent & event = events[ index & ( capacity - 1 ) ];
+
+                event.name = name;
+                event.begin = begin;
+                event.end = end;
+
+                count.store( index + 1, std::memory_order_release );
+            }
+
+            std::uint32_t thread;
+            std::atomic< std::uint64_t > count;
+            std::vector< TraceEvent > events;
+        };
+
+        // TRACE REGISTRY -----------------------------------------------------
+
+        // Owns every ring so spans survive the threads that recorded them.
+        // A thread takes a ring when its first span begins and hands it
+        // back when it exits, so short-lived worker threads reuse rings
+        // rather than allocating new ones; a track in the output is
+        // therefore a ring, which may have been used by several threads one
+        // after another. Taking the ring at the start of the span keeps
+        // a later thread's spans from overlapping an earlier thread's spans
+        // on the same track.
+        // The lock is only taken when a thread takes or returns its ring
+        // and when the trace is written or cleared.
+
+        class TraceRegistry
+        {
+            public:
+
+            static TraceRegistry & getInstance( void )
+            {
+                static TraceRegistry registry;
+
+                return registry;
+            }
+
+            TraceRing & getRing( void )
+            {
+                thread_local RingLease lease;
+
+                if( lease.ring == nullptr )
+                {
+                    lease.ring = acquire();
+                }
+
+                return *lease.ring;
+            }
+
+            std::uint64_t const getTime( void ) const
+            {
+                return static_cast< std::uint64_t >
+                (
+                    std::chrono::duration_cast< std::chrono::nanoseconds >
+                    (
+                        std::chrono::steady_clock::now() - epoch
+                    ).count()
+                );
+            }
+
+            std::mutex mutex;
+            std::vector< std::unique_ptr< TraceRing > > rings;
+            std::vector< TraceRing * > freeRings;
+            std::chrono::steady_clock::time_point epoch;
+
+            private:
+
+            class RingLease
+            {
+                public:
+
+                RingLease( void )
+                {
+                    this->ring = nullptr;
+                }
+
+                ~RingLease( void )
+                {
+                    if( ring != nullptr )
+                    {
+                        getInstance().release( ring );
+                    }
+                }
+
+                TraceRing * ring;
+            };
+
+            TraceRegistry( void )
+            {
+                this->epoch = std::chrono::steady_clock::now();
+            }
+
+            TraceRing * acquire( void )
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+
+                if( !freeRings.empty() )
+                {
+                    TraceRing * ring = freeRings.back();
+                    freeRings.pop_back();
+                    return ring;
+                }
+
+                std::uint32_t thread =
+                    static_cast< std::uint32_t >( rings.size() );
+                rings.emplace_back( new TraceRing( thread ) );
+
+                return rings.back().get();
+            }
+
+            void release( TraceRing * ring )
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+                freeRings.push_back( ring );
+            }
+        };
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // TRACE SCOPE CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Records one span into the calling thread's ring when destroyed.
+    // Normally created through PG_TRACE_SCOPE.
+
+    class TraceScope
+    {
+        public:
+
+        TraceScope( char const * name )
+        {
+            detail::TraceRegistry & registry =
+                detail::TraceRegistry::getInstance();
+
+            this->name = name;
+            this->ring = &registry.getRing();
+            this->begin = registry.getTime();
+        }
+
+        ~TraceScope( void )
+        {
+            ring->push( name, begin,
+                        detail::TraceRegistry::getInstance().getTime() );
+        }
+
+        private:
+
+        TraceScope( TraceScope const & other );
+        TraceScope const & operator = ( TraceScope const & other );
+
+        char const * name;
+        detail::TraceRing * ring;
+        std::uint64_t begin;
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // TRACE FUNCTIONS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // WRITE CHROME TRACE -----------------------------------------------------
+
+    // Writes the recorded spans in Chrome trace-event JSON, loadable in
+    // chrome://tracing or Perfetto, with one track per ring.
+    // Call it while no traced operation is running: a ring that wraps
+    // during the write may yield a mix of old and new spans. Returns false
+    // if the file cannot be written.
+
+    inline bool const writeChromeTrace( char const * path )
+    {
+        std::FILE * file = std::fopen( path, "wb" );
+
+        if( file == nullptr )
+        {
+            return false;
+        }
+
+        detail::TraceRegistry & registry =
+            detail::TraceRegistry::getInstance();
+        std::lock_guard< std::mutex > lock( registry.mutex );
+
+        std::size_t const capacity = detail::TraceRing::capacity;
+        bool first = true;
+
+        std::fprintf( file, "{\"traceEvents\":[" );
+
+        for( std::size_t r = 0; r < registry.rings.size(); ++r )
+        {
+            detail::TraceRing const & ring = *registry.rings[ r ];
+            std::uint64_t end = ring.count.load( std::memory_order_acquire );
+            std::uint64_t begin = end > capacity ? end - capacity : 0;
+
+            for( std::uint64_t e = begin; e < end; ++e )
+            {
+                detail::TraceEvent const & event =
+                    ring.events[ e & ( capacity - 1 ) ];
+
+                std::fprintf( file, "%s\n{\"name\":\"%s\",\"ph\":\"X\","
+                                    "\"ts\":%.3f,\"dur\":%.3f,"
+                                    "\"pid\":1,\"tid\":%u}",
+                              first ? "" : ",",
+                              event.name,
+                              event.begin / 1000.0,
+                              ( event.end - event.begin ) / 1000.0,
+                              static_cast< unsigned >( ring.thread ) );
+                first = false;
+            }
+        }
+
+        std::fprintf( file, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+
+        return std::fclose( file ) == 0;
+    }
+
+    // CLEAR TRACE ------------------------------------------------------------
+
+    // Drops all recorded spans. Like writeChromeTrace, call it only while
+    // no traced operation is running.
+
+    inline void clearTrace( void )
+    {
+        detail::TraceRegistry & registry =
+            detail::TraceRegistry::getInstance();
+        std::lock_guard< std::mutex > lock( registry.mutex );
+
+        for( std::size_t r = 0; r < registry.rings.size(); ++r )
+        {
+            registry.rings[ r ]->count.store( 0, std::memory_order_relaxed );
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_TRACE_H
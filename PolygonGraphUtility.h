@@ -0,0 +1,329 @@
+#ifndef POLYGON_GRAPH_UTILITY_H
+#define POLYGON_GRAPH_UTILITY_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "PolygonGraphTrace.h"
+
+// Modules with vector kernels include <immintrin.h> when this is defined
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && \
+    ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define POLYGON_GRAPH_X86_SIMD
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // MEMBER POSITION ACCESSOR CLASS +++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Default position accessor for the geometry modules. An accessor is
+    // called with a vertex (or its BaseVertex) and returns something
+    // indexable by 0, 1 and 2; this one returns the vertex's "position"
+    // member, so any BaseVertex declaring e.g. "float position[ 3 ]" works.
+
+    class MemberPosition
+    {
+        public:
+
+        template< class Vertex >
+        auto operator () ( Vertex & vertex ) const
+            -> decltype( ( vertex.position ) )
+        {
+            return vertex.position;
+        }
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // INDEXED ITERATOR CLASS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Forward iterator over an array of indices that dereferences to the
+    // matching entry of a handle table. Lets index lists be passed straight
+    // to PolygonGraph::addPolygon without first gathering the handles.
+
+    template< class Handle, class Index >
+    class IndexedIterator
+    {
+        public:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC TYPES +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef Handle                      value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef Handle const *              pointer;
+        typedef Handle const &              reference;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // CONSTRUCTORS -------------------------------------------------------
+
+        IndexedIterator( void )
+        {
+            this->table = nullptr;
+            this->index = nullptr;
+        }
+
+        IndexedIterator( Handle const * table, Index const * index )
+        {
+            this->table = table;
+            this->index = index;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PUBLIC OPERATORS +++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // EQUALITY -----------------------------------------------------------
+
+        bool const operator == ( IndexedIterator const & other ) const
+        {
+            return this->index == other.index;
+        }
+
+        // INEQUALITY ---------------------------------------------------------
+
+        bool const operator != ( IndexedIterator const & other ) const
+        {
+            return this->index != other.index;
+        }
+
+        // INDIRECTION --------------------------------------------------------
+
+        Handle const & operator * ( void ) const
+        {
+            return table[ *index ];
+        }
+
+        // STRUCTURE DEREFERENCE ----------------------------------------------
+
+        Handle const * operator -> ( void ) const
+        {
+            return &( table[ *index ] );
+        }
+
+        // INCREMENT ----------------------------------------------------------
+
+        IndexedIterator & operator ++ ( void ) // prefix
+        {
+            ++index;
+            return *this;
+        }
+
+        IndexedIterator const operator ++ ( int ) // postfix
+        {
+            IndexedIterator copy( *this );
+            ++index;
+            return copy;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        private:
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // PRIVATE DATA +++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        Handle const * table;
+        Index const * index;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    };
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // SIMD LEVELS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Instruction sets the vector kernels may use, chosen at run time. A
+    // module runs the widest kernel it has at or below the level set: the
+    // BVH's four-lane batches take SSE at every level above simdScalar.
+
+    enum SimdLevel
+    {
+        simdScalar,
+        simdAvx2,
+        simdAvx512
+    };
+
+    // GET SUPPORTED SIMD LEVEL -----------------------------------------------
+
+    // Widest instruction set the running CPU supports, checked once.
+    // Always simdScalar off x86 or with compilers lacking target
+    // attributes.
+
+    inline SimdLevel const getSupportedSimdLevel( void )
+    {
+        #if defined( POLYGON_GRAPH_X86_SIMD )
+
+        static SimdLevel const level =
+            __builtin_cpu_supports( "avx512f" ) ? simdAvx512 :
+            __builtin_cpu_supports( "avx2" ) ? simdAvx2 : simdScalar;
+
+        return level;
+
+        #else
+
+        return simdScalar;
+
+        #endif
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // THREADING FUNCTIONS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // GET THREAD COUNT -------------------------------------------------------
+
+    // Resolves a requested thread count, where zero means one thread per
+    // hardware thread.
+
+    inline std::size_t const getThreadCount( std::size_t requested )
+    {
+        if( requested != 0 )
+        {
+            return requested;
+        }
+
+        std::size_t hardware = std::thread::hardware_concurrency();
+
+        return hardware == 0 ? 1 : hardware;
+    }
+
+    // PARALLEL FOR -----------------------------------------------------------
+
+    // Splits [0, count) into one contiguous block per thread and calls
+    // function( begin, end, threadIndex ) for each block. The calling
+    // thread processes the first block; small ranges run inline. If a
+    // block throws, the other blocks still run to completion and every
+    // worker is joined before the exception of the lowest-numbered block
+    // that threw is rethrown. Blocks whose worker thread cannot be started
+    // run on the calling thread instead.
+
+    template< class Function >
+    void parallelFor
+    (
+        std::size_t count,
+        std::size_t threadCount,
+        Function function,
+        std::size_t minimumBlock = 1024
+    )
+    {
+        threadCount = getThreadCount( threadCount );
+
+        if( minimumBlock == 0 )
+        {
+            minimumBlock = 1;
+        }
+
+        if( threadCount > ( count + minimumBlock - 1 ) / minimumBlock )
+        {
+            threadCount = ( count + minimumBlock - 1 ) / minimumBlock;
+        }
+
+        if( threadCount <= 1 )
+        {
+            if( count != 0 )
+            {
+                function( std::size_t( 0 ), count, std::size_t( 0 ) );
+            }
+
+            return;
+        }
+
+        // Each block is traced as its own span on the thread running it,
+        // and keeps what it throws for the calling thread
+
+        std::vector< std::exception_ptr > errors( threadCount );
+
+        auto block = [ function, &errors ]( std::size_t begin,
+                                            std::size_t end,
+                                            std::size_t thread ) mutable
+        {
+            PG_TRACE_SCOPE( "parallelFor" );
+
+            try
+            {
+                function( begin, end, thread );
+            }
+            catch( ... )
+            {
+                errors[ thread ] = std::current_exception();
+            }
+        };
+
+        // Launch worker threads for all but the first block, as many as
+        // the system allows
+
+        std::vector< std::thread > workers;
+        std::size_t launched = 1;
+
+        try
+        {
+            workers.reserve( threadCount - 1 );
+
+            for( ; launched < threadCount; ++launched )
+            {
+                std::size_t begin = count * launched / threadCount;
+                std::size_t end = count * ( launched + 1 ) / threadCount;
+
+                workers.push_back
+                (
+                    std::thread( block, begin, end, launched )
+                );
+            }
+        }
+        catch( ... )
+        {
+            // Out of threads or memory; the rest run below
+        }
+
+        // Process the first block and any not launched on the calling
+        // thread, then wait for workers
+
+        block( std::size_t( 0 ), count / threadCount, std::size_t( 0 ) );
+
+        for( std::size_t thread = launched; thread < threadCount; ++thread )
+        {
+            block( count * thread / threadCount,
+                   count * ( thread + 1 ) / threadCount, thread );
+        }
+
+        for( std::size_t thread = 0; thread < workers.size(); ++thread )
+        {
+            workers[ thread ].join();
+        }
+
+        for( std::size_t thread = 0; thread < threadCount; ++thread )
+        {
+            if( errors[ thread ] )
+            {
+                std::rethrow_exception( errors[ thread ] );
+            }
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_UTILITY_H
@@ -0,0 +1,499 @@
+#ifndef POLYGON_GRAPH_WELD_H
+#define POLYGON_GRAPH_WELD_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "PolygonGraph.h"
+#include "PolygonGraphUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GRAPH NAMESPACE ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // IMPLEMENTATION DETAILS +++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    namespace detail
+    {
+        // WELD ENTRY ---------------------------------------------------------
+
+        // A vertex filed under its grid cell. Entries are sorted by cell and
+        // then index, so each cell is a run in ascending vertex order.
+
+        class WeldEntry
+        {
+            public:
+
+            bool const operator < ( WeldEntry const & other ) const
+            {
+                if( x != other.x ) return x < other.x;
+                if( y != other.y ) return y < other.y;
+                if( z != other.z ) return z < other.z;
+
+                return index < other.index;
+            }
+
+            std::int64_t x;
+            std::int64_t y;
+            std::int64_t z;
+            std::uint32_t index;
+        };
+
+        // HASH CELL ----------------------------------------------------------
+
+        inline std::size_t const hashCell
+        (
+            std::int64_t x,
+            std::int64_t y,
+            std::int64_t z
+        )
+        {
+            std::uint64_t h = static_cast< std::uint64_t >( x ) *
+                              0x9e3779b97f4a7c15ull;
+            h ^= static_cast< std::uint64_t >( y ) * 0xc2b2ae3d27d4eb4full;
+            h ^= static_cast< std::uint64_t >( z ) * 0x165667b19e3779f9ull;
+            h ^= h >> 31;
+
+            return static_cast< std::size_t >( h );
+        }
+
+        // GET CELL -----------------------------------------------------------
+
+        // Cells are tolerance-sized cubes. A zero tolerance welds exact
+        // duplicates only, so each distinct coordinate gets its own cell.
+        // Cells are clamped to +-2^62, leaving room for neighbour offsets;
+        // NaN goes to the lowest cell. Clamped values share a cell but
+        // are still only welded within tolerance, and NaN never is.
+
+        inline std::int64_t const getCell( double value, double tolerance )
+        {
+            if( tolerance > 0.0 )
+            {
+                double const limit = 4611686018427387904.0; // 2^62
+                double cell = std::floor( value / tolerance );
+
+                if( !( cell > -limit ) )
+                {
+                    cell = -limit;
+                }
+                else if( cell > limit )
+                {
+                    cell = limit;
+                }
+
+                return static_cast< std::int64_t >( cell );
+            }
+
+            std::int64_t bits = 0;
+            value = value == 0.0 ? 0.0 : value; // merge -0 and +0
+            std::memcpy( &bits, &value, sizeof( bits ) );
+
+            return bits;
+        }
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // WELDING FUNCTIONS ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // WELD VERTICES ----------------------------------------------------------
+
+    // Merges vertices lying within tolerance of each other. positions holds
+    // x, y, z per vertex. Vertices are filed in a spatial hash split into
+    // one shard per thread; each then takes as representative the smallest
+    // index within tolerance in its 27 neighbouring cells, and chains of
+    // representatives are resolved in index order. On return remap maps
+    // every input vertex to a welded vertex and unique lists the input
+    // vertex kept for each welded vertex. Returns the welded vertex count.
+
+    template< class Scalar >
+    std::size_t const weldVertices
+    (
+        Scalar const * positions,
+        std::size_t vertexCount,
+        double tolerance,
+        std::vector< std::uint32_t > & remap,
+        std::vector< std::uint32_t > & unique,
+        std::size_t threadCount = 0
+    )
+    {
+        using detail::WeldEntry;
+
+        PG_TRACE_SCOPE( "weldVertices" );
+
+        threadCount = getThreadCount( threadCount );
+        std::size_t shardCount = threadCount;
+        int reach = tolerance > 0.0 ? 1 : 0;
+
+        // Bucket vertices by shard, one bucket set per thread
+
+        std::vector< std::vector< std::vector< WeldEntry > > > buckets
+        (
+            threadCount, std::vector< std::vector< WeldEntry > >( shardCount )
+        );
+
+        parallelFor
+        (
+            vertexCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t thread )
+            {
+                for( std::size_t v = begin; v < end; ++v )
+                {
+                    WeldEntry entry;
+                    entry.x = detail::getCell( positions[ v * 3 ], tolerance );
+                    entry.y = detail::getCell( positions[ v * 3 + 1 ],
+                                               tolerance );
+                    entry.z = detail::getCell( positions[ v * 3 + 2 ],
+                                               tolerance );
+                    entry.index = static_cast< std::uint32_t >( v );
+
+                    buckets[ thread ][ detail::hashCell
+                    (
+                        entry.x, entry.y, entry.z
+                    ) % shardCount ].push_back( entry );
+                }
+            }
+        );
+
+        // Gather and sort each shard
+
+        std::vector< std::vector< WeldEntry > > shards( shardCount );
+
+        parallelFor
+        (
+            shardCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                for( std::size_t s = begin; s < end; ++s )
+                {
+                    for( std::size_t t = 0; t < threadCount; ++t )
+                    {
+                        shards[ s ].insert( shards[ s ].end(),
+                                            buckets[ t ][ s ].begin(),
+                                            buckets[ t ][ s ].end() );
+                        std::vector< WeldEntry >().swap( buckets[ t ][ s ] );
+                    }
+
+                    std::sort( shards[ s ].begin(), shards[ s ].end() );
+                }
+            },
+            1
+        );
+
+        // Find the smallest index within tolerance of each vertex
+
+        std::vector< std::uint32_t > representatives( vertexCount );
+        double toleranceSquared =
+            tolerance > 0.0 ? tolerance * tolerance : 0.0;
+
+        parallelFor
+        (
+            vertexCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                for( std::size_t v = begin; v < end; ++v )
+                {
+                    double px = positions[ v * 3 ];
+                    double py = positions[ v * 3 + 1 ];
+                    double pz = positions[ v * 3 + 2 ];
+                    std::int64_t cx = detail::getCell( px, tolerance );
+                    std::int64_t cy = detail::getCell( py, tolerance );
+                    std::int64_t cz = detail::getCell( pz, tolerance );
+                    std::uint32_t best = static_cast< std::uint32_t >( v );
+
+                    for( int dx = -reach; dx <= reach; ++dx )
+                    for( int dy = -reach; dy <= reach; ++dy )
+                    for( int dz = -reach; dz <= reach; ++dz )
+                    {
+                        WeldEntry key;
+                        key.x = cx + dx;
+                        key.y = cy + dy;
+                        key.z = cz + dz;
+                        key.index = 0;
+
+                        std::vector< WeldEntry > const & shard = shards
+                        [
+                            detail::hashCell( key.x, key.y, key.z ) %
+                            shardCount
+                        ];
+                        std::vector< WeldEntry >::const_iterator entry =
+                            std::lower_bound( shard.begin(), shard.end(),
+                                              key );
+
+                        // Cell runs are in index order, so stop at best
+
+                        while( entry != shard.end() && entry->x == key.x &&
+                               entry->y == key.y && entry->z == key.z &&
+                               entry->index < best )
+                        {
+                            double ox = positions[ entry->index * 3 ] - px;
+                            double oy = positions[ entry->index * 3 + 1 ] - py;
+                            double oz = positions[ entry->index * 3 + 2 ] - pz;
+
+                            if( ox * ox + oy * oy + oz * oz <=
+                                toleranceSquared )
+                            {
+                                best = entry->index;
+                                break;
+                            }
+
+                            ++entry;
+                        }
+                    }
+
+                    representatives[ v ] = best;
+                }
+            }
+        );
+
+        // Resolve chains in index order and number the welded vertices
+
+        remap.resize( vertexCount );
+        unique.clear();
+
+        for( std::size_t v = 0; v < vertexCount; ++v )
+        {
+            std::uint32_t representative = representatives[ v ];
+
+            if( representative == v )
+            {
+                remap[ v ] = static_cast< std::uint32_t >( unique.size() );
+                unique.push_back( representative );
+            }
+            else
+            {
+                remap[ v ] = remap[ representative ];
+            }
+        }
+
+        return unique.size();
+    }
+
+    // INGEST POLYGON SOUP ----------------------------------------------------
+
+    // Welds a polygon soup and appends it to the graph in one pass. Face f
+    // uses faceSizes[ f ] consecutive entries of indices. Vertices are
+    // welded as by weldVertices and face indices are remapped. Consecutive
+    // repeats, such as an edge collapsed by welding, are removed; faces
+    // then left with fewer than three vertices, or still visiting a vertex
+    // twice, are dropped. Welded vertices are written through the position
+    // accessor. When handles is given it receives the graph vertex for
+    // every input vertex, and droppedFaces receives the number of faces
+    // not added. Returns false without touching the graph if any index is
+    // out of range.
+
+    template< class Traits, class Scalar, class PositionAccessor >
+    bool const ingestPolygonSoup
+    (
+        PolygonGraph< Traits > & graph,
+        Scalar const * positions,
+        std::size_t vertexCount,
+        std::uint32_t const * faceSizes,
+        std::size_t faceCount,
+        std::uint32_t const * indices,
+        double tolerance,
+        PositionAccessor accessor,
+        std::size_t threadCount = 0,
+        std::vector< typename PolygonGraph< Traits >::VertexIterator > *
+            handles = nullptr,
+        std::size_t * droppedFaces = nullptr
+    )
+    {
+        typedef PolygonGraph< Traits > Graph;
+        typedef typename Graph::BaseVertex BaseVertex;
+        typedef typename Graph::VertexIterator VertexIterator;
+        typedef IndexedIterator< VertexIterator, std::uint32_t > IndexIter;
+
+        PG_TRACE_SCOPE( "ingestPolygonSoup" );
+
+        // Find first index of each face
+
+        std::vector< std::size_t > faceOffsets( faceCount + 1, 0 );
+
+        for( std::size_t f = 0; f < faceCount; ++f )
+        {
+            faceOffsets[ f + 1 ] = faceOffsets[ f ] + faceSizes[ f ];
+        }
+
+        // Validate indices
+
+        std::vector< char > valid( getThreadCount( threadCount ), 1 );
+
+        parallelFor
+        (
+            faceOffsets.back(), threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t thread )
+            {
+                for( std::size_t i = begin; i < end; ++i )
+                {
+                    if( indices[ i ] >= vertexCount )
+                    {
+                        valid[ thread ] = 0;
+                    }
+                }
+            }
+        );
+
+        for( std::size_t t = 0; t < valid.size(); ++t )
+        {
+            if( !valid[ t ] )
+            {
+                return false;
+            }
+        }
+
+        // Weld
+
+        std::vector< std::uint32_t > remap;
+        std::vector< std::uint32_t > unique;
+        weldVertices( positions, vertexCount, tolerance, remap, unique,
+                      threadCount );
+
+        // Remap faces in place within their slots, removing consecutive
+        // repeats. A face with any other repeat gets size 0.
+
+        std::vector< std::uint32_t > welded( faceOffsets.back() );
+        std::vector< std::uint32_t > weldedSizes( faceCount );
+
+        parallelFor
+        (
+            faceCount, threadCount,
+            [ & ]( std::size_t begin, std::size_t end, std::size_t )
+            {
+                std::vector< std::uint32_t > sorted;
+
+                for( std::size_t f = begin; f < end; ++f )
+                {
+                    std::uint32_t * face = welded.data() + faceOffsets[ f ];
+                    std::uint32_t size = 0;
+
+                    for( std::size_t i = faceOffsets[ f ];
+                         i < faceOffsets[ f + 1 ]; ++i )
+                    {
+                        std::uint32_t vertex = remap[ indices[ i ] ];
+
+                        if( size == 0 || face[ size - 1 ] != vertex )
+                        {
+                            face[ size++ ] = vertex;
+                        }
+                    }
+
+                    while( size > 1 && face[ size - 1 ] == face[ 0 ] )
+                    {
+                        --size;
+                    }
+
+                    sorted.assign( face, face + size );
+                    std::sort( sorted.begin(), sorted.end() );
+
+                    if( std::adjacent_find( sorted.begin(), sorted.end() ) !=
+                        sorted.end() )
+                    {
+                        size = 0;
+                    }
+
+                    weldedSizes[ f ] = size;
+                }
+            }
+        );
+
+        // Add welded vertices
+
+        typedef typename std::decay
+        <
+            decltype( accessor( std::declval< BaseVertex & >() )[ 0 ] )
+        >::type Position;
+
+        std::vector< VertexIterator > weldedHandles;
+        weldedHandles.reserve( unique.size() );
+        BaseVertex baseVertex;
+
+        for( std::size_t u = 0; u < unique.size(); ++u )
+        {
+            Scalar const * position = positions + unique[ u ] * 3;
+
+            accessor( baseVertex )[ 0 ] =
+                static_cast< Position >( position[ 0 ] );
+            accessor( baseVertex )[ 1 ] =
+                static_cast< Position >( position[ 1 ] );
+            accessor( baseVertex )[ 2 ] =
+                static_cast< Position >( position[ 2 ] );
+
+            weldedHandles.push_back( graph.addVertex( baseVertex ) );
+        }
+
+        // Add polygons straight from the welded index arrays
+
+        VertexIterator const * table =
+            weldedHandles.empty() ? nullptr : &( weldedHandles[ 0 ] );
+
+        std::size_t dropped = 0;
+
+        for( std::size_t f = 0; f < faceCount; ++f )
+        {
+            std::uint32_t const * face = welded.data() + faceOffsets[ f ];
+
+            if( weldedSizes[ f ] < 3 ||
+                graph.addPolygon( IndexIter( table, face ),
+                                  IndexIter( table,
+                                             face + weldedSizes[ f ] ) ) ==
+                    graph.endPolygons() )
+            {
+                ++dropped;
+            }
+        }
+
+        if( droppedFaces != nullptr )
+        {
+            *droppedFaces = dropped;
+        }
+
+        if( handles != nullptr )
+        {
+            handles->resize( vertexCount );
+
+            for( std::size_t v = 0; v < vertexCount; ++v )
+            {
+                ( *handles )[ v ] = weldedHandles[ remap[ v ] ];
+            }
+        }
+
+        return true;
+    }
+
+    template< class Traits, class Scalar >
+    bool const ingestPolygonSoup
+    (
+        PolygonGraph< Traits > & graph,
+        Scalar const * positions,
+        std::size_t vertexCount,
+        std::uint32_t const * faceSizes,
+        std::size_t faceCount,
+        std::uint32_t const * indices,
+        double tolerance
+    )
+    {
+        return ingestPolygonSoup( graph, positions, vertexCount, faceSizes,
+                                  faceCount, indices, tolerance,
+                                  MemberPosition() );
+    }
+
+    // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_WELD_H
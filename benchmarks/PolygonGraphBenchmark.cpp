@@ -0,0 +1,1031 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined( __linux__ )
+#include <unistd.h>
+#define POLYGON_GRAPH_BENCHMARK_RSS
+#endif
+
+#include "PolygonGraph.h"
+#include "PolygonGraphAdjacency.h"
+#include "PolygonGraphAllocator.h"
+#include "PolygonGraphBVH.h"
+#include "PolygonGraphDual.h"
+#include "PolygonGraphGeometry.h"
+#include "PolygonGraphIO.h"
+#include "PolygonGraphPerf.h"
+#include "PolygonGraphShortestPath.h"
+#include "PolygonGraphSmoothing.h"
+#include "PolygonGraphWeld.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// BENCH TRAITS ---------------------------------------------------------------
+
+// Vertices carry a position for the geometry modules; edges and polygons
+// carry nothing.
+
+class BenchTraits
+{
+    public:
+
+    class BaseVertex
+    {
+        public:
+
+        float position[ 3 ];
+    };
+
+    class BaseEdge {};
+
+    class BasePolygon {};
+};
+
+typedef graph::PolygonGraph< BenchTraits > Graph;
+
+// The same graph with its elements drawn from pools over ChunkSource
+
+template< class ChunkSource >
+class PoolBenchTraits : public BenchTraits
+{
+    public:
+
+    template< class T > using Allocator =
+        graph::PoolAllocator< T, ChunkSource >;
+};
+
+// OPTIONS --------------------------------------------------------------------
+
+class Options
+{
+    public:
+
+    Options( void )
+    {
+        size = 200;
+        threadCount = 0;
+        jsonPath = nullptr;
+        baselinePath = nullptr;
+        filter = nullptr;
+    }
+
+    std::size_t size;
+    std::size_t threadCount;
+    char const * jsonPath;
+    char const * baselinePath;
+    char const * filter;
+};
+
+bool const parseOptions( int argc, char ** argv, Options & options )
+{
+    for( int a = 1; a < argc; ++a )
+    {
+        char const * argument = argv[ a ];
+        char const * value = a + 1 < argc ? argv[ a + 1 ] : nullptr;
+
+        if( value == nullptr )
+        {
+            return false;
+        }
+
+        if( std::strcmp( argument, "--size" ) == 0 )
+        {
+            options.size = std::strtoul( value, nullptr, 10 );
+        }
+        else if( std::strcmp( argument, "--threads" ) == 0 )
+        {
+            options.threadCount = std::strtoul( value, nullptr, 10 );
+        }
+        else if( std::strcmp( argument, "--json" ) == 0 )
+        {
+            options.jsonPath = value;
+        }
+        else if( std::strcmp( argument, "--baseline" ) == 0 )
+        {
+            options.baselinePath = value;
+        }
+        else if( std::strcmp( argument, "--filter" ) == 0 )
+        {
+            options.filter = value;
+        }
+        else
+        {
+            return false;
+        }
+
+        ++a;
+    }
+
+    return options.size >= 2;
+}
+
+// True if the group of benchmarks called name should run
+
+bool const isSelected( Options const & options, char const * name )
+{
+    return options.filter == nullptr ||
+           std::strstr( name, options.filter ) != nullptr;
+}
+
+// CHECK ----------------------------------------------------------------------
+
+// Benchmarks check their results so that a broken operation is not timed
+// as a fast one. Failures are reported and make the driver exit non-zero.
+
+std::size_t failureCount = 0;
+
+void check( bool passed, char const * what )
+{
+    if( !passed )
+    {
+        std::fprintf( stderr, "check failed: %s\n", what );
+        ++failureCount;
+    }
+}
+
+// MESH FUNCTIONS -------------------------------------------------------------
+
+Graph::BaseVertex const makeVertex( float x, float y, float z )
+{
+    Graph::BaseVertex vertex;
+    vertex.position[ 0 ] = x;
+    vertex.position[ 1 ] = y;
+    vertex.position[ 2 ] = z;
+
+    return vertex;
+}
+
+// Adds a size x size grid of unit squares in the z = 0 plane, each split
+// into two triangles, and returns the vertices row by row.
+
+template< class GridGraph >
+std::vector< typename GridGraph::VertexIterator > makeGrid
+(
+    GridGraph & graph,
+    std::size_t size
+)
+{
+    std::vector< typename GridGraph::VertexIterator > vertices;
+    std::size_t row = size + 1;
+    vertices.reserve( row * row );
+
+    for( std::size_t y = 0; y < row; ++y )
+    {
+        for( std::size_t x = 0; x < row; ++x )
+        {
+            vertices.push_back( graph.addVertex
+            (
+                makeVertex( float( x ), float( y ), 0.0f )
+            ) );
+        }
+    }
+
+    for( std::size_t y = 0; y < size; ++y )
+    {
+        for( std::size_t x = 0; x < size; ++x )
+        {
+            std::size_t a = y * row + x;
+
+            graph.addTriangle( vertices[ a ], vertices[ a + 1 ],
+                               vertices[ a + row + 1 ] );
+            graph.addTriangle( vertices[ a ], vertices[ a + row + 1 ],
+                               vertices[ a + row ] );
+        }
+    }
+
+    return vertices;
+}
+
+// Adds a closed unit sphere of triangles with ringCount bands of latitude
+// and twice as many of longitude, giving 2 ringCount ( ringCount - 1 ) + 2
+// vertices. Radii vary by up to noise, from a fixed seed.
+
+void makeSphere( Graph & graph, std::size_t ringCount, float noise )
+{
+    double const pi = 3.14159265358979323846;
+    std::size_t segmentCount = 2 * ringCount;
+    std::uint32_t seed = 12345;
+
+    auto makePoint = [ & ]( double theta, double phi )
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double radius = 1.0 + noise * ( ( seed >> 8 ) / 8388608.0 - 1.0 );
+
+        return makeVertex
+        (
+            float( radius * std::sin( theta ) * std::cos( phi ) ),
+            float( radius * std::sin( theta ) * std::sin( phi ) ),
+            float( radius * std::cos( theta ) )
+        );
+    };
+
+    Graph::VertexIterator top = graph.addVertex( makePoint( 0.0, 0.0 ) );
+    Graph::VertexIterator bottom = graph.addVertex( makePoint( pi, 0.0 ) );
+    std::vector< Graph::VertexIterator > rings;
+
+    for( std::size_t r = 1; r < ringCount; ++r )
+    {
+        for( std::size_t s = 0; s < segmentCount; ++s )
+        {
+            rings.push_back( graph.addVertex( makePoint
+            (
+                pi * r / ringCount, 2.0 * pi * s / segmentCount
+            ) ) );
+        }
+    }
+
+    auto at = [ & ]( std::size_t ring, std::size_t segment )
+    {
+        return rings[ ( ring - 1 ) * segmentCount +
+                      segment % segmentCount ];
+    };
+
+    for( std::size_t s = 0; s < segmentCount; ++s )
+    {
+        graph.addTriangle( top, at( 1, s ), at( 1, s + 1 ) );
+        graph.addTriangle( at( ringCount - 1, s ), bottom,
+                           at( ringCount - 1, s + 1 ) );
+
+        for( std::size_t r = 1; r + 1 < ringCount; ++r )
+        {
+            graph.addTriangle( at( r, s ), at( r + 1, s ),
+                               at( r + 1, s + 1 ) );
+            graph.addTriangle( at( r, s ), at( r + 1, s + 1 ),
+                               at( r, s + 1 ) );
+        }
+    }
+}
+
+// TRAVERSALS -----------------------------------------------------------------
+
+// Walk every polygon's ring or every vertex's outgoing edges, summing a
+// coordinate so the walks are not optimised away.
+
+template< class WalkGraph >
+float const sumPolygonRings( WalkGraph & graph )
+{
+    float sum = 0.0f;
+
+    for( typename WalkGraph::PolygonIterator polyIt = graph.beginPolygons();
+         polyIt != graph.endPolygons(); ++polyIt )
+    {
+        for( typename WalkGraph::Edge & edge : polyIt->getEdges() )
+        {
+            sum += edge.getTargetVertex()->position[ 0 ];
+        }
+    }
+
+    return sum;
+}
+
+template< class WalkGraph >
+float const sumVertexStars( WalkGraph & graph )
+{
+    float sum = 0.0f;
+
+    for( typename WalkGraph::VertexIterator vertexIt =
+             graph.beginVertices();
+         vertexIt != graph.endVertices(); ++vertexIt )
+    {
+        for( typename WalkGraph::Edge & edge :
+             vertexIt->getOutgoingEdges() )
+        {
+            sum += edge.getTargetVertex()->position[ 1 ];
+        }
+    }
+
+    return sum;
+}
+
+// GET RESIDENT BYTES ---------------------------------------------------------
+
+// Resident set size from /proc, or 0 where it cannot be read.
+
+std::size_t const getResidentBytes( void )
+{
+    std::size_t pages = 0;
+
+    #if defined( POLYGON_GRAPH_BENCHMARK_RSS )
+
+    std::FILE * file = std::fopen( "/proc/self/statm", "r" );
+
+    if( file == nullptr )
+    {
+        return 0;
+    }
+
+    unsigned long size = 0;
+    unsigned long resident = 0;
+
+    if( std::fscanf( file, "%lu %lu", &size, &resident ) == 2 )
+    {
+        pages = resident * static_cast< std::size_t >
+        (
+            sysconf( _SC_PAGESIZE )
+        );
+    }
+
+    std::fclose( file );
+
+    #endif
+
+    return pages;
+}
+
+// READ FIRST LINE ------------------------------------------------------------
+
+// First line of a text file without its newline, or empty.
+
+std::string const readFirstLine( char const * path )
+{
+    std::string line;
+    std::FILE * file = std::fopen( path, "r" );
+
+    if( file == nullptr )
+    {
+        return line;
+    }
+
+    int character = 0;
+
+    while( ( character = std::fgetc( file ) ) != EOF && character != '\n' )
+    {
+        line.push_back( static_cast< char >( character ) );
+    }
+
+    std::fclose( file );
+
+    return line;
+}
+
+// GET HUGE PAGE BYTES --------------------------------------------------------
+
+// Anonymous memory the process has on transparent huge pages, or 0 where
+// it cannot be read.
+
+std::size_t const getHugePageBytes( void )
+{
+    std::size_t bytes = 0;
+    std::FILE * file = std::fopen( "/proc/self/smaps_rollup", "r" );
+
+    if( file == nullptr )
+    {
+        return 0;
+    }
+
+    char line[ 256 ];
+
+    while( std::fgets( line, sizeof( line ), file ) != nullptr )
+    {
+        unsigned long kilobytes = 0;
+
+        if( std::sscanf( line, "AnonHugePages: %lu kB", &kilobytes ) == 1 )
+        {
+            bytes = kilobytes * 1024;
+            break;
+        }
+    }
+
+    std::fclose( file );
+
+    return bytes;
+}
+
+// PRINT REPORT ---------------------------------------------------------------
+
+// One line per sample: milliseconds per repetition, then instructions per
+// cycle and L1D, LLC and dTLB misses per repetition where counted.
+
+void printReport( graph::PerfReport const & report )
+{
+    typedef graph::PerfCounters Counters;
+
+    std::printf( "%-36s %5s %12s %6s %12s %12s %12s\n", "operation", "reps",
+                 "ms/rep", "ipc", "l1d/rep", "llc/rep", "dtlb/rep" );
+
+    for( std::size_t s = 0; s < report.getSampleCount(); ++s )
+    {
+        graph::PerfSample const & sample = report.getSample( s );
+        double repetitions = double( sample.repetitions );
+
+        std::printf( "%-36s %5zu %12.3f", sample.name.c_str(),
+                     sample.repetitions,
+                     sample.seconds * 1e3 / repetitions );
+
+        if( sample.valid[ Counters::cycles ] &&
+            sample.valid[ Counters::instructions ] &&
+            sample.values[ Counters::cycles ] != 0 )
+        {
+            std::printf( " %6.2f",
+                         double( sample.values[ Counters::instructions ] ) /
+                         double( sample.values[ Counters::cycles ] ) );
+        }
+        else
+        {
+            std::printf( " %6s", "-" );
+        }
+
+        Counters::Counter const misses[ 3 ] =
+        {
+            Counters::l1dMisses, Counters::llcMisses, Counters::dtlbMisses
+        };
+
+        for( int m = 0; m < 3; ++m )
+        {
+            if( sample.valid[ misses[ m ] ] )
+            {
+                std::printf( " %12.0f",
+                             sample.values[ misses[ m ] ] / repetitions );
+            }
+            else
+            {
+                std::printf( " %12s", "-" );
+            }
+        }
+
+        std::printf( "\n" );
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// BENCHMARKS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Each benchmark group builds its inputs outside the measured intervals
+// and records one sample per operation.
+
+// MEMORY ---------------------------------------------------------------------
+
+// Compares getMemoryUsage's estimate with the growth in resident set size
+// while a grid is built. Runs first, before other groups leave freed
+// memory cached in the allocator, and drops the grid's vertex handles
+// before reading the size. The two only agree as far as the estimate's
+// assumptions about the standard library and malloc hold.
+
+void benchmarkMemory( graph::PerfReport & report, Options const & options )
+{
+    std::size_t before = getResidentBytes();
+    Graph graph;
+
+    report.measure( "memory build grid", [ & ]( void )
+    {
+        makeGrid( graph, options.size );
+    } );
+
+    std::size_t after = getResidentBytes();
+    double estimate = double( graph.getMemoryUsage().getTotal() );
+
+    if( before == 0 || after == 0 )
+    {
+        std::printf( "memory: estimate %.1f MB, resident size unavailable\n",
+                     estimate / 1048576.0 );
+        return;
+    }
+
+    double resident = double( after - before );
+
+    std::printf( "memory: estimate %.1f MB, resident growth %.1f MB, "
+                 "ratio %.3f\n", estimate / 1048576.0,
+                 resident / 1048576.0, estimate / resident );
+}
+
+// GRAPH ----------------------------------------------------------------------
+
+void benchmarkGraph( graph::PerfReport & report, Options const & options )
+{
+    std::size_t const size = options.size;
+
+    report.measure( "graph build grid", [ & ]( void )
+    {
+        Graph graph;
+        makeGrid( graph, size );
+        check( graph.getPolygonCount() == 2 * size * size, "grid build" );
+    }, 3 );
+
+    Graph graph;
+    makeGrid( graph, size );
+
+    // Every directed edge of the grid, looked up by its end vertices
+
+    std::vector< Graph::VertexIterator > sources;
+    std::vector< Graph::VertexIterator > targets;
+    std::vector< Graph::Edge * > found( graph.getEdgeCount() );
+
+    for( Graph::PolygonIterator polyIt = graph.beginPolygons();
+         polyIt != graph.endPolygons(); ++polyIt )
+    {
+        for( Graph::Edge & edge : polyIt->getEdges() )
+        {
+            sources.push_back( edge.getPreviousEdge()->getTargetVertex() );
+            targets.push_back( edge.getTargetVertex() );
+        }
+    }
+
+    auto findAll = [ & ]( void )
+    {
+        for( std::size_t e = 0; e < sources.size(); ++e )
+        {
+            found[ e ] = graph.findEdge( sources[ e ], targets[ e ] );
+        }
+    };
+
+    report.measure( "graph findEdge", findAll, 5 );
+    check( found.back() != nullptr, "findEdge" );
+
+    graph.enableEdgeIndex();
+    report.measure( "graph findEdge indexed", findAll, 5 );
+    report.measure( "graph findEdges indexed", [ & ]( void )
+    {
+        graph.findEdges( sources.data(), targets.data(), sources.size(),
+                         found.data() );
+    }, 5 );
+    check( found.back() != nullptr, "findEdges" );
+    graph.enableEdgeIndex( false );
+
+    float sum = 0.0f;
+
+    report.measure( "graph polygon rings", [ & ]( void )
+    {
+        sum += sumPolygonRings( graph );
+    }, 5 );
+
+    report.measure( "graph vertex stars", [ & ]( void )
+    {
+        sum += sumVertexStars( graph );
+    }, 5 );
+
+    check( sum > 0.0f, "traversal" );
+}
+
+// ALLOCATOR ------------------------------------------------------------------
+
+// Builds and walks the same grid with elements from the standard
+// allocator, from malloc-backed pools, and from pools over transparent
+// huge pages with either NUMA policy. The huge-page gain shows as fewer
+// dTLB misses and page faults; the interleave gain needs several nodes.
+// Pools keep their chunks, so each variant is built once.
+
+template< class VariantTraits >
+void benchmarkAllocatorVariant
+(
+    graph::PerfReport & report,
+    Options const & options,
+    char const * name
+)
+{
+    graph::PolygonGraph< VariantTraits > graph;
+    std::string prefix = std::string( "allocator " ) + name;
+    std::size_t hugeBefore = getHugePageBytes();
+    float sum = 0.0f;
+
+    report.measure( ( prefix + " build" ).c_str(), [ & ]( void )
+    {
+        makeGrid( graph, options.size );
+    } );
+
+    std::size_t hugeAfter = getHugePageBytes();
+
+    report.measure( ( prefix + " walk" ).c_str(), [ & ]( void )
+    {
+        sum += sumPolygonRings( graph ) + sumVertexStars( graph );
+    }, 5 );
+
+    check( sum > 0.0f, "allocator walk" );
+
+    std::printf( "allocator: %s grid on %.1f MB of huge pages\n", name,
+                 double( hugeAfter > hugeBefore
+                         ? hugeAfter - hugeBefore : 0 ) / 1048576.0 );
+}
+
+void benchmarkAllocator( graph::PerfReport & report,
+                         Options const & options )
+{
+    typedef graph::HugePageChunkSource< graph::NumaFirstTouch > FirstTouch;
+    typedef graph::HugePageChunkSource< graph::NumaInterleave > Interleave;
+
+    std::string hugePages = readFirstLine
+    (
+        "/sys/kernel/mm/transparent_hugepage/enabled"
+    );
+    std::string nodes = readFirstLine( "/sys/devices/system/node/online" );
+
+    std::printf( "allocator: transparent huge pages %s, NUMA nodes %s\n",
+                 hugePages.empty() ? "unknown" : hugePages.c_str(),
+                 nodes.empty() ? "unknown" : nodes.c_str() );
+
+    benchmarkAllocatorVariant< BenchTraits >( report, options, "std" );
+    benchmarkAllocatorVariant< PoolBenchTraits< graph::MallocChunkSource > >
+    (
+        report, options, "pool"
+    );
+    benchmarkAllocatorVariant< PoolBenchTraits< FirstTouch > >
+    (
+        report, options, "hugepage"
+    );
+    benchmarkAllocatorVariant< PoolBenchTraits< Interleave > >
+    (
+        report, options, "interleave"
+    );
+}
+
+// IO -------------------------------------------------------------------------
+
+void benchmarkIO( graph::PerfReport & report, Options const & options )
+{
+    char const * const plyPath = "PolygonGraphBenchmark.ply";
+    char const * const objPath = "PolygonGraphBenchmark.obj";
+
+    Graph graph;
+    makeGrid( graph, options.size );
+
+    bool written = true;
+    bool read = true;
+
+    report.measure( "io write ply", [ & ]( void )
+    {
+        written = graph::writePly( graph, plyPath ) && written;
+    }, 3 );
+
+    report.measure( "io read ply", [ & ]( void )
+    {
+        Graph copy;
+        read = graph::readPly( copy, plyPath, graph::MemberPosition(),
+                               options.threadCount ) &&
+               copy.getPolygonCount() == graph.getPolygonCount() && read;
+    }, 3 );
+
+    report.measure( "io write obj", [ & ]( void )
+    {
+        written = graph::writeObj( graph, objPath ) && written;
+    }, 3 );
+
+    report.measure( "io read obj", [ & ]( void )
+    {
+        Graph copy;
+        read = graph::readObj( copy, objPath, graph::MemberPosition(),
+                               options.threadCount ) &&
+               copy.getPolygonCount() == graph.getPolygonCount() && read;
+    }, 3 );
+
+    check( written, "io write" );
+    check( read, "io read" );
+
+    std::remove( plyPath );
+    std::remove( objPath );
+}
+
+// WELD -----------------------------------------------------------------------
+
+// A grid's triangles as a soup, each with its own copies of its corners
+
+void benchmarkWeld( graph::PerfReport & report, Options const & options )
+{
+    std::size_t const size = options.size;
+    std::size_t const faceCount = 2 * size * size;
+
+    std::vector< float > positions;
+    std::vector< std::uint32_t > faceSizes( faceCount, 3 );
+    std::vector< std::uint32_t > indices;
+    positions.reserve( faceCount * 9 );
+
+    for( std::size_t y = 0; y < size; ++y )
+    {
+        for( std::size_t x = 0; x < size; ++x )
+        {
+            float const corners[ 6 ][ 2 ] =
+            {
+                { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f },
+                { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+            };
+
+            for( int c = 0; c < 6; ++c )
+            {
+                indices.push_back
+                (
+                    static_cast< std::uint32_t >( positions.size() / 3 )
+                );
+                positions.push_back( float( x ) + corners[ c ][ 0 ] );
+                positions.push_back( float( y ) + corners[ c ][ 1 ] );
+                positions.push_back( 0.0f );
+            }
+        }
+    }
+
+    std::size_t const cornerCount = positions.size() / 3;
+    std::size_t const row = size + 1;
+    std::vector< std::uint32_t > remap;
+    std::vector< std::uint32_t > unique;
+    std::size_t uniqueCount = 0;
+
+    report.measure( "weld vertices", [ & ]( void )
+    {
+        uniqueCount = graph::weldVertices( positions.data(), cornerCount,
+                                           1e-4, remap, unique,
+                                           options.threadCount );
+    }, 3 );
+
+    check( uniqueCount == row * row, "weld vertices" );
+
+    report.measure( "weld ingest soup", [ & ]( void )
+    {
+        Graph graph;
+        check( graph::ingestPolygonSoup( graph, positions.data(),
+                                         cornerCount, faceSizes.data(),
+                                         faceCount, indices.data(), 1e-4,
+                                         graph::MemberPosition(),
+                                         options.threadCount ) &&
+               graph.getVertexCount() == row * row, "ingest soup" );
+    }, 3 );
+}
+
+// DUAL -----------------------------------------------------------------------
+
+void benchmarkDual( graph::PerfReport & report, Options const & options )
+{
+    Graph graph;
+    makeGrid( graph, options.size );
+
+    graph::FaceAdjacency< BenchTraits > adjacency;
+
+    report.measure( "dual face adjacency", [ & ]( void )
+    {
+        graph::buildDual( graph, adjacency, options.threadCount );
+    }, 3 );
+
+    check( adjacency.getPolygonCount() == graph.getPolygonCount(),
+           "face adjacency" );
+
+    report.measure( "dual graph", [ & ]( void )
+    {
+        Graph dual;
+        std::vector< Graph::VertexIterator > dualVertices;
+        graph::buildDual( graph, adjacency, dual, dualVertices,
+                          options.threadCount );
+        check( dual.getVertexCount() == graph.getPolygonCount(),
+               "dual graph" );
+    }, 3 );
+}
+
+// PATHS ----------------------------------------------------------------------
+
+void benchmarkPaths( graph::PerfReport & report, Options const & options )
+{
+    Graph graph;
+    std::vector< Graph::VertexIterator > vertices =
+        makeGrid( graph, options.size );
+
+    graph::VertexAdjacency< BenchTraits > adjacency;
+
+    report.measure( "paths vertex adjacency", [ & ]( void )
+    {
+        graph::buildVertexAdjacency( graph, adjacency,
+                                     options.threadCount );
+    }, 3 );
+
+    graph::ShortestPaths< BenchTraits > paths( adjacency );
+    graph::ShortestPaths< BenchTraits >::Result result;
+    std::vector< Graph::VertexIterator > sources( 1, vertices.front() );
+
+    paths.setEdgeLengths( graph::MemberPosition(), options.threadCount );
+
+    report.measure( "paths single source", [ & ]( void )
+    {
+        paths.findPaths( sources, result );
+    }, 3 );
+
+    // The far corner is straight up the diagonal
+
+    check( std::fabs( paths.getDistance( result, vertices.back() ) -
+                      std::sqrt( 2.0 ) * options.size ) < 1e-3,
+           "paths distance" );
+}
+
+// BVH ------------------------------------------------------------------------
+
+void benchmarkBVH( graph::PerfReport & report, Options const & options )
+{
+    typedef graph::PolygonBVH< BenchTraits > BVH;
+
+    std::size_t const size = options.size;
+
+    Graph graph;
+    makeGrid( graph, size );
+
+    BVH bvh;
+
+    report.measure( "bvh build", [ & ]( void )
+    {
+        bvh.build( graph, options.threadCount );
+    }, 3 );
+
+    report.measure( "bvh refit", [ & ]( void )
+    {
+        bvh.refit();
+    }, 3 );
+
+    // One ray down through, and one closest point above, every cell
+
+    std::size_t hits = 0;
+    double const down[ 3 ] = { 0.0, 0.0, -1.0 };
+
+    report.measure( "bvh rays", [ & ]( void )
+    {
+        BVH::RayHit hit = BVH::RayHit();
+
+        for( std::size_t y = 0; y < size; ++y )
+        {
+            for( std::size_t x = 0; x < size; ++x )
+            {
+                double const origin[ 3 ] = { x + 0.3, y + 0.6, 1.0 };
+                hits += bvh.intersectRay( origin, down, hit );
+            }
+        }
+    }, 3 );
+
+    check( hits == 3 * size * size, "bvh rays" );
+    hits = 0;
+
+    report.measure( "bvh closest points", [ & ]( void )
+    {
+        BVH::ClosestHit closest = BVH::ClosestHit();
+
+        for( std::size_t y = 0; y < size; ++y )
+        {
+            for( std::size_t x = 0; x < size; ++x )
+            {
+                double const point[ 3 ] = { x + 0.6, y + 0.3, 0.5 };
+                hits += bvh.findClosestPoint( point, closest );
+            }
+        }
+    }, 3 );
+
+    check( hits == 3 * size * size, "bvh closest points" );
+}
+
+// GEOMETRY -------------------------------------------------------------------
+
+// Updates at every instruction set the CPU supports, widest last
+
+void benchmarkGeometry( graph::PerfReport & report, Options const & options )
+{
+    static char const * const names[] =
+    {
+        "geometry update scalar",
+        "geometry update avx2",
+        "geometry update avx512"
+    };
+
+    Graph graph;
+    makeGrid( graph, options.size );
+
+    graph::PolygonGeometry< BenchTraits > geometry;
+
+    report.measure( "geometry build", [ & ]( void )
+    {
+        geometry.build( graph, options.threadCount );
+    }, 3 );
+
+    check( geometry.isTriangleMesh(), "geometry build" );
+
+    for( int level = graph::simdScalar;
+         level <= graph::getSupportedSimdLevel(); ++level )
+    {
+        geometry.setSimdLevel( static_cast< graph::SimdLevel >( level ) );
+
+        report.measure( names[ level ], [ & ]( void )
+        {
+            geometry.update( options.threadCount );
+        }, 10 );
+    }
+}
+
+// SMOOTHING ------------------------------------------------------------------
+
+// On a noisy closed sphere; at the default size it has 79,602 vertices
+
+void benchmarkSmoothing( graph::PerfReport & report,
+                         Options const & options )
+{
+    typedef graph::LaplacianSmoother< BenchTraits > Smoother;
+
+    Graph graph;
+    makeSphere( graph, options.size, 0.02f );
+
+    graph::VertexAdjacency< BenchTraits > adjacency;
+    graph::buildVertexAdjacency( graph, adjacency, options.threadCount );
+
+    Smoother smoother( adjacency );
+
+    report.measure( "smoothing build uniform", [ & ]( void )
+    {
+        smoother.build( Smoother::uniformWeights, options.threadCount );
+    }, 3 );
+
+    report.measure( "smoothing laplacian iteration", [ & ]( void )
+    {
+        smoother.smooth( 1, 0.5f, options.threadCount );
+    }, 10 );
+
+    report.measure( "smoothing build cotangent", [ & ]( void )
+    {
+        smoother.build( Smoother::cotangentWeights, options.threadCount );
+    }, 3 );
+
+    report.measure( "smoothing taubin iteration", [ & ]( void )
+    {
+        smoother.smoothTaubin( 1, 0.5f, -0.53f, options.threadCount );
+    }, 10 );
+
+    report.measure( "smoothing apply", [ & ]( void )
+    {
+        smoother.apply( options.threadCount );
+    }, 3 );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( int argc, char ** argv )
+{
+    Options options;
+
+    if( !parseOptions( argc, argv, options ) )
+    {
+        std::fprintf( stderr,
+                      "usage: %s [--size N] [--threads N] [--filter TEXT]\n"
+                      "          [--json PATH] [--baseline PATH]\n"
+                      "size is the grid and sphere resolution, at least 2;\n"
+                      "filter runs only groups whose name contains TEXT\n",
+                      argv[ 0 ] );
+        return 2;
+    }
+
+    graph::PerfReport report;
+    report.setThreadCount( graph::getThreadCount( options.threadCount ) );
+
+    if( options.baselinePath != nullptr &&
+        !report.readBaseline( options.baselinePath ) )
+    {
+        std::fprintf( stderr, "cannot read baseline %s\n",
+                      options.baselinePath );
+        return 2;
+    }
+
+    if( !report.isCounting() )
+    {
+        std::printf( "hardware counters unavailable; timing only\n" );
+    }
+
+    typedef void ( *Benchmark )( graph::PerfReport &, Options const & );
+
+    struct Group
+    {
+        char const * name;
+        Benchmark benchmark;
+    };
+
+    Group const groups[] =
+    {
+        { "memory", benchmarkMemory },
+        { "graph", benchmarkGraph },
+        { "allocator", benchmarkAllocator },
+        { "io", benchmarkIO },
+        { "weld", benchmarkWeld },
+        { "dual", benchmarkDual },
+        { "paths", benchmarkPaths },
+        { "bvh", benchmarkBVH },
+        { "geometry", benchmarkGeometry },
+        { "smoothing", benchmarkSmoothing }
+    };
+
+    for( Group const & group : groups )
+    {
+        if( isSelected( options, group.name ) )
+        {
+            group.benchmark( report, options );
+        }
+    }
+
+    printReport( report );
+
+    if( options.jsonPath != nullptr && !report.writeJson( options.jsonPath ) )
+    {
+        std::fprintf( stderr, "cannot write %s\n", options.jsonPath );
+        return 2;
+    }
+
+    return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "PolygonGraphAllocator.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Test traits with every graph container drawing from the pools
+
+class PoolTraits : public graph::test::TestTraits
+{
+    public:
+
+    template< class T > using Allocator = graph::PoolAllocator< T >;
+};
+
+typedef graph::PolygonGraph< PoolTraits > PoolGraph;
+
+// Constructed before any pool, so destroyed after them if the pools were
+// ordinary function statics
+
+PoolGraph staticGraph;
+
+class Block
+{
+    public:
+
+    std::uint64_t values[ 3 ];
+};
+
+typedef graph::PoolAllocator< Block > BlockAllocator;
+
+std::size_t const threadCount = 8;
+std::size_t const blocksPerThread = 5000;
+
+// FILL BLOCK -----------------------------------------------------------------
+
+void fillBlock( Block * block, std::uint64_t value )
+{
+    block->values[ 0 ] = value;
+    block->values[ 1 ] = ~value;
+    block->values[ 2 ] = value * 3;
+}
+
+bool const checkBlock( Block const * block, std::uint64_t value )
+{
+    return block->values[ 0 ] == value && block->values[ 1 ] == ~value &&
+           block->values[ 2 ] == value * 3;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// THREADED BLOCKS ------------------------------------------------------------
+
+// In each round, threads allocate blocks through their caches and free
+// every other one before exiting, so the second round reuses blocks the
+// first round's threads flushed back. The survivors are then freed by
+// other threads than the ones that allocated them. No block may be handed
+// out twice or lose its contents.
+
+void testThreadedBlocks( void )
+{
+    std::size_t const rounds = 2;
+    std::vector< std::vector< Block * > > blocks( threadCount );
+    std::vector< char > intact( threadCount, 0 );
+
+    for( std::size_t round = 0; round < rounds; ++round )
+    {
+        std::vector< std::thread > threads;
+
+        for( std::size_t t = 0; t < threadCount; ++t )
+        {
+            threads.push_back( std::thread( [ &, t ]( void )
+            {
+                BlockAllocator allocator;
+                std::vector< Block * > & own = blocks[ t ];
+                std::size_t first = own.size();
+                bool ok = true;
+
+                for( std::size_t b = first; b < first + blocksPerThread; ++b )
+                {
+                    own.push_back( allocator.allocate( 1 ) );
+                    fillBlock( own.back(), t * rounds * blocksPerThread + b );
+                }
+
+                for( std::size_t b = first; b < own.size(); ++b )
+                {
+                    ok = ok && checkBlock( own[ b ],
+                                           t * rounds * blocksPerThread + b );
+
+                    if( b % 2 == 0 )
+                    {
+                        allocator.deallocate( own[ b ], 1 );
+                        own[ b ] = nullptr;
+                    }
+                }
+
+                intact[ t ] = ok;
+            } ) );
+        }
+
+        for( std::size_t t = 0; t < threads.size(); ++t )
+        {
+            threads[ t ].join();
+            PG_CHECK( intact[ t ] );
+        }
+    }
+
+    // Survivors are distinct and intact
+
+    std::vector< Block * > live;
+
+    for( std::size_t t = 0; t < threadCount; ++t )
+    {
+        for( std::size_t b = 1; b < blocks[ t ].size(); b += 2 )
+        {
+            PG_CHECK( checkBlock( blocks[ t ][ b ],
+                                  t * rounds * blocksPerThread + b ) );
+            live.push_back( blocks[ t ][ b ] );
+        }
+    }
+
+    std::sort( live.begin(), live.end() );
+    PG_CHECK( std::adjacent_find( live.begin(), live.end() ) ==
+              live.end() );
+
+    // Free them from the next thread along
+
+    std::vector< std::thread > threads;
+
+    for( std::size_t t = 0; t < threadCount; ++t )
+    {
+        threads.push_back( std::thread( [ &, t ]( void )
+        {
+            BlockAllocator allocator;
+            std::vector< Block * > & other =
+                blocks[ ( t + 1 ) % threadCount ];
+
+            for( std::size_t b = 1; b < other.size(); b += 2 )
+            {
+                allocator.deallocate( other[ b ], 1 );
+            }
+        } ) );
+    }
+
+    for( std::size_t t = 0; t < threads.size(); ++t )
+    {
+        threads[ t ].join();
+    }
+}
+
+// POOLED GRAPHS --------------------------------------------------------------
+
+// Graphs built on separate threads and destroyed on another
+
+void testPooledGraphs( void )
+{
+    std::vector< std::unique_ptr< PoolGraph > > graphs( threadCount );
+    std::vector< std::thread > threads;
+
+    for( std::size_t t = 0; t < threadCount; ++t )
+    {
+        threads.push_back( std::thread( [ &, t ]( void )
+        {
+            graphs[ t ].reset( new PoolGraph );
+
+            std::vector< PoolGraph::VertexIterator > vertices;
+
+            for( std::size_t v = 0; v < 100; ++v )
+            {
+                vertices.push_back( graphs[ t ]->addVertex() );
+            }
+
+            for( std::size_t v = 0; v + 2 < vertices.size(); ++v )
+            {
+                graphs[ t ]->addTriangle( vertices[ v ], vertices[ v + 1 ],
+                                          vertices[ v + 2 ] );
+            }
+        } ) );
+    }
+
+    for( std::size_t t = 0; t < threads.size(); ++t )
+    {
+        threads[ t ].join();
+        PG_CHECK( graphs[ t ]->getPolygonCount() == 98 );
+        PG_CHECK( graphs[ t ]->getEdgeCount() == 98 * 3 );
+    }
+
+    graphs.clear();
+
+    // The static graph outlives the pools' users and frees at exit
+
+    PoolGraph::VertexIterator a = staticGraph.addVertex();
+    PoolGraph::VertexIterator b = staticGraph.addVertex();
+    PoolGraph::VertexIterator c = staticGraph.addVertex();
+    staticGraph.addTriangle( a, b, c );
+
+    PG_CHECK( staticGraph.getPolygonCount() == 1 );
+}
+
+// HUGE PAGE CHUNKS -----------------------------------------------------------
+
+// Chunks are whole huge pages, aligned to them on Linux, and usable
+// whether or not the NUMA policy could be applied.
+
+void testHugePageChunks( void )
+{
+    typedef graph::HugePageChunkSource< graph::NumaInterleave > Source;
+
+    std::size_t bytes = Source::getChunkBytes( 1 );
+
+    PG_CHECK( bytes == Source::hugePageBytes );
+    PG_CHECK( Source::getChunkBytes( bytes + 1 ) == 2 * bytes );
+
+    char * chunk = static_cast< char * >( Source::allocateChunk( bytes ) );
+    PG_CHECK( chunk != nullptr );
+
+    if( chunk == nullptr )
+    {
+        return;
+    }
+
+#if defined( __linux__ )
+    PG_CHECK( reinterpret_cast< std::uintptr_t >( chunk ) % bytes == 0 );
+#endif
+
+    std::memset( chunk, 0x5a, bytes );
+    PG_CHECK( chunk[ 0 ] == 0x5a && chunk[ bytes - 1 ] == 0x5a );
+    PG_CHECK( graph::NumaFirstTouch::apply( chunk, bytes ) );
+
+    Source::deallocateChunk( chunk, bytes );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testThreadedBlocks();
+    testPooledGraphs();
+    testHugePageChunks();
+
+    return graph::test::finish();
+}
@@ -0,0 +1,276 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "PolygonGraphBVH.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+using graph::test::isNear;
+
+typedef graph::PolygonBVH< graph::test::TestTraits > BVH;
+
+std::size_t const gridSize = 16;
+double const tolerance = 1e-4;
+
+// IN CELL --------------------------------------------------------------------
+
+// True if every corner of the polygon lies in the unit cell at ( x, y ) and
+// one of them is at corner ( cx, cy ).
+
+bool const inCell
+(
+    TestGraph::PolygonIterator polygon,
+    float x,
+    float y,
+    float cx,
+    float cy
+)
+{
+    TestGraph::Edge * startEdge = polygon->getStartEdge();
+    TestGraph::Edge * edge = startEdge;
+    bool inside = true;
+    bool corner = false;
+
+    do
+    {
+        float const * p = edge->getTargetVertex()->position;
+
+        inside = inside && p[ 0 ] >= x && p[ 0 ] <= x + 1.0f &&
+                 p[ 1 ] >= y && p[ 1 ] <= y + 1.0f;
+        corner = corner || ( p[ 0 ] == cx && p[ 1 ] == cy );
+        edge = edge->getNextEdge();
+    }
+    while( edge != startEdge );
+
+    return inside && corner;
+}
+
+// GET RANDOM -----------------------------------------------------------------
+
+// Deterministic uniform value in [ low, high ).
+
+double const getRandom( unsigned & state, double low, double high )
+{
+    state = state * 1664525u + 1013904223u;
+
+    return low + ( high - low ) * double( state >> 8 ) / double( 1 << 24 );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// RAY HITS -------------------------------------------------------------------
+
+// A ray down through every cell, either side of the diagonal, hits the
+// triangle on that side.
+
+void testRayHits( void )
+{
+    TestGraph graph;
+    graph::test::makeGrid( graph, gridSize );
+
+    BVH bvh;
+    bvh.build( graph, 2 );
+
+    double const down[ 3 ] = { 0.0, 0.0, -1.0 };
+
+    for( std::size_t y = 0; y < gridSize; ++y )
+    {
+        for( std::size_t x = 0; x < gridSize; ++x )
+        {
+            float fx = float( x );
+            float fy = float( y );
+            double const upper[ 3 ] = { fx + 0.3, fy + 0.6, 5.0 };
+            double const lower[ 3 ] = { fx + 0.6, fy + 0.3, 5.0 };
+            BVH::RayHit hit = BVH::RayHit();
+
+            PG_CHECK( bvh.intersectRay( upper, down, hit ) );
+            PG_CHECK( isNear( hit.distance, 5.0, tolerance ) );
+            PG_CHECK( inCell( hit.polygon, fx, fy, fx, fy + 1.0f ) );
+
+            PG_CHECK( bvh.intersectRay( lower, down, hit ) );
+            PG_CHECK( inCell( hit.polygon, fx, fy, fx + 1.0f, fy ) );
+        }
+    }
+}
+
+// RAY MISSES -----------------------------------------------------------------
+
+void testRayMisses( void )
+{
+    TestGraph graph;
+    graph::test::makeGrid( graph, gridSize );
+
+    BVH bvh;
+    BVH::RayHit hit = BVH::RayHit();
+    double const inside[ 3 ] = { 3.5, 2.25, 5.0 };
+    double const down[ 3 ] = { 0.0, 0.0, -1.0 };
+
+    // Nothing to hit before building
+
+    PG_CHECK( !bvh.intersectRay( inside, down, hit ) );
+
+    bvh.build( graph );
+
+    // Pointing away, beside the grid, parallel to it and sloping down
+    // past its far side
+
+    double const up[ 3 ] = { 0.0, 0.0, 1.0 };
+    double const beside[ 3 ] = { -5.0, -5.0, 5.0 };
+    double const level[ 3 ] = { -1.0, 3.5, 1.0 };
+    double const across[ 3 ] = { 1.0, 0.0, 0.0 };
+    double const diagonal[ 3 ] = { 1.0, 1.0, -0.01 };
+
+    PG_CHECK( !bvh.intersectRay( inside, up, hit ) );
+    PG_CHECK( !bvh.intersectRay( beside, down, hit ) );
+    PG_CHECK( !bvh.intersectRay( level, across, hit ) );
+    PG_CHECK( !bvh.intersectRay( level, diagonal, hit ) );
+
+    // maxDistance cuts the ray short, inclusively
+
+    PG_CHECK( !bvh.intersectRay( inside, down, hit, 4.0 ) );
+    PG_CHECK( bvh.intersectRay( inside, down, hit, 5.0 ) );
+}
+
+// CLOSEST POINT AND REFIT ----------------------------------------------------
+
+void testClosestPointAndRefit( void )
+{
+    TestGraph graph;
+    graph::test::makeGrid( graph, gridSize );
+
+    BVH bvh;
+    bvh.build( graph );
+
+    double const point[ 3 ] = { 3.5, 2.25, 2.0 };
+    BVH::ClosestHit closest = BVH::ClosestHit();
+
+    PG_CHECK( bvh.findClosestPoint( point, closest ) );
+    PG_CHECK( isNear( closest.distance, 2.0, tolerance ) );
+    PG_CHECK( isNear( closest.point[ 0 ], 3.5, tolerance ) );
+    PG_CHECK( isNear( closest.point[ 1 ], 2.25, tolerance ) );
+    PG_CHECK( !bvh.findClosestPoint( point, closest, 1.0 ) );
+
+    // Lift the grid by one and refit
+
+    TestGraph::VertexIterator vertexIt = graph.beginVertices();
+
+    while( vertexIt != graph.endVertices() )
+    {
+        vertexIt->position[ 2 ] += 1.0f;
+        ++vertexIt;
+    }
+
+    bvh.refit();
+
+    double const origin[ 3 ] = { 3.5, 2.25, 5.0 };
+    double const down[ 3 ] = { 0.0, 0.0, -1.0 };
+    BVH::RayHit hit = BVH::RayHit();
+
+    PG_CHECK( bvh.intersectRay( origin, down, hit ) );
+    PG_CHECK( isNear( hit.distance, 4.0, tolerance ) );
+    PG_CHECK( bvh.findClosestPoint( point, closest ) );
+    PG_CHECK( isNear( closest.distance, 1.0, tolerance ) );
+}
+
+// SIMD KERNELS ---------------------------------------------------------------
+
+// The vector batch kernels find the same hits as the scalar ones on a
+// bumpy grid with a quad, a degenerate triangle and partly filled batches.
+
+void testSimdKernels( void )
+{
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, gridSize );
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        float * p = vertices[ v ]->position;
+        p[ 2 ] = 0.5f * std::sin( p[ 0 ] * 0.7f ) * std::cos( p[ 1 ] * 0.4f );
+    }
+
+    float const size = float( gridSize );
+    TestGraph::VertexIterator a =
+        graph.addVertex( graph::test::makeVertex( 0.0f, 0.0f, 2.0f ) );
+    TestGraph::VertexIterator b =
+        graph.addVertex( graph::test::makeVertex( size, 0.0f, 2.0f ) );
+    TestGraph::VertexIterator c =
+        graph.addVertex( graph::test::makeVertex( size, size, 2.0f ) );
+    TestGraph::VertexIterator d =
+        graph.addVertex( graph::test::makeVertex( 0.0f, size, 2.5f ) );
+
+    graph.addQuad( a, b, c, d );
+    graph.addTriangle( a, c, graph.addVertex( graph::test::makeVertex(
+        size * 0.5f, size * 0.5f, 2.0f ) ) );
+
+    BVH scalar;
+    BVH vector;
+    scalar.build( graph, 1 );
+    vector.build( graph, 1 );
+    scalar.setSimdLevel( graph::simdScalar );
+
+    PG_CHECK( scalar.getSimdLevel() == graph::simdScalar );
+    PG_CHECK( vector.getSimdLevel() == graph::getSupportedSimdLevel() );
+
+    unsigned state = 1;
+
+    for( std::size_t r = 0; r < 500; ++r )
+    {
+        double origin[ 3 ];
+        double direction[ 3 ];
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            origin[ axis ] = getRandom( state, -2.0, size + 2.0 );
+            direction[ axis ] = getRandom( state, -1.0, 1.0 );
+        }
+
+        BVH::RayHit expected = BVH::RayHit();
+        BVH::RayHit actual = BVH::RayHit();
+        bool hit = scalar.intersectRay( origin, direction, expected );
+
+        PG_CHECK( vector.intersectRay( origin, direction, actual ) == hit );
+        PG_CHECK( !hit || ( actual.polygon == expected.polygon &&
+                            isNear( actual.distance, expected.distance,
+                                    tolerance ) ) );
+
+        BVH::ClosestHit expectedPoint = BVH::ClosestHit();
+        BVH::ClosestHit actualPoint = BVH::ClosestHit();
+
+        PG_CHECK( scalar.findClosestPoint( origin, expectedPoint ) );
+        PG_CHECK( vector.findClosestPoint( origin, actualPoint ) );
+        PG_CHECK( isNear( actualPoint.distance, expectedPoint.distance,
+                          tolerance ) );
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            PG_CHECK( isNear( actualPoint.point[ axis ],
+                              expectedPoint.point[ axis ], tolerance ) );
+        }
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testRayHits();
+    testRayMisses();
+    testClosestPointAndRefit();
+    testSimdKernels();
+
+    return graph::test::finish();
+}
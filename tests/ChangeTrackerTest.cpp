@@ -0,0 +1,121 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <utility>
+
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+// CREATION -------------------------------------------------------------------
+
+void testCreation( void )
+{
+    TestGraph graph;
+    TestGraph::ChangeTracker tracker;
+    graph.attachChangeTracker( tracker );
+
+    TestGraph::VertexIterator a = graph.addVertex();
+    TestGraph::VertexIterator b = graph.addVertex();
+    TestGraph::VertexIterator c = graph.addVertex();
+    TestGraph::PolygonIterator polygon = graph.addTriangle( a, b, c );
+
+    PG_CHECK( tracker.getCreatedVertices().size() == 3 );
+    PG_CHECK( tracker.getCreatedEdges().size() == 3 );
+    PG_CHECK( tracker.getCreatedPolygons().size() == 1 );
+    PG_CHECK( tracker.getCreatedPolygons().count( polygon ) == 1 );
+    PG_CHECK( tracker.getModifiedVertices().empty() );
+
+    // An element created and destroyed between checkpoints is not reported
+
+    TestGraph::VertexIterator d = graph.addVertex();
+    graph.removeVertex( d );
+
+    PG_CHECK( tracker.getCreatedVertices().size() == 3 );
+    PG_CHECK( tracker.getDestroyedVertices().empty() );
+}
+
+// MODIFICATION AND DESTRUCTION -----------------------------------------------
+
+void testModificationAndDestruction( void )
+{
+    TestGraph graph;
+    TestGraph::ChangeTracker tracker;
+    graph.attachChangeTracker( tracker );
+
+    TestGraph::VertexIterator a = graph.addVertex();
+    TestGraph::VertexIterator b = graph.addVertex();
+    TestGraph::VertexIterator c = graph.addVertex();
+    TestGraph::VertexIterator d = graph.addVertex();
+    TestGraph::PolygonIterator first = graph.addTriangle( a, b, c );
+
+    tracker.clear();
+    graph.addTriangle( a, c, d );
+
+    PG_CHECK( tracker.getCreatedPolygons().size() == 1 );
+    PG_CHECK( tracker.getModifiedVertices().size() == 3 );
+
+    tracker.clear();
+    graph.removePolygon( first );
+
+    PG_CHECK( tracker.getDestroyedPolygons().size() == 1 );
+    PG_CHECK( tracker.getDestroyedEdges().size() == 3 );
+    PG_CHECK( tracker.getModifiedVertices().size() == 3 );
+
+    tracker.clear();
+    graph.markModified( d );
+
+    PG_CHECK( tracker.getModifiedVertices().count( d ) == 1 );
+}
+
+// MOVE AND DETACH ------------------------------------------------------------
+
+void testMoveAndDetach( void )
+{
+    TestGraph graph;
+    TestGraph::ChangeTracker tracker;
+    graph.attachChangeTracker( tracker );
+
+    TestGraph::VertexIterator a = graph.addVertex();
+    TestGraph::VertexIterator b = graph.addVertex();
+    TestGraph::VertexIterator c = graph.addVertex();
+    graph.addTriangle( a, b, c );
+
+    // The tracker follows the graph's contents when it is moved
+
+    TestGraph moved( std::move( graph ) );
+    tracker.clear();
+    moved.removeVertex( c );
+
+    PG_CHECK( tracker.getDestroyedVertices().size() == 1 );
+    PG_CHECK( tracker.getDestroyedPolygons().size() == 1 );
+
+    // A tracker destroyed first detaches itself
+
+    {
+        TestGraph::ChangeTracker scoped;
+        moved.attachChangeTracker( scoped );
+    }
+
+    moved.clear();
+
+    PG_CHECK( tracker.getDestroyedVertices().size() == 3 );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testCreation();
+    testModificationAndDestruction();
+    testMoveAndDetach();
+
+    return graph::test::finish();
+}
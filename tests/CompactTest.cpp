@@ -0,0 +1,359 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <vector>
+
+#include "PolygonGraphCompact.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+typedef graph::CompactPolygonGraph< graph::test::TestTraits > CompactGraph;
+typedef CompactGraph::index_type index_type;
+typedef graph::detail::CowArray< CompactGraph::BaseVertex > VertexArray;
+
+// Test traits with numbered edges and polygons, to follow payloads
+
+class PayloadTraits : public graph::test::TestTraits
+{
+    public:
+
+    class BaseEdge
+    {
+        public:
+
+        int id;
+    };
+
+    class BasePolygon
+    {
+        public:
+
+        int id;
+    };
+};
+
+typedef graph::PolygonGraph< PayloadTraits > PayloadGraph;
+typedef graph::CompactPolygonGraph< PayloadTraits > CompactPayloadGraph;
+
+// MAKE PAYLOAD MESH ----------------------------------------------------------
+
+// Adds a grid mixing quads and triangles, a separate pentagon and an
+// isolated vertex, numbering every polygon and half-edge. Returns the
+// vertices in order.
+
+std::vector< PayloadGraph::VertexIterator > const makePayloadMesh
+(
+    PayloadGraph & graph
+)
+{
+    std::size_t const size = 4;
+    std::size_t const row = size + 1;
+
+    std::vector< PayloadGraph::VertexIterator > vertices;
+    std::vector< std::vector< std::size_t > > rings;
+
+    for( std::size_t v = 0; v < row * row; ++v )
+    {
+        vertices.push_back( graph.addVertex( graph::test::makeVertex
+        (
+            float( v % row ), float( v / row ), 0.0f
+        ) ) );
+    }
+
+    for( std::size_t y = 0; y < size; ++y )
+    {
+        for( std::size_t x = 0; x < size; ++x )
+        {
+            std::size_t a = y * row + x;
+
+            if( ( x + y ) % 3 == 0 )
+            {
+                rings.push_back( { a, a + 1, a + row + 1, a + row } );
+            }
+            else
+            {
+                rings.push_back( { a, a + 1, a + row + 1 } );
+                rings.push_back( { a, a + row + 1, a + row } );
+            }
+        }
+    }
+
+    std::vector< std::size_t > pentagon;
+
+    for( std::size_t v = 0; v < 5; ++v )
+    {
+        pentagon.push_back( vertices.size() );
+        vertices.push_back( graph.addVertex( graph::test::makeVertex
+        (
+            float( v ), 10.0f + float( v % 2 ), 0.0f
+        ) ) );
+    }
+
+    rings.push_back( pentagon );
+    vertices.push_back( graph.addVertex() );
+
+    int edgeId = 0;
+
+    for( std::size_t r = 0; r < rings.size(); ++r )
+    {
+        std::vector< PayloadGraph::VertexIterator > ring;
+
+        for( std::size_t v : rings[ r ] )
+        {
+            ring.push_back( vertices[ v ] );
+        }
+
+        PayloadTraits::BasePolygon basePolygon;
+        basePolygon.id = int( r ) + 1000;
+
+        PayloadGraph::PolygonIterator polygon =
+            graph.addPolygon( ring.begin(), ring.end(), basePolygon );
+
+        for( PayloadGraph::Edge & edge : polygon->getEdges() )
+        {
+            edge.id = edgeId++;
+        }
+    }
+
+    return vertices;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// SHARING --------------------------------------------------------------------
+
+void testSharing( void )
+{
+    // 71 x 71 vertices fill two payload chunks
+
+    std::size_t const size = 70;
+    std::size_t const row = size + 1;
+    std::size_t const chunkBytes =
+        VertexArray::chunkSize * sizeof( CompactGraph::BaseVertex );
+
+    TestGraph source;
+    graph::test::makeGrid( source, size );
+
+    CompactGraph const original( source );
+    std::size_t const vertexCount = original.getVertexCount();
+    std::size_t const edgeCount = original.getEdgeCount();
+    std::size_t const polygonCount = original.getPolygonCount();
+    std::size_t const memoryBytes = original.getMemoryBytes();
+
+    PG_CHECK( vertexCount == row * row );
+    PG_CHECK( vertexCount > VertexArray::chunkSize );
+    PG_CHECK( original.getUniqueMemoryBytes() == memoryBytes );
+
+    // A copy shares every array, the adjacency index included
+
+    CompactGraph fork( original );
+
+    PG_CHECK( fork.getMemoryBytes() == memoryBytes );
+    PG_CHECK( fork.getUniqueMemoryBytes() == 0 );
+    PG_CHECK( original.getUniqueMemoryBytes() == 0 );
+    PG_CHECK( &static_cast< CompactGraph const & >( fork ).getVertex( 0 ) ==
+              &original.getVertex( 0 ) );
+    PG_CHECK( &fork.getEdge( 0 ) == &original.getEdge( 0 ) );
+    PG_CHECK( fork.beginOutgoingEdges( 0 ) ==
+              original.beginOutgoingEdges( 0 ) );
+
+    // A payload write duplicates just the chunk it lands in, which
+    // leaves the original holding its own chunk alone
+
+    fork.getVertex( 5 ).position[ 2 ] = 1.0f;
+
+    PG_CHECK( fork.getUniqueMemoryBytes() == chunkBytes );
+    PG_CHECK( original.getUniqueMemoryBytes() == chunkBytes );
+    PG_CHECK( original.getVertex( 5 ).position[ 2 ] == 0.0f );
+    PG_CHECK( &static_cast< CompactGraph const & >( fork ).getVertex(
+                  vertexCount - 1 ) ==
+              &original.getVertex( vertexCount - 1 ) );
+
+    // Appends after the fork leave the original unchanged
+
+    index_type ring[ 3 ];
+    ring[ 0 ] = 0;
+    ring[ 1 ] = fork.addVertex( graph::test::makeVertex( 0, -1, 0 ) );
+    ring[ 2 ] = 1;
+
+    index_type polygon = fork.addPolygon( ring, ring + 3 );
+
+    PG_CHECK( polygon == polygonCount );
+    PG_CHECK( fork.getVertexCount() == vertexCount + 1 );
+    PG_CHECK( fork.getEdgeCount() == edgeCount + 3 );
+    PG_CHECK( !fork.hasAdjacency() );
+    PG_CHECK( original.getVertexCount() == vertexCount );
+    PG_CHECK( original.getEdgeCount() == edgeCount );
+    PG_CHECK( original.getPolygonCount() == polygonCount );
+    PG_CHECK( original.getMemoryBytes() == memoryBytes );
+    PG_CHECK( original.hasAdjacency() );
+
+    // Building the fork's adjacency publishes a new index, leaving the
+    // original's in place
+
+    index_type const * originalEdges = original.beginOutgoingEdges( 0 );
+    std::size_t const originalDegree = original.getVertexEdgeCount( 0 );
+
+    fork.buildAdjacency();
+
+    PG_CHECK( fork.hasAdjacency() );
+    PG_CHECK( fork.getVertexEdgeCount( 0 ) == originalDegree + 1 );
+    PG_CHECK( fork.findEdge( ring[ 1 ], 1 ) != CompactGraph::invalidIndex );
+    PG_CHECK( fork.getTwin( fork.findEdge( 1, 0 ) ) ==
+              fork.findEdge( 0, 1 ) );
+    PG_CHECK( original.beginOutgoingEdges( 0 ) == originalEdges );
+    PG_CHECK( original.getVertexEdgeCount( 0 ) == originalDegree );
+    PG_CHECK( original.findEdge( 1, 0 ) == CompactGraph::invalidIndex );
+    PG_CHECK( original.getMemoryBytes() == memoryBytes );
+    PG_CHECK( original.getUniqueMemoryBytes() < memoryBytes );
+}
+
+// ROUND TRIP -----------------------------------------------------------------
+
+// PolygonGraph to CompactPolygonGraph and back keeps numbering,
+// orientation, payloads and the edge lookups.
+
+void testRoundTrip( void )
+{
+    PayloadGraph source;
+    std::vector< PayloadGraph::VertexIterator > sourceVertices =
+        makePayloadMesh( source );
+
+    CompactPayloadGraph compact;
+    compact.assign( source );
+
+    PayloadGraph exported;
+    std::vector< PayloadGraph::VertexIterator > exportedVertices;
+    compact.exportTo( exported, &exportedVertices );
+
+    PG_CHECK( compact.hasAdjacency() );
+    PG_CHECK( compact.getVertexCount() == source.getVertexCount() );
+    PG_CHECK( compact.getEdgeCount() == source.getEdgeCount() );
+    PG_CHECK( compact.getPolygonCount() == source.getPolygonCount() );
+    PG_CHECK( exported.getVertexCount() == source.getVertexCount() );
+    PG_CHECK( exported.getEdgeCount() == source.getEdgeCount() );
+    PG_CHECK( exported.getPolygonCount() == source.getPolygonCount() );
+    PG_CHECK( exportedVertices.size() == sourceVertices.size() );
+
+    // Vertices keep their order and payloads
+
+    for( std::size_t v = 0; v < sourceVertices.size(); ++v )
+    {
+        PG_CHECK( compact.getVertex( index_type( v ) ).position[ 1 ] ==
+                  sourceVertices[ v ]->position[ 1 ] );
+        PG_CHECK( exportedVertices[ v ]->position[ 0 ] ==
+                  sourceVertices[ v ]->position[ 0 ] );
+        PG_CHECK( exportedVertices[ v ]->position[ 1 ] ==
+                  sourceVertices[ v ]->position[ 1 ] );
+        PG_CHECK( exportedVertices[ v ]->getEdgeCount() ==
+                  sourceVertices[ v ]->getEdgeCount() );
+    }
+
+    // Polygons keep their order, payload and rings, starting from the
+    // same edge in the same direction
+
+    PayloadGraph::PolygonIterator sourcePolygon = source.beginPolygons();
+    PayloadGraph::PolygonIterator exportedPolygon = exported.beginPolygons();
+
+    for( index_type p = 0; p < compact.getPolygonCount(); ++p )
+    {
+        PayloadGraph::Edge * sourceEdge = sourcePolygon->getStartEdge();
+        PayloadGraph::Edge * exportedEdge = exportedPolygon->getStartEdge();
+        index_type compactEdge = compact.getStartEdge( p );
+        std::size_t ringSize = 0;
+
+        PG_CHECK( compact.getPolygonData( p ).id == sourcePolygon->id );
+        PG_CHECK( exportedPolygon->id == sourcePolygon->id );
+
+        do
+        {
+            PayloadGraph::Vertex const * target =
+                &( *sourceEdge->getTargetVertex() );
+            index_type compactTarget = compact.getTargetVertex( compactEdge );
+
+            PG_CHECK( compact.getPolygon( compactEdge ) == p );
+            PG_CHECK( compact.getEdgeData( compactEdge ).id ==
+                      sourceEdge->id );
+            PG_CHECK( exportedEdge->id == sourceEdge->id );
+            PG_CHECK( &( *sourceVertices[ compactTarget ] ) == target );
+            PG_CHECK( exportedVertices[ compactTarget ] ==
+                      exportedEdge->getTargetVertex() );
+
+            sourceEdge = sourceEdge->getNextEdge();
+            exportedEdge = exportedEdge->getNextEdge();
+            compactEdge = compact.getNextEdge( compactEdge );
+            ++ringSize;
+        }
+        while( sourceEdge != sourcePolygon->getStartEdge() );
+
+        PG_CHECK( exportedEdge == exportedPolygon->getStartEdge() );
+        PG_CHECK( compactEdge == compact.getStartEdge( p ) );
+        PG_CHECK( compact.getPolygonEdgeCount( p ) == ringSize );
+
+        ++sourcePolygon;
+        ++exportedPolygon;
+    }
+
+    // findEdge and getTwin agree with the source for every vertex pair,
+    // missing edges included
+
+    std::size_t missing = 0;
+
+    for( index_type a = 0; a < compact.getVertexCount(); ++a )
+    {
+        for( index_type b = 0; b < compact.getVertexCount(); ++b )
+        {
+            PayloadGraph::Edge * sourceEdge =
+                source.findEdge( sourceVertices[ a ], sourceVertices[ b ] );
+            PayloadGraph::Edge * exportedEdge = exported.findEdge
+            (
+                exportedVertices[ a ], exportedVertices[ b ]
+            );
+            index_type edge = compact.findEdge( a, b );
+
+            if( sourceEdge == nullptr )
+            {
+                PG_CHECK( edge == CompactPayloadGraph::invalidIndex );
+                PG_CHECK( exportedEdge == nullptr );
+                ++missing;
+                continue;
+            }
+
+            PG_CHECK( edge != CompactPayloadGraph::invalidIndex &&
+                      compact.getSourceVertex( edge ) == a &&
+                      compact.getTargetVertex( edge ) == b &&
+                      compact.getEdgeData( edge ).id == sourceEdge->id );
+            PG_CHECK( exportedEdge != nullptr &&
+                      exportedEdge->id == sourceEdge->id );
+            PG_CHECK( compact.getTwin( edge ) == compact.findEdge( b, a ) );
+            PG_CHECK( ( compact.getTwin( edge ) ==
+                        CompactPayloadGraph::invalidIndex ) ==
+                      ( source.findEdge( sourceVertices[ b ],
+                                         sourceVertices[ a ] ) == nullptr ) );
+        }
+    }
+
+    PG_CHECK( missing + compact.getEdgeCount() ==
+              compact.getVertexCount() * compact.getVertexCount() );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testRoundTrip();
+    testSharing();
+
+    return graph::test::finish();
+}
@@ -0,0 +1,164 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PolygonGraphDual.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+using graph::test::getSource;
+using graph::test::getTarget;
+
+typedef graph::FaceAdjacency< graph::test::TestTraits > Adjacency;
+
+// MAKE CUBE ------------------------------------------------------------------
+
+// Six outward-facing quads over the corners of the unit cube; vertex
+// x + 2y + 4z sits at ( x, y, z ).
+
+void makeCube( TestGraph & graph )
+{
+    std::vector< TestGraph::VertexIterator > v;
+
+    for( int i = 0; i < 8; ++i )
+    {
+        v.push_back( graph.addVertex( graph::test::makeVertex
+        (
+            float( i & 1 ), float( ( i >> 1 ) & 1 ), float( i >> 2 )
+        ) ) );
+    }
+
+    graph.addQuad( v[ 0 ], v[ 2 ], v[ 3 ], v[ 1 ] );
+    graph.addQuad( v[ 4 ], v[ 5 ], v[ 7 ], v[ 6 ] );
+    graph.addQuad( v[ 0 ], v[ 1 ], v[ 5 ], v[ 4 ] );
+    graph.addQuad( v[ 2 ], v[ 6 ], v[ 7 ], v[ 3 ] );
+    graph.addQuad( v[ 0 ], v[ 4 ], v[ 6 ], v[ 2 ] );
+    graph.addQuad( v[ 1 ], v[ 3 ], v[ 7 ], v[ 5 ] );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// FACE ADJACENCY -------------------------------------------------------------
+
+void testFaceAdjacency( void )
+{
+    std::size_t const size = 5;
+
+    TestGraph graph;
+    graph::test::makeGrid( graph, size, true );
+
+    Adjacency adjacency;
+    graph::buildDual( graph, adjacency, 2 );
+
+    PG_CHECK( adjacency.getPolygonCount() == size * size );
+    PG_CHECK( adjacency.offsets.size() == size * size + 1 );
+
+    // Grid quads are added row by row, so index q sits at ( q % size,
+    // q / size ) and has one neighbour per side away from the border
+
+    for( std::uint32_t q = 0; q < size * size; ++q )
+    {
+        std::size_t x = q % size;
+        std::size_t y = q / size;
+        std::uint32_t expected = ( x > 0 ) + ( x + 1 < size ) +
+                                 ( y > 0 ) + ( y + 1 < size );
+
+        PG_CHECK( adjacency.getIndex( adjacency.polygons[ q ] ) == q );
+        PG_CHECK( adjacency.offsets[ q + 1 ] - adjacency.offsets[ q ] ==
+                  expected );
+
+        for( std::uint32_t n = adjacency.offsets[ q ];
+             n < adjacency.offsets[ q + 1 ]; ++n )
+        {
+            TestGraph::Edge const * shared = adjacency.sharedEdges[ n ];
+            TestGraph::Edge const * twin = adjacency.twinEdges[ n ];
+            std::uint32_t other = adjacency.neighbours[ n ];
+
+            PG_CHECK( shared->getPolygon() == adjacency.polygons[ q ] );
+            PG_CHECK( twin->getPolygon() == adjacency.polygons[ other ] );
+            PG_CHECK( getSource( shared ) == getTarget( twin ) );
+            PG_CHECK( getTarget( shared ) == getSource( twin ) );
+        }
+    }
+
+    // Polygons of another graph have no index
+
+    TestGraph other;
+    TestGraph::VertexIterator a = other.addVertex();
+    TestGraph::VertexIterator b = other.addVertex();
+    TestGraph::VertexIterator c = other.addVertex();
+
+    PG_CHECK( adjacency.getIndex( other.addTriangle( a, b, c ) ) ==
+              Adjacency::noPolygon );
+}
+
+// DUAL MESH ------------------------------------------------------------------
+
+void testDualMesh( void )
+{
+    // The dual of a cube is an octahedron
+
+    TestGraph cube;
+    makeCube( cube );
+
+    Adjacency adjacency;
+    TestGraph octahedron;
+    std::vector< TestGraph::VertexIterator > dualVertices;
+    graph::buildDual( cube, adjacency, octahedron, dualVertices );
+
+    PG_CHECK( dualVertices.size() == 6 );
+    PG_CHECK( octahedron.getVertexCount() == 6 );
+    PG_CHECK( octahedron.getPolygonCount() == 8 );
+
+    TestGraph::PolygonIterator polyIt = octahedron.beginPolygons();
+
+    while( polyIt != octahedron.endPolygons() )
+    {
+        PG_CHECK( polyIt->getEdgeCount() == 3 );
+        ++polyIt;
+    }
+
+    // Its dual is closed too, with every face meeting three others
+
+    Adjacency octahedronAdjacency;
+    graph::buildDual( octahedron, octahedronAdjacency );
+
+    for( std::uint32_t p = 0; p < 8; ++p )
+    {
+        PG_CHECK( octahedronAdjacency.offsets[ p + 1 ] -
+                  octahedronAdjacency.offsets[ p ] == 3 );
+    }
+
+    // Only interior vertices of an open grid get a dual polygon
+
+    TestGraph grid;
+    graph::test::makeGrid( grid, 4, true );
+
+    TestGraph dual;
+    graph::buildDual( grid, adjacency, dual, dualVertices );
+
+    PG_CHECK( dual.getVertexCount() == 16 );
+    PG_CHECK( dual.getPolygonCount() == 9 );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testFaceAdjacency();
+    testDualMesh();
+
+    return graph::test::finish();
+}
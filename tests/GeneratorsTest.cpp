@@ -0,0 +1,139 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "PolygonGraphGenerators.h"
+#include "TestUtility.h"
+
+// The generators are empty without coroutine support, leaving nothing to
+// test.
+
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+// COUNT UP -------------------------------------------------------------------
+
+// Yields 0 to failAt - 1 and then throws.
+
+graph::Generator< int > countUp( int failAt )
+{
+    for( int i = 0; i < failAt; ++i )
+    {
+        co_yield i;
+    }
+
+    throw std::runtime_error( "count" );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// EXCEPTIONS -----------------------------------------------------------------
+
+// An exception escaping the coroutine surfaces from the call that resumed
+// it, and leaves the range at its end.
+
+void testExceptions( void )
+{
+    graph::Generator< int > generator = countUp( 2 );
+    graph::Generator< int >::Iterator it = generator.begin();
+    std::vector< int > values;
+    bool thrown = false;
+
+    try
+    {
+        while( it != generator.end() )
+        {
+            values.push_back( *it );
+            ++it;
+        }
+    }
+    catch( std::runtime_error const & )
+    {
+        thrown = true;
+    }
+
+    PG_CHECK( thrown );
+    PG_CHECK( values.size() == 2 && values[ 0 ] == 0 && values[ 1 ] == 1 );
+    PG_CHECK( it == generator.end() );
+
+    // Thrown before the first value, from begin
+
+    graph::Generator< int > empty = countUp( 0 );
+    thrown = false;
+
+    try
+    {
+        empty.begin();
+    }
+    catch( std::runtime_error const & )
+    {
+        thrown = true;
+    }
+
+    PG_CHECK( thrown );
+}
+
+// TRAVERSALS -----------------------------------------------------------------
+
+void testTraversals( void )
+{
+    std::size_t const size = 6;
+
+    TestGraph graph;
+    graph::test::makeGrid( graph, size );
+
+    // Breadth first reaches every polygon once, seed first
+
+    std::size_t count = 0;
+    TestGraph::PolygonIterator seed = graph.beginPolygons();
+
+    for( TestGraph::PolygonIterator polygon :
+         graph::faceBreadthFirst( graph, seed ) )
+    {
+        PG_CHECK( count > 0 || polygon == seed );
+        ++count;
+    }
+
+    PG_CHECK( count == graph.getPolygonCount() );
+
+    // A big enough ring reaches every vertex, centre first
+
+    TestGraph::VertexIterator centre = graph.beginVertices();
+    count = 0;
+
+    for( TestGraph::VertexIterator vertex :
+         graph::vertexRing( graph, centre, 2 * size ) )
+    {
+        PG_CHECK( count > 0 || vertex == centre );
+        ++count;
+    }
+
+    PG_CHECK( count == graph.getVertexCount() );
+}
+
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+    testExceptions();
+    testTraversals();
+#endif
+
+    return graph::test::finish();
+}
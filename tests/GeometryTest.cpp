@@ -0,0 +1,307 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PolygonGraphGeometry.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+typedef graph::PolygonGeometry< graph::test::TestTraits > Geometry;
+
+// IS CLOSE -------------------------------------------------------------------
+
+// Within 1e-5 relative to the larger value, or absolute below one.
+
+bool const isClose( double a, double b )
+{
+    double scale = std::fmax( 1.0, std::fmax( std::fabs( a ),
+                                              std::fabs( b ) ) );
+
+    return graph::test::isNear( a, b, 1e-5 * scale );
+}
+
+// MAKE STRIP -----------------------------------------------------------------
+
+// Adds a strip of count triangles over a bumpy surface, zig-zagging
+// between two rows of vertices, so any count can be made.
+
+void makeStrip( TestGraph & graph, std::size_t count )
+{
+    std::vector< TestGraph::VertexIterator > vertices;
+
+    for( std::size_t v = 0; v < count + 2; ++v )
+    {
+        float x = 0.5f * float( v );
+        float y = float( v % 2 );
+        float z = 0.5f * std::sin( x * 0.7f ) * std::cos( y + x * 0.3f );
+
+        vertices.push_back
+        (
+            graph.addVertex( graph::test::makeVertex( x, y, z ) )
+        );
+    }
+
+    for( std::size_t t = 0; t < count; ++t )
+    {
+        if( t % 2 == 0 )
+        {
+            graph.addTriangle( vertices[ t ], vertices[ t + 1 ],
+                               vertices[ t + 2 ] );
+        }
+        else
+        {
+            graph.addTriangle( vertices[ t ], vertices[ t + 2 ],
+                               vertices[ t + 1 ] );
+        }
+    }
+}
+
+// CHECK REFERENCE ------------------------------------------------------------
+
+// Checks each polygon's normal, area and centroid against a fan computed
+// in double precision from the graph itself.
+
+void checkReference( Geometry const & geometry )
+{
+    for( std::size_t p = 0; p < geometry.getPolygonCount(); ++p )
+    {
+        std::vector< float const * > corners;
+
+        for( TestGraph::VertexIterator vertex :
+             geometry.polygons[ p ]->getVertices() )
+        {
+            corners.push_back( vertex->position );
+        }
+
+        double normal[ 3 ] = { 0.0, 0.0, 0.0 };
+        double centroid[ 3 ] = { 0.0, 0.0, 0.0 };
+
+        for( std::size_t i = 0; i < corners.size(); ++i )
+        {
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                centroid[ axis ] += corners[ i ][ axis ] /
+                                    double( corners.size() );
+            }
+        }
+
+        for( std::size_t i = 1; i + 1 < corners.size(); ++i )
+        {
+            double e1[ 3 ];
+            double e2[ 3 ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                e1[ axis ] = double( corners[ i ][ axis ] ) -
+                             corners[ 0 ][ axis ];
+                e2[ axis ] = double( corners[ i + 1 ][ axis ] ) -
+                             corners[ 0 ][ axis ];
+            }
+
+            normal[ 0 ] += e1[ 1 ] * e2[ 2 ] - e1[ 2 ] * e2[ 1 ];
+            normal[ 1 ] += e1[ 2 ] * e2[ 0 ] - e1[ 0 ] * e2[ 2 ];
+            normal[ 2 ] += e1[ 0 ] * e2[ 1 ] - e1[ 1 ] * e2[ 0 ];
+        }
+
+        double length = std::sqrt( normal[ 0 ] * normal[ 0 ] +
+                                   normal[ 1 ] * normal[ 1 ] +
+                                   normal[ 2 ] * normal[ 2 ] );
+
+        PG_CHECK( isClose( geometry.faceAreas[ p ], 0.5 * length ) );
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            double unit = length > 0.0 ? normal[ axis ] / length : 0.0;
+
+            PG_CHECK( isClose( geometry.faceNormals[ axis ][ p ], unit ) );
+            PG_CHECK( isClose( geometry.faceCentroids[ axis ][ p ],
+                               centroid[ axis ] ) );
+        }
+    }
+}
+
+// CHECK LEVELS ---------------------------------------------------------------
+
+// Builds the geometry at every supported SIMD level and checks each
+// against the scalar kernels, which are checked against the reference.
+
+void checkLevels( TestGraph & graph, bool triangleMesh )
+{
+    Geometry scalar;
+    scalar.setSimdLevel( graph::simdScalar );
+    scalar.build( graph, 1 );
+
+    PG_CHECK( scalar.getSimdLevel() == graph::simdScalar );
+    PG_CHECK( scalar.isTriangleMesh() == triangleMesh );
+    PG_CHECK( scalar.getPolygonCount() == graph.getPolygonCount() );
+    checkReference( scalar );
+
+    graph::SimdLevel const supported = graph::getSupportedSimdLevel();
+
+    for( int level = graph::simdScalar; level <= graph::simdAvx512;
+         ++level )
+    {
+        Geometry vector;
+        vector.setSimdLevel( static_cast< graph::SimdLevel >( level ) );
+        vector.build( graph, 1 );
+
+        // Levels the CPU lacks run as the widest supported one
+
+        PG_CHECK( vector.getSimdLevel() ==
+                  ( level > supported ? supported : level ) );
+
+        for( std::size_t p = 0; p < scalar.getPolygonCount(); ++p )
+        {
+            PG_CHECK( vector.polygons[ p ] == scalar.polygons[ p ] );
+            PG_CHECK( isClose( vector.faceAreas[ p ],
+                               scalar.faceAreas[ p ] ) );
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                PG_CHECK( isClose( vector.faceNormals[ axis ][ p ],
+                                   scalar.faceNormals[ axis ][ p ] ) );
+                PG_CHECK( isClose( vector.faceCentroids[ axis ][ p ],
+                                   scalar.faceCentroids[ axis ][ p ] ) );
+            }
+        }
+
+        for( std::size_t v = 0; v < scalar.getVertexCount(); ++v )
+        {
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                PG_CHECK( isClose( vector.vertexNormals[ axis ][ v ],
+                                   scalar.vertexNormals[ axis ][ v ] ) );
+            }
+        }
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// TRIANGLE COUNTS ------------------------------------------------------------
+
+// Counts either side of the 8- and 16-lane batch widths, so the vector
+// kernels hand partial batches to the scalar remainder.
+
+void testTriangleCounts( void )
+{
+    std::size_t const counts[] = { 1, 7, 9, 15, 17, 23, 31, 33, 50 };
+
+    for( std::size_t count : counts )
+    {
+        TestGraph graph;
+        makeStrip( graph, count );
+        checkLevels( graph, true );
+    }
+}
+
+// DEGENERATE TRIANGLE --------------------------------------------------------
+
+// A triangle with collinear corners inside a full vector batch has a zero
+// normal and area at every level, and adds nothing to its vertex normals.
+
+void testDegenerateTriangle( void )
+{
+    TestGraph graph;
+    makeStrip( graph, 20 );
+
+    TestGraph::VertexIterator a =
+        graph.addVertex( graph::test::makeVertex( 0.0f, 3.0f, 1.0f ) );
+    TestGraph::VertexIterator b =
+        graph.addVertex( graph::test::makeVertex( 1.0f, 4.0f, 2.0f ) );
+    TestGraph::VertexIterator c =
+        graph.addVertex( graph::test::makeVertex( 2.0f, 5.0f, 3.0f ) );
+
+    TestGraph::PolygonIterator degenerate = graph.addTriangle( a, b, c );
+
+    makeStrip( graph, 20 );
+    checkLevels( graph, true );
+
+    for( int level = graph::simdScalar; level <= graph::simdAvx512;
+         ++level )
+    {
+        Geometry geometry;
+        geometry.setSimdLevel( static_cast< graph::SimdLevel >( level ) );
+        geometry.build( graph, 1 );
+
+        std::uint32_t p = geometry.getIndex( degenerate );
+
+        PG_CHECK( geometry.faceAreas[ p ] == 0.0f );
+        PG_CHECK( isClose( geometry.faceCentroids[ 1 ][ p ], 4.0 ) );
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            PG_CHECK( geometry.faceNormals[ axis ][ p ] == 0.0f );
+            PG_CHECK( geometry.vertexNormals[ axis ][
+                          geometry.getIndex( b ) ] == 0.0f );
+        }
+    }
+}
+
+// QUAD MESH ------------------------------------------------------------------
+
+// Quads take the general polygon kernel at every level. On a flat grid
+// every normal is +z, every area one and every centroid a cell centre.
+
+void testQuadMesh( void )
+{
+    std::size_t const size = 5;
+
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, size, true );
+
+    checkLevels( graph, false );
+
+    Geometry geometry;
+    geometry.build( graph, 1 );
+
+    for( std::size_t p = 0; p < geometry.getPolygonCount(); ++p )
+    {
+        float cx = geometry.faceCentroids[ 0 ][ p ];
+        float cy = geometry.faceCentroids[ 1 ][ p ];
+
+        PG_CHECK( isClose( geometry.faceAreas[ p ], 1.0 ) );
+        PG_CHECK( isClose( geometry.faceNormals[ 2 ][ p ], 1.0 ) );
+        PG_CHECK( cx - std::floor( cx ) == 0.5f );
+        PG_CHECK( cy - std::floor( cy ) == 0.5f );
+    }
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        PG_CHECK( isClose( geometry.vertexNormals[ 2 ][
+                               geometry.getIndex( vertices[ v ] ) ], 1.0 ) );
+    }
+
+    // One triangle makes the mesh mixed, still on the general kernel
+
+    graph.addTriangle( vertices[ 0 ], vertices[ size + 1 ],
+                       graph.addVertex( graph::test::makeVertex(
+                           -1.0f, 0.5f, 0.5f ) ) );
+    checkLevels( graph, false );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testTriangleCounts();
+    testDegenerateTriangle();
+    testQuadMesh();
+
+    return graph::test::finish();
+}
@@ -0,0 +1,1387 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+typedef TestGraph::VertexIterator VertexIterator;
+typedef TestGraph::PolygonIterator PolygonIterator;
+typedef TestGraph::Edge Edge;
+
+// Payload that counts its live instances, which clearAsync destroys on
+// another thread
+
+template< int Kind >
+class Counted
+{
+    public:
+
+    Counted( void ) { ++getLiveCount(); }
+    Counted( Counted const & ) { ++getLiveCount(); }
+    ~Counted( void ) { --getLiveCount(); }
+
+    static std::atomic< long > & getLiveCount( void )
+    {
+        static std::atomic< long > liveCount( 0 );
+
+        return liveCount;
+    }
+};
+
+class CountedTraits
+{
+    public:
+
+    class BaseVertex : public Counted< 0 > {};
+    class BaseEdge : public Counted< 1 > {};
+    class BasePolygon : public Counted< 2 > {};
+};
+
+typedef graph::PolygonGraph< CountedTraits > CountedGraph;
+
+// Payloads constructed only from arguments, one of them move-only and one
+// an lvalue reference, so emplacing must forward them as given
+
+class EmplaceTraits
+{
+    public:
+
+    class BaseVertex
+    {
+        public:
+
+        BaseVertex( float weight, std::unique_ptr< int > && label )
+        {
+            this->weight = weight;
+            this->label = std::move( label );
+        }
+
+        float weight;
+        std::unique_ptr< int > label;
+    };
+
+    class BaseEdge {};
+
+    class BasePolygon
+    {
+        public:
+
+        BasePolygon( std::string && name, int & constructions )
+        {
+            this->name = std::move( name );
+            ++constructions;
+        }
+
+        std::string name;
+    };
+};
+
+typedef graph::PolygonGraph< EmplaceTraits > EmplaceGraph;
+
+// CHECK GRAPH ----------------------------------------------------------------
+
+// Checks the links, edge sets, edge index, isolated list and edge count
+// against each other by walking every ring and every edge set.
+
+template< class Graph >
+void checkGraph( Graph & graph )
+{
+    typedef typename Graph::VertexIterator VertexIterator;
+    typedef typename Graph::PolygonIterator PolygonIterator;
+    typedef typename Graph::Vertex::EdgeIterator EdgeIterator;
+    typedef typename Graph::Edge Edge;
+
+    std::size_t ringEdges = 0;
+    std::size_t setEdges = 0;
+    std::size_t isolated = 0;
+
+    for( PolygonIterator polygon = graph.beginPolygons();
+         polygon != graph.endPolygons(); ++polygon )
+    {
+        Edge * startEdge = polygon->getStartEdge();
+        Edge * edge = startEdge;
+
+        do
+        {
+            VertexIterator source =
+                edge->getPreviousEdge()->getTargetVertex();
+            VertexIterator target = edge->getTargetVertex();
+            std::pair< EdgeIterator, EdgeIterator > range =
+                source->findEdges( target );
+            bool inSet = false;
+
+            for( ; range.first != range.second; ++range.first )
+            {
+                inSet = inSet || &( *range.first ) == edge;
+            }
+
+            Edge * found = graph.findEdge( source, target );
+
+            PG_CHECK( edge->getPolygon() == polygon );
+            PG_CHECK( edge->getNextEdge()->getPreviousEdge() == edge );
+            PG_CHECK( inSet );
+            PG_CHECK( found != nullptr &&
+                      found->getTargetVertex() == target &&
+                      found->getPreviousEdge()->getTargetVertex() ==
+                          source );
+
+            ++ringEdges;
+            edge = edge->getNextEdge();
+        }
+        while( edge != startEdge );
+    }
+
+    for( VertexIterator vertex = graph.beginVertices();
+         vertex != graph.endVertices(); ++vertex )
+    {
+        for( EdgeIterator edge = vertex->beginEdges();
+             edge != vertex->endEdges(); ++edge )
+        {
+            PG_CHECK( edge->getPreviousEdge()->getTargetVertex() == vertex );
+            ++setEdges;
+        }
+
+        isolated += vertex->getEdgeCount() == 0 ? 1 : 0;
+    }
+
+    PG_CHECK( ringEdges == graph.getEdgeCount() );
+    PG_CHECK( setEdges == graph.getEdgeCount() );
+    PG_CHECK( isolated == graph.getIsolatedVertexCount() );
+}
+
+// GET ORDERED SHARE ----------------------------------------------------------
+
+// Share of consecutive addresses that increase.
+
+double const getOrderedShare( std::vector< void const * > const & addresses )
+{
+    std::size_t ordered = 0;
+
+    for( std::size_t a = 1; a < addresses.size(); ++a )
+    {
+        ordered += addresses[ a - 1 ] < addresses[ a ] ? 1 : 0;
+    }
+
+    return addresses.size() < 2 ?
+        1.0 : double( ordered ) / double( addresses.size() - 1 );
+}
+
+// CHECK LAYOUT ---------------------------------------------------------------
+
+// Checks that vertices, polygons and the half-edges of each ring in turn
+// are nearly all allocated at increasing addresses, as after compaction.
+
+void checkLayout( TestGraph & graph )
+{
+    std::vector< void const * > vertexAddresses;
+    std::vector< void const * > polygonAddresses;
+    std::vector< void const * > edgeAddresses;
+
+    for( VertexIterator vertex = graph.beginVertices();
+         vertex != graph.endVertices(); ++vertex )
+    {
+        vertexAddresses.push_back( &( *vertex ) );
+    }
+
+    for( PolygonIterator polygon = graph.beginPolygons();
+         polygon != graph.endPolygons(); ++polygon )
+    {
+        polygonAddresses.push_back( &( *polygon ) );
+
+        for( Edge & edge : polygon->getEdges() )
+        {
+            edgeAddresses.push_back( &edge );
+        }
+    }
+
+    PG_CHECK( getOrderedShare( vertexAddresses ) > 0.9 );
+    PG_CHECK( getOrderedShare( polygonAddresses ) > 0.9 );
+    PG_CHECK( getOrderedShare( edgeAddresses ) > 0.9 );
+}
+
+// GET RANDOM -----------------------------------------------------------------
+
+// Deterministic LCG, so failures reproduce.
+
+std::uint32_t const getRandom( std::uint32_t & state, std::uint32_t bound )
+{
+    state = state * 1664525u + 1013904223u;
+
+    return ( state >> 8 ) % bound;
+}
+
+// CHECK EDGE LOOKUP ----------------------------------------------------------
+
+// Checks findEdge, the batched findEdges and Vertex::findEdges for every
+// ordered pair of vertices against the half-edges found by walking rings.
+
+void checkEdgeLookup( TestGraph & graph )
+{
+    typedef std::pair< TestGraph::Vertex const *,
+                       TestGraph::Vertex const * > VertexPair;
+
+    std::map< VertexPair, std::set< Edge const * > > expected;
+
+    for( PolygonIterator polygon = graph.beginPolygons();
+         polygon != graph.endPolygons(); ++polygon )
+    {
+        for( Edge & edge : polygon->getEdges() )
+        {
+            expected[ VertexPair
+            (
+                &( *edge.getPreviousEdge()->getTargetVertex() ),
+                &( *edge.getTargetVertex() )
+            ) ].insert( &edge );
+        }
+    }
+
+    std::vector< VertexIterator > sources;
+    std::vector< VertexIterator > targets;
+
+    for( VertexIterator source = graph.beginVertices();
+         source != graph.endVertices(); ++source )
+    {
+        for( VertexIterator target = graph.beginVertices();
+             target != graph.endVertices(); ++target )
+        {
+            std::set< Edge const * > const & edges =
+                expected[ VertexPair( &( *source ), &( *target ) ) ];
+            std::set< Edge const * > found;
+            std::pair< TestGraph::Vertex::EdgeIterator,
+                       TestGraph::Vertex::EdgeIterator > range =
+                source->findEdges( target );
+
+            for( ; range.first != range.second; ++range.first )
+            {
+                found.insert( &( *range.first ) );
+            }
+
+            Edge * edge = graph.findEdge( source, target );
+
+            PG_CHECK( found == edges );
+            PG_CHECK( edges.empty() ? edge == nullptr :
+                                      edges.count( edge ) == 1 );
+
+            sources.push_back( source );
+            targets.push_back( target );
+        }
+    }
+
+    std::vector< Edge * > batch( sources.size() );
+
+    if( !sources.empty() )
+    {
+        graph.findEdges( &sources[ 0 ], &targets[ 0 ], sources.size(),
+                         &batch[ 0 ] );
+    }
+
+    for( std::size_t q = 0; q < sources.size(); ++q )
+    {
+        PG_CHECK( batch[ q ] == graph.findEdge( sources[ q ], targets[ q ] ) );
+    }
+}
+
+// CHECK ISOLATED -------------------------------------------------------------
+
+// Checks the graph, then that removeIsolatedVertices on a copy removes
+// exactly the vertices a scan finds without edges.
+
+void checkIsolated( TestGraph & graph )
+{
+    std::size_t isolated = 0;
+
+    for( VertexIterator vertex = graph.beginVertices();
+         vertex != graph.endVertices(); ++vertex )
+    {
+        isolated += vertex->getEdgeCount() == 0 ? 1 : 0;
+    }
+
+    checkGraph( graph );
+    PG_CHECK( graph.getIsolatedVertexCount() == isolated );
+
+    TestGraph copy( graph );
+
+    PG_CHECK( copy.removeIsolatedVertices() == isolated );
+    PG_CHECK( copy.getIsolatedVertexCount() == 0 );
+    PG_CHECK( copy.getVertexCount() == graph.getVertexCount() - isolated );
+    PG_CHECK( copy.removeIsolatedVertices() == 0 );
+
+    for( VertexIterator vertex = copy.beginVertices();
+         vertex != copy.endVertices(); ++vertex )
+    {
+        PG_CHECK( vertex->getEdgeCount() > 0 );
+    }
+
+    checkGraph( copy );
+}
+
+// MAKE STRIP -----------------------------------------------------------------
+
+// Adds a consistently oriented strip of count triangles.
+
+template< class Graph >
+void makeStrip( Graph & graph, std::size_t count )
+{
+    std::vector< typename Graph::VertexIterator > vertices;
+
+    for( std::size_t v = 0; v < count + 2; ++v )
+    {
+        vertices.push_back( graph.addVertex() );
+    }
+
+    for( std::size_t t = 0; t < count; ++t )
+    {
+        std::size_t a = t % 2 == 0 ? t : t + 1;
+        std::size_t b = t % 2 == 0 ? t + 1 : t;
+
+        graph.addTriangle( vertices[ a ], vertices[ b ], vertices[ t + 2 ] );
+    }
+}
+
+// GET RING -------------------------------------------------------------------
+
+// Source vertices of a polygon's half-edges from its start edge.
+
+std::vector< VertexIterator > const getRing( PolygonIterator polygon )
+{
+    std::vector< VertexIterator > ring;
+    Edge * edge = polygon->getStartEdge();
+
+    do
+    {
+        ring.push_back( edge->getPreviousEdge()->getTargetVertex() );
+        edge = edge->getNextEdge();
+    }
+    while( edge != polygon->getStartEdge() );
+
+    return ring;
+}
+
+// CHECK LIVE COUNTS ----------------------------------------------------------
+
+// Checks that exactly the graph's elements have live payloads.
+
+void checkLiveCounts( CountedGraph const & graph )
+{
+    PG_CHECK( CountedTraits::BaseVertex::getLiveCount() ==
+              long( graph.getVertexCount() ) );
+    PG_CHECK( CountedTraits::BaseEdge::getLiveCount() ==
+              long( graph.getEdgeCount() ) );
+    PG_CHECK( CountedTraits::BasePolygon::getLiveCount() ==
+              long( graph.getPolygonCount() ) );
+}
+
+// GET BLOCK SIZE -------------------------------------------------------------
+
+// Heap block for a request under the allocator getMemoryUsage documents:
+// an 8-byte header, rounded up to 16 bytes, at least 32 bytes.
+
+std::size_t const getBlockSize( std::size_t request )
+{
+    std::size_t block = ( request + 8 + 15 ) & ~std::size_t( 15 );
+
+    return block < 32 ? 32 : block;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// COMPACTION -----------------------------------------------------------------
+
+void testCompaction( void )
+{
+    std::size_t const size = 12;
+    std::size_t const spareCount = 40;
+
+    TestGraph graph;
+    graph.enableEdgeIndex( true );
+
+    graph::test::makeGrid( graph, size );
+
+    // Scatter the layout: re-adding every third triangle and a batch of
+    // isolated vertices reuses freed storage in reverse order
+
+    std::vector< VertexIterator > spare;
+
+    for( std::size_t s = 0; s < spareCount; ++s )
+    {
+        spare.push_back( graph.addVertex() );
+    }
+
+    for( std::size_t s = 0; s < spareCount; ++s )
+    {
+        graph.removeVertex( spare[ s ] );
+    }
+
+    for( std::size_t s = 0; s < spareCount; ++s )
+    {
+        graph.addVertex();
+    }
+
+    std::vector< std::vector< VertexIterator > > removed;
+    std::size_t p = 0;
+
+    for( PolygonIterator polygon = graph.beginPolygons();
+         polygon != graph.endPolygons(); ++p )
+    {
+        if( p % 3 != 0 )
+        {
+            ++polygon;
+            continue;
+        }
+
+        std::vector< VertexIterator > ring;
+
+        for( VertexIterator vertex : polygon->getVertices() )
+        {
+            ring.push_back( vertex );
+        }
+
+        removed.push_back( ring );
+        polygon = graph.removePolygon( polygon );
+    }
+
+    for( std::size_t r = removed.size(); r > 0; --r )
+    {
+        graph.addPolygon( removed[ r - 1 ].begin(), removed[ r - 1 ].end() );
+    }
+
+    checkGraph( graph );
+
+    std::size_t const vertexCount = graph.getVertexCount();
+    std::size_t const polygonCount = graph.getPolygonCount();
+
+    TestGraph::ChangeTracker tracker;
+    graph.attachChangeTracker( tracker );
+
+    // Remove the vertex under the cursor between slices, and finish the
+    // vertices exactly
+
+    PG_CHECK( !graph.compact( 7 ) );
+    checkGraph( graph );
+
+    VertexIterator cursor = graph.beginVertices();
+
+    for( std::size_t v = 0; v < 7; ++v )
+    {
+        ++cursor;
+    }
+
+    graph.removeVertex( cursor );
+    PG_CHECK( !graph.compact( graph.getVertexCount() - 7 ) );
+    checkGraph( graph );
+
+    // Then the polygon under the cursor, and add one that the pass will
+    // reach at the end of the list
+
+    PG_CHECK( !graph.compact( 3 ) );
+
+    PolygonIterator polygonCursor = graph.beginPolygons();
+
+    for( std::size_t q = 0; q < 3; ++q )
+    {
+        ++polygonCursor;
+    }
+
+    VertexIterator c = graph.endVertices();
+    --c;
+    VertexIterator b = c;
+    --b;
+    VertexIterator a = b;
+    --a;
+
+    graph.removePolygon( polygonCursor );
+    graph.addTriangle( a, b, c );
+    checkGraph( graph );
+
+    while( !graph.compact( 7 ) )
+    {
+    }
+
+    checkGraph( graph );
+
+    // Every original element was moved or removed, and every element left
+    // is a new one
+
+    PG_CHECK( tracker.getDestroyedVertices().size() == vertexCount );
+    PG_CHECK( tracker.getDestroyedPolygons().size() == polygonCount );
+    PG_CHECK( tracker.getCreatedVertices().size() ==
+              graph.getVertexCount() );
+    PG_CHECK( tracker.getCreatedPolygons().size() ==
+              graph.getPolygonCount() );
+
+    // Old storage outlives the pass, so even in slices the elements end up
+    // in traversal order
+
+    checkLayout( graph );
+
+    // A budget covering everything completes a pass in one call
+
+    tracker.clear();
+    PG_CHECK( graph.compact( graph.getVertexCount() +
+                             graph.getPolygonCount() ) );
+    checkGraph( graph );
+    PG_CHECK( tracker.getCreatedVertices().size() ==
+              graph.getVertexCount() );
+    PG_CHECK( tracker.getCreatedPolygons().size() ==
+              graph.getPolygonCount() );
+}
+
+// CONST RANGES ---------------------------------------------------------------
+
+// Circulator ranges on const vertices and polygons yield const elements,
+// the same ones hand-written loops reach.
+
+void testConstRanges( void )
+{
+    typedef TestGraph::ConstVertexIterator ConstVertexIterator;
+    typedef TestGraph::ConstPolygonIterator ConstPolygonIterator;
+
+    TestGraph graph;
+    graph::test::makeGrid( graph, 3, true );
+    graph::test::makeGrid( graph, 2 );
+
+    TestGraph const & view = graph;
+
+    static_assert( std::is_same< decltype( *view.cbeginPolygons()->
+                                           getEdges().begin() ),
+                                 Edge const & >::value,
+                   "const polygons yield const edges" );
+    static_assert( std::is_same< decltype( *view.cbeginPolygons()->
+                                           getVertices().begin() ),
+                                 ConstVertexIterator >::value,
+                   "const polygons yield const vertex handles" );
+    static_assert( std::is_same< decltype( *view.cbeginVertices()->
+                                           getPolygons().begin() ),
+                                 ConstPolygonIterator >::value,
+                   "const vertices yield const polygon handles" );
+
+    for( ConstPolygonIterator polygon = view.cbeginPolygons();
+         polygon != view.cendPolygons(); ++polygon )
+    {
+        std::vector< Edge const * > edges;
+        std::vector< ConstVertexIterator > vertices;
+        Edge const * edge = polygon->getStartEdge();
+
+        do
+        {
+            edges.push_back( edge );
+            vertices.push_back( edge->getPreviousEdge()->getTargetVertex() );
+            edge = edge->getNextEdge();
+        }
+        while( edge != polygon->getStartEdge() );
+
+        std::size_t e = 0;
+
+        for( Edge const & ringEdge : polygon->getEdges() )
+        {
+            PG_CHECK( e < edges.size() && &ringEdge == edges[ e ] );
+            ++e;
+        }
+
+        PG_CHECK( e == edges.size() );
+
+        std::size_t v = 0;
+
+        for( ConstVertexIterator vertex : polygon->getVertices() )
+        {
+            PG_CHECK( v < vertices.size() && vertex == vertices[ v ] );
+            ++v;
+        }
+
+        PG_CHECK( v == vertices.size() );
+    }
+
+    for( ConstVertexIterator vertex = view.cbeginVertices();
+         vertex != view.cendVertices(); ++vertex )
+    {
+        std::vector< Edge const * > outgoing;
+
+        for( TestGraph::ConstEdgeIterator edge = vertex->cbeginEdges();
+             edge != vertex->cendEdges(); ++edge )
+        {
+            outgoing.push_back( &( *edge ) );
+        }
+
+        std::size_t o = 0;
+
+        for( Edge const & edge : vertex->getOutgoingEdges() )
+        {
+            PG_CHECK( o < outgoing.size() && &edge == outgoing[ o ] );
+            ++o;
+        }
+
+        PG_CHECK( o == outgoing.size() );
+
+        std::size_t i = 0;
+
+        for( Edge const & edge : vertex->getIncomingEdges() )
+        {
+            PG_CHECK( i < outgoing.size() &&
+                      &edge == outgoing[ i ]->getPreviousEdge() );
+            PG_CHECK( edge.getTargetVertex() == vertex );
+            ++i;
+        }
+
+        PG_CHECK( i == outgoing.size() );
+
+        std::size_t p = 0;
+
+        for( ConstPolygonIterator polygon : vertex->getPolygons() )
+        {
+            PG_CHECK( p < outgoing.size() &&
+                      polygon == outgoing[ p ]->getPolygon() );
+            ++p;
+        }
+
+        PG_CHECK( p == outgoing.size() );
+    }
+
+    // The mutable ranges reach the same elements
+
+    PolygonIterator polygon = graph.beginPolygons();
+    std::size_t e = 0;
+    Edge const * edge = polygon->getStartEdge();
+
+    for( Edge & ringEdge : polygon->getEdges() )
+    {
+        PG_CHECK( &ringEdge == edge );
+        edge = edge->getNextEdge();
+        ++e;
+    }
+
+    PG_CHECK( e == polygon->getEdgeCount() );
+}
+
+// EDGE LOOKUP ----------------------------------------------------------------
+
+// Random adds and removes, including duplicated directed edges and
+// compaction, with and without the edge index.
+
+void testEdgeLookup( void )
+{
+    std::size_t const stepCount = 400;
+    std::size_t const poolSize = 24;
+
+    for( int indexed = 0; indexed < 2; ++indexed )
+    {
+        TestGraph graph;
+        std::uint32_t state = 7;
+
+        graph.enableEdgeIndex( indexed != 0 );
+
+        for( std::size_t v = 0; v < poolSize; ++v )
+        {
+            graph.addVertex();
+        }
+
+        for( std::size_t step = 0; step < stepCount; ++step )
+        {
+            std::vector< VertexIterator > vertices;
+            std::vector< PolygonIterator > polygons;
+
+            for( VertexIterator vertex = graph.beginVertices();
+                 vertex != graph.endVertices(); ++vertex )
+            {
+                vertices.push_back( vertex );
+            }
+
+            for( PolygonIterator polygon = graph.beginPolygons();
+                 polygon != graph.endPolygons(); ++polygon )
+            {
+                polygons.push_back( polygon );
+            }
+
+            std::uint32_t action = getRandom( state, 16 );
+
+            if( action < 8 && vertices.size() >= 4 )
+            {
+                // Triangle or quad on distinct vertices, often reusing a
+                // directed edge already present
+
+                std::vector< VertexIterator > ring;
+                std::size_t corners = action < 6 ? 3 : 4;
+
+                while( ring.size() < corners )
+                {
+                    VertexIterator vertex = vertices[ getRandom
+                    (
+                        state, std::uint32_t( vertices.size() )
+                    ) ];
+                    bool repeated = false;
+
+                    for( VertexIterator other : ring )
+                    {
+                        repeated = repeated || other == vertex;
+                    }
+
+                    if( !repeated )
+                    {
+                        ring.push_back( vertex );
+                    }
+                }
+
+                graph.addPolygon( ring.begin(), ring.end() );
+            }
+            else if( action < 12 && !polygons.empty() )
+            {
+                graph.removePolygon( polygons[ getRandom
+                (
+                    state, std::uint32_t( polygons.size() )
+                ) ] );
+            }
+            else if( action < 13 && !vertices.empty() )
+            {
+                graph.removeVertex( vertices[ getRandom
+                (
+                    state, std::uint32_t( vertices.size() )
+                ) ] );
+            }
+            else if( action < 14 )
+            {
+                graph.addVertex();
+            }
+            else if( action < 15 )
+            {
+                graph.compact( getRandom( state, 20 ) + 1 );
+            }
+            else if( indexed != 0 )
+            {
+                // Rebuilding indexes the existing edges afresh
+
+                graph.enableEdgeIndex( false );
+                graph.enableEdgeIndex( true );
+            }
+
+            PG_CHECK( graph.hasEdgeIndex() == ( indexed != 0 ) );
+
+            if( step % 10 == 0 )
+            {
+                checkEdgeLookup( graph );
+            }
+        }
+
+        while( !graph.compact( 50 ) )
+        {
+        }
+
+        checkEdgeLookup( graph );
+        checkGraph( graph );
+    }
+}
+
+// ISOLATED VERTICES ----------------------------------------------------------
+
+void testIsolatedVertices( void )
+{
+    std::size_t const size = 3;
+    std::size_t const row = size + 1;
+
+    TestGraph graph;
+    std::vector< VertexIterator > vertices =
+        graph::test::makeGrid( graph, size );
+
+    checkIsolated( graph );
+    PG_CHECK( graph.getIsolatedVertexCount() == 0 );
+
+    // New vertices start isolated
+
+    VertexIterator a = graph.addVertex();
+    VertexIterator b = graph.addVertex();
+    VertexIterator c = graph.addVertex();
+    graph.addVertex();
+
+    checkIsolated( graph );
+    PG_CHECK( graph.getIsolatedVertexCount() == 4 );
+
+    // A polygon takes vertices off the list, and removing it puts back
+    // those left without edges
+
+    PolygonIterator triangle = graph.addTriangle( a, b, c );
+    checkIsolated( graph );
+    PG_CHECK( graph.getIsolatedVertexCount() == 1 );
+
+    graph.addTriangle( vertices[ 0 ], b, a );
+    checkIsolated( graph );
+
+    graph.removePolygon( triangle );
+    checkIsolated( graph );
+    PG_CHECK( graph.getIsolatedVertexCount() == 2 );
+
+    // The corner that the diagonals skip is in one triangle only
+
+    VertexIterator corner = vertices[ row - 1 ];
+    graph.removePolygon( corner->beginEdges()->getPolygon() );
+    checkIsolated( graph );
+    PG_CHECK( corner->getEdgeCount() == 0 );
+
+    // Removing an isolated vertex, and a connected one whose polygons
+    // isolate nothing else
+
+    graph.removeVertex( corner );
+    checkIsolated( graph );
+
+    graph.removeVertex( vertices[ row + 1 ] );
+    checkIsolated( graph );
+
+    // Compaction moves isolated vertices along with the rest
+
+    graph.compact( 5 );
+    checkIsolated( graph );
+
+    while( !graph.compact( 5 ) )
+    {
+    }
+
+    checkIsolated( graph );
+
+    // Copies, moves and assignments carry the list over
+
+    TestGraph copy( graph );
+    checkIsolated( copy );
+    PG_CHECK( copy.getIsolatedVertexCount() ==
+              graph.getIsolatedVertexCount() );
+
+    TestGraph assigned;
+    assigned.addVertex();
+    assigned = graph;
+    checkIsolated( assigned );
+    PG_CHECK( assigned.getIsolatedVertexCount() ==
+              graph.getIsolatedVertexCount() );
+
+    std::size_t const isolated = graph.getIsolatedVertexCount();
+    TestGraph moved( std::move( copy ) );
+    checkIsolated( moved );
+    checkIsolated( copy );
+    PG_CHECK( moved.getIsolatedVertexCount() == isolated );
+    PG_CHECK( copy.getIsolatedVertexCount() == 0 );
+
+    TestGraph moveAssigned;
+    moveAssigned.addVertex();
+    moveAssigned = std::move( moved );
+    checkIsolated( moveAssigned );
+    checkIsolated( moved );
+    PG_CHECK( moveAssigned.getIsolatedVertexCount() == isolated );
+    PG_CHECK( moved.getIsolatedVertexCount() == 0 );
+
+    // The source of a move keeps working
+
+    moved.addVertex();
+    checkIsolated( moved );
+    PG_CHECK( moved.getIsolatedVertexCount() == 1 );
+
+    // Removal empties the list, and clearing empties the graph
+
+    PG_CHECK( graph.removeIsolatedVertices() == isolated );
+    checkIsolated( graph );
+
+    graph.addVertex();
+    graph.clear();
+    checkIsolated( graph );
+    PG_CHECK( graph.getIsolatedVertexCount() == 0 );
+}
+
+// MEMORY USAGE ---------------------------------------------------------------
+
+// The estimate grows by one block per documented node: a list node of two
+// links per vertex, polygon and isolated vertex entry, and per half-edge
+// the edge itself and a tree node of three links, a colour and the edge
+// pointer. The maintained half-edge count matches a recount throughout.
+
+void testMemoryUsage( void )
+{
+    typedef TestGraph::MemoryUsage MemoryUsage;
+
+    std::size_t const link = sizeof( void * );
+    std::size_t const vertexBlock =
+        getBlockSize( 2 * link + sizeof( TestGraph::Vertex ) );
+    std::size_t const isolatedBlock =
+        getBlockSize( 2 * link + sizeof( VertexIterator ) );
+    std::size_t const polygonBlock =
+        getBlockSize( 2 * link + sizeof( TestGraph::Polygon ) );
+    std::size_t const edgeBlock = getBlockSize( sizeof( Edge ) ) +
+                                  getBlockSize( 5 * link );
+
+    TestGraph graph;
+    MemoryUsage usage = graph.getMemoryUsage();
+
+    PG_CHECK( usage.getTotal() == 0 );
+
+    // Each vertex starts isolated
+
+    std::vector< VertexIterator > vertices;
+
+    for( std::size_t v = 0; v < 6; ++v )
+    {
+        std::size_t before = graph.getMemoryUsage().getTotal();
+        vertices.push_back( graph.addVertex() );
+
+        PG_CHECK( graph.getMemoryUsage().getTotal() - before ==
+                  vertexBlock + isolatedBlock );
+    }
+
+    usage = graph.getMemoryUsage();
+
+    PG_CHECK( usage.payloads == 6 * sizeof( TestGraph::BaseVertex ) );
+    PG_CHECK( usage.edges == 0 );
+    PG_CHECK( usage.polygons == 0 );
+
+    // A triangle on isolated vertices adds three half-edges and a polygon
+    // and drops three isolated entries
+
+    std::size_t before = usage.getTotal();
+    PolygonIterator first =
+        graph.addTriangle( vertices[ 0 ], vertices[ 1 ], vertices[ 2 ] );
+
+    PG_CHECK( graph.getMemoryUsage().getTotal() + 3 * isolatedBlock -
+              before == 3 * edgeBlock + polygonBlock );
+    PG_CHECK( graph.getEdgeCount() == 3 );
+    checkGraph( graph );
+
+    // A quad on vertices already in use adds four half-edges
+
+    usage = graph.getMemoryUsage();
+    graph.addQuad( vertices[ 0 ], vertices[ 2 ],
+                   vertices[ 3 ], vertices[ 4 ] );
+    MemoryUsage after = graph.getMemoryUsage();
+
+    PG_CHECK( after.getTotal() + 2 * isolatedBlock - usage.getTotal() ==
+              4 * edgeBlock + polygonBlock );
+    PG_CHECK( after.edges - usage.edges == 4 * sizeof( Edge ) );
+    PG_CHECK( after.adjacency - usage.adjacency == 4 * 5 * link );
+    PG_CHECK( graph.getEdgeCount() == 7 );
+    checkGraph( graph );
+
+    usage = graph.getMemoryUsage();
+
+    PG_CHECK( usage.getTotal() ==
+              6 * vertexBlock + 1 * isolatedBlock + 7 * edgeBlock +
+              2 * polygonBlock );
+    PG_CHECK( usage.edges == 7 * sizeof( Edge ) );
+
+    // Removing the triangle gives its half-edges and polygon back; its
+    // vertices other than those the quad uses become isolated again
+
+    before = usage.getTotal();
+    graph.removePolygon( first );
+
+    PG_CHECK( before + isolatedBlock - graph.getMemoryUsage().getTotal() ==
+              3 * edgeBlock + polygonBlock );
+    PG_CHECK( graph.getEdgeCount() == 4 );
+    checkGraph( graph );
+
+    // Removing a vertex removes its polygons too
+
+    before = graph.getMemoryUsage().getTotal();
+    graph.removeVertex( vertices[ 3 ] );
+
+    PG_CHECK( before + 3 * isolatedBlock -
+              graph.getMemoryUsage().getTotal() ==
+              vertexBlock + 4 * edgeBlock + polygonBlock );
+    PG_CHECK( graph.getEdgeCount() == 0 );
+    checkGraph( graph );
+
+    // The edge index is counted with the adjacency
+
+    makeStrip( graph, 9 );
+    graph.addQuad( vertices[ 0 ], vertices[ 1 ],
+                   vertices[ 2 ], vertices[ 4 ] );
+    checkGraph( graph );
+
+    PG_CHECK( graph.getEdgeCount() == 9 * 3 + 4 );
+
+    usage = graph.getMemoryUsage();
+    graph.enableEdgeIndex();
+
+    PG_CHECK( graph.getMemoryUsage().adjacency > usage.adjacency );
+    PG_CHECK( graph.getMemoryUsage().edges == usage.edges );
+
+    graph.enableEdgeIndex( false );
+
+    PG_CHECK( graph.getMemoryUsage().getTotal() == usage.getTotal() );
+
+    // Clearing leaves nothing
+
+    graph.clear();
+    usage = graph.getMemoryUsage();
+
+    PG_CHECK( graph.getEdgeCount() == 0 );
+    PG_CHECK( usage.getTotal() == 0 );
+    checkGraph( graph );
+
+    // and counting resumes from zero
+
+    makeStrip( graph, 4 );
+
+    PG_CHECK( graph.getEdgeCount() == 12 );
+    checkGraph( graph );
+}
+
+// ADD POLYGON ----------------------------------------------------------------
+
+// Every way of passing a face builds the same ring, starting from the
+// first vertex given.
+
+void testAddPolygon( void )
+{
+    TestGraph graph;
+    TestGraph::ChangeTracker tracker;
+    graph.attachChangeTracker( tracker );
+    graph.enableEdgeIndex( true );
+
+    std::vector< VertexIterator > table;
+
+    for( std::size_t v = 0; v < 12; ++v )
+    {
+        table.push_back( graph.addVertex() );
+    }
+
+    std::vector< VertexIterator > expected;
+    std::size_t edgeCount = 0;
+
+    // Triangle, quad and the initializer_list overload
+
+    PolygonIterator triangle =
+        graph.addTriangle( table[ 0 ], table[ 1 ], table[ 2 ] );
+    expected.assign( table.begin(), table.begin() + 3 );
+    PG_CHECK( getRing( triangle ) == expected );
+    edgeCount += 3;
+
+    PolygonIterator quad = graph.addQuad( table[ 0 ], table[ 2 ],
+                                          table[ 3 ], table[ 4 ] );
+    expected.assign( 1, table[ 0 ] );
+    expected.insert( expected.end(), table.begin() + 2, table.begin() + 5 );
+    PG_CHECK( getRing( quad ) == expected );
+    edgeCount += 4;
+
+    PolygonIterator pentagon = graph.addPolygon
+    (
+        { table[ 5 ], table[ 6 ], table[ 7 ], table[ 8 ], table[ 9 ] }
+    );
+    expected.assign( table.begin() + 5, table.begin() + 10 );
+    PG_CHECK( getRing( pentagon ) == expected );
+    edgeCount += 5;
+
+    // Pointer and count, and indices into a table
+
+    PolygonIterator counted = graph.addPolygon( &table[ 8 ], 4 );
+    expected.assign( table.begin() + 8, table.begin() + 12 );
+    PG_CHECK( getRing( counted ) == expected );
+    edgeCount += 4;
+
+    std::uint16_t const indices[ 4 ] = { 11, 10, 2, 1 };
+    PolygonIterator indexed = graph.addPolygon( &table[ 0 ], indices, 4 );
+    expected.clear();
+
+    for( std::uint16_t index : indices )
+    {
+        expected.push_back( table[ index ] );
+    }
+
+    PG_CHECK( getRing( indexed ) == expected );
+    edgeCount += 4;
+
+    // Fewer than three vertices adds nothing
+
+    PG_CHECK( graph.addPolygon( { table[ 0 ], table[ 1 ] } ) ==
+              graph.endPolygons() );
+    PG_CHECK( graph.addPolygon( &table[ 0 ], 2 ) == graph.endPolygons() );
+    PG_CHECK( graph.addPolygon( &table[ 0 ], indices, 0 ) ==
+              graph.endPolygons() );
+
+    PG_CHECK( graph.getPolygonCount() == 5 );
+    PG_CHECK( graph.getEdgeCount() == edgeCount );
+    PG_CHECK( tracker.getCreatedPolygons().size() == 5 );
+    PG_CHECK( tracker.getCreatedEdges().size() == edgeCount );
+    PG_CHECK( graph.getIsolatedVertexCount() == 0 );
+    checkGraph( graph );
+
+    // The direct paths unlink like any other polygon
+
+    graph.removePolygon( quad );
+    graph.removePolygon( triangle );
+    PG_CHECK( graph.getEdgeCount() == edgeCount - 7 );
+    PG_CHECK( table[ 0 ]->getEdgeCount() == 0 );
+    checkGraph( graph );
+}
+
+// CLEAR ----------------------------------------------------------------------
+
+// clear and clearAsync report each element destroyed once, and the graph
+// takes new contents straight away, which the background thread of
+// clearAsync leaves alone.
+
+void testClear( void )
+{
+    typedef CountedGraph::ChangeTracker Tracker;
+
+    for( int async = 0; async < 2; ++async )
+    {
+        CountedGraph graph;
+        Tracker tracker;
+        graph.attachChangeTracker( tracker );
+        graph.enableEdgeIndex( async != 0 );
+
+        makeStrip( graph, 40 );
+        graph.addVertex();
+        checkLiveCounts( graph );
+
+        Tracker::DestroyedVertexSet vertices;
+        Tracker::DestroyedEdgeSet edges;
+        Tracker::DestroyedPolygonSet polygons;
+
+        for( CountedGraph::VertexIterator vertex = graph.beginVertices();
+             vertex != graph.endVertices(); ++vertex )
+        {
+            vertices.insert( &( *vertex ) );
+        }
+
+        for( CountedGraph::PolygonIterator polygon = graph.beginPolygons();
+             polygon != graph.endPolygons(); ++polygon )
+        {
+            polygons.insert( &( *polygon ) );
+
+            for( CountedGraph::Edge & edge : polygon->getEdges() )
+            {
+                edges.insert( &edge );
+            }
+        }
+
+        tracker.clear();
+
+        std::future< void > done;
+
+        if( async != 0 )
+        {
+            done = graph.clearAsync();
+        }
+        else
+        {
+            graph.clear();
+            checkLiveCounts( graph );
+        }
+
+        PG_CHECK( graph.getVertexCount() == 0 );
+        PG_CHECK( graph.getEdgeCount() == 0 );
+        PG_CHECK( graph.getPolygonCount() == 0 );
+        PG_CHECK( graph.getIsolatedVertexCount() == 0 );
+        PG_CHECK( graph.beginVertices() == graph.endVertices() );
+        PG_CHECK( graph.beginPolygons() == graph.endPolygons() );
+        PG_CHECK( tracker.getDestroyedVertices() == vertices );
+        PG_CHECK( tracker.getDestroyedEdges() == edges );
+        PG_CHECK( tracker.getDestroyedPolygons() == polygons );
+        PG_CHECK( tracker.getCreatedVertices().empty() );
+
+        // New contents, possibly while the old ones are still being freed
+
+        makeStrip( graph, 5 );
+        checkGraph( graph );
+
+        PG_CHECK( tracker.getCreatedVertices().size() == 7 );
+        PG_CHECK( tracker.getCreatedPolygons().size() == 5 );
+
+        if( async != 0 )
+        {
+            done.wait();
+        }
+
+        checkGraph( graph );
+        checkLiveCounts( graph );
+        PG_CHECK( graph.getPolygonCount() == 5 );
+        PG_CHECK( tracker.getDestroyedVertices().size() == vertices.size() );
+        PG_CHECK( tracker.getDestroyedEdges().size() == edges.size() );
+        PG_CHECK( tracker.getCreatedVertices().size() == 7 );
+
+        graph.clear();
+        checkLiveCounts( graph );
+    }
+}
+
+// EMPLACE --------------------------------------------------------------------
+
+void testEmplace( void )
+{
+    EmplaceGraph graph;
+    std::vector< EmplaceGraph::VertexIterator > vertices;
+
+    for( int v = 0; v < 4; ++v )
+    {
+        vertices.push_back( graph.emplaceVertex
+        (
+            float( v ) * 0.5f, std::unique_ptr< int >( new int( v ) )
+        ) );
+    }
+
+    int constructions = 0;
+    std::string name = "quad";
+
+    EmplaceGraph::PolygonIterator quad = graph.emplacePolygon
+    (
+        vertices.begin(), vertices.end(), std::move( name ),
+        constructions
+    );
+
+    std::list< EmplaceGraph::VertexIterator > ring( vertices.begin(),
+                                                    vertices.begin() + 3 );
+    std::reverse( ring.begin(), ring.end() );
+
+    EmplaceGraph::PolygonIterator triangle =
+        graph.emplacePolygon( ring, std::string( "triangle" ),
+                              constructions );
+
+    // Too few vertices constructs nothing
+
+    EmplaceGraph::PolygonIterator none = graph.emplacePolygon
+    (
+        vertices.begin(), vertices.begin() + 2, std::string( "none" ),
+        constructions
+    );
+
+    PG_CHECK( none == graph.endPolygons() );
+    PG_CHECK( constructions == 2 );
+    PG_CHECK( quad->name == "quad" && triangle->name == "triangle" );
+    PG_CHECK( quad->getEdgeCount() == 4 && triangle->getEdgeCount() == 3 );
+    PG_CHECK( graph.getPolygonCount() == 2 );
+
+    for( int v = 0; v < 4; ++v )
+    {
+        PG_CHECK( vertices[ v ]->weight == float( v ) * 0.5f );
+        PG_CHECK( vertices[ v ]->label && *vertices[ v ]->label == v );
+    }
+
+    checkGraph( graph );
+}
+
+// MOVE -----------------------------------------------------------------------
+
+// Moves hand over the elements, so handles stay valid, along with the
+// change trackers.
+
+void testMove( void )
+{
+    TestGraph graph;
+    TestGraph::ChangeTracker tracker;
+    graph.attachChangeTracker( tracker );
+    graph.enableEdgeIndex( true );
+
+    std::vector< VertexIterator > vertices =
+        graph::test::makeGrid( graph, 3 );
+    VertexIterator isolated = graph.addVertex();
+    PolygonIterator polygon = graph.beginPolygons();
+    std::size_t const vertexCount = graph.getVertexCount();
+    std::size_t const polygonCount = graph.getPolygonCount();
+
+    // Move construction
+
+    TestGraph moved( std::move( graph ) );
+    tracker.clear();
+
+    PG_CHECK( moved.getVertexCount() == vertexCount );
+    PG_CHECK( moved.getPolygonCount() == polygonCount );
+    PG_CHECK( moved.hasEdgeIndex() && !graph.hasEdgeIndex() );
+    PG_CHECK( moved.beginVertices() == vertices[ 0 ] );
+    PG_CHECK( moved.beginPolygons() == polygon );
+    PG_CHECK( moved.findEdge( vertices[ 0 ], vertices[ 1 ] ) != nullptr );
+    checkGraph( moved );
+
+    // The moved-from graph is empty, usable, and no longer tracked
+
+    PG_CHECK( graph.getVertexCount() == 0 );
+    PG_CHECK( graph.getEdgeCount() == 0 );
+    PG_CHECK( graph.getIsolatedVertexCount() == 0 );
+
+    VertexIterator left = graph.addVertex();
+    checkGraph( graph );
+    PG_CHECK( tracker.getCreatedVertices().empty() );
+
+    moved.removeVertex( isolated );
+    moved.removePolygon( polygon );
+
+    PG_CHECK( tracker.getDestroyedVertices().size() == 1 );
+    PG_CHECK( tracker.getDestroyedPolygons().size() == 1 );
+
+    // Move assignment reports the old contents of the target to its own
+    // trackers, then detaches them and takes the source's
+
+    TestGraph assigned;
+    TestGraph::ChangeTracker assignedTracker;
+    assigned.attachChangeTracker( assignedTracker );
+    assigned.addVertex();
+    assignedTracker.clear();
+
+    assigned = std::move( moved );
+    tracker.clear();
+
+    PG_CHECK( assignedTracker.getDestroyedVertices().size() == 1 );
+    PG_CHECK( assigned.getVertexCount() == vertexCount - 1 );
+    PG_CHECK( assigned.getPolygonCount() == polygonCount - 1 );
+    PG_CHECK( assigned.hasEdgeIndex() );
+    PG_CHECK( assigned.beginVertices() == vertices[ 0 ] );
+    PG_CHECK( moved.getVertexCount() == 0 );
+    checkGraph( assigned );
+    checkGraph( moved );
+
+    assigned.removeVertex( vertices[ 5 ] );
+
+    PG_CHECK( tracker.getDestroyedVertices().size() == 1 );
+    PG_CHECK( assignedTracker.getDestroyedVertices().size() == 1 );
+
+    // Self-move-assignment leaves the graph and its trackers as they were
+
+    TestGraph & alias = assigned;
+    std::size_t const edgeCount = assigned.getEdgeCount();
+
+    tracker.clear();
+    assigned = std::move( alias );
+
+    PG_CHECK( assigned.getVertexCount() == vertexCount - 2 );
+    PG_CHECK( assigned.getEdgeCount() == edgeCount );
+    PG_CHECK( assigned.beginVertices() == vertices[ 0 ] );
+    PG_CHECK( !tracker.hasChanges() );
+    checkGraph( assigned );
+
+    assigned.removeVertex( vertices[ 0 ] );
+    PG_CHECK( tracker.getDestroyedVertices().size() == 1 );
+
+    graph.removeVertex( left );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testAddPolygon();
+    testClear();
+    testCompaction();
+    testConstRanges();
+    testEdgeLookup();
+    testEmplace();
+    testIsolatedVertices();
+    testMemoryUsage();
+    testMove();
+
+    return graph::test::finish();
+}
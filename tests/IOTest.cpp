@@ -0,0 +1,224 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "PolygonGraphIO.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+// WRITE FILE -----------------------------------------------------------------
+
+void writeFile( char const * path, std::string const & contents )
+{
+    std::FILE * file = std::fopen( path, "wb" );
+    std::fwrite( contents.data(), 1, contents.size(), file );
+    std::fclose( file );
+}
+
+// DESCRIBE -------------------------------------------------------------------
+
+// Lists each polygon as the positions of its corners in ring order, so two
+// graphs can be compared independently of their vertex handles.
+
+std::vector< std::vector< float > > const describe( TestGraph const & graph )
+{
+    std::vector< std::vector< float > > polygons;
+    TestGraph::ConstPolygonIterator polyIt = graph.cbeginPolygons();
+
+    while( polyIt != graph.cendPolygons() )
+    {
+        TestGraph::Edge const * start = polyIt->getStartEdge();
+        TestGraph::Edge const * edge = start;
+        std::vector< float > corners;
+
+        do
+        {
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                corners.push_back
+                (
+                    edge->getTargetVertex()->position[ axis ]
+                );
+            }
+
+            edge = edge->getNextEdge();
+        }
+        while( edge != start );
+
+        polygons.push_back( corners );
+        ++polyIt;
+    }
+
+    return polygons;
+}
+
+// MAKE MIXED MESH ------------------------------------------------------------
+
+// A triangulated grid with one extra pentagon, so the files carry faces of
+// several sizes.
+
+void makeMixedMesh( TestGraph & graph )
+{
+    graph::test::makeGrid( graph, 6 );
+
+    std::vector< TestGraph::VertexIterator > pentagon;
+
+    for( int i = 0; i < 5; ++i )
+    {
+        pentagon.push_back
+        (
+            graph.addVertex( graph::test::makeVertex( 10.0f + i * 0.5f,
+                                                      float( i % 2 ),
+                                                      0.25f ) )
+        );
+    }
+
+    graph.addPolygon( pentagon.begin(), pentagon.end() );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// ROUND TRIP -----------------------------------------------------------------
+
+void testRoundTrip( void )
+{
+    TestGraph original;
+    makeMixedMesh( original );
+
+    TestGraph fromObj;
+    TestGraph fromPly;
+
+    PG_CHECK( graph::writeObj( original, "IOTest.obj" ) );
+    PG_CHECK( graph::writePly( original, "IOTest.ply" ) );
+    PG_CHECK( graph::readObj( fromObj, "IOTest.obj" ) );
+    PG_CHECK( graph::readPly( fromPly, "IOTest.ply" ) );
+
+    PG_CHECK( fromObj.getVertexCount() == original.getVertexCount() );
+    PG_CHECK( fromPly.getVertexCount() == original.getVertexCount() );
+    PG_CHECK( describe( fromObj ) == describe( original ) );
+    PG_CHECK( describe( fromPly ) == describe( original ) );
+}
+
+// RELATIVE INDICES AND ASCII PLY ---------------------------------------------
+
+void testTextFormats( void )
+{
+    TestGraph obj;
+
+    writeFile( "IOTestRelative.obj",
+               "# comment\n"
+               "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+               "f -4/1 -3/2 -2/3 -1/4\n"
+               "f 1 2 3\n" );
+
+    PG_CHECK( graph::readObj( obj, "IOTestRelative.obj" ) );
+    PG_CHECK( obj.getVertexCount() == 4 );
+    PG_CHECK( obj.getPolygonCount() == 2 );
+
+    TestGraph ply;
+
+    writeFile( "IOTestAscii.ply",
+               "ply\nformat ascii 1.0\n"
+               "element vertex 3\n"
+               "property float x\nproperty float y\nproperty float z\n"
+               "element face 1\n"
+               "property list uchar int vertex_indices\n"
+               "end_header\n"
+               "0 0 0\n1 0 0\n0 1 0\n"
+               "3 0 1 2\n" );
+
+    PG_CHECK( graph::readPly( ply, "IOTestAscii.ply" ) );
+    PG_CHECK( ply.getVertexCount() == 3 );
+    PG_CHECK( ply.getPolygonCount() == 1 );
+}
+
+// MALFORMED INPUT ------------------------------------------------------------
+
+// Each file must be rejected, leaving the graph empty, rather than read
+// out of bounds.
+
+void testMalformedInput( void )
+{
+    std::string const vertexHeader =
+        "ply\nformat binary_little_endian 1.0\n"
+        "element vertex ";
+    std::string const vertexProperties =
+        "\nproperty float x\nproperty float y\nproperty float z\n"
+        "end_header\n";
+    std::string const record( 12, '\0' );
+
+    // Counts that wrap count * stride, or exceed the index range
+
+    char const * counts[] =
+    {
+        "1537228672809129302", // 2^64 / 12 + 1
+        "4294967296",
+        "4000000000",
+        "-1",
+        "12x"
+    };
+
+    for( std::size_t c = 0; c < sizeof( counts ) / sizeof( *counts ); ++c )
+    {
+        TestGraph graph;
+
+        writeFile( "IOTestMalformed.ply",
+                   vertexHeader + counts[ c ] + vertexProperties + record );
+
+        PG_CHECK( !graph::readPly( graph, "IOTestMalformed.ply" ) );
+        PG_CHECK( graph.getVertexCount() == 0 );
+    }
+
+    // Truncated data
+
+    TestGraph truncated;
+
+    writeFile( "IOTestMalformed.ply",
+               vertexHeader + "2" + vertexProperties + record );
+
+    PG_CHECK( !graph::readPly( truncated, "IOTestMalformed.ply" ) );
+
+    // Face indices beyond the vertices or the integer range
+
+    char const * faces[] =
+    {
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n",
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 99999999999999999999999\n",
+        "v 0 0 0\nf 0 1 1\n"
+    };
+
+    for( std::size_t f = 0; f < sizeof( faces ) / sizeof( *faces ); ++f )
+    {
+        TestGraph graph;
+
+        writeFile( "IOTestMalformed.obj", faces[ f ] );
+
+        PG_CHECK( !graph::readObj( graph, "IOTestMalformed.obj" ) );
+        PG_CHECK( graph.getVertexCount() == 0 );
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testRoundTrip();
+    testTextFormats();
+    testMalformedInput();
+
+    return graph::test::finish();
+}
@@ -0,0 +1,370 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "PolygonGraphPaged.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+typedef graph::PagedPolygonGraph< graph::test::TestTraits > PagedGraph;
+typedef PagedGraph::VertexId VertexId;
+typedef PagedGraph::ChunkPointer ChunkPointer;
+
+std::size_t const gridSize = 16;
+std::size_t const gridRow = gridSize + 1;
+
+// WRITE GRID -----------------------------------------------------------------
+
+// Writes a gridSize^2 grid of quads, row by row or shuffled, plus one
+// vertex no polygon uses. With spatial set the chunks are cut in Morton
+// order.
+
+bool const writeGrid
+(
+    char const * prefix,
+    std::size_t polygonsPerChunk,
+    bool shuffled,
+    bool spatial
+)
+{
+    PagedGraph paged;
+
+    bool created = spatial ?
+        paged.create( prefix, polygonsPerChunk, graph::MemberPosition() ) :
+        paged.create( prefix, polygonsPerChunk );
+
+    if( !created )
+    {
+        return false;
+    }
+
+    for( std::size_t v = 0; v < gridRow * gridRow; ++v )
+    {
+        paged.addVertex( graph::test::makeVertex( float( v % gridRow ),
+                                                  float( v / gridRow ),
+                                                  0.0f ) );
+    }
+
+    paged.addVertex( graph::test::makeVertex( -1.0f, -1.0f, 0.0f ) );
+
+    std::vector< std::size_t > order( gridSize * gridSize );
+
+    for( std::size_t q = 0; q < order.size(); ++q )
+    {
+        order[ q ] = q;
+    }
+
+    if( shuffled )
+    {
+        std::shuffle( order.begin(), order.end(), std::mt19937( 7 ) );
+    }
+
+    for( std::size_t q = 0; q < order.size(); ++q )
+    {
+        VertexId a = ( order[ q ] / gridSize ) * gridRow +
+                     order[ q ] % gridSize;
+        VertexId const ids[ 4 ] = { a, a + 1, a + gridRow + 1, a + gridRow };
+
+        if( !paged.addPolygon( ids, 4 ) )
+        {
+            return false;
+        }
+    }
+
+    return paged.finish();
+}
+
+// COUNT SHARED VERTICES ------------------------------------------------------
+
+std::size_t const countSharedVertices( PagedGraph const & paged )
+{
+    std::size_t shared = 0;
+
+    for( VertexId v = 0; v < paged.getVertexCount(); ++v )
+    {
+        shared += paged.getVertexChunks( v ).size() > 1;
+    }
+
+    return shared;
+}
+
+// GET X ----------------------------------------------------------------------
+
+float const getX( ChunkPointer const & chunk, VertexId id )
+{
+    return chunk->findVertex( id )->position[ 0 ];
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// SHARED VERTEX WRITE-BACK ---------------------------------------------------
+
+// Rows of quads go to separate chunks, so the vertices of row boundaries
+// are shared. An edit through one chunk must survive the other chunk
+// being written back, whichever is evicted first, and reach its copy.
+
+void testSharedWriteBack( void )
+{
+    // Vertex shared by the chunks of the first two rows
+
+    VertexId const shared = gridRow + 3;
+    VertexId const onlySecond = 2 * gridRow + 3;
+
+    for( int evictFirst = 0; evictFirst < 2; ++evictFirst )
+    {
+        PG_CHECK( writeGrid( "PagedTest", gridSize, false, false ) );
+
+        PagedGraph paged;
+        PG_CHECK( paged.open( "PagedTest" ) );
+        PG_CHECK( paged.getVertexChunks( shared ).size() == 2 );
+
+        ChunkPointer first = paged.getChunk( 0 );
+        ChunkPointer second = paged.getChunk( 1 );
+
+        first->findVertex( shared )->position[ 0 ] = 100.0f;
+        first->markDirty();
+        second->findVertex( onlySecond )->position[ 0 ] = 200.0f;
+        second->markDirty();
+
+        // Write the chunks back one at a time, in either order
+
+        if( evictFirst )
+        {
+            first.reset();
+            paged.setMemoryBudget( 0 );
+            PG_CHECK( getX( second, shared ) == 100.0f );
+            second.reset();
+            paged.setMemoryBudget( 0 );
+        }
+        else
+        {
+            second.reset();
+            paged.setMemoryBudget( 0 );
+            first.reset();
+            paged.setMemoryBudget( 0 );
+        }
+
+        PG_CHECK( paged.getResidentBytes() == 0 );
+
+        paged.close();
+        PG_CHECK( paged.open( "PagedTest" ) );
+
+        PG_CHECK( getX( paged.getChunk( 0 ), shared ) == 100.0f );
+        PG_CHECK( getX( paged.getChunk( 1 ), shared ) == 100.0f );
+        PG_CHECK( getX( paged.getChunk( 1 ), onlySecond ) == 200.0f );
+    }
+
+    // flush() reaches resident copies, and setVertex updates them at once
+
+    PG_CHECK( writeGrid( "PagedTest", gridSize, false, false ) );
+
+    PagedGraph paged;
+    PG_CHECK( paged.open( "PagedTest" ) );
+
+    ChunkPointer first = paged.getChunk( 0 );
+    ChunkPointer second = paged.getChunk( 1 );
+
+    first->findVertex( shared )->position[ 0 ] = 300.0f;
+    first->markDirty();
+    second->markDirty();
+
+    PG_CHECK( paged.flush() );
+    PG_CHECK( getX( second, shared ) == 300.0f );
+
+    PG_CHECK( paged.setVertex( shared,
+                               graph::test::makeVertex( 400.0f, 0.0f,
+                                                        0.0f ) ) );
+    PG_CHECK( getX( first, shared ) == 400.0f );
+    PG_CHECK( getX( second, shared ) == 400.0f );
+
+    first.reset();
+    second.reset();
+    paged.close();
+    PG_CHECK( paged.open( "PagedTest" ) );
+    PG_CHECK( getX( paged.getChunk( 1 ), shared ) == 400.0f );
+}
+
+// MISSING VERTICES -----------------------------------------------------------
+
+void testMissingVertices( void )
+{
+    PG_CHECK( writeGrid( "PagedTest", gridSize, false, false ) );
+
+    PagedGraph paged;
+    PG_CHECK( paged.open( "PagedTest" ) );
+
+    std::size_t calls = 0;
+
+    auto count = [ & ]( PagedGraph::Chunk &, PagedGraph::Edge & )
+    {
+        ++calls;
+    };
+
+    // The unused vertex and ids past the end have no edges
+
+    paged.forEachOutgoingEdge( gridRow * gridRow, count );
+    paged.forEachOutgoingEdge( gridRow * gridRow + 10, count );
+    PG_CHECK( calls == 0 );
+
+    paged.forEachOutgoingEdge( gridRow + 1, count );
+    PG_CHECK( calls == 4 );
+
+    // A vertex of another graph has no id here
+
+    graph::test::TestGraph other;
+    ChunkPointer chunk = paged.getChunk( 0 );
+
+    PG_CHECK( chunk->getVertexId( other.addVertex() ) ==
+              PagedGraph::noVertex );
+    PG_CHECK( chunk->getVertexId( chunk->findVertex( 1 ) ) == 1 );
+}
+
+// SPATIAL ORDER --------------------------------------------------------------
+
+// Shuffled input cut in insertion order shares most vertices between
+// chunks; Morton order restores compact chunks with the same topology.
+
+void testSpatialOrder( void )
+{
+    std::size_t const polygonsPerChunk = 16;
+
+    PagedGraph unordered;
+    PG_CHECK( writeGrid( "PagedTestUnordered", polygonsPerChunk, true,
+                         false ) );
+    PG_CHECK( unordered.open( "PagedTestUnordered" ) );
+
+    PagedGraph spatial;
+    PG_CHECK( writeGrid( "PagedTestSpatial", polygonsPerChunk, true,
+                         true ) );
+    PG_CHECK( spatial.open( "PagedTestSpatial" ) );
+
+    PG_CHECK( spatial.getChunkCount() == unordered.getChunkCount() );
+    PG_CHECK( countSharedVertices( spatial ) * 3 <
+              countSharedVertices( unordered ) );
+
+    for( VertexId v = 0; v < spatial.getVertexCount(); ++v )
+    {
+        std::size_t spatialDegree = 0;
+        std::size_t unorderedDegree = 0;
+
+        spatial.forEachOutgoingEdge
+        (
+            v, [ & ]( PagedGraph::Chunk &, PagedGraph::Edge & )
+            {
+                ++spatialDegree;
+            }
+        );
+        unordered.forEachOutgoingEdge
+        (
+            v, [ & ]( PagedGraph::Chunk &, PagedGraph::Edge & )
+            {
+                ++unorderedDegree;
+            }
+        );
+
+        PG_CHECK( spatialDegree == unorderedDegree );
+    }
+}
+
+// BORDER ONE-RING ------------------------------------------------------------
+
+// A chunk's graph holds only part of the one-ring of a vertex on a chunk
+// border, which isShared reports; forEachOutgoingEdge walks all of it, as
+// the in-memory graph does.
+
+void testBorderOneRing( void )
+{
+    graph::test::TestGraph whole;
+    std::vector< graph::test::TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( whole, gridSize, true );
+    std::map< graph::test::TestGraph::Vertex const *, VertexId > ids;
+
+    for( VertexId v = 0; v < vertices.size(); ++v )
+    {
+        ids[ &( *vertices[ v ] ) ] = v;
+    }
+
+    for( int spatial = 0; spatial < 2; ++spatial )
+    {
+        PG_CHECK( writeGrid( "PagedTest", gridSize, spatial != 0,
+                             spatial != 0 ) );
+
+        PagedGraph paged;
+        PG_CHECK( paged.open( "PagedTest" ) );
+
+        std::size_t borderCount = 0;
+
+        for( VertexId v = 0; v < vertices.size(); ++v )
+        {
+            std::vector< VertexId > expected;
+            std::vector< VertexId > walked;
+
+            for( auto edge = vertices[ v ]->beginEdges();
+                 edge != vertices[ v ]->endEdges(); ++edge )
+            {
+                expected.push_back( ids[ &( *edge->getTargetVertex() ) ] );
+            }
+
+            paged.forEachOutgoingEdge
+            (
+                v, [ & ]( PagedGraph::Chunk & chunk, PagedGraph::Edge & edge )
+                {
+                    walked.push_back
+                    (
+                        chunk.getVertexId( edge.getTargetVertex() )
+                    );
+                }
+            );
+
+            std::sort( expected.begin(), expected.end() );
+            std::sort( walked.begin(), walked.end() );
+
+            PG_CHECK( walked == expected );
+
+            // Each chunk holds part of a border vertex's edges
+
+            std::vector< std::size_t > chunks = paged.getVertexChunks( v );
+            bool border = chunks.size() > 1;
+
+            borderCount += border ? 1 : 0;
+
+            for( std::size_t c = 0; c < chunks.size(); ++c )
+            {
+                ChunkPointer chunk = paged.getChunk( chunks[ c ] );
+                PagedGraph::VertexIterator local = chunk->findVertex( v );
+
+                PG_CHECK( chunk->isShared( local ) == border );
+                PG_CHECK( border ?
+                          local->getEdgeCount() < expected.size() :
+                          local->getEdgeCount() == expected.size() );
+            }
+        }
+
+        PG_CHECK( borderCount > 0 );
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testSharedWriteBack();
+    testMissingVertices();
+    testSpatialOrder();
+    testBorderOneRing();
+
+    return graph::test::finish();
+}
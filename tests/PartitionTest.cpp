@@ -0,0 +1,302 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/wait.h>
+#include <unistd.h>
+#define PARTITION_TEST_FORK
+#endif
+
+#include "PolygonGraphPartition.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+typedef graph::GraphPartitioner< graph::test::TestTraits > Partitioner;
+typedef Partitioner::Part Part;
+
+std::size_t const partCount = 4;
+
+// FILE HELPERS ---------------------------------------------------------------
+
+bool const writeBytes( char const * path, std::vector< char > const & bytes )
+{
+    std::FILE * file = std::fopen( path, "wb" );
+
+    if( file == nullptr )
+    {
+        return false;
+    }
+
+    bool written = bytes.empty() ||
+        std::fwrite( &( bytes[ 0 ] ), 1, bytes.size(), file ) ==
+            bytes.size();
+
+    return std::fclose( file ) == 0 && written;
+}
+
+bool const readBytes( char const * path, std::vector< char > & bytes )
+{
+    std::FILE * file = std::fopen( path, "rb" );
+
+    if( file == nullptr )
+    {
+        return false;
+    }
+
+    char buffer[ 4096 ];
+    std::size_t count = 0;
+    bytes.clear();
+
+    while( ( count = std::fread( buffer, 1, sizeof( buffer ), file ) ) != 0 )
+    {
+        bytes.insert( bytes.end(), buffer, buffer + count );
+    }
+
+    std::fclose( file );
+
+    return true;
+}
+
+// PROCESS PART ---------------------------------------------------------------
+
+// The worker's job: stamp every vertex and move it up by its part number.
+
+void processPart( Part & part, std::size_t index )
+{
+    TestGraph::VertexIterator vertexIt = part.getGraph().beginVertices();
+
+    while( vertexIt != part.getGraph().endVertices() )
+    {
+        vertexIt->position[ 2 ] = float( index + 1 );
+        ++vertexIt;
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// PARTITION ------------------------------------------------------------------
+
+void testPartition( void )
+{
+    TestGraph source;
+    graph::test::makeGrid( source, 24 );
+
+    Partitioner partitioner;
+    partitioner.partition( source, partCount );
+
+    PG_CHECK( partitioner.getPartCount() == partCount );
+
+    std::size_t owned = 0;
+
+    for( std::size_t p = 0; p < partCount; ++p )
+    {
+        Part & part = partitioner.getPart( p );
+        owned += part.getOwnedPolygonCount();
+
+        // Within 3% imbalance, plus rounding
+
+        PG_CHECK( part.getOwnedPolygonCount() * partCount <=
+                  source.getPolygonCount() * 103 / 100 + partCount );
+
+        // Every owned polygon maps back to the source; halo polygons are
+        // the ones listed after them
+
+        TestGraph::PolygonIterator polyIt = part.getGraph().beginPolygons();
+        std::size_t halo = 0;
+
+        while( polyIt != part.getGraph().endPolygons() )
+        {
+            PG_CHECK( part.getGlobalPolygon( polyIt ) !=
+                      source.endPolygons() );
+            halo += part.isHalo( polyIt );
+            ++polyIt;
+        }
+
+        PG_CHECK( halo + part.getOwnedPolygonCount() ==
+                  part.getGraph().getPolygonCount() );
+    }
+
+    PG_CHECK( owned == source.getPolygonCount() );
+
+    // Elements of another graph are not in any part
+
+    TestGraph other;
+    TestGraph::VertexIterator a = other.addVertex();
+    TestGraph::VertexIterator b = other.addVertex();
+    TestGraph::VertexIterator c = other.addVertex();
+    TestGraph::PolygonIterator foreign = other.addTriangle( a, b, c );
+    Part & part = partitioner.getPart( 0 );
+
+    PG_CHECK( !part.isHalo( foreign ) );
+    PG_CHECK( !part.isOwned( a ) );
+    PG_CHECK( part.getGlobalVertex( a ) == source.endVertices() );
+    PG_CHECK( part.getGlobalPolygon( foreign ) == source.endPolygons() );
+}
+
+// SERIALIZATION --------------------------------------------------------------
+
+void testSerialization( void )
+{
+    TestGraph source;
+    graph::test::makeGrid( source, 8, true );
+
+    Partitioner partitioner;
+    partitioner.partition( source, 2 );
+
+    Part & original = partitioner.getPart( 1 );
+    std::vector< char > bytes;
+    original.serialize( bytes );
+
+    // Rebuilt part has the same shape and ownership
+
+    Part copy;
+    PG_CHECK( copy.deserialize( &( bytes[ 0 ] ), bytes.size() ) );
+    PG_CHECK( copy.getGraph().getVertexCount() ==
+              original.getGraph().getVertexCount() );
+    PG_CHECK( copy.getGraph().getPolygonCount() ==
+              original.getGraph().getPolygonCount() );
+    PG_CHECK( copy.getOwnedPolygonCount() ==
+              original.getOwnedPolygonCount() );
+    PG_CHECK( copy.getGlobalVertex( copy.getGraph().beginVertices() ) ==
+              copy.getGraph().endVertices() );
+
+    std::vector< char > again;
+    copy.serialize( again );
+    PG_CHECK( again == bytes );
+
+    // Truncated or corrupted buffers and mismatched parts are rejected
+
+    Partitioner other;
+    other.partition( source, 3 );
+
+    PG_CHECK( !copy.deserialize( &( bytes[ 0 ] ), bytes.size() - 1 ) );
+    PG_CHECK( !other.getPart( 0 ).deserialize( &( bytes[ 0 ] ),
+                                               bytes.size() ) );
+
+    std::vector< char > corrupt( bytes );
+    corrupt[ 8 ] = 0x7f; // vertex count
+    PG_CHECK( !copy.deserialize( &( corrupt[ 0 ] ), corrupt.size() ) );
+}
+
+// WORKER PROCESSES -----------------------------------------------------------
+
+// Each part is serialised to a file, processed by a forked worker that
+// only sees the file, and read back before merging.
+
+void testWorkerProcesses( void )
+{
+#if defined( PARTITION_TEST_FORK )
+    TestGraph source;
+    graph::test::makeGrid( source, 24 );
+
+    Partitioner partitioner;
+    partitioner.partition( source, partCount );
+
+    std::vector< pid_t > workers;
+
+    for( std::size_t p = 0; p < partCount; ++p )
+    {
+        char input[ 64 ];
+        std::snprintf( input, sizeof( input ), "PartitionTest%zu.in", p );
+
+        std::vector< char > bytes;
+        partitioner.getPart( p ).serialize( bytes );
+        PG_CHECK( writeBytes( input, bytes ) );
+
+        pid_t worker = fork();
+
+        if( worker == 0 )
+        {
+            char output[ 64 ];
+            std::snprintf( output, sizeof( output ), "PartitionTest%zu.out",
+                           p );
+
+            Part part;
+            bool processed = readBytes( input, bytes ) &&
+                part.deserialize( bytes.data(), bytes.size() );
+
+            if( processed )
+            {
+                processPart( part, p );
+                bytes.clear();
+                part.serialize( bytes );
+                processed = writeBytes( output, bytes );
+            }
+
+            _exit( processed ? 0 : 1 );
+        }
+
+        PG_CHECK( worker > 0 );
+        workers.push_back( worker );
+    }
+
+    for( std::size_t p = 0; p < workers.size(); ++p )
+    {
+        int status = 0;
+        PG_CHECK( waitpid( workers[ p ], &status, 0 ) == workers[ p ] );
+        PG_CHECK( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+
+        char output[ 64 ];
+        std::snprintf( output, sizeof( output ), "PartitionTest%zu.out", p );
+
+        std::vector< char > bytes;
+        PG_CHECK( readBytes( output, bytes ) );
+        PG_CHECK( partitioner.getPart( p ).deserialize( bytes.data(),
+                                                        bytes.size() ) );
+    }
+
+    partitioner.merge();
+
+    // Each source vertex carries the stamp of the part owning it
+
+    for( std::size_t p = 0; p < partCount; ++p )
+    {
+        Part & part = partitioner.getPart( p );
+        TestGraph::VertexIterator vertexIt = part.getGraph().beginVertices();
+
+        while( vertexIt != part.getGraph().endVertices() )
+        {
+            if( part.isOwned( vertexIt ) )
+            {
+                PG_CHECK( part.getGlobalVertex( vertexIt )->position[ 2 ] ==
+                          float( p + 1 ) );
+            }
+
+            ++vertexIt;
+        }
+    }
+
+    TestGraph::VertexIterator vertexIt = source.beginVertices();
+
+    while( vertexIt != source.endVertices() )
+    {
+        PG_CHECK( vertexIt->position[ 2 ] >= 1.0f );
+        ++vertexIt;
+    }
+#endif
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testPartition();
+    testSerialization();
+    testWorkerProcesses();
+
+    return graph::test::finish();
+}
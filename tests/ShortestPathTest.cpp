@@ -0,0 +1,200 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "PolygonGraphShortestPath.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+using graph::test::getSource;
+using graph::test::isNear;
+
+typedef graph::VertexAdjacency< graph::test::TestTraits > Adjacency;
+typedef graph::ShortestPaths< graph::test::TestTraits > Paths;
+
+std::size_t const gridSize = 8;
+std::size_t const row = gridSize + 1;
+double const tolerance = 1e-6;
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// VERTEX ADJACENCY -----------------------------------------------------------
+
+void testVertexAdjacency( void )
+{
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, gridSize );
+
+    Adjacency adjacency;
+    graph::buildVertexAdjacency( graph, adjacency, 3 );
+
+    PG_CHECK( adjacency.getVertexCount() == row * row );
+
+    // Triangles split each cell along the rising diagonal, so interior
+    // vertices have six neighbours and the two corners it skips have two
+
+    for( std::uint32_t v = 0; v < row * row; ++v )
+    {
+        std::size_t x = v % row;
+        std::size_t y = v / row;
+        bool interior = x > 0 && x + 1 < row && y > 0 && y + 1 < row;
+
+        PG_CHECK( adjacency.getIndex( vertices[ v ] ) == v );
+        PG_CHECK( !interior || adjacency.getDegree( v ) == 6 );
+
+        for( std::uint32_t n = adjacency.offsets[ v ];
+             n < adjacency.offsets[ v + 1 ]; ++n )
+        {
+            std::uint32_t other = adjacency.neighbours[ n ];
+            TestGraph::Edge const * edge = adjacency.edges[ n ];
+            TestGraph::Vertex const * a = &( *vertices[ v ] );
+            TestGraph::Vertex const * b = &( *vertices[ other ] );
+            TestGraph::Vertex const * target = &( *edge->getTargetVertex() );
+
+            // Rows are sorted with no repeats, and each edge joins the
+            // pair, leaving v when such an edge exists
+
+            PG_CHECK( n == adjacency.offsets[ v ] ||
+                      adjacency.neighbours[ n - 1 ] < other );
+            PG_CHECK( ( getSource( edge ) == a && target == b ) ||
+                      ( getSource( edge ) == b && target == a &&
+                        graph.findEdge( vertices[ v ], vertices[ other ] ) ==
+                            nullptr ) );
+        }
+    }
+
+    PG_CHECK( adjacency.getDegree( row - 1 ) == 2 );
+    PG_CHECK( adjacency.getDegree( row * ( row - 1 ) ) == 2 );
+
+    // Vertices of another graph have no index
+
+    TestGraph other;
+    PG_CHECK( adjacency.getIndex( other.addVertex() ) ==
+              Adjacency::noVertex );
+}
+
+// SHORTEST PATHS -------------------------------------------------------------
+
+void testShortestPaths( void )
+{
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, gridSize );
+
+    Adjacency adjacency;
+    graph::buildVertexAdjacency( graph, adjacency );
+
+    Paths paths( adjacency );
+    Paths::Result result;
+    std::vector< TestGraph::VertexIterator > sources( 1, vertices[ 0 ] );
+
+    // Counting edges, the diagonals make ( x, y ) max( x, y ) steps from
+    // the origin
+
+    paths.findPaths( sources, result );
+
+    for( std::size_t v = 0; v < row * row; ++v )
+    {
+        std::size_t x = v % row;
+        std::size_t y = v / row;
+
+        PG_CHECK( paths.getDistance( result, vertices[ v ] ) ==
+                  double( std::max( x, y ) ) );
+    }
+
+    // By length, the path runs up the diagonal and then along the side
+
+    paths.setEdgeLengths();
+    paths.findPaths( sources, result );
+
+    std::vector< TestGraph::VertexIterator > path;
+    TestGraph::VertexIterator corner = vertices[ 3 * row + 7 ];
+
+    PG_CHECK( isNear( paths.getDistance( result, corner ),
+                      3.0 * std::sqrt( 2.0 ) + 4.0, tolerance ) );
+    PG_CHECK( paths.getPath( result, corner, path ) );
+    PG_CHECK( path.size() == 8 );
+    PG_CHECK( path.front() == vertices[ 0 ] && path.back() == corner );
+
+    for( std::size_t p = 1; p < path.size(); ++p )
+    {
+        PG_CHECK( graph.findEdge( path[ p - 1 ], path[ p ] ) != nullptr ||
+                  graph.findEdge( path[ p ], path[ p - 1 ] ) != nullptr );
+    }
+
+    // maxDistance and targets cut the search short
+
+    paths.clearWeights();
+    paths.findPaths( sources, result, 2.0 );
+
+    PG_CHECK( paths.getDistance( result, vertices[ 2 * row + 2 ] ) == 2.0 );
+    PG_CHECK( paths.getDistance( result, vertices[ 3 ] ) ==
+              std::numeric_limits< double >::infinity() );
+    PG_CHECK( !paths.getPath( result, vertices[ 3 ], path ) );
+    PG_CHECK( path.empty() );
+
+    std::vector< TestGraph::VertexIterator > targets( 1, vertices[ 1 ] );
+    paths.findPaths( sources, targets, result );
+
+    PG_CHECK( paths.getDistance( result, vertices[ 1 ] ) == 1.0 );
+    PG_CHECK( paths.getDistance( result, vertices[ row - 1 ] ) ==
+              std::numeric_limits< double >::infinity() );
+
+    // A batch matches single searches
+
+    std::vector< Paths::Result > results;
+    sources.push_back( vertices[ row * row - 1 ] );
+    paths.findPathsBatch( sources, results, 100.0, 2 );
+
+    PG_CHECK( results.size() == 2 );
+    PG_CHECK( paths.getDistance( results[ 0 ], vertices[ 4 ] ) == 4.0 );
+    PG_CHECK( paths.getDistance( results[ 1 ], vertices[ 0 ] ) ==
+              double( gridSize ) );
+
+    // Vertices of another graph are ignored as sources and targets and
+    // have no distance or path
+
+    TestGraph other;
+    TestGraph::VertexIterator foreign = other.addVertex();
+
+    sources.assign( 1, foreign );
+    targets.assign( 1, foreign );
+    paths.findPaths( sources, targets, result );
+
+    PG_CHECK( paths.getDistance( result, vertices[ 0 ] ) ==
+              std::numeric_limits< double >::infinity() );
+    PG_CHECK( paths.getDistance( result, foreign ) ==
+              std::numeric_limits< double >::infinity() );
+    PG_CHECK( !paths.getPath( result, foreign, path ) );
+
+    paths.findPathsBatch( sources, results );
+    PG_CHECK( results.size() == 1 );
+    PG_CHECK( paths.getDistance( results[ 0 ], vertices[ 0 ] ) ==
+              std::numeric_limits< double >::infinity() );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testVertexAdjacency();
+    testShortestPaths();
+
+    return graph::test::finish();
+}
@@ -0,0 +1,431 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PolygonGraphSmoothing.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+using graph::test::isNear;
+
+typedef graph::VertexAdjacency< graph::test::TestTraits > Adjacency;
+typedef graph::LaplacianSmoother< graph::test::TestTraits > Smoother;
+
+std::size_t const gridSize = 6;
+double const tolerance = 1e-5;
+
+// GET DISTANCE ---------------------------------------------------------------
+
+double const getDistance( float const * a, float const * b )
+{
+    double dx = double( a[ 0 ] ) - b[ 0 ];
+    double dy = double( a[ 1 ] ) - b[ 1 ];
+    double dz = double( a[ 2 ] ) - b[ 2 ];
+
+    return std::sqrt( dx * dx + dy * dy + dz * dz );
+}
+
+// MAKE SPHERE ----------------------------------------------------------------
+
+// Adds a closed unit sphere of triangles with ringCount bands of latitude
+// and twice as many of longitude. Radii vary by up to noise either way,
+// from a fixed seed.
+
+void makeSphere( TestGraph & graph, std::size_t ringCount, float noise )
+{
+    double const pi = 3.14159265358979323846;
+    std::size_t segmentCount = 2 * ringCount;
+    unsigned seed = 1;
+
+    auto addPoint = [ & ]( double theta, double phi )
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double radius = 1.0 + noise * ( ( seed >> 8 ) / 8388608.0 - 1.0 );
+
+        return graph.addVertex( graph::test::makeVertex
+        (
+            float( radius * std::sin( theta ) * std::cos( phi ) ),
+            float( radius * std::sin( theta ) * std::sin( phi ) ),
+            float( radius * std::cos( theta ) )
+        ) );
+    };
+
+    TestGraph::VertexIterator top = addPoint( 0.0, 0.0 );
+    TestGraph::VertexIterator bottom = addPoint( pi, 0.0 );
+    std::vector< TestGraph::VertexIterator > rings;
+
+    for( std::size_t r = 1; r < ringCount; ++r )
+    {
+        for( std::size_t s = 0; s < segmentCount; ++s )
+        {
+            rings.push_back( addPoint( pi * r / ringCount,
+                                       2.0 * pi * s / segmentCount ) );
+        }
+    }
+
+    auto at = [ & ]( std::size_t ring, std::size_t segment )
+    {
+        return rings[ ( ring - 1 ) * segmentCount +
+                      segment % segmentCount ];
+    };
+
+    for( std::size_t s = 0; s < segmentCount; ++s )
+    {
+        graph.addTriangle( top, at( 1, s ), at( 1, s + 1 ) );
+        graph.addTriangle( at( ringCount - 1, s ), bottom,
+                           at( ringCount - 1, s + 1 ) );
+
+        for( std::size_t r = 1; r + 1 < ringCount; ++r )
+        {
+            graph.addTriangle( at( r, s ), at( r + 1, s ),
+                               at( r + 1, s + 1 ) );
+            graph.addTriangle( at( r, s ), at( r + 1, s + 1 ),
+                               at( r, s + 1 ) );
+        }
+    }
+}
+
+// GET MEAN RADIUS ------------------------------------------------------------
+
+double const getMeanRadius( TestGraph & graph )
+{
+    float const origin[ 3 ] = { 0.0f, 0.0f, 0.0f };
+    double sum = 0.0;
+
+    for( TestGraph::VertexIterator vertex = graph.beginVertices();
+         vertex != graph.endVertices(); ++vertex )
+    {
+        sum += getDistance( vertex->position, origin );
+    }
+
+    return sum / double( graph.getVertexCount() );
+}
+
+// GET RADIUS SPREAD ----------------------------------------------------------
+
+// Root mean square deviation of the radii from their mean.
+
+double const getRadiusSpread( TestGraph & graph )
+{
+    float const origin[ 3 ] = { 0.0f, 0.0f, 0.0f };
+    double mean = getMeanRadius( graph );
+    double sum = 0.0;
+
+    for( TestGraph::VertexIterator vertex = graph.beginVertices();
+         vertex != graph.endVertices(); ++vertex )
+    {
+        double deviation = getDistance( vertex->position, origin ) - mean;
+        sum += deviation * deviation;
+    }
+
+    return std::sqrt( sum / double( graph.getVertexCount() ) );
+}
+
+// IS GRID BORDER -------------------------------------------------------------
+
+bool const isGridBorder( std::size_t index )
+{
+    std::size_t row = gridSize + 1;
+    std::size_t x = index % row;
+    std::size_t y = index / row;
+
+    return x == 0 || y == 0 || x == gridSize || y == gridSize;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// UNIFORM WEIGHTS ------------------------------------------------------------
+
+// With lambda one a uniform step moves a vertex onto the average of its
+// neighbours; with lambda one half it goes half way.
+
+void testUniformWeights( void )
+{
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, gridSize );
+
+    TestGraph::VertexIterator raised = vertices[ 2 * ( gridSize + 1 ) + 3 ];
+    raised->position[ 0 ] += 0.3f;
+    raised->position[ 2 ] = 2.0f;
+
+    Adjacency adjacency;
+    graph::buildVertexAdjacency( graph, adjacency );
+
+    std::uint32_t index = adjacency.getIndex( raised );
+    float average[ 3 ] = { 0.0f, 0.0f, 0.0f };
+    std::uint32_t first = adjacency.offsets[ index ];
+    std::uint32_t last = adjacency.offsets[ index + 1 ];
+
+    PG_CHECK( last - first == 6 );
+
+    for( std::uint32_t n = first; n < last; ++n )
+    {
+        float const * p =
+            adjacency.vertices[ adjacency.neighbours[ n ] ]->position;
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            average[ axis ] += p[ axis ] / float( last - first );
+        }
+    }
+
+    std::vector< float > start;
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        start.insert( start.end(), vertices[ v ]->position,
+                      vertices[ v ]->position + 3 );
+    }
+
+    Smoother smoother( adjacency );
+    smoother.build( Smoother::uniformWeights, 2 );
+    smoother.smooth( 1, 1.0f, 2 );
+
+    float moved[ 3 ];
+    smoother.getPosition( index, moved );
+
+    PG_CHECK( getDistance( moved, average ) < 1e-5 );
+
+    // The graph keeps its positions until apply
+
+    PG_CHECK( raised->position[ 2 ] == 2.0f );
+
+    smoother.apply();
+
+    PG_CHECK( getDistance( raised->position, average ) < 1e-5 );
+
+    // Half way, from the graph's original positions
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            vertices[ v ]->position[ axis ] = start[ v * 3 + axis ];
+        }
+    }
+
+    smoother.gather();
+    smoother.smooth( 1, 0.5f );
+    smoother.getPosition( index, moved );
+
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        float halfway = 0.5f * ( raised->position[ axis ] + average[ axis ] );
+
+        PG_CHECK( isNear( moved[ axis ], halfway, tolerance ) );
+    }
+}
+
+// COTANGENT FLAT GRID --------------------------------------------------------
+
+// Cotangent weights reproduce linear functions on a flat mesh of right
+// triangles, so interior vertices stay put. The columns alternate in
+// width, so uniform weights, which ignore geometry, drift them sideways.
+
+void testCotangentFlatGrid( void )
+{
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, gridSize );
+
+    // A regular grid first: every interior vertex stays put
+
+    Adjacency adjacency;
+    graph::buildVertexAdjacency( graph, adjacency );
+
+    Smoother smoother( adjacency );
+    smoother.setFixedBoundary();
+    smoother.build( Smoother::cotangentWeights, 2 );
+    smoother.smooth( 10, 0.5f, 2 );
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        float moved[ 3 ];
+        smoother.getPosition( adjacency.getIndex( vertices[ v ] ), moved );
+
+        PG_CHECK( getDistance( moved, vertices[ v ]->position ) < 1e-5 );
+    }
+
+    // Then columns of alternating width
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        std::size_t x = v % ( gridSize + 1 );
+        vertices[ v ]->position[ 0 ] = 1.5f * float( x ) - 0.25f *
+                                       float( x % 2 );
+    }
+
+    Smoother uniform( adjacency );
+    uniform.setFixedBoundary();
+    uniform.build( Smoother::uniformWeights, 2 );
+    uniform.smooth( 10, 0.5f, 2 );
+
+    smoother.build( Smoother::cotangentWeights, 2 );
+    smoother.smooth( 10, 0.5f, 2 );
+
+    double uniformDrift = 0.0;
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        std::uint32_t index = adjacency.getIndex( vertices[ v ] );
+        float moved[ 3 ];
+
+        smoother.getPosition( index, moved );
+        PG_CHECK( getDistance( moved, vertices[ v ]->position ) < 1e-5 );
+
+        uniform.getPosition( index, moved );
+        PG_CHECK( moved[ 2 ] == 0.0f );
+        uniformDrift = std::fmax
+        (
+            uniformDrift, getDistance( moved, vertices[ v ]->position )
+        );
+    }
+
+    PG_CHECK( uniformDrift > 0.05 );
+}
+
+// FIXED BOUNDARY -------------------------------------------------------------
+
+// Boundary vertices are those on an edge with one polygon. Fixed, they
+// keep their exact positions while the interior is smoothed.
+
+void testFixedBoundary( void )
+{
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, gridSize );
+    std::vector< float > heights;
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        float * p = vertices[ v ]->position;
+        p[ 2 ] = 0.5f * std::sin( p[ 0 ] * 1.3f ) * std::cos( p[ 1 ] );
+        heights.push_back( p[ 2 ] );
+    }
+
+    Adjacency adjacency;
+    graph::buildVertexAdjacency( graph, adjacency );
+
+    Smoother smoother( adjacency );
+    smoother.build( Smoother::uniformWeights );
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        PG_CHECK( smoother.isBoundary( adjacency.getIndex( vertices[ v ] ) )
+                  == isGridBorder( v ) );
+    }
+
+    // Free, the boundary moves too
+
+    smoother.smooth( 5, 0.5f );
+
+    std::size_t movedBorder = 0;
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        float moved[ 3 ];
+        smoother.getPosition( adjacency.getIndex( vertices[ v ] ), moved );
+
+        movedBorder += isGridBorder( v ) &&
+                       getDistance( moved, vertices[ v ]->position ) >
+                       1e-3 ? 1 : 0;
+    }
+
+    PG_CHECK( movedBorder > 0 );
+
+    // Fixed, it keeps its exact positions through apply
+
+    smoother.setFixedBoundary();
+    smoother.gather();
+    smoother.smooth( 5, 0.5f );
+    smoother.apply();
+
+    std::size_t movedInterior = 0;
+
+    for( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        float const * p = vertices[ v ]->position;
+        float x = float( v % ( gridSize + 1 ) );
+        float y = float( v / ( gridSize + 1 ) );
+
+        if( isGridBorder( v ) )
+        {
+            PG_CHECK( p[ 0 ] == x && p[ 1 ] == y && p[ 2 ] == heights[ v ] );
+        }
+        else
+        {
+            movedInterior += p[ 2 ] != heights[ v ] ? 1 : 0;
+        }
+    }
+
+    PG_CHECK( movedInterior == ( gridSize - 1 ) * ( gridSize - 1 ) );
+}
+
+// TAUBIN SHRINKAGE -----------------------------------------------------------
+
+// On a noisy closed sphere plain Laplacian smoothing shrinks the mesh;
+// Taubin smoothing removes the noise while keeping its size.
+
+void testTaubinShrinkage( void )
+{
+    std::size_t const iterations = 10;
+
+    TestGraph laplacianGraph;
+    TestGraph taubinGraph;
+    makeSphere( laplacianGraph, 12, 0.05f );
+    makeSphere( taubinGraph, 12, 0.05f );
+
+    double const radius = getMeanRadius( laplacianGraph );
+    double const spread = getRadiusSpread( laplacianGraph );
+
+    Adjacency laplacianAdjacency;
+    Adjacency taubinAdjacency;
+    graph::buildVertexAdjacency( laplacianGraph, laplacianAdjacency );
+    graph::buildVertexAdjacency( taubinGraph, taubinAdjacency );
+
+    Smoother laplacian( laplacianAdjacency );
+    laplacian.build( Smoother::cotangentWeights, 2 );
+    laplacian.smooth( iterations, 0.5f, 2 );
+    laplacian.apply();
+
+    Smoother taubin( taubinAdjacency );
+    taubin.build( Smoother::cotangentWeights, 2 );
+    taubin.smoothTaubin( iterations, 0.5f, -0.53f, 2 );
+    taubin.apply();
+
+    double laplacianShrink = radius - getMeanRadius( laplacianGraph );
+    double taubinShrink = radius - getMeanRadius( taubinGraph );
+
+    PG_CHECK( laplacianShrink > 0.05 );
+    PG_CHECK( std::fabs( taubinShrink ) < 0.25 * laplacianShrink );
+
+    // while still evening out the noise
+
+    PG_CHECK( getRadiusSpread( taubinGraph ) < 0.75 * spread );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testUniformWeights();
+    testCotangentFlatGrid();
+    testFixedBoundary();
+    testTaubinShrinkage();
+
+    return graph::test::finish();
+}
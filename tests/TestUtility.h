@@ -0,0 +1,210 @@
+#ifndef POLYGON_GRAPH_TEST_UTILITY_H
+#define POLYGON_GRAPH_TEST_UTILITY_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "PolygonGraph.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TEST MACROS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// PG_CHECK( condition ) reports a failed condition and carries on, so one
+// run lists every failure. main returns graph::test::finish().
+
+#define PG_CHECK( condition ) \
+    graph::test::check( ( condition ), #condition, __FILE__, __LINE__ )
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TEST NAMESPACE +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace graph
+{
+    namespace test
+    {
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // CHECK FUNCTIONS ++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        inline std::size_t & getFailureCount( void )
+        {
+            static std::size_t failures = 0;
+
+            return failures;
+        }
+
+        inline bool const check
+        (
+            bool passed,
+            char const * condition,
+            char const * file,
+            int line
+        )
+        {
+            if( !passed )
+            {
+                std::fprintf( stderr, "%s:%d: check failed: %s\n",
+                              file, line, condition );
+                ++getFailureCount();
+            }
+
+            return passed;
+        }
+
+        inline int const finish( void )
+        {
+            if( getFailureCount() != 0 )
+            {
+                std::fprintf( stderr, "%zu check(s) failed\n",
+                              getFailureCount() );
+                return 1;
+            }
+
+            return 0;
+        }
+
+        // IS NEAR ------------------------------------------------------------
+
+        // True if a and b differ by less than tolerance.
+
+        inline bool const isNear( double a, double b, double tolerance )
+        {
+            return std::fabs( a - b ) < tolerance;
+        }
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // TEST TRAITS CLASS ++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // Vertices carry a position for the geometry modules; edges and
+        // polygons carry nothing.
+
+        class TestTraits
+        {
+            public:
+
+            class BaseVertex
+            {
+                public:
+
+                float position[ 3 ];
+            };
+
+            class BaseEdge {};
+
+            class BasePolygon {};
+        };
+
+        typedef PolygonGraph< TestTraits > TestGraph;
+
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // MESH FUNCTIONS +++++++++++++++++++++++++++++++++++++++++++++++++++++
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+        // MAKE VERTEX --------------------------------------------------------
+
+        inline TestTraits::BaseVertex const makeVertex
+        (
+            float x,
+            float y,
+            float z
+        )
+        {
+            TestTraits::BaseVertex vertex;
+            vertex.position[ 0 ] = x;
+            vertex.position[ 1 ] = y;
+            vertex.position[ 2 ] = z;
+
+            return vertex;
+        }
+
+        // MAKE GRID ----------------------------------------------------------
+
+        // Adds a size x size grid of unit squares in the z = 0 plane, each
+        // split into two triangles, or left as a quad if quads is set.
+        // Returns the ( size + 1 )^2 vertices row by row.
+
+        inline std::vector< TestGraph::VertexIterator > const makeGrid
+        (
+            TestGraph & graph,
+            std::size_t size,
+            bool quads = false
+        )
+        {
+            std::vector< TestGraph::VertexIterator > vertices;
+            std::size_t row = size + 1;
+
+            for( std::size_t y = 0; y < row; ++y )
+            {
+                for( std::size_t x = 0; x < row; ++x )
+                {
+                    vertices.push_back
+                    (
+                        graph.addVertex( makeVertex( float( x ),
+                                                     float( y ),
+                                                     0.0f ) )
+                    );
+                }
+            }
+
+            for( std::size_t y = 0; y < size; ++y )
+            {
+                for( std::size_t x = 0; x < size; ++x )
+                {
+                    std::size_t a = y * row + x;
+
+                    if( quads )
+                    {
+                        graph.addQuad( vertices[ a ],
+                                       vertices[ a + 1 ],
+                                       vertices[ a + row + 1 ],
+                                       vertices[ a + row ] );
+                    }
+                    else
+                    {
+                        graph.addTriangle( vertices[ a ],
+                                           vertices[ a + 1 ],
+                                           vertices[ a + row + 1 ] );
+                        graph.addTriangle( vertices[ a ],
+                                           vertices[ a + row + 1 ],
+                                           vertices[ a + row ] );
+                    }
+                }
+            }
+
+            return vertices;
+        }
+
+        // GET SOURCE AND TARGET ----------------------------------------------
+
+        // Vertices a half-edge leaves and enters, as pointers to compare.
+
+        inline TestGraph::Vertex const * getSource
+        (
+            TestGraph::Edge const * edge
+        )
+        {
+            return &( *edge->getPreviousEdge()->getTargetVertex() );
+        }
+
+        inline TestGraph::Vertex const * getTarget
+        (
+            TestGraph::Edge const * edge
+        )
+        {
+            return &( *edge->getTargetVertex() );
+        }
+    }
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#endif // POLYGON_GRAPH_TEST_UTILITY_H
@@ -0,0 +1,494 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PolygonGraphShortestPath.h"
+#include "PolygonGraphTrace.h"
+#include "TestUtility.h"
+
+// Built with POLYGON_GRAPH_TRACE defined, so the library records spans.
+
+#if !defined( POLYGON_GRAPH_TRACE )
+#error "TraceTest must be built with POLYGON_GRAPH_TRACE defined"
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+typedef graph::VertexAdjacency< graph::test::TestTraits > Adjacency;
+typedef graph::ShortestPaths< graph::test::TestTraits > Paths;
+
+char const * const tracePath = "TraceTest.json";
+
+// JSON VALUE -----------------------------------------------------------------
+
+class JsonValue
+{
+    public:
+
+    enum Type { null, boolean, number, string, array, object };
+
+    JsonValue( void )
+    {
+        this->type = null;
+        this->value = 0.0;
+    }
+
+    // Returns the member called key, or nullptr
+
+    JsonValue const * find( std::string const & key ) const
+    {
+        for( std::size_t m = 0; m < members.size(); ++m )
+        {
+            if( members[ m ].first == key )
+            {
+                return &members[ m ].second;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Type type;
+    double value;
+    std::string text;
+    std::vector< JsonValue > elements;
+    std::vector< std::pair< std::string, JsonValue > > members;
+};
+
+// JSON READER ----------------------------------------------------------------
+
+// Strict recursive-descent reader for the subset of JSON without escapes
+// in strings, which is all the trace writer produces.
+
+class JsonReader
+{
+    public:
+
+    JsonReader( std::string const & text )
+    {
+        this->text = text;
+        this->position = 0;
+    }
+
+    // Reads the whole text as one value
+
+    bool const read( JsonValue & value )
+    {
+        if( !readValue( value ) )
+        {
+            return false;
+        }
+
+        skipSpace();
+        return position == text.size();
+    }
+
+    private:
+
+    void skipSpace( void )
+    {
+        while( position < text.size() &&
+               std::isspace( static_cast< unsigned char >
+               (
+                   text[ position ]
+               ) ) )
+        {
+            ++position;
+        }
+    }
+
+    bool const accept( char c )
+    {
+        skipSpace();
+
+        if( position < text.size() && text[ position ] == c )
+        {
+            ++position;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool const readLiteral( char const * literal )
+    {
+        std::string word( literal );
+
+        if( text.compare( position, word.size(), word ) != 0 )
+        {
+            return false;
+        }
+
+        position += word.size();
+        return true;
+    }
+
+    bool const readString( std::string & result )
+    {
+        if( !accept( '"' ) )
+        {
+            return false;
+        }
+
+        std::size_t end = text.find( '"', position );
+
+        if( end == std::string::npos ||
+            text.find( '\\', position ) < end )
+        {
+            return false;
+        }
+
+        result = text.substr( position, end - position );
+        position = end + 1;
+        return true;
+    }
+
+    bool const readValue( JsonValue & value )
+    {
+        skipSpace();
+
+        if( position >= text.size() )
+        {
+            return false;
+        }
+
+        char c = text[ position ];
+
+        if( c == '{' )
+        {
+            value.type = JsonValue::object;
+            ++position;
+
+            if( accept( '}' ) )
+            {
+                return true;
+            }
+
+            do
+            {
+                std::pair< std::string, JsonValue > member;
+
+                if( !readString( member.first ) || !accept( ':' ) ||
+                    !readValue( member.second ) )
+                {
+                    return false;
+                }
+
+                value.members.push_back( member );
+            }
+            while( accept( ',' ) );
+
+            return accept( '}' );
+        }
+
+        if( c == '[' )
+        {
+            value.type = JsonValue::array;
+            ++position;
+
+            if( accept( ']' ) )
+            {
+                return true;
+            }
+
+            do
+            {
+                value.elements.push_back( JsonValue() );
+
+                if( !readValue( value.elements.back() ) )
+                {
+                    return false;
+                }
+            }
+            while( accept( ',' ) );
+
+            return accept( ']' );
+        }
+
+        if( c == '"' )
+        {
+            value.type = JsonValue::string;
+            return readString( value.text );
+        }
+
+        if( c == 't' || c == 'f' )
+        {
+            value.type = JsonValue::boolean;
+            value.value = c == 't' ? 1.0 : 0.0;
+            return readLiteral( c == 't' ? "true" : "false" );
+        }
+
+        if( c == 'n' )
+        {
+            return readLiteral( "null" );
+        }
+
+        char const * begin = text.c_str() + position;
+        char * end = nullptr;
+
+        value.type = JsonValue::number;
+        value.value = std::strtod( begin, &end );
+        position += static_cast< std::size_t >( end - begin );
+
+        return end != begin;
+    }
+
+    std::string text;
+    std::size_t position;
+};
+
+// SPAN -----------------------------------------------------------------------
+
+class Span
+{
+    public:
+
+    std::string name;
+    double begin;
+    double end;
+};
+
+// READ TRACE -----------------------------------------------------------------
+
+// Reads the trace file into spans per track, in file order. Returns false
+// unless the file is valid JSON in the trace-event format.
+
+bool const readTrace
+(
+    char const * path,
+    std::map< unsigned, std::vector< Span > > & tracks
+)
+{
+    tracks.clear();
+
+    std::FILE * file = std::fopen( path, "rb" );
+
+    if( file == nullptr )
+    {
+        return false;
+    }
+
+    std::string text;
+    char buffer[ 4096 ];
+    std::size_t read;
+
+    while( ( read = std::fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+    {
+        text.append( buffer, read );
+    }
+
+    std::fclose( file );
+
+    JsonValue root;
+
+    if( !JsonReader( text ).read( root ) ||
+        root.type != JsonValue::object )
+    {
+        return false;
+    }
+
+    JsonValue const * events = root.find( "traceEvents" );
+
+    if( events == nullptr || events->type != JsonValue::array )
+    {
+        return false;
+    }
+
+    for( JsonValue const & event : events->elements )
+    {
+        JsonValue const * name = event.find( "name" );
+        JsonValue const * phase = event.find( "ph" );
+        JsonValue const * begin = event.find( "ts" );
+        JsonValue const * duration = event.find( "dur" );
+        JsonValue const * thread = event.find( "tid" );
+
+        if( name == nullptr || name->type != JsonValue::string ||
+            phase == nullptr || phase->text != "X" ||
+            begin == nullptr || begin->type != JsonValue::number ||
+            duration == nullptr || duration->type != JsonValue::number ||
+            duration->value < 0.0 ||
+            thread == nullptr || thread->type != JsonValue::number )
+        {
+            return false;
+        }
+
+        Span span;
+        span.name = name->text;
+        span.begin = begin->value;
+        span.end = begin->value + duration->value;
+        tracks[ unsigned( thread->value ) ].push_back( span );
+    }
+
+    return true;
+}
+
+// CHECK TRACKS ---------------------------------------------------------------
+
+// Spans on one track are recorded as they end, so they come in order of
+// end time, and any two either nest or do not overlap.
+
+void checkTracks( std::map< unsigned, std::vector< Span > > const & tracks )
+{
+    // Times are written in microseconds to three decimals
+
+    double const tolerance = 0.002;
+
+    for( auto const & track : tracks )
+    {
+        std::vector< Span > const & spans = track.second;
+
+        for( std::size_t a = 0; a < spans.size(); ++a )
+        {
+            PG_CHECK( a == 0 || spans[ a - 1 ].end <= spans[ a ].end +
+                                                      tolerance );
+
+            for( std::size_t b = a + 1; b < spans.size(); ++b )
+            {
+                bool disjoint =
+                    spans[ a ].end <= spans[ b ].begin + tolerance ||
+                    spans[ b ].end <= spans[ a ].begin + tolerance;
+                bool nested =
+                    spans[ b ].begin <= spans[ a ].begin + tolerance &&
+                    spans[ a ].end <= spans[ b ].end + tolerance;
+
+                PG_CHECK( disjoint || nested );
+            }
+        }
+    }
+}
+
+// COUNT SPANS ----------------------------------------------------------------
+
+std::size_t const countSpans
+(
+    std::map< unsigned, std::vector< Span > > const & tracks,
+    std::string const & name
+)
+{
+    std::size_t count = 0;
+
+    for( auto const & track : tracks )
+    {
+        for( Span const & span : track.second )
+        {
+            count += span.name == name ? 1 : 0;
+        }
+    }
+
+    return count;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// THREADED TRACE -------------------------------------------------------------
+
+void testThreadedTrace( void )
+{
+    std::size_t const threadCount = 4;
+
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > vertices =
+        graph::test::makeGrid( graph, 8 );
+
+    Adjacency adjacency;
+    graph::buildVertexAdjacency( graph, adjacency );
+
+    Paths paths( adjacency );
+    std::vector< Paths::Result > results;
+    std::vector< TestGraph::VertexIterator > sources( vertices.begin(),
+                                                      vertices.begin() + 8 );
+    std::map< unsigned, std::vector< Span > > tracks;
+
+    graph::clearTrace();
+
+    // One span for the batch and one per block, each block on its own
+    // thread, the first on the calling thread
+
+    paths.findPathsBatch( sources, results, 100.0, threadCount );
+
+    PG_CHECK( graph::writeChromeTrace( tracePath ) );
+    PG_CHECK( readTrace( tracePath, tracks ) );
+    checkTracks( tracks );
+
+    PG_CHECK( countSpans( tracks, "ShortestPaths::findPathsBatch" ) == 1 );
+    PG_CHECK( countSpans( tracks, "parallelFor" ) == threadCount );
+
+    // Workers may hand their ring on to the next one, but the calling
+    // thread keeps its own
+
+    PG_CHECK( tracks.size() >= 2 );
+
+    // The batch span ends last on its track and holds the block run on
+    // the calling thread
+
+    std::size_t heldBlocks = 0;
+
+    for( auto const & track : tracks )
+    {
+        Span const & last = track.second.back();
+
+        if( last.name != "ShortestPaths::findPathsBatch" )
+        {
+            continue;
+        }
+
+        for( Span const & span : track.second )
+        {
+            heldBlocks += span.name == "parallelFor" &&
+                          span.begin >= last.begin &&
+                          span.end <= last.end ? 1 : 0;
+        }
+    }
+
+    PG_CHECK( heldBlocks == 1 );
+
+    // Clearing drops every span, leaving a valid empty trace
+
+    graph::clearTrace();
+
+    PG_CHECK( graph::writeChromeTrace( tracePath ) );
+    PG_CHECK( readTrace( tracePath, tracks ) );
+    PG_CHECK( tracks.empty() );
+
+    // and spans recorded afterwards start afresh
+
+    paths.findPathsBatch( sources, results, 100.0, threadCount );
+
+    PG_CHECK( graph::writeChromeTrace( tracePath ) );
+    PG_CHECK( readTrace( tracePath, tracks ) );
+    checkTracks( tracks );
+    PG_CHECK( countSpans( tracks, "ShortestPaths::findPathsBatch" ) == 1 );
+    PG_CHECK( countSpans( tracks, "parallelFor" ) == threadCount );
+
+    std::remove( tracePath );
+
+    // An unwritable path is reported
+
+    PG_CHECK( !graph::writeChromeTrace( "no-such-directory/trace.json" ) );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testThreadedTrace();
+
+    return graph::test::finish();
+}
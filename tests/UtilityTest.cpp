@@ -0,0 +1,162 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PolygonGraphUtility.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// RUN THROWING ---------------------------------------------------------------
+
+// Runs count one-item blocks, one per thread, where the blocks listed in
+// throwing throw their index. Returns the message caught, or an empty
+// string, and counts the blocks that ran to completion.
+
+std::string const runThrowing
+(
+    std::size_t count,
+    std::vector< std::size_t > const & throwing,
+    std::size_t & completed
+)
+{
+    std::vector< int > done( count, 0 );
+    std::string message;
+
+    try
+    {
+        graph::parallelFor
+        (
+            count, count,
+            [ & ]( std::size_t begin, std::size_t, std::size_t thread )
+            {
+                for( std::size_t t : throwing )
+                {
+                    if( t == thread )
+                    {
+                        throw std::runtime_error( std::to_string( begin ) );
+                    }
+                }
+
+                done[ thread ] = 1;
+            },
+            1
+        );
+    }
+    catch( std::runtime_error const & error )
+    {
+        message = error.what();
+    }
+
+    completed = 0;
+
+    for( std::size_t b = 0; b < count; ++b )
+    {
+        completed += std::size_t( done[ b ] );
+    }
+
+    return message;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// PARALLEL FOR BLOCKS --------------------------------------------------------
+
+// Blocks are contiguous, cover the range once and have distinct thread
+// indices below the thread count.
+
+void testParallelForBlocks( void )
+{
+    std::size_t const counts[] = { 0, 1, 5, 1000, 4097 };
+    std::size_t const threadCounts[] = { 1, 2, 3, 8 };
+    std::size_t const minimumBlocks[] = { 1, 1024 };
+
+    for( std::size_t count : counts )
+    {
+        for( std::size_t threadCount : threadCounts )
+        {
+            for( std::size_t minimumBlock : minimumBlocks )
+            {
+                std::vector< int > visits( count, 0 );
+                std::vector< std::size_t > owners( count, threadCount );
+
+                graph::parallelFor
+                (
+                    count, threadCount,
+                    [ & ]( std::size_t begin, std::size_t end,
+                           std::size_t thread )
+                    {
+                        for( std::size_t i = begin; i < end; ++i )
+                        {
+                            ++visits[ i ];
+                            owners[ i ] = thread;
+                        }
+                    },
+                    minimumBlock
+                );
+
+                for( std::size_t i = 0; i < count; ++i )
+                {
+                    PG_CHECK( visits[ i ] == 1 );
+                    PG_CHECK( owners[ i ] < threadCount );
+                    PG_CHECK( i == 0 || owners[ i ] == owners[ i - 1 ] ||
+                              owners[ i ] == owners[ i - 1 ] + 1 );
+                }
+            }
+        }
+    }
+}
+
+// PARALLEL FOR EXCEPTIONS ----------------------------------------------------
+
+// A throw from any block, on a worker or on the calling thread, reaches
+// the caller after every other block has finished; the lowest block that
+// threw wins.
+
+void testParallelForExceptions( void )
+{
+    std::size_t const count = 6;
+    std::size_t completed = 0;
+
+    PG_CHECK( runThrowing( count, {}, completed ).empty() );
+    PG_CHECK( completed == count );
+
+    PG_CHECK( runThrowing( count, { 3 }, completed ) == "3" );
+    PG_CHECK( completed == count - 1 );
+
+    PG_CHECK( runThrowing( count, { 0 }, completed ) == "0" );
+    PG_CHECK( completed == count - 1 );
+
+    PG_CHECK( runThrowing( count, { 5, 2, 4 }, completed ) == "2" );
+    PG_CHECK( completed == count - 3 );
+
+    PG_CHECK( runThrowing( count, { 0, 1, 2, 3, 4, 5 },
+                           completed ) == "0" );
+    PG_CHECK( completed == 0 );
+
+    // Inline, a single block throws straight through
+
+    PG_CHECK( runThrowing( 1, { 0 }, completed ) == "0" );
+    PG_CHECK( completed == 0 );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testParallelForBlocks();
+    testParallelForExceptions();
+
+    return graph::test::finish();
+}
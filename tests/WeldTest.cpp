@@ -0,0 +1,140 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// INCLUDES +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "PolygonGraphWeld.h"
+#include "TestUtility.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// HELPERS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+using graph::test::TestGraph;
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TESTS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// WELD VERTICES --------------------------------------------------------------
+
+void testWeldVertices( void )
+{
+    double const nan = std::numeric_limits< double >::quiet_NaN();
+    double const inf = std::numeric_limits< double >::infinity();
+
+    // 0, 1 and 3 are within tolerance of each other; 2 is not, nor are
+    // the NaN, infinite and huge vertices, which only weld to exact copies
+    // of themselves through tolerance
+
+    double const positions[] =
+    {
+        0.0, 0.0, 0.0,
+        0.0005, 0.0, 0.0,
+        1.0, 0.0, 0.0,
+        0.0, -0.0005, 0.0,
+        nan, 0.0, 0.0,
+        inf, 0.0, 0.0,
+        -inf, 1e300, 0.0,
+        1e300, 0.0, 0.0,
+        nan, 0.0, 0.0
+    };
+    std::size_t const vertexCount = sizeof( positions ) /
+                                    sizeof( *positions ) / 3;
+
+    std::vector< std::uint32_t > remap;
+    std::vector< std::uint32_t > unique;
+
+    PG_CHECK( graph::weldVertices( positions, vertexCount, 0.001, remap,
+                                   unique, 3 ) == 7 );
+    PG_CHECK( remap.size() == vertexCount );
+    PG_CHECK( remap[ 1 ] == remap[ 0 ] && remap[ 3 ] == remap[ 0 ] );
+    PG_CHECK( remap[ 2 ] != remap[ 0 ] );
+    PG_CHECK( remap[ 8 ] != remap[ 4 ] );
+    PG_CHECK( unique[ remap[ 0 ] ] == 0 );
+
+    // Zero tolerance welds exact duplicates, treating -0 as +0
+
+    double const exact[] =
+    {
+        0.0, 1.0, 2.0,
+        -0.0, 1.0, 2.0,
+        0.0, 1.0, 2.0000001
+    };
+
+    PG_CHECK( graph::weldVertices( exact, 3, 0.0, remap, unique ) == 2 );
+    PG_CHECK( remap[ 0 ] == remap[ 1 ] && remap[ 2 ] != remap[ 0 ] );
+}
+
+// INGEST POLYGON SOUP --------------------------------------------------------
+
+void testIngestPolygonSoup( void )
+{
+    // Two unit squares side by side, every face with its own corners.
+    // Corner 9 of the third face lies on corner 8, collapsing an edge.
+
+    float const positions[] =
+    {
+        0.0f, 0.0f, 0.0f,   1.0f, 0.0f, 0.0f,
+        1.0f, 1.0f, 0.0f,   0.0f, 1.0f, 0.0f,
+        1.0f, 0.0f, 0.0f,   2.0f, 0.0f, 0.0f,
+        2.0f, 1.0f, 0.0f,   1.0f, 1.0f, 0.0f,
+        3.0f, 0.0f, 0.0f,   3.0f, 0.0f, 0.0001f,
+        4.0f, 0.0f, 0.0f,   3.0f, 1.0f, 0.0f
+    };
+    std::uint32_t const faceSizes[] = { 4, 4, 4, 3, 5 };
+    std::uint32_t const indices[] =
+    {
+        0, 1, 2, 3,
+        4, 5, 6, 7,
+        8, 9, 10, 11,       // quad with a collapsed edge: a triangle
+        8, 9, 10,           // triangle collapsed to an edge: dropped
+        1, 5, 6, 4, 7       // visits welded corner 1 twice: dropped
+    };
+
+    TestGraph graph;
+    std::vector< TestGraph::VertexIterator > handles;
+    std::size_t dropped = 0;
+
+    PG_CHECK( graph::ingestPolygonSoup( graph, positions, 12, faceSizes, 5,
+                                        indices, 0.001,
+                                        graph::MemberPosition(), 2,
+                                        &handles, &dropped ) );
+
+    PG_CHECK( graph.getVertexCount() == 9 );
+    PG_CHECK( graph.getPolygonCount() == 3 );
+    PG_CHECK( dropped == 2 );
+    PG_CHECK( handles.size() == 12 );
+    PG_CHECK( handles[ 1 ] == handles[ 4 ] && handles[ 2 ] == handles[ 7 ] );
+    PG_CHECK( handles[ 8 ] == handles[ 9 ] );
+    PG_CHECK( handles[ 5 ]->position[ 0 ] == 2.0f );
+
+    // The squares share their middle edge once welded
+
+    PG_CHECK( handles[ 1 ]->getEdgeCount() == 2 );
+
+    // An out-of-range index leaves the graph untouched
+
+    std::uint32_t const bad[] = { 0, 1, 12 };
+    std::uint32_t const badSize[] = { 3 };
+
+    PG_CHECK( !graph::ingestPolygonSoup( graph, positions, 12, badSize, 1,
+                                         bad, 0.001 ) );
+    PG_CHECK( graph.getPolygonCount() == 3 );
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// MAIN +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+int main( void )
+{
+    testWeldVertices();
+    testIngestPolygonSoup();
+
+    return graph::test::finish();
+}